@@ -0,0 +1,548 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_AUCTION_ASSIGNMENT_H
+#define LEMON_AUCTION_ASSIGNMENT_H
+
+/// \ingroup matching
+///
+/// \file
+/// \brief Auction algorithm for the assignment problem.
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+
+#include <lemon/core.h>
+#include <lemon/bits/thread_pool.h>
+
+namespace lemon {
+
+  /// \addtogroup matching
+  /// @{
+
+  /// \brief Auction algorithm for sparse assignment problems given by
+  /// arrays.
+  ///
+  /// \ref CsrAuctionAssignment implements the epsilon-scaling auction
+  /// algorithm of Bertsekas \cite bertsekas88auction for finding a
+  /// minimum cost perfect matching in a bipartite graph having \c n
+  /// nodes on both sides (\e persons and \e objects). The graph is given
+  /// in compressed sparse row (CSR) form, i.e. the arcs of the person
+  /// \c i are <tt>first[i]..first[i+1]-1</tt>, and \c target[a] and
+  /// \c cost[a] are the object and the cost of the arc \c a.
+  ///
+  /// In each round of the auction, the unassigned persons bid for their
+  /// best objects concurrently (Jacobi bidding), and each object is
+  /// assigned to its highest bidder. These rounds are performed by
+  /// several threads (see \ref threadNum()). Once only a few persons are
+  /// unassigned, the bids are processed one by one (Gauss-Seidel
+  /// bidding). The costs are multiplied by <tt>n+1</tt>, and the scaling
+  /// phases are continued until \e epsilon is 1, so the solution is
+  /// optimal for the original integer costs.
+  ///
+  /// The arrays are not copied, so they must be kept valid while the
+  /// algorithm is used. For graph input, see \ref AuctionAssignment.
+  ///
+  /// \tparam C The number type of the costs. The default type is \c int.
+  ///
+  /// \warning The costs must be integer, and <tt>n^2</tt> times the
+  /// largest absolute cost must fit into \c long \c long.
+  template <typename C = int>
+  class CsrAuctionAssignment
+  {
+  public:
+
+    /// The type of the costs
+    typedef C Cost;
+
+  private:
+
+    typedef long long LargeCost;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<LargeCost> LargeCostVector;
+
+    // The factor by which epsilon is divided in each phase
+    static const int ALPHA = 5;
+
+    int _n;
+    const int *_first;
+    const int *_target;
+    const Cost *_cost;
+    int _thread_num;
+
+    // The assigned arc of each person and the owner of each object
+    IntVector _person_arc;
+    IntVector _owner;
+    LargeCostVector _price;
+
+    // The difference of the largest and the smallest scaled benefit
+    LargeCost _range;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param n The number of persons and objects.
+    /// \param first The first arc of each person (<tt>n+1</tt> values,
+    /// the last one is the number of arcs).
+    /// \param target The object of each arc.
+    /// \param cost The cost of each arc.
+    CsrAuctionAssignment(int n, const int* first, const int* target,
+                         const Cost* cost) :
+      _n(n), _first(first), _target(target), _cost(cost),
+      _thread_num(0), _range(0)
+    {
+      LEMON_ASSERT(std::numeric_limits<Cost>::is_integer,
+        "The cost type of CsrAuctionAssignment must be integer");
+    }
+
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used for the Jacobi
+    /// bidding rounds. If it is not used before calling \ref run(), or
+    /// the given value is not positive, the number of hardware threads
+    /// will be used.
+    ///
+    /// \return <tt>(*this)</tt>
+    CsrAuctionAssignment& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    ///
+    /// \return \c true if a perfect matching exists (then a minimum
+    /// cost one is found), \c false otherwise.
+    bool run() {
+      _person_arc.assign(_n, -1);
+      _owner.assign(_n, -1);
+      _price.assign(_n, 0);
+      if (!hasPerfectMatching()) return false;
+      if (_n == 0) return true;
+
+      LargeCost max_benefit = std::numeric_limits<LargeCost>::min();
+      LargeCost min_benefit = std::numeric_limits<LargeCost>::max();
+      for (int a = 0; a != _first[_n]; ++a) {
+        max_benefit = std::max(max_benefit, benefit(a));
+        min_benefit = std::min(min_benefit, benefit(a));
+      }
+      _range = max_benefit - min_benefit;
+
+      bits::ThreadPool pool(std::min(_thread_num > 0 ? _thread_num :
+                                     bits::hardwareThreadNum(), _n));
+      IntVector queue;
+      LargeCost eps = std::max(_range / ALPHA, LargeCost(1));
+      while (true) {
+        queue.clear();
+        for (int i = 0; i != _n; ++i) {
+          _person_arc[i] = -1;
+          _owner[i] = -1;
+          queue.push_back(i);
+        }
+        if (pool.size() > 1) parallelAuction(pool, queue, eps);
+        sequentialAuction(queue, eps);
+        if (eps == 1) break;
+        eps = std::max(eps / ALPHA, LargeCost(1));
+      }
+      return true;
+    }
+
+    /// \brief Return the object assigned to the given person.
+    int mate(int person) const {
+      return _target[_person_arc[person]];
+    }
+
+    /// \brief Return the arc of the given person in the assignment.
+    int mateArc(int person) const {
+      return _person_arc[person];
+    }
+
+    /// \brief Return the person assigned to the given object.
+    int owner(int object) const {
+      return _owner[object];
+    }
+
+    /// \brief Return the total cost of the assignment.
+    ///
+    /// This function returns the total cost of the assignment.
+    ///
+    /// \note The return type of the function can be specified as a
+    /// template parameter.
+    template <typename Number>
+    Number totalCost() const {
+      Number c = 0;
+      for (int i = 0; i != _n; ++i) {
+        c += static_cast<Number>(_cost[_person_arc[i]]);
+      }
+      return c;
+    }
+
+#ifndef DOXYGEN
+    Cost totalCost() const {
+      return totalCost<Cost>();
+    }
+#endif
+
+  private:
+
+    LargeCost benefit(int a) const {
+      return -static_cast<LargeCost>(_cost[a]) * (_n + 1);
+    }
+
+    // Find the best arc of the person i and the price it bids for its
+    // object (if it has a single arc, then the second best value is
+    // considered to be smaller by the range of the benefits)
+    void bid(int i, LargeCost eps, int& best, LargeCost& price) const {
+      LargeCost v1 = std::numeric_limits<LargeCost>::min(), v2 = v1;
+      best = -1;
+      for (int a = _first[i]; a != _first[i + 1]; ++a) {
+        LargeCost v = benefit(a) - _price[_target[a]];
+        if (v > v1) {
+          v2 = v1;
+          v1 = v;
+          best = a;
+        } else if (v > v2) {
+          v2 = v;
+        }
+      }
+      if (v2 == std::numeric_limits<LargeCost>::min()) v2 = v1 - _range;
+      price = _price[_target[best]] + v1 - v2 + eps;
+    }
+
+    // Gauss-Seidel auction: process the bids of the unassigned persons
+    // one by one
+    void sequentialAuction(IntVector& queue, LargeCost eps) {
+      while (!queue.empty()) {
+        int i = queue.back();
+        queue.pop_back();
+        int a;
+        LargeCost price;
+        bid(i, eps, a, price);
+        int j = _target[a];
+        int prev = _owner[j];
+        _owner[j] = i;
+        _person_arc[i] = a;
+        _price[j] = price;
+        if (prev != -1) {
+          _person_arc[prev] = -1;
+          queue.push_back(prev);
+        }
+      }
+    }
+
+    // Jacobi auction: in each round, all unassigned persons bid, and
+    // each object is assigned to its highest bidder (the first one
+    // recording it in case of ties). The rounds are performed until
+    // only a few persons are unassigned.
+    void parallelAuction(bits::ThreadPool& pool, IntVector& queue,
+                         LargeCost eps) {
+      const int thread_num = pool.size();
+      const int MIN_PARALLEL_BIDS = 64 * thread_num;
+      std::vector<std::atomic<LargeCost> > best_bid(_n);
+      std::vector<std::atomic<int> > winner(_n);
+      for (int j = 0; j != _n; ++j) {
+        best_bid[j].store(std::numeric_limits<LargeCost>::min(),
+                          std::memory_order_relaxed);
+        winner[j].store(-1, std::memory_order_relaxed);
+      }
+      IntVector bid_arc;
+      LargeCostVector bid_price;
+      std::vector<IntVector> next(thread_num);
+
+      while (int(queue.size()) >= MIN_PARALLEL_BIDS) {
+        const int num = int(queue.size());
+        bid_arc.resize(num);
+        bid_price.resize(num);
+
+        // Compute the bids and the highest bid for each object
+        pool.run([&](int id) {
+          int last = int(static_cast<long long>(num) * (id + 1) /
+                         thread_num);
+          for (int k = int(static_cast<long long>(num) * id / thread_num);
+               k != last; ++k) {
+            bid(queue[k], eps, bid_arc[k], bid_price[k]);
+            std::atomic<LargeCost> &b = best_bid[_target[bid_arc[k]]];
+            LargeCost cur = b.load(std::memory_order_relaxed);
+            while (cur < bid_price[k] &&
+                   !b.compare_exchange_weak(cur, bid_price[k])) {}
+          }
+        });
+
+        // Select a winner for each object
+        pool.run([&](int id) {
+          int last = int(static_cast<long long>(num) * (id + 1) /
+                         thread_num);
+          for (int k = int(static_cast<long long>(num) * id / thread_num);
+               k != last; ++k) {
+            int j = _target[bid_arc[k]];
+            if (bid_price[k] == best_bid[j].load()) {
+              int none = -1;
+              winner[j].compare_exchange_strong(none, k);
+            }
+          }
+        });
+
+        // Assign the objects to the winners, the losers and the
+        // displaced persons will bid in the next round
+        pool.run([&](int id) {
+          IntVector &nx = next[id];
+          nx.clear();
+          int last = int(static_cast<long long>(num) * (id + 1) /
+                         thread_num);
+          for (int k = int(static_cast<long long>(num) * id / thread_num);
+               k != last; ++k) {
+            int i = queue[k], j = _target[bid_arc[k]];
+            if (winner[j].load() != k) {
+              nx.push_back(i);
+              continue;
+            }
+            int prev = _owner[j];
+            _owner[j] = i;
+            _person_arc[i] = bid_arc[k];
+            _price[j] = bid_price[k];
+            if (prev != -1) {
+              _person_arc[prev] = -1;
+              nx.push_back(prev);
+            }
+            best_bid[j].store(std::numeric_limits<LargeCost>::min());
+            winner[j].store(-1);
+          }
+        });
+
+        queue.clear();
+        for (int t = 0; t != thread_num; ++t) {
+          queue.insert(queue.end(), next[t].begin(), next[t].end());
+        }
+      }
+    }
+
+    // Check whether a perfect matching exists using the Hopcroft-Karp
+    // algorithm (the auction would not terminate otherwise)
+    bool hasPerfectMatching() const {
+      const int INF = std::numeric_limits<int>::max();
+      IntVector person_mate(_n, -1), object_mate(_n, -1);
+      IntVector dist(_n), queue, it(_n), stack;
+      int matched = 0;
+      while (matched != _n) {
+        // Compute the layers using BFS from the free persons
+        queue.clear();
+        for (int i = 0; i != _n; ++i) {
+          dist[i] = person_mate[i] == -1 ? 0 : INF;
+          if (dist[i] == 0) queue.push_back(i);
+        }
+        bool found = false;
+        for (int k = 0; k != int(queue.size()); ++k) {
+          int i = queue[k];
+          for (int a = _first[i]; a != _first[i + 1]; ++a) {
+            int p = object_mate[_target[a]];
+            if (p == -1) {
+              found = true;
+            } else if (dist[p] == INF) {
+              dist[p] = dist[i] + 1;
+              queue.push_back(p);
+            }
+          }
+        }
+        if (!found) return false;
+
+        // Find vertex-disjoint shortest augmenting paths using DFS
+        for (int i = 0; i != _n; ++i) it[i] = _first[i];
+        int prev_matched = matched;
+        for (int s = 0; s != _n; ++s) {
+          if (person_mate[s] != -1) continue;
+          stack.assign(1, s);
+          while (!stack.empty()) {
+            int u = stack.back();
+            if (it[u] == _first[u + 1]) {
+              dist[u] = INF;
+              stack.pop_back();
+              continue;
+            }
+            int j = _target[it[u]++];
+            int p = object_mate[j];
+            if (p == -1) {
+              for (int k = 0; k != int(stack.size()); ++k) {
+                int v = stack[k], o = _target[it[v] - 1];
+                person_mate[v] = o;
+                object_mate[o] = v;
+              }
+              ++matched;
+              break;
+            } else if (dist[p] == dist[u] + 1) {
+              stack.push_back(p);
+            }
+          }
+        }
+        if (matched == prev_matched) return false;
+      }
+      return true;
+    }
+
+  }; //class CsrAuctionAssignment
+
+  /// \brief Auction algorithm for the assignment problem in bipartite
+  /// graphs.
+  ///
+  /// \ref AuctionAssignment finds a minimum cost perfect matching in a
+  /// bipartite graph having the same number of red and blue nodes using
+  /// the parallel epsilon-scaling auction algorithm. It converts the
+  /// graph to arrays and runs \ref CsrAuctionAssignment.
+  ///
+  /// \tparam BPGR The bipartite graph type the algorithm runs on
+  /// (e.g. \ref SmartBpGraph or \ref ListBpGraph).
+  /// \tparam CM The type of the edge cost map. The default type is
+  /// \ref concepts::BpGraph::EdgeMap "BPGR::EdgeMap<int>".
+  ///
+  /// \warning The costs must be integer.
+  template <typename BPGR,
+            typename CM = typename BPGR::template EdgeMap<int> >
+  class AuctionAssignment
+  {
+  public:
+
+    /// The type of the bipartite graph
+    typedef BPGR BpGraph;
+    /// The type of the cost map
+    typedef CM CostMap;
+    /// The type of the costs
+    typedef typename CostMap::Value Cost;
+
+  private:
+
+    TEMPLATE_BPGRAPH_TYPEDEFS(BpGraph);
+
+    const BpGraph &_graph;
+    const CostMap &_cost;
+    int _thread_num;
+
+    std::vector<RedNode> _red;
+    std::vector<BlueNode> _blue;
+    IntRedNodeMap _red_index;
+    IntBlueNodeMap _blue_index;
+    std::vector<Edge> _edges;
+    std::vector<int> _red_mate;
+    std::vector<int> _blue_mate;
+    Cost _total_cost;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param graph The bipartite graph the algorithm runs on.
+    /// \param cost The costs of the edges.
+    AuctionAssignment(const BpGraph& graph, const CostMap& cost) :
+      _graph(graph), _cost(cost), _thread_num(0),
+      _red_index(graph), _blue_index(graph), _total_cost(0) {}
+
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used by the algorithm
+    /// (see \ref CsrAuctionAssignment::threadNum()).
+    ///
+    /// \return <tt>(*this)</tt>
+    AuctionAssignment& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    ///
+    /// \return \c true if a perfect matching exists (then a minimum
+    /// cost one is found), \c false otherwise.
+    bool run() {
+      _red.clear();
+      _blue.clear();
+      _edges.clear();
+      _red_mate.clear();
+      _blue_mate.clear();
+      _total_cost = 0;
+      for (RedNodeIt r(_graph); r != INVALID; ++r) {
+        _red_index[r] = int(_red.size());
+        _red.push_back(r);
+      }
+      for (BlueNodeIt b(_graph); b != INVALID; ++b) {
+        _blue_index[b] = int(_blue.size());
+        _blue.push_back(b);
+      }
+      int n = int(_red.size());
+      if (n != int(_blue.size())) return false;
+
+      std::vector<int> first, target;
+      std::vector<Cost> cost;
+      for (int i = 0; i != n; ++i) {
+        first.push_back(int(target.size()));
+        for (IncEdgeIt e(_graph, _red[i]); e != INVALID; ++e) {
+          target.push_back(_blue_index[_graph.blueNode(e)]);
+          cost.push_back(_cost[e]);
+          _edges.push_back(e);
+        }
+      }
+      first.push_back(int(target.size()));
+      target.push_back(0);
+      cost.push_back(0);
+
+      CsrAuctionAssignment<Cost> alg(n, &first[0], &target[0], &cost[0]);
+      alg.threadNum(_thread_num);
+      if (!alg.run()) return false;
+      _red_mate.resize(n);
+      _blue_mate.resize(n);
+      for (int i = 0; i != n; ++i) {
+        _red_mate[i] = alg.mateArc(i);
+        _blue_mate[alg.mate(i)] = i;
+      }
+      _total_cost = alg.totalCost();
+      return true;
+    }
+
+    /// \brief Return the matching edge of the given red node.
+    Edge matching(const RedNode& node) const {
+      return _edges[_red_mate[_red_index[node]]];
+    }
+
+    /// \brief Return the mate of the given red node.
+    BlueNode mate(const RedNode& node) const {
+      return _graph.blueNode(matching(node));
+    }
+
+    /// \brief Return the mate of the given blue node.
+    RedNode mate(const BlueNode& node) const {
+      return _red[_blue_mate[_blue_index[node]]];
+    }
+
+    /// \brief Return the total cost of the matching.
+    Cost totalCost() const {
+      return _total_cost;
+    }
+
+  }; //class AuctionAssignment
+
+  /// @}
+
+} //namespace lemon
+
+#endif //LEMON_AUCTION_ASSIGNMENT_H
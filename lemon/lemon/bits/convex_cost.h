@@ -0,0 +1,224 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BITS_CONVEX_COST_H
+#define LEMON_BITS_CONVEX_COST_H
+
+#include <vector>
+#include <lemon/assert.h>
+
+namespace lemon {
+  namespace bits {
+
+    // Convex piecewise-linear arc costs for the minimum cost flow
+    // algorithms. The cost function of an arc consisting of k pieces is
+    // given by the slopes s[0..k-1] and the breakpoints b[1..k-1]: its
+    // slope is s[i] between b[i] and b[i+1] (where b[0] = -inf and
+    // b[k] = +inf), and its value is zero for zero flow.
+    //
+    // The algorithms store only the current piece of such an arc in each
+    // direction as residual arcs, i.e. the residual capacity of the
+    // forward (backward) arc is the distance of the flow from the next
+    // (previous) breakpoint or bound. This is equivalent to having a
+    // parallel arc for each piece, since due to the convexity the other
+    // pieces have larger reduced costs in the same direction.
+    template <typename V, typename C>
+    class ConvexCosts {
+    public:
+
+      // Return true if there are no convex cost arcs
+      bool empty() const {
+        return _index.empty();
+      }
+
+      // Remove all cost functions
+      void clear() {
+        _index.clear();
+        _first.clear();
+        _bp.clear();
+        _slope.clear();
+      }
+
+      // Set the cost function of the (forward residual) arc j (the
+      // breakpoints must be increasing and the slopes non-decreasing)
+      template <typename BpIt, typename SlopeIt>
+      void set(int res_arc_num, int j, BpIt bp_first, BpIt bp_last,
+               SlopeIt slope_first) {
+        if (_index.empty()) {
+          _index.assign(res_arc_num, -1);
+          _first.assign(1, 0);
+        }
+        _index[j] = int(_first.size()) - 1;
+        _bp.push_back(V());
+        _slope.push_back(*slope_first);
+        for ( ; bp_first != bp_last; ++bp_first) {
+          _bp.push_back(*bp_first);
+          _slope.push_back(*(++slope_first));
+        }
+        _first.push_back(int(_slope.size()));
+        int num = int(_first.size()) - 1;
+        for (int p = _first[num-1] + 1; p != _first[num]; ++p) {
+          LEMON_ASSERT(p == _first[num-1] + 1 || _bp[p-1] < _bp[p],
+                       "The breakpoints must be increasing");
+          LEMON_ASSERT(_slope[p-1] <= _slope[p],
+                       "The slopes must be non-decreasing");
+        }
+        _lower.resize(num);
+        _upper.resize(num);
+        _flow.resize(num);
+        _piece.resize(num);
+        _inf_upper.resize(num);
+      }
+
+      // Return the index of the cost function of the arc j (or -1)
+      int id(int j) const {
+        return _index[j];
+      }
+
+      // Return the largest absolute slope of the cost function i
+      C maxSlope(int i) const {
+        C max = 0;
+        for (int p = _first[i]; p != _first[i+1]; ++p) {
+          if (_slope[p] > max) max = _slope[p];
+          if (-_slope[p] > max) max = -_slope[p];
+        }
+        return max;
+      }
+
+      // Find the flow value minimizing the cost function i within the
+      // given bounds. Return false if it is unbounded from below.
+      bool minFlow(int i, V lower, V upper, bool inf_upper, V& x) const {
+        int p = _first[i], last = _first[i+1];
+        while (p != last && _slope[p] < 0) ++p;
+        if (p == last) {
+          if (inf_upper) return false;
+          x = upper;
+        } else {
+          x = p == _first[i] ? lower : _bp[p];
+        }
+        if (x < lower) x = lower;
+        if (!inf_upper && x > upper) x = upper;
+        return true;
+      }
+
+      // Initialize the bounds and the flow of the arc i
+      void init(int i, V lower, V upper, bool inf_upper, V x) {
+        _lower[i] = lower;
+        _upper[i] = upper;
+        _inf_upper[i] = inf_upper;
+        _flow[i] = 0;
+        _piece[i] = _first[i];
+        move(i, x);
+      }
+
+      // Change the flow of the arc i by d (it must not exceed the
+      // current residual capacity in the given direction)
+      void move(int i, V d) {
+        V x = (_flow[i] += d);
+        int p = _piece[i];
+        while (p + 1 != _first[i+1] && _bp[p+1] <= x) ++p;
+        while (p != _first[i] && _bp[p] > x) --p;
+        _piece[i] = p;
+      }
+
+      // Return the flow of the arc i
+      V flow(int i) const {
+        return _flow[i];
+      }
+
+      // Compute the residual capacities and costs of the current pieces
+      // of the arc i in both directions
+      void residual(int i, V inf, V& fcap, C& fcost, V& bcap, C& bcost)
+        const {
+        int p = _piece[i];
+        V x = _flow[i];
+        fcost = _slope[p];
+        if (p + 1 != _first[i+1] &&
+            (_inf_upper[i] || _bp[p+1] < _upper[i])) {
+          fcap = _bp[p+1] - x;
+        } else {
+          fcap = _inf_upper[i] ? inf : _upper[i] - x;
+        }
+        int q = p != _first[i] && _bp[p] == x ? p - 1 : p;
+        bcost = -_slope[q];
+        V s = q != _first[i] && _bp[q] > _lower[i] ? _bp[q] : _lower[i];
+        bcap = x - s;
+      }
+
+      // Return the value of the cost function i for the current flow
+      template <typename Number>
+      Number cost(int i) const {
+        Number c = 0;
+        V x = _flow[i];
+        for (int p = _first[i]; p != _first[i+1]; ++p) {
+          c += static_cast<Number>(_slope[p]) *
+               (static_cast<Number>(clamp(i, p, x)) -
+                static_cast<Number>(clamp(i, p, V(0))));
+        }
+        return c;
+      }
+
+      // Return the sum of the negative reduced costs multiplied by the
+      // residual capacities over all pieces of the arc i in both
+      // directions (used for computing the duality gap). The slopes are
+      // multiplied by the given scale and dpi is the potential
+      // difference of the source and the target node.
+      template <typename LC>
+      LC gap(int i, LC scale, LC dpi) const {
+        LC g = 0;
+        V x = _flow[i];
+        for (int p = _first[i]; p != _first[i+1]; ++p) {
+          V lo = clamp(i, p, _lower[i]), hi = clamp(i, p, _upper[i]);
+          LC rc = static_cast<LC>(_slope[p]) * scale + dpi;
+          if (rc < 0 && x < hi) {
+            g -= rc * (hi - (x > lo ? x : lo));
+          } else if (rc > 0 && x > lo) {
+            g += rc * ((x < hi ? x : hi) - lo);
+          }
+        }
+        return g;
+      }
+
+    private:
+
+      // Clamp the given value into the interval of the piece p of the
+      // arc i
+      V clamp(int i, int p, V x) const {
+        if (p != _first[i] && x < _bp[p]) return _bp[p];
+        if (p + 1 != _first[i+1] && x > _bp[p+1]) return _bp[p+1];
+        return x;
+      }
+
+      // Cost functions (the first breakpoint of each function is unused)
+      std::vector<int> _index;
+      std::vector<int> _first;
+      std::vector<V> _bp;
+      std::vector<C> _slope;
+
+      // Bounds and current flow
+      std::vector<V> _lower;
+      std::vector<V> _upper;
+      std::vector<V> _flow;
+      std::vector<int> _piece;
+      std::vector<char> _inf_upper;
+    };
+
+  }
+}
+
+#endif
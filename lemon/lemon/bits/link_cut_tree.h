@@ -0,0 +1,229 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BITS_LINK_CUT_TREE_H
+#define LEMON_BITS_LINK_CUT_TREE_H
+
+#include <vector>
+
+namespace lemon {
+  namespace bits {
+
+    // Dynamic trees of Sleator and Tarjan on the items 0..n-1, which
+    // form a forest of rooted trees. Each non-root item has a cost (the
+    // cost of the edge to its parent). The trees are represented by
+    // splay trees of their preferred paths, so all operations take
+    // O(log n) amortized time. The path operations (findMin(),
+    // addCost()) are applied to the path from the given item to the
+    // root of its tree, excluding the root itself.
+    template <typename V>
+    class LinkCutTree {
+    public:
+
+      explicit LinkCutTree(int n = 0) {
+        resize(n);
+      }
+
+      // Resize the structure and make each item a separate tree
+      void resize(int n) {
+        _items.assign(n, Item());
+      }
+
+      int size() const {
+        return static_cast<int>(_items.size());
+      }
+
+      // Return the root of the tree containing item v
+      int findRoot(int v) {
+        access(v);
+        int r = v;
+        while (_items[r].child[0] >= 0) {
+          push(r);
+          r = _items[r].child[0];
+        }
+        splay(r);
+        return r;
+      }
+
+      // Return the cost of item v (i.e. of the edge to its parent)
+      V cost(int v) {
+        access(v);
+        return _items[v].cost;
+      }
+
+      // Make root item v a child of item w with the given cost (v and w
+      // must be in different trees)
+      void link(int v, int w, V c) {
+        access(v);
+        Item &it = _items[v];
+        it.cost = c;
+        update(v);
+        it.parent = w;
+      }
+
+      // Make item v the root of a new tree by removing the edge to its
+      // parent, and return the cost of the removed edge
+      V cut(int v) {
+        access(v);
+        Item &it = _items[v];
+        int l = it.child[0];
+        if (l >= 0) {
+          _items[l].parent = -1;
+          it.child[0] = -1;
+          update(v);
+        }
+        return it.cost;
+      }
+
+      // Return an item of minimum cost on the path from item v to its
+      // root (-1 if v is a root)
+      int findMin(int v) {
+        int t = pathTree(v);
+        if (t < 0) return -1;
+        V m = _items[t].min;
+        while (true) {
+          push(t);
+          int l = _items[t].child[0];
+          if (l >= 0 && !(m < _items[l].min)) {
+            t = l;
+          } else if (!(m < _items[t].cost)) {
+            break;
+          } else {
+            t = _items[t].child[1];
+          }
+        }
+        splay(t);
+        return t;
+      }
+
+      // Add d to the cost of each item on the path from item v to its
+      // root
+      void addCost(int v, V d) {
+        int t = pathTree(v);
+        if (t >= 0) apply(t, d);
+      }
+
+    private:
+
+      struct Item {
+        int parent, child[2];
+        V cost, min, delta;
+        Item() : parent(-1), cost(), min(), delta() {
+          child[0] = child[1] = -1;
+        }
+      };
+
+      std::vector<Item> _items;
+      std::vector<int> _stack;
+
+      // The parent pointer of the root of a splay tree is the path-parent
+      // pointer of the represented path
+      bool isSplayRoot(int v) const {
+        int p = _items[v].parent;
+        return p < 0 ||
+          (_items[p].child[0] != v && _items[p].child[1] != v);
+      }
+
+      void apply(int v, V d) {
+        Item &it = _items[v];
+        it.cost += d;
+        it.min += d;
+        it.delta += d;
+      }
+
+      void push(int v) {
+        Item &it = _items[v];
+        if (it.delta != V()) {
+          if (it.child[0] >= 0) apply(it.child[0], it.delta);
+          if (it.child[1] >= 0) apply(it.child[1], it.delta);
+          it.delta = V();
+        }
+      }
+
+      void update(int v) {
+        Item &it = _items[v];
+        it.min = it.cost;
+        for (int i = 0; i != 2; ++i) {
+          int c = it.child[i];
+          if (c >= 0 && _items[c].min < it.min) it.min = _items[c].min;
+        }
+      }
+
+      void rotate(int v) {
+        int p = _items[v].parent, g = _items[p].parent;
+        int d = _items[p].child[1] == v ? 1 : 0;
+        int c = _items[v].child[1 - d];
+        if (!isSplayRoot(p)) {
+          _items[g].child[_items[g].child[1] == p ? 1 : 0] = v;
+        }
+        _items[v].parent = g;
+        _items[v].child[1 - d] = p;
+        _items[p].parent = v;
+        _items[p].child[d] = c;
+        if (c >= 0) _items[c].parent = p;
+        update(p);
+        update(v);
+      }
+
+      void splay(int v) {
+        _stack.clear();
+        for (int u = v; ; u = _items[u].parent) {
+          _stack.push_back(u);
+          if (isSplayRoot(u)) break;
+        }
+        for (int i = static_cast<int>(_stack.size()) - 1; i >= 0; --i) {
+          push(_stack[i]);
+        }
+        while (!isSplayRoot(v)) {
+          int p = _items[v].parent;
+          if (!isSplayRoot(p)) {
+            int g = _items[p].parent;
+            bool zigzig = (_items[g].child[1] == p) ==
+              (_items[p].child[1] == v);
+            rotate(zigzig ? p : v);
+          }
+          rotate(v);
+        }
+      }
+
+      // Make the path from v to its root preferred, with v being the
+      // root of its splay tree and having no deeper items on the path
+      void access(int v) {
+        int last = -1;
+        for (int u = v; u >= 0; u = _items[u].parent) {
+          splay(u);
+          _items[u].child[1] = last;
+          update(u);
+          last = u;
+        }
+        splay(v);
+      }
+
+      // Return the root of a splay tree that contains exactly the path
+      // from v to its root, excluding the root (-1 if v is a root)
+      int pathTree(int v) {
+        // The root is the leftmost item of the path and findRoot()
+        // splays it, so the other items are in its right subtree
+        return _items[findRoot(v)].child[1];
+      }
+    };
+
+  } //namespace bits
+} //namespace lemon
+
+#endif
@@ -0,0 +1,123 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BITS_THREAD_POOL_H
+#define LEMON_BITS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lemon {
+  namespace bits {
+
+    // Return the number of hardware threads (at least one)
+    inline int hardwareThreadNum() {
+      int num = static_cast<int>(std::thread::hardware_concurrency());
+      return num > 0 ? num : 1;
+    }
+
+    // Fixed size pool of worker threads. The run() function executes
+    // the given task on all threads (the calling thread is used as the
+    // thread with index 0) and waits for them to finish.
+    class ThreadPool {
+    public:
+
+      explicit ThreadPool(int num = 0)
+        : _num(num > 0 ? num : hardwareThreadNum()),
+          _generation(0), _pending(0), _stop(false)
+      {
+        for (int i = 1; i < _num; ++i) {
+          _threads.push_back(std::thread(&ThreadPool::work, this, i));
+        }
+      }
+
+      ~ThreadPool() {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _stop = true;
+        }
+        _start_cv.notify_all();
+        for (int i = 0; i != int(_threads.size()); ++i) {
+          _threads[i].join();
+        }
+      }
+
+      int size() const { return _num; }
+
+      template <typename Task>
+      void run(const Task &task) {
+        if (_num == 1) {
+          task(0);
+          return;
+        }
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _task = task;
+          _pending = _num - 1;
+          ++_generation;
+        }
+        _start_cv.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_pending > 0) _finish_cv.wait(lock);
+      }
+
+    private:
+
+      ThreadPool(const ThreadPool&);
+      ThreadPool& operator=(const ThreadPool&);
+
+      void work(int id) {
+        long generation = 0;
+        while (true) {
+          std::function<void(int)> task;
+          {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stop && _generation == generation) {
+              _start_cv.wait(lock);
+            }
+            if (_stop) return;
+            generation = _generation;
+            task = _task;
+          }
+          task(id);
+          {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pending == 0) _finish_cv.notify_one();
+          }
+        }
+      }
+
+      int _num;
+      std::vector<std::thread> _threads;
+      std::function<void(int)> _task;
+      long _generation;
+      int _pending;
+      bool _stop;
+      std::mutex _mutex;
+      std::condition_variable _start_cv;
+      std::condition_variable _finish_cv;
+    };
+
+  }
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include <limits>
 #include <lemon/core.h>
 #include <lemon/bin_heap.h>
+#include <lemon/bits/convex_cost.h>
 
 namespace lemon {
 
@@ -82,6 +83,10 @@ namespace lemon {
   /// executed using the \ref run() function. If some parameters are not
   /// specified, then default values will be used.
   ///
+  /// Besides linear arc costs, convex piecewise-linear cost functions
+  /// are also supported (see \ref convexCost()). They are handled
+  /// directly in the residual network, without expanding the arcs.
+  ///
   /// \tparam GR The digraph type the algorithm runs on.
   /// \tparam V The number type used for flow amounts, capacity bounds
   /// and supply values in the algorithm. By default, it is \c int.
@@ -188,10 +193,17 @@ namespace lemon {
     IntVector _excess_nodes;
     IntVector _deficit_nodes;
 
+    // Convex piecewise-linear arc costs
+    bits::ConvexCosts<Value, Cost> _convex;
+
     Value _delta;
     int _factor;
     IntVector _pred;
 
+    // Breakpoints of the cost curve
+    ValueVector _curve_flow;
+    CostVector _curve_cost;
+
   public:
 
     /// \brief Constant for infinite upper bounds (capacities).
@@ -400,6 +412,44 @@ namespace lemon {
         _cost[_arc_idf[a]] =  map[a];
         _cost[_arc_idb[a]] = -map[a];
       }
+      _convex.clear();
+      return *this;
+    }
+
+    /// \brief Set a convex piecewise-linear cost function on an arc.
+    ///
+    /// This function sets a convex piecewise-linear cost function on
+    /// the given arc instead of its linear cost. The function consists
+    /// of \e k pieces, which are given by \e k slopes
+    /// \f$s_0\le s_1\le\ldots\le s_{k-1}\f$ and \e k-1 breakpoints
+    /// \f$b_1<b_2<\ldots<b_{k-1}\f$ (flow values). The cost of a unit
+    /// of flow is \f$s_i\f$ between \f$b_i\f$ and \f$b_{i+1}\f$
+    /// (where \f$b_0=-\infty\f$ and \f$b_k=\infty\f$), and the cost of
+    /// zero flow is zero. Breakpoints outside the bounds of the arc are
+    /// allowed.
+    ///
+    /// The pieces are handled directly in the residual network (only
+    /// the current piece of the arc is stored in each direction), so
+    /// the number of arcs is not increased.
+    /// The cost functions are kept until \ref costMap(),
+    /// \ref resetParams() or \ref reset() is called.
+    /// The linear cost of the arc is replaced by the slopes of the
+    /// pieces during \ref run().
+    ///
+    /// \param a The arc.
+    /// \param bp_first, bp_last The range of the breakpoints.
+    /// \param slope_first The beginning of the range of the slopes,
+    /// which must contain one more value than the range of breakpoints.
+    ///
+    /// \pre The breakpoints must be increasing and the slopes must be
+    /// non-decreasing (i.e. the function must be convex).
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename BreakpointIt, typename SlopeIt>
+    CapacityScaling& convexCost(const Arc& a, BreakpointIt bp_first,
+                                BreakpointIt bp_last, SlopeIt slope_first) {
+      _convex.set(_res_arc_num, _arc_idf[a], bp_first, bp_last,
+                  slope_first);
       return *this;
     }
 
@@ -497,6 +547,54 @@ namespace lemon {
       return start();
     }
 
+    /// \brief Compute the cost curve of the flows from a source node to
+    /// a target node.
+    ///
+    /// This function computes the minimum cost of sending \e k units
+    /// of flow from node \c s to node \c t as a function of \e k
+    /// (between zero and the maximum flow value or \c max_flow). This
+    /// function is piecewise-linear and convex, and it is obtained
+    /// using the successive shortest path method: the flow is augmented
+    /// along shortest paths, whose costs are the slopes of the curve.
+    /// The breakpoints can be obtained using \ref curvePointNum(),
+    /// \ref curveFlow() and \ref curveCost(), while the other query
+    /// functions provide the solution at the last breakpoint.
+    ///
+    /// The lower and upper bounds and the costs given before are used,
+    /// while the supply values are overwritten with zero (like
+    /// \ref stSupply() with \c k = 0).
+    ///
+    /// \param s The source node.
+    /// \param t The target node.
+    /// \param max_flow The largest flow value to consider. By default,
+    /// the curve is computed up to the maximum flow value.
+    ///
+    /// \return \c INFEASIBLE if no feasible flow of zero value exists,
+    /// \n \c OPTIMAL if the cost curve has been computed,
+    /// \n \c UNBOUNDED if the digraph contains an arc of negative cost
+    /// and infinite upper bound, or if \c max_flow is not given and the
+    /// flow value is unbounded (i.e. there is an \c s-\c t path of
+    /// infinite capacity). In the latter case, the breakpoints found
+    /// before reaching the unbounded path are kept.
+    ///
+    /// \see run()
+    ProblemType runCostCurve(const Node& s, const Node& t,
+      Value max_flow = std::numeric_limits<Value>::max())
+    {
+      _curve_flow.clear();
+      _curve_cost.clear();
+      stSupply(s, t, 0);
+      _factor = 1;
+      ProblemType pt = init();
+      if (pt != OPTIMAL) return pt;
+      pt = startWithoutScaling();
+      if (pt == OPTIMAL) {
+        pt = startCostCurve(_node_id[s], _node_id[t], max_flow);
+      }
+      finish();
+      return pt;
+    }
+
     /// \brief Reset all the parameters that have been given before.
     ///
     /// This function resets all the paramaters that have been given
@@ -542,6 +640,7 @@ namespace lemon {
         _upper[j] = INF;
         _cost[j] = _forward[j] ? 1 : -1;
       }
+      _convex.clear();
       _has_lower = false;
       return *this;
     }
@@ -662,8 +761,13 @@ namespace lemon {
       Number c = 0;
       for (ArcIt a(_graph); a != INVALID; ++a) {
         int i = _arc_idb[a];
-        c += static_cast<Number>(_res_cap[i]) *
-             (-static_cast<Number>(_cost[i]));
+        int k = _convex.empty() ? -1 : _convex.id(_arc_idf[a]);
+        if (k >= 0) {
+          c += _convex.template cost<Number>(k);
+        } else {
+          c += static_cast<Number>(_res_cap[i]) *
+               (-static_cast<Number>(_cost[i]));
+        }
       }
       return c;
     }
@@ -724,6 +828,40 @@ namespace lemon {
       }
     }
 
+    /// \brief Return the number of breakpoints of the cost curve.
+    ///
+    /// This function returns the number of breakpoints of the cost
+    /// curve (including its endpoints).
+    ///
+    /// \pre \ref runCostCurve() must be called before using this
+    /// function.
+    int curvePointNum() const {
+      return _curve_flow.size();
+    }
+
+    /// \brief Return the flow value of a breakpoint of the cost curve.
+    ///
+    /// This function returns the flow value of the given breakpoint of
+    /// the cost curve. The breakpoints are ordered by increasing flow
+    /// values, the first one is always zero.
+    ///
+    /// \pre \ref runCostCurve() must be called before using this
+    /// function.
+    Value curveFlow(int i) const {
+      return _curve_flow[i];
+    }
+
+    /// \brief Return the cost of a breakpoint of the cost curve.
+    ///
+    /// This function returns the minimum cost of a flow having the
+    /// value of the given breakpoint of the cost curve.
+    ///
+    /// \pre \ref runCostCurve() must be called before using this
+    /// function.
+    Cost curveCost(int i) const {
+      return _curve_cost[i];
+    }
+
     /// @}
 
   private:
@@ -777,6 +915,25 @@ namespace lemon {
         }
       }
 
+      // Move the flow of convex cost arcs to their minimum cost point
+      if (!_convex.empty()) {
+        for (int i = 0; i != _root; ++i) {
+          last_out = _first_out[i+1] - 1;
+          for (int j = _first_out[i]; j != last_out; ++j) {
+            int k = _convex.id(j);
+            if (k < 0) continue;
+            Value l = _lower[j], x;
+            bool inf_upper = _upper[j] >= MAX;
+            if (!_convex.minFlow(k, l, _upper[j], inf_upper, x)) {
+              return UNBOUNDED;
+            }
+            _excess[i] -= x - l;
+            _excess[_target[j]] += x - l;
+            _convex.init(k, l, _upper[j], inf_upper, x);
+          }
+        }
+      }
+
       // Handle negative costs
       for (int i = 0; i != _root; ++i) {
         last_out = _first_out[i+1] - 1;
@@ -792,6 +949,30 @@ namespace lemon {
         }
       }
 
+      // Set the current pieces of convex cost arcs. Infinite upper
+      // bounds are replaced by the flow at the minimum cost point plus
+      // the total excess if scaling is used, since the scaling phases
+      // may saturate a piece of infinite capacity hidden behind a
+      // smaller one.
+      if (!_convex.empty()) {
+        Value sum_excess = 0;
+        for (int i = 0; i != _root; ++i) {
+          if (_excess[i] > 0) sum_excess += _excess[i];
+        }
+        for (int i = 0; i != _root; ++i) {
+          last_out = _first_out[i+1] - 1;
+          for (int j = _first_out[i]; j != last_out; ++j) {
+            int k = _convex.id(j);
+            if (k < 0) continue;
+            Value x = _convex.flow(k);
+            if (_factor > 1 && _upper[j] >= MAX && x < MAX - sum_excess) {
+              _convex.init(k, _lower[j], x + sum_excess, false, x);
+            }
+            updateConvexArc(j, k);
+          }
+        }
+      }
+
       // Handle GEQ supply type
       if (_sum_supply < 0) {
         _pi[_root] = 0;
@@ -838,6 +1019,26 @@ namespace lemon {
       return OPTIMAL;
     }
 
+    // Set the residual capacities and costs of a convex cost arc
+    // according to its current flow (the linear costs of the arc in
+    // _cost are replaced by the slopes of the current pieces)
+    void updateConvexArc(int j, int k) {
+      int rj = _reverse[j];
+      _convex.residual(k, INF, _res_cap[j], _cost[j],
+                       _res_cap[rj], _cost[rj]);
+    }
+
+    // Update a convex cost arc after pushing d units of flow on the
+    // residual arc a (return false if it is a linear cost arc)
+    bool pushConvexArc(int a, Value d) {
+      int j = _forward[a] ? a : _reverse[a];
+      int k = _convex.id(j);
+      if (k < 0) return false;
+      _convex.move(k, _forward[a] ? d : -d);
+      updateConvexArc(j, k);
+      return true;
+    }
+
     // Check if the upper bound is greater than or equal to the lower bound
     // on each forward arc.
     bool checkBoundMaps() {
@@ -854,6 +1055,20 @@ namespace lemon {
         pt = startWithScaling();
       else
         pt = startWithoutScaling();
+      finish();
+      return pt;
+    }
+
+    // Transform the results
+    void finish() {
+      // Set the flow of convex cost arcs
+      if (!_convex.empty()) {
+        int limit = _first_out[_root];
+        for (int j = 0; j != limit; ++j) {
+          int k = _forward[j] ? _convex.id(j) : -1;
+          if (k >= 0) _res_cap[_reverse[j]] = _convex.flow(k) - _lower[j];
+        }
+      }
 
       // Handle non-zero lower bounds
       if (_has_lower) {
@@ -870,8 +1085,6 @@ namespace lemon {
           _pi[i] -= pr;
         }
       }
-
-      return pt;
     }
 
     // Execute the capacity scaling algorithm
@@ -889,11 +1102,15 @@ namespace lemon {
             int v = _target[a];
             Cost c = _cost[a] + _pi[u] - _pi[v];
             Value rc = _res_cap[a];
-            if (c < 0 && rc >= _delta) {
+            while (c < 0 && rc >= _delta) {
               _excess[u] -= rc;
               _excess[v] += rc;
               _res_cap[a] = 0;
               _res_cap[_reverse[a]] += rc;
+              // The next piece of a convex cost arc is also checked
+              if (_convex.empty() || !pushConvexArc(a, rc)) break;
+              c = _cost[a] + _pi[u] - _pi[v];
+              rc = _res_cap[a];
             }
           }
         }
@@ -947,6 +1164,7 @@ namespace lemon {
           while ((a = _pred[u]) != -1) {
             _res_cap[a] -= d;
             _res_cap[_reverse[a]] += d;
+            if (!_convex.empty()) pushConvexArc(a, d);
             u = _source[a];
           }
           _excess[s] -= d;
@@ -996,6 +1214,7 @@ namespace lemon {
         while ((a = _pred[u]) != -1) {
           _res_cap[a] -= d;
           _res_cap[_reverse[a]] += d;
+          if (!_convex.empty()) pushConvexArc(a, d);
           u = _source[a];
         }
         _excess[s] -= d;
@@ -1005,6 +1224,77 @@ namespace lemon {
       return OPTIMAL;
     }
 
+    // Compute the cost curve of s-t flows starting from an optimal
+    // flow of zero value using the successive shortest path method
+    ProblemType startCostCurve(int s, int t, Value max_flow) {
+      const Value MAX = std::numeric_limits<Value>::max();
+      bool bounded = max_flow < MAX;
+
+      // Cost of the current flow
+      Cost c = 0;
+      int limit = _first_out[_root];
+      for (int j = 0; j != limit; ++j) {
+        if (!_forward[j]) continue;
+        int k = _convex.empty() ? -1 : _convex.id(j);
+        if (k >= 0) {
+          c += _convex.template cost<Cost>(k);
+        } else {
+          c += (_res_cap[_reverse[j]] + _lower[j]) * _cost[j];
+        }
+      }
+      _curve_flow.push_back(0);
+      _curve_cost.push_back(c);
+      if (s == t) return OPTIMAL;
+
+      // Augment along shortest paths
+      ResidualDijkstra dijkstra(*this);
+      ProblemType pt = OPTIMAL;
+      Value f = 0;
+      Cost last_slope = 0;
+      while (!bounded || f < max_flow) {
+        Value rem = bounded ? max_flow - f : INF;
+        _excess[s] = rem;
+        _excess[t] = -rem;
+        if (dijkstra.run(s) == -1) break;
+
+        Value d = rem;
+        Cost slope = 0;
+        int u = t, a;
+        while ((a = _pred[u]) != -1) {
+          if (_res_cap[a] < d) d = _res_cap[a];
+          slope += _cost[a];
+          u = _source[a];
+        }
+        if (d >= INF) {
+          pt = UNBOUNDED;
+          break;
+        }
+        u = t;
+        while ((a = _pred[u]) != -1) {
+          _res_cap[a] -= d;
+          _res_cap[_reverse[a]] += d;
+          if (!_convex.empty()) pushConvexArc(a, d);
+          u = _source[a];
+        }
+        f += d;
+        c += slope * d;
+
+        // Merge the segments of equal slopes
+        if (_curve_flow.size() > 1 && slope == last_slope) {
+          _curve_flow.back() = f;
+          _curve_cost.back() = c;
+        } else {
+          _curve_flow.push_back(f);
+          _curve_cost.push_back(c);
+        }
+        last_slope = slope;
+      }
+      _excess[s] = 0;
+      _excess[t] = 0;
+
+      return pt;
+    }
+
   }; //class CapacityScaling
 
   ///@}
@@ -0,0 +1,428 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_COST_ROUNDING_H
+#define LEMON_COST_ROUNDING_H
+
+/// \ingroup min_cost_flow_algs
+///
+/// \file
+/// \brief Solving minimum cost flow problems with real-valued costs
+/// using integer algorithms.
+
+#include <cmath>
+#include <limits>
+#include <lemon/core.h>
+
+namespace lemon {
+
+  /// \addtogroup min_cost_flow_algs
+  /// @{
+
+  /// \brief Solving minimum cost flow problems with real-valued costs
+  /// using integer algorithms.
+  ///
+  /// \ref CostRounding solves minimum cost flow problems with
+  /// real-valued arc costs using one of the minimum cost flow algorithms
+  /// that are designed for integer costs (e.g. \ref CostScaling or
+  /// \ref NetworkSimplex with an integer \c Cost type).
+  ///
+  /// The arc costs are multiplied by a power of two and rounded to
+  /// integers. The smallest scaling factor is chosen for which the
+  /// rounding error of each arc cost (i.e. the difference of the
+  /// original cost and the rounded cost divided by the factor) is
+  /// within the given \ref tolerance() "tolerance". The scaled costs
+  /// are bounded by \ref maxScaledCost(), thus the tolerance cannot be
+  /// met if the costs span too many orders of magnitude. In this case,
+  /// the largest allowed factor is used and the actual error can be
+  /// obtained using \ref roundingError().
+  ///
+  /// The integer algorithm finds an optimal flow with respect to the
+  /// rounded costs, which is also optimal for the original costs up to
+  /// \ref roundingError() times the total amount of flow on the arcs
+  /// of the found and of an optimal flow. The total cost of the flow is
+  /// computed using the original costs.
+  ///
+  /// \tparam GR The digraph type the algorithm runs on.
+  /// \tparam MCF The type of the minimum cost flow algorithm used for
+  /// the rounded costs. Its \c Cost type must be an integer type.
+  /// \tparam C The number type of the original arc costs.
+  /// By default, it is \c double.
+#ifdef DOXYGEN
+  template <typename GR, typename MCF, typename C>
+#else
+  template <typename GR, typename MCF, typename C = double>
+#endif
+  class CostRounding
+  {
+  public:
+
+    /// The type of the digraph
+    typedef GR Digraph;
+    /// The type of the underlying minimum cost flow algorithm
+    typedef MCF Algorithm;
+    /// The type of the flow amounts, capacity bounds and supply values
+    typedef typename MCF::Value Value;
+    /// The type of the original arc costs
+    typedef C Cost;
+    /// The type of the rounded arc costs
+    typedef typename MCF::Cost IntCost;
+    /// The problem type constants of the underlying algorithm
+    typedef typename MCF::ProblemType ProblemType;
+
+  private:
+
+    TEMPLATE_DIGRAPH_TYPEDEFS(GR);
+
+    const GR &_graph;
+    MCF _mcf;
+    typename GR::template ArcMap<Cost> _cost;
+    typename GR::template ArcMap<IntCost> _int_cost;
+
+    double _tolerance;
+    double _max_scaled_cost;
+    double _scale;
+    double _error;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param graph The digraph the algorithm runs on.
+    CostRounding(const GR& graph) :
+      _graph(graph), _mcf(graph), _cost(graph, 0), _int_cost(graph, 0),
+      _tolerance(1e-9), _scale(1), _error(0)
+    {
+      LEMON_ASSERT(std::numeric_limits<IntCost>::is_integer,
+        "The cost type of the underlying algorithm must be integer");
+
+      // The scaled costs leave room for the internal cost multiplication
+      // of the algorithms (e.g. CostScaling) and for the node potentials
+      _max_scaled_cost =
+        std::ldexp(1.0, std::numeric_limits<IntCost>::digits - 1) /
+        (1024.0 * (countNodes(_graph) + 1));
+    }
+
+    /// \name Parameters
+    /// The parameters of the algorithm can be specified using these
+    /// functions.
+
+    /// @{
+
+    /// \brief Set the lower bounds on the arcs.
+    ///
+    /// This function sets the lower bounds on the arcs
+    /// (see \ref CostScaling::lowerMap()).
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename LowerMap>
+    CostRounding& lowerMap(const LowerMap& map) {
+      _mcf.lowerMap(map);
+      return *this;
+    }
+
+    /// \brief Set the upper bounds (capacities) on the arcs.
+    ///
+    /// This function sets the upper bounds (capacities) on the arcs
+    /// (see \ref CostScaling::upperMap()).
+    ///
+    /// \return <tt>(*this)</tt>
+    template<typename UpperMap>
+    CostRounding& upperMap(const UpperMap& map) {
+      _mcf.upperMap(map);
+      return *this;
+    }
+
+    /// \brief Set the costs of the arcs.
+    ///
+    /// This function sets the (real-valued) costs of the arcs.
+    /// If it is not used before calling \ref run(), the costs
+    /// will be set to \c 0 on all arcs.
+    ///
+    /// \param map An arc map storing the costs.
+    /// Its \c Value type must be convertible to the \c Cost type
+    /// of the algorithm.
+    ///
+    /// \return <tt>(*this)</tt>
+    template<typename CostMap>
+    CostRounding& costMap(const CostMap& map) {
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        _cost[a] = map[a];
+      }
+      return *this;
+    }
+
+    /// \brief Set the supply values of the nodes.
+    ///
+    /// This function sets the supply values of the nodes
+    /// (see \ref CostScaling::supplyMap()).
+    ///
+    /// \return <tt>(*this)</tt>
+    template<typename SupplyMap>
+    CostRounding& supplyMap(const SupplyMap& map) {
+      _mcf.supplyMap(map);
+      return *this;
+    }
+
+    /// \brief Set single source and target nodes and a supply value.
+    ///
+    /// This function sets a single source node and a single target node
+    /// and the required flow value
+    /// (see \ref CostScaling::stSupply()).
+    ///
+    /// \return <tt>(*this)</tt>
+    CostRounding& stSupply(const Node& s, const Node& t, Value k) {
+      _mcf.stSupply(s, t, k);
+      return *this;
+    }
+
+    /// \brief Set the tolerance of the cost rounding.
+    ///
+    /// This function sets the maximum allowed rounding error of the
+    /// arc costs. The default value is \c 1e-9.
+    /// If the costs are integers and the tolerance is less than
+    /// \c 0.5, they are not scaled at all.
+    ///
+    /// \return <tt>(*this)</tt>
+    CostRounding& tolerance(double tol) {
+      _tolerance = tol;
+      return *this;
+    }
+
+    /// \brief Set the upper bound on the scaled costs.
+    ///
+    /// This function sets an upper bound on the absolute values of the
+    /// scaled costs. By default, it is
+    /// \f$2^{d-1}/(1024(n+1))\f$, where \f$d\f$ is the number of binary
+    /// digits of the \c IntCost type.
+    ///
+    /// \return <tt>(*this)</tt>
+    CostRounding& maxScaledCost(double bound) {
+      _max_scaled_cost = bound;
+      return *this;
+    }
+
+    /// @}
+
+    /// \name Execution control
+
+    /// @{
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function scales and rounds the arc costs, and runs the
+    /// underlying algorithm. The given parameters (if any) are passed
+    /// to its \c run() function (e.g. the internal method of
+    /// \ref CostScaling or the pivot rule of \ref NetworkSimplex).
+    ///
+    /// \return The result of the underlying algorithm.
+    ProblemType run() {
+      roundCosts();
+      return _mcf.run();
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This is an overloaded version of \ref run().
+    template <typename P1>
+    ProblemType run(P1 p1) {
+      roundCosts();
+      return _mcf.run(p1);
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This is an overloaded version of \ref run().
+    template <typename P1, typename P2>
+    ProblemType run(P1 p1, P2 p2) {
+      roundCosts();
+      return _mcf.run(p1, p2);
+    }
+
+    /// @}
+
+    /// \name Query Functions
+    /// The results of the algorithm can be obtained using these
+    /// functions.\n
+    /// The \ref run() function must be called before using them.
+
+    /// @{
+
+    /// \brief Return the total cost of the found flow.
+    ///
+    /// This function returns the total cost of the found flow with
+    /// respect to the original (not rounded) arc costs.
+    /// Its complexity is O(m).
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename Number>
+    Number totalCost() const {
+      Number c = 0;
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        c += static_cast<Number>(_mcf.flow(a)) *
+             static_cast<Number>(_cost[a]);
+      }
+      return c;
+    }
+
+#ifndef DOXYGEN
+    Cost totalCost() const {
+      return totalCost<Cost>();
+    }
+#endif
+
+    /// \brief Return the flow on the given arc.
+    ///
+    /// This function returns the flow on the given arc.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Value flow(const Arc& a) const {
+      return _mcf.flow(a);
+    }
+
+    /// \brief Copy the flow values (the primal solution) into the
+    /// given map.
+    ///
+    /// This function copies the flow value on each arc into the given
+    /// map.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename FlowMap>
+    void flowMap(FlowMap &map) const {
+      _mcf.flowMap(map);
+    }
+
+    /// \brief Return the potential (dual value) of the given node.
+    ///
+    /// This function returns the potential of the given node with
+    /// respect to the original costs (i.e. the potential found by the
+    /// underlying algorithm divided by the scaling factor).
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Cost potential(const Node& n) const {
+      return static_cast<Cost>(_mcf.potential(n)) / static_cast<Cost>(_scale);
+    }
+
+    /// \brief Copy the potential values (the dual solution) into the
+    /// given map.
+    ///
+    /// This function copies the potential (dual value) of each node
+    /// with respect to the original costs into the given map.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename PotentialMap>
+    void potentialMap(PotentialMap &map) const {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        map.set(n, potential(n));
+      }
+    }
+
+    /// \brief Return the scaling factor of the costs.
+    ///
+    /// This function returns the factor (a power of two) by which the
+    /// arc costs were multiplied before rounding.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    double scale() const {
+      return _scale;
+    }
+
+    /// \brief Return the maximum rounding error of the costs.
+    ///
+    /// This function returns the maximum difference of an original arc
+    /// cost and the corresponding rounded cost divided by the scaling
+    /// factor.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    double roundingError() const {
+      return _error;
+    }
+
+    /// \brief Return a const reference to the underlying algorithm.
+    ///
+    /// This function returns a const reference to the underlying
+    /// minimum cost flow algorithm, which uses the rounded costs.
+    const MCF& algorithm() const {
+      return _mcf;
+    }
+
+    /// \brief Return a reference to the underlying algorithm.
+    ///
+    /// This function returns a reference to the underlying minimum
+    /// cost flow algorithm, which can be used for setting its other
+    /// parameters.
+    MCF& algorithm() {
+      return _mcf;
+    }
+
+    /// @}
+
+  private:
+
+    // Rounding error of the given cost with scaling factor 2^k
+    static double error(double c, int k) {
+      double x = std::ldexp(c, k);
+      return std::fabs(std::floor(x + 0.5) - x) / std::ldexp(1.0, k);
+    }
+
+    // Choose the scaling factor and compute the rounded costs
+    void roundCosts() {
+      double max_cost = 0;
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        double c = std::fabs(static_cast<double>(_cost[a]));
+        if (c > max_cost) max_cost = c;
+      }
+
+      // The largest allowed exponent of the scaling factor
+      int k_max = 0;
+      if (max_cost > 0) {
+        int e, f;
+        std::frexp(max_cost, &e);
+        std::frexp(_max_scaled_cost, &f);
+        k_max = f - 1 - e;
+      }
+
+      // The error is non-increasing in the exponent, since the multiples
+      // of 2^-k are also multiples of 2^-(k+1)
+      int k = k_max < 0 ? k_max : 0;
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        double c = static_cast<double>(_cost[a]);
+        while (k < k_max && error(c, k) > _tolerance) ++k;
+      }
+      _scale = std::ldexp(1.0, k);
+
+      _error = 0;
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        double c = static_cast<double>(_cost[a]);
+        double r = std::floor(std::ldexp(c, k) + 0.5);
+        _int_cost[a] = static_cast<IntCost>(r);
+        double err = std::fabs(r / _scale - c);
+        if (err > _error) _error = err;
+      }
+      _mcf.costMap(_int_cost);
+    }
+
+  }; //class CostRounding
+
+  ///@}
+
+} //namespace lemon
+
+#endif //LEMON_COST_ROUNDING_H
@@ -25,7 +25,10 @@
 
 #include <vector>
 #include <deque>
+#include <map>
 #include <limits>
+#include <atomic>
+#include <type_traits>
 
 #include <lemon/core.h>
 #include <lemon/maps.h>
@@ -33,6 +36,9 @@
 #include <lemon/static_graph.h>
 #include <lemon/circulation.h>
 #include <lemon/bellman_ford.h>
+#include <lemon/bin_heap.h>
+#include <lemon/bits/thread_pool.h>
+#include <lemon/bits/convex_cost.h>
 
 namespace lemon {
 
@@ -109,6 +115,10 @@ namespace lemon {
   /// executed using the \ref run() function. If some parameters are not
   /// specified, then default values will be used.
   ///
+  /// Besides linear arc costs, convex piecewise-linear cost functions
+  /// are also supported (see \ref convexCost()). They are handled
+  /// directly in the residual network, without expanding the arcs.
+  ///
   /// \tparam GR The digraph type the algorithm runs on.
   /// \tparam V The number type used for flow amounts, capacity bounds
   /// and supply values in the algorithm. By default, it is \c int.
@@ -126,7 +136,7 @@ namespace lemon {
   /// \warning This algorithm does not support negative costs for
   /// arcs having infinite upper bound.
   ///
-  /// \note %CostScaling provides three different internal methods,
+  /// \note %CostScaling provides five different internal methods,
   /// from which the most efficient one is used by default.
   /// For more information, see \ref Method.
 #ifdef DOXYGEN
@@ -175,7 +185,12 @@ namespace lemon {
       /// on that arc, however, note that it could actually be bounded
       /// over the feasible flows, but this algroithm cannot handle
       /// these cases.
-      UNBOUNDED
+      UNBOUNDED,
+      /// The algorithm stopped early, since the optimality gap given by
+      /// \ref optimalityGap() was reached. It has found a feasible flow
+      /// and node potentials that certify its suboptimality
+      /// (see \ref dualBound()).
+      FEASIBLE
     };
 
     /// \brief Constants for selecting the internal method.
@@ -183,9 +198,9 @@ namespace lemon {
     /// Enum type containing constants for selecting the internal method
     /// for the \ref run() function.
     ///
-    /// \ref CostScaling provides three internal methods that differ mainly
-    /// in their base operations, which are used in conjunction with the
-    /// relabel operation.
+    /// \ref CostScaling provides five internal methods that differ mainly
+    /// in their base operations and node selection rules, which are used
+    /// in conjunction with the relabel operation.
     /// By default, the so called \ref PARTIAL_AUGMENT
     /// "Partial Augment-Relabel" method is used, which turned out to be
     /// the most efficient and the most robust on various test inputs.
@@ -202,7 +217,25 @@ namespace lemon {
       /// admissible paths started from a node with excess, but the
       /// lengths of these paths are limited. This method can be viewed
       /// as a combined version of the previous two operations.
-      PARTIAL_AUGMENT
+      PARTIAL_AUGMENT,
+      /// Local push operations are used, but the active nodes are
+      /// processed in a topological order of the admissible network
+      /// (wave implementation). A relabeled node is moved to the front
+      /// of the order, thus most of the excess is moved forward in a
+      /// single pass over the nodes.
+      WAVE,
+      /// Local push operations are used, and the active nodes are
+      /// processed concurrently by several threads (see
+      /// \ref threadNum()) in synchronous rounds. In each round, the
+      /// active nodes push their excess with respect to the potentials
+      /// of the previous round, then the ones that still have excess are
+      /// relabeled. The pushes require no locks, only atomic additions
+      /// to the excesses of the target nodes. The global update
+      /// heuristic is also performed in parallel. The rounds with few
+      /// active nodes, and all rounds if one thread is used or there are
+      /// convex costs (see \ref convexCost()), are processed by one
+      /// thread that discharges the nodes like \ref PUSH.
+      PARALLEL_PUSH
     };
 
   private:
@@ -217,6 +250,13 @@ namespace lemon {
     // Note: vector<char> is used instead of vector<bool>
     // for efficiency reasons
 
+    // The type of the excesses added concurrently in the PARALLEL_PUSH
+    // method. Since the data are integer, floating-point values are
+    // added as double (std::atomic<long double> is not lock-free).
+    typedef typename std::conditional<std::numeric_limits<Value>::is_integer,
+      Value, double>::type AddedValue;
+    typedef std::vector<std::atomic<AddedValue> > AddedValueVector;
+
   private:
 
     template <typename KT, typename VT>
@@ -283,9 +323,17 @@ namespace lemon {
     IntVector _next_out;
     std::deque<int> _active_nodes;
 
+    // Convex piecewise-linear arc costs
+    bits::ConvexCosts<Value, Cost> _convex;
+
     // Data for scaling
     LargeCost _epsilon;
     int _alpha;
+    int _thread_num;
+    double _abs_gap;
+    double _rel_gap;
+    bool _gap_reached;
+    long double _gap;
 
     IntVector _buckets;
     IntVector _bucket_next;
@@ -339,6 +387,8 @@ namespace lemon {
     /// \param graph The digraph the algorithm runs on.
     CostScaling(const GR& graph) :
       _graph(graph), _node_id(graph), _arc_idf(graph), _arc_idb(graph),
+      _thread_num(0), _abs_gap(0), _rel_gap(0),
+      _gap_reached(false), _gap(0),
       INF(std::numeric_limits<Value>::has_infinity ?
           std::numeric_limits<Value>::infinity() :
           std::numeric_limits<Value>::max())
@@ -416,6 +466,44 @@ namespace lemon {
         _scost[_arc_idf[a]] =  map[a];
         _scost[_arc_idb[a]] = -map[a];
       }
+      _convex.clear();
+      return *this;
+    }
+
+    /// \brief Set a convex piecewise-linear cost function on an arc.
+    ///
+    /// This function sets a convex piecewise-linear cost function on
+    /// the given arc instead of its linear cost. The function consists
+    /// of \e k pieces, which are given by \e k slopes
+    /// \f$s_0\le s_1\le\ldots\le s_{k-1}\f$ and \e k-1 breakpoints
+    /// \f$b_1<b_2<\ldots<b_{k-1}\f$ (flow values). The cost of a unit
+    /// of flow is \f$s_i\f$ between \f$b_i\f$ and \f$b_{i+1}\f$
+    /// (where \f$b_0=-\infty\f$ and \f$b_k=\infty\f$), and the cost of
+    /// zero flow is zero. Breakpoints outside the bounds of the arc are
+    /// allowed.
+    ///
+    /// The pieces are handled directly in the residual network (only
+    /// the current piece of the arc is stored in each direction), so
+    /// the number of arcs is not increased.
+    /// The cost functions are kept until \ref costMap(),
+    /// \ref resetParams() or \ref reset() is called.
+    /// The linear cost of the arc is replaced by the slopes of the
+    /// pieces during \ref run().
+    ///
+    /// \param a The arc.
+    /// \param bp_first, bp_last The range of the breakpoints.
+    /// \param slope_first The beginning of the range of the slopes,
+    /// which must contain one more value than the range of breakpoints.
+    ///
+    /// \pre The breakpoints must be increasing and the slopes must be
+    /// non-decreasing (i.e. the function must be convex).
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename BreakpointIt, typename SlopeIt>
+    CostScaling& convexCost(const Arc& a, BreakpointIt bp_first,
+                            BreakpointIt bp_last, SlopeIt slope_first) {
+      _convex.set(_res_arc_num, _arc_idf[a], bp_first, bp_last,
+                  slope_first);
       return *this;
     }
 
@@ -464,6 +552,50 @@ namespace lemon {
       return *this;
     }
 
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used by the
+    /// \ref PARALLEL_PUSH method. The other methods are sequential.
+    /// If it is not used before calling \ref run(), or the given value
+    /// is not positive, the number of hardware threads will be used.
+    ///
+    /// \return <tt>(*this)</tt>
+    CostScaling& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
+    /// \brief Set the allowed optimality gap.
+    ///
+    /// This function makes the algorithm stop as soon as the current
+    /// flow is certified to be within the given absolute or relative
+    /// gap from the optimum. The check is performed at the end of each
+    /// scaling phase, when the flow is feasible and epsilon-optimal,
+    /// thus the final (most expensive) phases can be skipped if the
+    /// gap is large enough. In this case, \ref run() returns
+    /// \c FEASIBLE and \ref dualBound() gives a lower bound on the
+    /// optimal cost.
+    ///
+    /// The gap is computed from the reduced costs of the residual arcs
+    /// (i.e. it is the exact Lagrangian duality gap of the current
+    /// flow and potentials), which is at most \f$n\epsilon\f$ times
+    /// the total amount of flow, but usually much smaller.
+    ///
+    /// If this function is not used, or both values are zero, the
+    /// algorithm always finds an optimal solution.
+    ///
+    /// \param abs_gap The allowed absolute gap, i.e. the difference of
+    /// the total cost of the flow and the optimal cost.
+    /// \param rel_gap The allowed relative gap, i.e. the absolute gap
+    /// divided by the absolute value of the total cost of the flow.
+    ///
+    /// \return <tt>(*this)</tt>
+    CostScaling& optimalityGap(double abs_gap, double rel_gap = 0) {
+      _abs_gap = abs_gap;
+      _rel_gap = rel_gap;
+      return *this;
+    }
+
     /// @}
 
     /// \name Execution control
@@ -502,17 +634,21 @@ namespace lemon {
     /// and infinite upper bound. It means that the objective function
     /// is unbounded on that arc, however, note that it could actually be
     /// bounded over the feasible flows, but this algroithm cannot handle
-    /// these cases.
+    /// these cases,
+    /// \n \c FEASIBLE if the algorithm stopped early, since the
+    /// optimality gap given by \ref optimalityGap() was reached.
     ///
     /// \see ProblemType, Method
     /// \see resetParams(), reset()
     ProblemType run(Method method = PARTIAL_AUGMENT, int factor = 16) {
       LEMON_ASSERT(factor >= 2, "The scaling factor must be at least 2");
       _alpha = factor;
+      _gap_reached = false;
+      _gap = 0;
       ProblemType pt = init();
       if (pt != OPTIMAL) return pt;
       start(method);
-      return OPTIMAL;
+      return _gap_reached ? FEASIBLE : OPTIMAL;
     }
 
     /// \brief Reset all the parameters that have been given before.
@@ -567,6 +703,7 @@ namespace lemon {
         _scost[j] = 0;
         _scost[_reverse[j]] = 0;
       }
+      _convex.clear();
       _has_lower = false;
       return *this;
     }
@@ -688,8 +825,13 @@ namespace lemon {
       Number c = 0;
       for (ArcIt a(_graph); a != INVALID; ++a) {
         int i = _arc_idb[a];
-        c += static_cast<Number>(_res_cap[i]) *
-             (-static_cast<Number>(_scost[i]));
+        int k = _convex.empty() ? -1 : _convex.id(_arc_idf[a]);
+        if (k >= 0) {
+          c += _convex.template cost<Number>(k);
+        } else {
+          c += static_cast<Number>(_res_cap[i]) *
+               (-static_cast<Number>(_scost[i]));
+        }
       }
       return c;
     }
@@ -700,6 +842,30 @@ namespace lemon {
     }
 #endif
 
+    /// \brief Return a lower bound on the optimal cost.
+    ///
+    /// This function returns a lower bound on the optimal total cost,
+    /// which is certified by the node potentials of the last scaling
+    /// phase. If \ref run() returned \c OPTIMAL, it is equal to
+    /// \ref totalCost(), otherwise (\c FEASIBLE) the difference of
+    /// the two values is within the gap given by \ref optimalityGap().
+    /// Its complexity is O(m).
+    ///
+    /// \note The return type of the function can be specified as a
+    /// template parameter (see \ref totalCost()).
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename Number>
+    Number dualBound() const {
+      return totalCost<Number>() - static_cast<Number>(_gap);
+    }
+
+#ifndef DOXYGEN
+    Cost dualBound() const {
+      return dualBound<Cost>();
+    }
+#endif
+
     /// \brief Return the flow on the given arc.
     ///
     /// This function returns the flow on the given arc.
@@ -783,7 +949,7 @@ namespace lemon {
         for (int i = 0; i != _root; ++i) {
           last_out = _first_out[i+1];
           for (int j = _first_out[i]; j != last_out; ++j) {
-            if (_forward[j]) {
+            if (_forward[j] && (_convex.empty() || _convex.id(j) < 0)) {
               Value c = _scost[j] < 0 ? _upper[j] : _lower[j];
               if (c >= MAX) return UNBOUNDED;
               _excess[i] -= c;
@@ -795,7 +961,8 @@ namespace lemon {
         for (int i = 0; i != _root; ++i) {
           last_out = _first_out[i+1];
           for (int j = _first_out[i]; j != last_out; ++j) {
-            if (_forward[j] && _scost[j] < 0) {
+            if (_forward[j] && _scost[j] < 0 &&
+                (_convex.empty() || _convex.id(j) < 0)) {
               Value c = _upper[j];
               if (c >= MAX) return UNBOUNDED;
               _excess[i] -= c;
@@ -805,6 +972,25 @@ namespace lemon {
         }
       }
       Value ex, max_cap = 0;
+      if (!_convex.empty()) {
+        // Convex cost arcs are moved to their minimum cost point (the
+        // bound for infinite capacities is increased by these flows)
+        for (int i = 0; i != _root; ++i) {
+          last_out = _first_out[i+1];
+          for (int j = _first_out[i]; j != last_out; ++j) {
+            int k = _convex.id(j);
+            if (k < 0) continue;
+            Value c;
+            if (!_convex.minFlow(k, _lower[j], _upper[j], _upper[j] >= MAX,
+                                 c)) {
+              return UNBOUNDED;
+            }
+            _excess[i] -= c;
+            _excess[_target[j]] += c;
+            max_cap += c < 0 ? -c : c;
+          }
+        }
+      }
       for (int i = 0; i != _res_node_num; ++i) {
         ex = _excess[i];
         _excess[i] = 0;
@@ -825,6 +1011,15 @@ namespace lemon {
           if (lc > _epsilon) _epsilon = lc;
         }
       }
+      if (!_convex.empty()) {
+        for (int j = 0; j != _res_arc_num; ++j) {
+          int k = _forward[j] ? _convex.id(j) : -1;
+          if (k < 0) continue;
+          lc = static_cast<LargeCost>(_convex.maxSlope(k)) *
+               _res_node_num * _alpha;
+          if (lc > _epsilon) _epsilon = lc;
+        }
+      }
       _epsilon /= _alpha;
 
       // Initialize maps for Circulation and remove non-zero lower bounds
@@ -896,6 +1091,17 @@ namespace lemon {
         }
       }
 
+      // Set the current pieces of convex cost arcs
+      if (!_convex.empty()) {
+        for (ArcIt a(_graph); a != INVALID; ++a) {
+          int j = _arc_idf[a];
+          int k = _convex.id(j);
+          if (k < 0) continue;
+          _convex.init(k, _lower[j], _upper[j], false, _lower[j] + flow[a]);
+          updateConvexArc(j, k);
+        }
+      }
+
       // Initialize data structures for buckets
       _max_rank = _alpha * _res_node_num;
       _buckets.resize(_max_rank);
@@ -906,6 +1112,28 @@ namespace lemon {
       return OPTIMAL;
     }
 
+    // Set the residual capacities and costs of a convex cost arc
+    // according to its current flow (the linear costs of the arc in
+    // _scost are replaced by the slopes of the current pieces)
+    void updateConvexArc(int j, int k) {
+      int rj = _reverse[j];
+      _convex.residual(k, _upper[j], _res_cap[j], _scost[j],
+                       _res_cap[rj], _scost[rj]);
+      _cost[j] = static_cast<LargeCost>(_scost[j]) * _res_node_num * _alpha;
+      _cost[rj] = static_cast<LargeCost>(_scost[rj]) * _res_node_num * _alpha;
+    }
+
+    // Update a convex cost arc after pushing d units of flow on the
+    // residual arc a (return false if it is a linear cost arc)
+    bool pushConvexArc(int a, Value d) {
+      int j = _forward[a] ? a : _reverse[a];
+      int k = _convex.id(j);
+      if (k < 0) return false;
+      _convex.move(k, _forward[a] ? d : -d);
+      updateConvexArc(j, k);
+      return true;
+    }
+
     // Check if the upper bound is greater than or equal to the lower bound
     // on each forward arc.
     bool checkBoundMaps() {
@@ -915,6 +1143,17 @@ namespace lemon {
       return true;
     }
 
+    // Return the epsilon value of the next phase. The division is
+    // rounded up, since the flow of a phase must be alpha*epsilon-optimal
+    // with respect to the next epsilon, otherwise the ranks computed in
+    // priceRefinement() could exceed _max_rank.
+    LargeCost nextEpsilon() const {
+      if (_epsilon <= 1) return _epsilon / _alpha;
+      if (_epsilon < _alpha) return 1;
+      LargeCost eps = _epsilon / _alpha;
+      return eps * _alpha < _epsilon ? eps + 1 : eps;
+    }
+
     // Execute the algorithm and transform the results
     void start(Method method) {
       const int MAX_PARTIAL_PATH_LENGTH = 4;
@@ -929,14 +1168,21 @@ namespace lemon {
         case PARTIAL_AUGMENT:
           startAugment(MAX_PARTIAL_PATH_LENGTH);
           break;
+        case WAVE:
+          startWave();
+          break;
+        case PARALLEL_PUSH:
+          startParallelPush();
+          break;
       }
 
       // Compute node potentials (dual solution)
       for (int i = 0; i != _res_node_num; ++i) {
         _pi[i] = static_cast<Cost>(_pi[i] / (_res_node_num * _alpha));
       }
+      // (the optimality check is skipped if the algorithm stopped early)
       bool optimal = true;
-      for (int i = 0; optimal && i != _res_node_num; ++i) {
+      for (int i = 0; optimal && !_gap_reached && i != _res_node_num; ++i) {
         LargeCost pi_i = _pi[i];
         int last_out = _first_out[i+1];
         for (int j = _first_out[i]; j != last_out; ++j) {
@@ -989,6 +1235,15 @@ namespace lemon {
         }
       }
 
+      // Set the flow of convex cost arcs
+      if (!_convex.empty()) {
+        int limit = _first_out[_root];
+        for (int j = 0; j != limit; ++j) {
+          int k = _forward[j] ? _convex.id(j) : -1;
+          if (k >= 0) _res_cap[_reverse[j]] = _convex.flow(k) - _lower[j];
+        }
+      }
+
       // Handle non-zero lower bounds
       if (_has_lower) {
         int limit = _first_out[_root];
@@ -998,6 +1253,57 @@ namespace lemon {
       }
     }
 
+    // Check if the current flow is within the allowed optimality gap.
+    // It is called between the scaling phases, when the flow is feasible
+    // and epsilon-optimal. The gap is the sum of -rc*res_cap over the
+    // residual arcs of negative reduced cost (Lagrangian duality gap).
+    // The sums are accumulated in long double, since the products of
+    // the scaled costs and the capacities may overflow LargeCost.
+    bool gapReached() {
+      if (_abs_gap <= 0 && _rel_gap <= 0) return false;
+      typedef long double Real;
+      Real gap = 0, cost = 0;
+      for (int u = 0; u != _res_node_num; ++u) {
+        LargeCost pi_u = _pi[u];
+        int last_out = _first_out[u+1];
+        for (int a = _first_out[u]; a != last_out; ++a) {
+          if (!_convex.empty() &&
+              _convex.id(_forward[a] ? a : _reverse[a]) >= 0) continue;
+          if (_res_cap[a] > 0) {
+            LargeCost rc = _cost[a] + pi_u - _pi[_target[a]];
+            if (rc < 0) {
+              gap -= static_cast<Real>(rc) * static_cast<Real>(_res_cap[a]);
+            }
+          }
+          if (!_forward[a]) {
+            cost -= static_cast<Real>(_scost[a]) *
+                    static_cast<Real>(_res_cap[a]);
+          } else if (_has_lower) {
+            cost += static_cast<Real>(_scost[a]) *
+                    static_cast<Real>(_lower[a]);
+          }
+        }
+      }
+      if (!_convex.empty()) {
+        // All pieces of convex cost arcs are taken into account
+        Real scale = static_cast<Real>(_res_node_num) * _alpha;
+        for (int j = 0; j != _res_arc_num; ++j) {
+          int k = _forward[j] ? _convex.id(j) : -1;
+          if (k < 0) continue;
+          gap += _convex.gap(k, scale,
+                   static_cast<Real>(_pi[_source[j]] - _pi[_target[j]]));
+          cost += _convex.template cost<Real>(k);
+        }
+      }
+      gap /= static_cast<Real>(_res_node_num) * _alpha;
+      if (cost < 0) cost = -cost;
+      if (gap <= _abs_gap || gap <= _rel_gap * cost) {
+        _gap = gap;
+        _gap_reached = true;
+      }
+      return _gap_reached;
+    }
+
     // Initialize a cost scaling phase
     void initPhase() {
       // Saturate arcs not satisfying the optimality condition
@@ -1006,14 +1312,15 @@ namespace lemon {
         LargeCost pi_u = _pi[u];
         for (int a = _first_out[u]; a != last_out; ++a) {
           Value delta = _res_cap[a];
-          if (delta > 0) {
-            int v = _target[a];
-            if (_cost[a] + pi_u - _pi[v] < 0) {
-              _excess[u] -= delta;
-              _excess[v] += delta;
-              _res_cap[a] = 0;
-              _res_cap[_reverse[a]] += delta;
-            }
+          int v = _target[a];
+          while (delta > 0 && _cost[a] + pi_u - _pi[v] < 0) {
+            _excess[u] -= delta;
+            _excess[v] += delta;
+            _res_cap[a] = 0;
+            _res_cap[_reverse[a]] += delta;
+            // The next piece of a convex cost arc is also checked
+            if (_convex.empty() || !pushConvexArc(a, delta)) break;
+            delta = _res_cap[a];
           }
         }
       }
@@ -1209,11 +1516,13 @@ namespace lemon {
                   // Augment along the cycle
                   _res_cap[a] -= delta;
                   _res_cap[_reverse[a]] += delta;
+                  if (!_convex.empty()) pushConvexArc(a, delta);
                   for (u = tip; u != v; ) {
                     u = pred[u];
                     int ca = _next_out[u];
                     _res_cap[ca] -= delta;
                     _res_cap[_reverse[ca]] += delta;
+                    if (!_convex.empty()) pushConvexArc(ca, delta);
                   }
 
                   // Check the maximum number of cycle canceling
@@ -1361,8 +1670,8 @@ namespace lemon {
       BoolVector path_arc(_res_arc_num, false);
       int relabel_cnt = 0;
       int eps_phase_cnt = 0;
-      for ( ; _epsilon >= 1; _epsilon = _epsilon < _alpha && _epsilon > 1 ?
-                                        1 : _epsilon / _alpha )
+      for ( ; _epsilon >= 1 && !gapReached();
+            _epsilon = nextEpsilon() )
       {
         ++eps_phase_cnt;
 
@@ -1453,6 +1762,7 @@ namespace lemon {
             delta = std::min(_res_cap[pa], _excess[u]);
             _res_cap[pa] -= delta;
             _res_cap[_reverse[pa]] += delta;
+            if (!_convex.empty()) pushConvexArc(pa, delta);
             _excess[u] -= delta;
             _excess[v] += delta;
             if (_excess[v] > 0 && _excess[v] <= delta) {
@@ -1487,8 +1797,8 @@ namespace lemon {
       LargeCostVector hyper_cost(_res_node_num);
       int relabel_cnt = 0;
       int eps_phase_cnt = 0;
-      for ( ; _epsilon >= 1; _epsilon = _epsilon < _alpha && _epsilon > 1 ?
-                                        1 : _epsilon / _alpha )
+      for ( ; _epsilon >= 1 && !gapReached();
+            _epsilon = nextEpsilon() )
       {
         ++eps_phase_cnt;
 
@@ -1536,6 +1846,7 @@ namespace lemon {
                 if (ahead < delta && !hyper[t]) {
                   _res_cap[a] -= ahead;
                   _res_cap[_reverse[a]] += ahead;
+                  if (!_convex.empty()) pushConvexArc(a, ahead);
                   _excess[n] -= ahead;
                   _excess[t] += ahead;
                   _active_nodes.push_front(t);
@@ -1546,6 +1857,7 @@ namespace lemon {
                 } else {
                   _res_cap[a] -= delta;
                   _res_cap[_reverse[a]] += delta;
+                  if (!_convex.empty()) pushConvexArc(a, delta);
                   _excess[n] -= delta;
                   _excess[t] += delta;
                   if (_excess[t] > 0 && _excess[t] <= delta)
@@ -1556,6 +1868,8 @@ namespace lemon {
                   _next_out[n] = a;
                   goto remove_nodes;
                 }
+                // The next piece of a convex cost arc is checked again
+                if (!_convex.empty() && _res_cap[a] > 0) --a;
               }
             }
             _next_out[n] = a;
@@ -1598,6 +1912,514 @@ namespace lemon {
       }
     }
 
+
+    // Compute a topological order of the admissible network using DFS
+    // and store the position of each node in the given vector
+    void waveOrder(IntVector &pos, IntVector &stack, BoolVector &reached) {
+      for (int i = 0; i != _res_node_num; ++i) {
+        reached[i] = false;
+        _next_out[i] = _first_out[i];
+      }
+
+      int next_pos = _res_node_num;
+      for (int start = 0; start != _res_node_num; ++start) {
+        if (reached[start]) continue;
+        int top = 0;
+        stack[0] = start;
+        reached[start] = true;
+        while (top >= 0) {
+          int u = stack[top];
+          LargeCost pi_u = _pi[u];
+          int a, last_out = _first_out[u+1];
+          for (a = _next_out[u]; a != last_out; ++a) {
+            if (_res_cap[a] > 0) {
+              int v = _target[a];
+              if (!reached[v] && _cost[a] + pi_u - _pi[v] < 0) break;
+            }
+          }
+          _next_out[u] = a;
+          if (a != last_out) {
+            int v = _target[a];
+            reached[v] = true;
+            stack[++top] = v;
+          } else {
+            // Nodes are finished in reverse topological order
+            pos[u] = --next_pos;
+            --top;
+          }
+        }
+      }
+
+      for (int i = 0; i != _res_node_num; ++i) {
+        _next_out[i] = _first_out[i];
+      }
+    }
+
+    /// Execute the algorithm performing push and relabel operations
+    /// on the nodes in topological order (wave implementation)
+    void startWave() {
+      // Parameters for heuristics
+      const int PRICE_REFINEMENT_LIMIT = 2;
+      const double GLOBAL_UPDATE_FACTOR = 2.0;
+
+      const int global_update_skip = static_cast<int>(GLOBAL_UPDATE_FACTOR *
+        (_res_node_num + _sup_node_num * _sup_node_num));
+      int next_global_update_limit = global_update_skip;
+
+      // The active nodes are stored in a heap with respect to their
+      // positions in the topological order. A relabeled node has no
+      // entering admissible arcs, so it can be moved to the front of
+      // the order, which is done by assigning a new smallest position.
+      IntVector pos(_res_node_num);
+      typedef BinHeap<int, RangeMap<int> > Heap;
+      RangeMap<int> heap_cross_ref(_res_node_num, Heap::PRE_HEAP);
+      Heap heap(heap_cross_ref);
+      IntVector stack(_res_node_num);
+      BoolVector reached(_res_node_num);
+
+      // Perform cost scaling phases
+      int relabel_cnt = 0;
+      int eps_phase_cnt = 0;
+      for ( ; _epsilon >= 1 && !gapReached();
+            _epsilon = nextEpsilon() )
+      {
+        ++eps_phase_cnt;
+
+        // Price refinement heuristic
+        if (eps_phase_cnt >= PRICE_REFINEMENT_LIMIT) {
+          if (priceRefinement()) continue;
+        }
+
+        // Initialize current phase
+        initPhase();
+        _active_nodes.clear();
+        waveOrder(pos, stack, reached);
+        int front_pos = 0;
+        heap.clear();
+        for (int u = 0; u != _res_node_num; ++u) {
+          heap_cross_ref[u] = Heap::PRE_HEAP;
+          if (_excess[u] > 0) heap.push(u, pos[u]);
+        }
+
+        // Discharge the first active node in the order
+        while (!heap.empty()) {
+          int u = heap.top();
+          heap.pop();
+          if (_excess[u] <= 0) continue;
+
+          LargeCost pi_u = _pi[u];
+          int last_out = _first_out[u+1];
+          while (true) {
+            int a;
+            for (a = _next_out[u]; a != last_out; ++a) {
+              if (_res_cap[a] > 0) {
+                int v = _target[a];
+                if (_cost[a] + pi_u - _pi[v] < 0) {
+                  Value delta = std::min(_res_cap[a], _excess[u]);
+                  _res_cap[a] -= delta;
+                  _res_cap[_reverse[a]] += delta;
+                  if (!_convex.empty()) pushConvexArc(a, delta);
+                  _excess[u] -= delta;
+                  _excess[v] += delta;
+                  if (_excess[v] > 0 && _excess[v] <= delta) {
+                    heap.push(v, pos[v]);
+                  }
+                  if (_excess[u] == 0) break;
+                  // The next piece of a convex cost arc is checked again
+                  if (!_convex.empty() && _res_cap[a] > 0) --a;
+                }
+              }
+            }
+            if (a != last_out) {
+              _next_out[u] = a;
+              break;
+            }
+
+            // Relabel node u and move it to the front of the order
+            LargeCost rc, min_red_cost = std::numeric_limits<LargeCost>::max();
+            for (a = _first_out[u]; a != last_out; ++a) {
+              if (_res_cap[a] > 0) {
+                rc = _cost[a] + pi_u - _pi[_target[a]];
+                if (rc < min_red_cost) {
+                  min_red_cost = rc;
+                }
+              }
+            }
+            _pi[u] -= min_red_cost + _epsilon;
+            pi_u = _pi[u];
+            _next_out[u] = _first_out[u];
+            pos[u] = --front_pos;
+            ++relabel_cnt;
+          }
+
+          // Global update heuristic
+          if (relabel_cnt >= next_global_update_limit) {
+            globalUpdate();
+            next_global_update_limit += global_update_skip;
+            waveOrder(pos, stack, reached);
+            front_pos = 0;
+            heap.clear();
+            for (int v = 0; v != _res_node_num; ++v) {
+              heap_cross_ref[v] = Heap::PRE_HEAP;
+              if (_excess[v] > 0) heap.push(v, pos[v]);
+            }
+          }
+        }
+      }
+    }
+
+    // Global potential update heuristic performed by several threads.
+    // The buckets are processed in increasing order, but the nodes of
+    // each bucket are scanned concurrently.
+    void parallelGlobalUpdate(bits::ThreadPool &pool) {
+      const int PARALLEL_SCAN_LIMIT = 1024;
+      const int thread_num = pool.size();
+
+      // Initialize ranks and buckets
+      std::vector<std::atomic<int> > rank(_res_node_num);
+      std::map<int, IntVector> buckets;
+      IntVector &b0 = buckets[0];
+      Value total_excess = 0;
+      for (int i = 0; i != _res_node_num; ++i) {
+        if (_excess[i] < 0) {
+          rank[i].store(0, std::memory_order_relaxed);
+          b0.push_back(i);
+        } else {
+          total_excess += _excess[i];
+          rank[i].store(_max_rank, std::memory_order_relaxed);
+        }
+      }
+      if (total_excess == 0) return;
+
+      // Search the buckets
+      typedef std::pair<int, int> IntPair;
+      std::vector<std::vector<IntPair> > found(thread_num);
+      IntVector frontier;
+      std::atomic<int> next_index(0);
+      int r = _max_rank;
+      while (!buckets.empty()) {
+        typename std::map<int, IntVector>::iterator it = buckets.begin();
+        int br = it->first;
+        frontier.swap(it->second);
+        buckets.erase(it);
+
+        // Remove the nodes whose rank has been decreased since
+        // their insertion into this bucket
+        int k = 0;
+        for (int i = 0; i != int(frontier.size()); ++i) {
+          int u = frontier[i];
+          if (rank[u].load(std::memory_order_relaxed) == br) {
+            frontier[k++] = u;
+          }
+        }
+        frontier.resize(k);
+        if (k == 0) continue;
+        r = br;
+
+        // Search the incoming arcs of the nodes in the current bucket
+        next_index.store(0);
+        int fsize = int(frontier.size());
+        auto scan = [&](int tid) {
+          std::vector<IntPair> &fnd = found[tid];
+          for (int i = next_index.fetch_add(1); i < fsize;
+               i = next_index.fetch_add(1)) {
+            int u = frontier[i];
+            LargeCost pi_u = _pi[u];
+            int last_out = _first_out[u+1];
+            for (int a = _first_out[u]; a != last_out; ++a) {
+              int ra = _reverse[a];
+              if (_res_cap[ra] > 0) {
+                int v = _source[ra];
+                int old_rank_v = rank[v].load(std::memory_order_relaxed);
+                if (br < old_rank_v) {
+                  LargeCost nrc = (_cost[ra] + _pi[v] - pi_u) / _epsilon;
+                  if (nrc < LargeCost(_max_rank)) {
+                    int new_rank_v = br + 1 + static_cast<int>(nrc);
+                    while (new_rank_v < old_rank_v) {
+                      if (rank[v].compare_exchange_weak(old_rank_v,
+                                                        new_rank_v)) {
+                        fnd.push_back(IntPair(new_rank_v, v));
+                        break;
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        };
+        if (fsize >= PARALLEL_SCAN_LIMIT) {
+          pool.run(scan);
+        } else {
+          scan(0);
+        }
+        for (int t = 0; t != thread_num; ++t) {
+          for (int i = 0; i != int(found[t].size()); ++i) {
+            buckets[found[t][i].first].push_back(found[t][i].second);
+          }
+          found[t].clear();
+        }
+
+        // Finish search if there are no more active nodes
+        for (int i = 0; i != fsize; ++i) {
+          if (_excess[frontier[i]] > 0) total_excess -= _excess[frontier[i]];
+        }
+        if (total_excess <= 0) break;
+      }
+      if (total_excess > 0) r = _max_rank;
+
+      // Relabel nodes
+      int chunk = (_res_node_num + thread_num - 1) / thread_num;
+      pool.run([&](int tid) {
+        int first = tid * chunk;
+        int last = std::min(first + chunk, _res_node_num);
+        for (int u = first; u < last; ++u) {
+          int k = std::min(rank[u].load(std::memory_order_relaxed), r);
+          if (k > 0) {
+            _pi[u] -= _epsilon * k;
+            _next_out[u] = _first_out[u];
+          }
+        }
+      });
+    }
+
+    // Add d to the given value by a compare-and-swap loop (which works
+    // for floating-point values too) and return its previous value
+    static AddedValue atomicAdd(std::atomic<AddedValue> &a, AddedValue d) {
+      AddedValue old = a.load(std::memory_order_relaxed);
+      while (!a.compare_exchange_weak(old, old + d,
+                                      std::memory_order_relaxed)) {}
+      return old;
+    }
+
+    // Call step(thread, node) for each node of the list on the threads
+    // of the pool
+    template <typename Step>
+    void parallelForEach(bits::ThreadPool &pool, const IntVector &list,
+                         const Step &step) {
+      const int size = int(list.size());
+      std::atomic<int> next_index(0);
+      pool.run([&](int tid) {
+        for (int i = next_index.fetch_add(1); i < size;
+             i = next_index.fetch_add(1)) {
+          step(tid, list[i]);
+        }
+      });
+    }
+
+    // Discharge the given node in the rounds of the PARALLEL_PUSH method
+    // that are processed by one thread, using the current potentials.
+    // Returns the number of relabel operations.
+    int serialDischarge(int u, IntVector &next_active) {
+      int relabel_cnt = 0;
+      LargeCost pi_u = _pi[u];
+      int last_out = _first_out[u+1];
+      while (_excess[u] > 0) {
+        int a;
+        for (a = _next_out[u]; a != last_out; ++a) {
+          int v = _target[a];
+          if (v != u && _res_cap[a] > 0 && _cost[a] + pi_u - _pi[v] < 0) {
+            Value delta = std::min(_res_cap[a], _excess[u]);
+            _res_cap[a] -= delta;
+            _res_cap[_reverse[a]] += delta;
+            if (!_convex.empty()) pushConvexArc(a, delta);
+            _excess[u] -= delta;
+            _excess[v] += delta;
+            if (_excess[v] > 0 && _excess[v] <= delta) {
+              next_active.push_back(v);
+            }
+            if (_excess[u] == 0) break;
+            // The next piece of a convex cost arc is checked again
+            if (!_convex.empty() && _res_cap[a] > 0) --a;
+          }
+        }
+        if (a != last_out) {
+          _next_out[u] = a;
+          break;
+        }
+
+        // Relabel node u
+        LargeCost rc, min_red_cost = std::numeric_limits<LargeCost>::max();
+        for (a = _first_out[u]; a != last_out; ++a) {
+          if (_res_cap[a] > 0) {
+            rc = _cost[a] + pi_u - _pi[_target[a]];
+            if (rc < min_red_cost) {
+              min_red_cost = rc;
+            }
+          }
+        }
+        _pi[u] -= min_red_cost + _epsilon;
+        pi_u = _pi[u];
+        _next_out[u] = _first_out[u];
+        ++relabel_cnt;
+      }
+      return relabel_cnt;
+    }
+
+    // Push the excess of the given node in the PARALLEL_PUSH method on
+    // its admissible arcs with respect to the potentials of the previous
+    // round. The reduced costs of the two directions of an arc cannot be
+    // both negative, so only the pushing node reads and writes the
+    // residual capacities of an admissible arc (the reduced cost is
+    // checked first). The excess is added to the target by atomicAdd(),
+    // the first addition lists the target as a candidate for the next
+    // round.
+    void parallelPush(int u, AddedValueVector &added,
+                      IntVector &next_active) {
+      LargeCost pi_u = _pi[u];
+      int last_out = _first_out[u+1];
+      for (int a = _next_out[u]; a != last_out; ++a) {
+        int v = _target[a];
+        if (v != u && _cost[a] + pi_u - _pi[v] < 0 && _res_cap[a] > 0) {
+          Value delta = std::min(_res_cap[a], _excess[u]);
+          _res_cap[a] -= delta;
+          _res_cap[_reverse[a]] += delta;
+          if (!_convex.empty()) pushConvexArc(a, delta);
+          _excess[u] -= delta;
+          if (atomicAdd(added[v], AddedValue(delta)) == 0) {
+            next_active.push_back(v);
+          }
+          if (_excess[u] == 0) {
+            _next_out[u] = a;
+            return;
+          }
+          // The next piece of a convex cost arc is checked again
+          if (!_convex.empty() && _res_cap[a] > 0) --a;
+        }
+      }
+      _next_out[u] = last_out;
+    }
+
+    // Relabel the given node in the PARALLEL_PUSH method if it still has
+    // excess after the push step. Its admissible arcs are saturated, and
+    // the residual capacities do not change in this step. The new
+    // potential is computed from the potentials of the previous round,
+    // which are only decreased by the concurrent relabels, so the
+    // relabel keeps epsilon-optimality.
+    bool parallelRelabel(int u, LargeCostVector &new_pi,
+                         IntVector &next_active) {
+      if (_excess[u] <= 0) return false;
+      LargeCost pi_u = _pi[u];
+      int last_out = _first_out[u+1];
+      LargeCost rc, min_red_cost = std::numeric_limits<LargeCost>::max();
+      for (int a = _first_out[u]; a != last_out; ++a) {
+        if (_res_cap[a] > 0) {
+          rc = _cost[a] + pi_u - _pi[_target[a]];
+          if (rc < min_red_cost) {
+            min_red_cost = rc;
+          }
+        }
+      }
+      new_pi[u] = pi_u - (min_red_cost + _epsilon);
+      _next_out[u] = _first_out[u];
+      next_active.push_back(u);
+      return true;
+    }
+
+    /// Execute the algorithm performing push and relabel operations
+    /// using several threads
+    void startParallelPush() {
+      // Parameters for heuristics
+      const int PRICE_REFINEMENT_LIMIT = 2;
+      const double GLOBAL_UPDATE_FACTOR = 2.0;
+      const int PARALLEL_ROUND_LIMIT = 256;
+
+      const int global_update_skip = static_cast<int>(GLOBAL_UPDATE_FACTOR *
+        (_res_node_num + _sup_node_num * _sup_node_num));
+      int next_global_update_limit = global_update_skip;
+
+      bits::ThreadPool pool(_thread_num);
+      const int thread_num = pool.size();
+      AddedValueVector added(_res_node_num);
+      for (int i = 0; i != _res_node_num; ++i) {
+        added[i].store(0, std::memory_order_relaxed);
+      }
+      LargeCostVector new_pi(_res_node_num);
+      std::vector<IntVector> next_active(thread_num);
+      std::vector<int> thread_relabel_cnt(thread_num);
+      std::vector<char> listed(_res_node_num, false);
+      IntVector active;
+
+      // The pushes on convex cost arcs change the costs of both
+      // directions, which are read by the other threads, so in this
+      // case the rounds are processed by one thread
+      const bool serial = thread_num == 1 || !_convex.empty();
+
+      // Perform cost scaling phases
+      int relabel_cnt = 0;
+      int eps_phase_cnt = 0;
+      for ( ; _epsilon >= 1 && !gapReached();
+            _epsilon = nextEpsilon() )
+      {
+        ++eps_phase_cnt;
+
+        // Price refinement heuristic
+        if (eps_phase_cnt >= PRICE_REFINEMENT_LIMIT) {
+          if (priceRefinement()) continue;
+        }
+
+        // Initialize current phase
+        initPhase();
+        active.assign(_active_nodes.begin(), _active_nodes.end());
+        _active_nodes.clear();
+
+        // Perform rounds, in each of which the active nodes push their
+        // excess, then the ones that still have excess are relabeled
+        while (!active.empty()) {
+          if (serial || int(active.size()) < PARALLEL_ROUND_LIMIT) {
+            // Small rounds are processed by one thread
+            for (int i = 0; i != int(active.size()); ++i) {
+              relabel_cnt += serialDischarge(active[i], next_active[0]);
+            }
+          } else {
+            parallelForEach(pool, active, [&](int tid, int u) {
+              parallelPush(u, added, next_active[tid]);
+            });
+            parallelForEach(pool, active, [&](int tid, int u) {
+              if (parallelRelabel(u, new_pi, next_active[tid])) {
+                ++thread_relabel_cnt[tid];
+              }
+            });
+            for (int i = 0; i != int(active.size()); ++i) {
+              int u = active[i];
+              if (_excess[u] > 0) _pi[u] = new_pi[u];
+            }
+          }
+
+          // Apply the received excesses and collect the active nodes for
+          // the next round
+          active.clear();
+          for (int t = 0; t != thread_num; ++t) {
+            for (int i = 0; i != int(next_active[t].size()); ++i) {
+              int v = next_active[t][i];
+              if (!listed[v]) {
+                listed[v] = true;
+                active.push_back(v);
+              }
+            }
+            next_active[t].clear();
+            relabel_cnt += thread_relabel_cnt[t];
+            thread_relabel_cnt[t] = 0;
+          }
+          int k = 0;
+          for (int i = 0; i != int(active.size()); ++i) {
+            int v = active[i];
+            listed[v] = false;
+            _excess[v] += added[v].load(std::memory_order_relaxed);
+            added[v].store(0, std::memory_order_relaxed);
+            if (_excess[v] > 0) active[k++] = v;
+          }
+          active.resize(k);
+
+          // Global update heuristic
+          if (relabel_cnt >= next_global_update_limit) {
+            parallelGlobalUpdate(pool);
+            next_global_update_limit += global_update_skip;
+          }
+        }
+      }
+    }
+
   }; //class CostScaling
 
   ///@}
@@ -0,0 +1,599 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_DINIC_H
+#define LEMON_DINIC_H
+
+/// \file
+/// \ingroup max_flow
+/// \brief Implementation of Dinic's algorithm with dynamic trees.
+
+#include <lemon/core.h>
+#include <lemon/tolerance.h>
+#include <lemon/bits/link_cut_tree.h>
+#include <vector>
+
+namespace lemon {
+
+  /// \brief Default traits class of Dinic class.
+  ///
+  /// Default traits class of Dinic class.
+  /// \param GR Digraph type.
+  /// \param CAP Type of capacity map.
+  template <typename GR, typename CAP>
+  struct DinicDefaultTraits {
+
+    /// \brief The digraph type the algorithm runs on.
+    typedef GR Digraph;
+
+    /// \brief The type of the map that stores the arc capacities.
+    ///
+    /// The type of the map that stores the arc capacities.
+    /// It must meet the \ref concepts::ReadMap "ReadMap" concept.
+    typedef CAP CapacityMap;
+
+    /// \brief The type of the flow values.
+    typedef typename CapacityMap::Value Value;
+
+    /// \brief The type of the map that stores the flow values.
+    ///
+    /// The type of the map that stores the flow values.
+    /// It must meet the \ref concepts::ReadWriteMap "ReadWriteMap" concept.
+#ifdef DOXYGEN
+    typedef GR::ArcMap<Value> FlowMap;
+#else
+    typedef typename Digraph::template ArcMap<Value> FlowMap;
+#endif
+
+    /// \brief Instantiates a FlowMap.
+    ///
+    /// This function instantiates a \ref FlowMap.
+    /// \param digraph The digraph for which we would like to define
+    /// the flow map.
+    static FlowMap* createFlowMap(const Digraph& digraph) {
+      return new FlowMap(digraph);
+    }
+
+    /// \brief The tolerance used by the algorithm
+    ///
+    /// The tolerance used by the algorithm to handle inexact computation.
+    typedef lemon::Tolerance<Value> Tolerance;
+
+  };
+
+  /// \ingroup max_flow
+  ///
+  /// \brief Dinic's blocking flow algorithm with dynamic trees.
+  ///
+  /// This class provides an implementation of \e Dinic's \e algorithm
+  /// \cite dinic70algorithm producing a \ref max_flow
+  /// "flow of maximum value" in a digraph. In each phase, the algorithm
+  /// computes the layered network of the shortest augmenting paths and
+  /// saturates it by a blocking flow. The blocking flows are found using
+  /// the dynamic trees of Sleator and Tarjan \cite sleator83dynamic:
+  /// the partial augmenting paths are kept in a forest, so an
+  /// augmentation takes \f$ O(\log n) \f$ amortized time instead of
+  /// time proportional to the length of the path.
+  ///
+  /// The time complexity of the algorithm is \f$ O(nm\log n) \f$ in
+  /// worst case. It is mainly useful if each phase contains many long
+  /// augmenting paths (e.g. long parallel paths with cross links), on
+  /// which the push operations of the \ref Preflow "preflow push-relabel
+  /// algorithm" and the augmentations of the \ref EdmondsKarp
+  /// "Edmonds-Karp algorithm" take quadratic time in practice.
+  /// For example, on 300 such paths of length 3000 it is about 38 times
+  /// faster than Preflow (\c max-flow-bench \c -paths \c -k \c 300
+  /// \c -len \c 3000).
+  /// On most other instances Preflow is faster, even if the paths are
+  /// long: e.g. if they share a single long chain, Preflow is about
+  /// seven times faster, and if a phase has only one path, it is
+  /// thousands of times faster (see the max-flow-bench tool).
+  ///
+  /// \tparam GR The type of the digraph the algorithm runs on.
+  /// \tparam CAP The type of the capacity map. The default map
+  /// type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
+  /// \tparam TR The traits class that defines various types used by the
+  /// algorithm. By default, it is \ref DinicDefaultTraits
+  /// "DinicDefaultTraits<GR, CAP>".
+  /// In most cases, this parameter should not be set directly,
+  /// consider to use the named template parameters instead.
+
+#ifdef DOXYGEN
+  template <typename GR, typename CAP, typename TR>
+#else
+  template <typename GR,
+            typename CAP = typename GR::template ArcMap<int>,
+            typename TR = DinicDefaultTraits<GR, CAP> >
+#endif
+  class Dinic {
+  public:
+
+    /// \brief The \ref lemon::DinicDefaultTraits "traits class"
+    /// of the algorithm.
+    typedef TR Traits;
+    /// The type of the digraph the algorithm runs on.
+    typedef typename Traits::Digraph Digraph;
+    /// The type of the capacity map.
+    typedef typename Traits::CapacityMap CapacityMap;
+    /// The type of the flow values.
+    typedef typename Traits::Value Value;
+
+    /// The type of the flow map.
+    typedef typename Traits::FlowMap FlowMap;
+    /// The type of the tolerance.
+    typedef typename Traits::Tolerance Tolerance;
+
+  private:
+
+    TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+
+    const Digraph& _graph;
+    const CapacityMap* _capacity;
+
+    Node _source, _target;
+
+    FlowMap* _flow;
+    bool _local_flow;
+
+    IntNodeMap* _index;
+
+    // The residual arcs of arc i are 2i (forward) and 2i+1 (backward),
+    // the residual capacity of the backward arc is the flow on arc i.
+    // The residual arcs leaving node v are _out[_first[v]..._first[v+1]).
+    std::vector<Node> _nodes;
+    std::vector<Arc> _arcs;
+    std::vector<int> _first, _out, _head;
+    std::vector<Value> _res;
+
+    // Node data of the current phase: the distance to the target in the
+    // residual network (-1 for the unreached and the dead end nodes),
+    // the next arc to examine and the residual arc of the node in the
+    // dynamic forest (-1 for roots). The first _reached nodes of the
+    // queue are the nodes reached by the last BFS, only these are reset.
+    // The nodes linked in the forest during the phase are collected in
+    // _linked (possibly more than once), only these are cut at its end.
+    std::vector<int> _level, _current, _tree_arc, _queue, _linked;
+    int _reached;
+    bits::LinkCutTree<Value> _tree;
+
+    Tolerance _tolerance;
+    Value _flow_value;
+
+    void createStructures() {
+      if (!_flow) {
+        _flow = Traits::createFlowMap(_graph);
+        _local_flow = true;
+      }
+      if (!_index) {
+        _index = new IntNodeMap(_graph);
+      }
+
+      // Build the residual network (the digraph may have been changed)
+      _nodes.clear();
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        _index->set(n, _nodes.size());
+        _nodes.push_back(n);
+      }
+      _arcs.clear();
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        _arcs.push_back(a);
+      }
+      int n = _nodes.size(), m = _arcs.size();
+      _first.assign(n + 1, 0);
+      _head.resize(2 * m);
+      for (int i = 0; i != m; ++i) {
+        int u = (*_index)[_graph.source(_arcs[i])];
+        int v = (*_index)[_graph.target(_arcs[i])];
+        _head[2 * i] = v;
+        _head[2 * i + 1] = u;
+        ++_first[u + 1];
+        ++_first[v + 1];
+      }
+      for (int v = 0; v != n; ++v) {
+        _first[v + 1] += _first[v];
+      }
+      _out.resize(2 * m);
+      _current.assign(_first.begin(), _first.end() - 1);
+      for (int r = 0; r != 2 * m; ++r) {
+        _out[_current[_head[r ^ 1]]++] = r;
+      }
+      _res.resize(2 * m);
+
+      _level.assign(n, -1);
+      _tree_arc.assign(n, -1);
+      _queue.resize(n);
+      _reached = 0;
+      _tree.resize(n);
+    }
+
+    void destroyStructures() {
+      if (_local_flow) {
+        delete _flow;
+      }
+      if (_index) {
+        delete _index;
+      }
+    }
+
+    // Compute the distances to the target by a backward BFS, the nodes
+    // farther than the source are not needed
+    bool computeLevels() {
+      int s = (*_index)[_source], t = (*_index)[_target];
+      for (int i = 0; i != _reached; ++i) {
+        _level[_queue[i]] = -1;
+      }
+      _level[t] = 0;
+      _queue[0] = t;
+      int first = 0, last = 1;
+      while (first != last) {
+        int w = _queue[first++];
+        if (_level[s] >= 0 && _level[w] >= _level[s]) break;
+        for (int k = _first[w]; k != _first[w + 1]; ++k) {
+          int r = _out[k] ^ 1, u = _head[_out[k]];
+          if (_level[u] < 0 && _tolerance.positive(_res[r])) {
+            _level[u] = _level[w] + 1;
+            _queue[last++] = u;
+          }
+        }
+      }
+      _reached = last;
+      return _level[s] >= 0;
+    }
+
+    // Remove the arc of node v from the dynamic forest and store the
+    // residual capacity kept in the forest
+    void cutTreeArc(int v) {
+      int r = _tree_arc[v];
+      Value c = _tree.cut(v);
+      _res[r ^ 1] += _res[r] - c;
+      _res[r] = c;
+      _tree_arc[v] = -1;
+      _flow->set(_arcs[r >> 1], _res[r | 1]);
+    }
+
+  public:
+
+    typedef Dinic Create;
+
+    ///\name Named template parameters
+
+    ///@{
+
+    template <typename T>
+    struct SetFlowMapTraits : public Traits {
+      typedef T FlowMap;
+      static FlowMap *createFlowMap(const Digraph&) {
+        LEMON_ASSERT(false, "FlowMap is not initialized");
+        return 0;
+      }
+    };
+
+    /// \brief \ref named-templ-param "Named parameter" for setting
+    /// FlowMap type
+    ///
+    /// \ref named-templ-param "Named parameter" for setting FlowMap
+    /// type
+    template <typename T>
+    struct SetFlowMap
+      : public Dinic<Digraph, CapacityMap, SetFlowMapTraits<T> > {
+      typedef Dinic<Digraph, CapacityMap, SetFlowMapTraits<T> > Create;
+    };
+
+    /// @}
+
+  protected:
+
+    Dinic() {}
+
+  public:
+
+    /// \brief The constructor of the class.
+    ///
+    /// The constructor of the class.
+    /// \param digraph The digraph the algorithm runs on.
+    /// \param capacity The capacity of the arcs.
+    /// \param source The source node.
+    /// \param target The target node.
+    Dinic(const Digraph& digraph, const CapacityMap& capacity,
+          Node source, Node target)
+      : _graph(digraph), _capacity(&capacity), _source(source),
+        _target(target), _flow(0), _local_flow(false), _index(0),
+        _tolerance(), _flow_value()
+    {
+      LEMON_ASSERT(_source != _target,
+                   "Flow source and target are the same nodes.");
+    }
+
+    /// \brief Destructor.
+    ///
+    /// Destructor.
+    ~Dinic() {
+      destroyStructures();
+    }
+
+    /// \brief Sets the capacity map.
+    ///
+    /// Sets the capacity map.
+    /// \return <tt>(*this)</tt>
+    Dinic& capacityMap(const CapacityMap& map) {
+      _capacity = &map;
+      return *this;
+    }
+
+    /// \brief Sets the flow map.
+    ///
+    /// Sets the flow map.
+    /// If you don't use this function before calling \ref run() or
+    /// \ref init(), an instance will be allocated automatically.
+    /// The destructor deallocates this automatically allocated map,
+    /// of course.
+    /// \return <tt>(*this)</tt>
+    Dinic& flowMap(FlowMap& map) {
+      if (_local_flow) {
+        delete _flow;
+        _local_flow = false;
+      }
+      _flow = &map;
+      return *this;
+    }
+
+    /// \brief Sets the source node.
+    ///
+    /// Sets the source node.
+    /// \return <tt>(*this)</tt>
+    Dinic& source(const Node& node) {
+      _source = node;
+      return *this;
+    }
+
+    /// \brief Sets the target node.
+    ///
+    /// Sets the target node.
+    /// \return <tt>(*this)</tt>
+    Dinic& target(const Node& node) {
+      _target = node;
+      return *this;
+    }
+
+    /// \brief Sets the tolerance used by algorithm.
+    ///
+    /// Sets the tolerance used by algorithm.
+    /// \return <tt>(*this)</tt>
+    Dinic& tolerance(const Tolerance& tolerance) {
+      _tolerance = tolerance;
+      return *this;
+    }
+
+    /// \brief Returns a const reference to the tolerance.
+    ///
+    /// Returns a const reference to the tolerance object used by
+    /// the algorithm.
+    const Tolerance& tolerance() const {
+      return _tolerance;
+    }
+
+    /// \name Execution control
+    /// The simplest way to execute the algorithm is to use \ref run().\n
+    /// If you need better control on the initial solution or the execution,
+    /// you have to call one of the \ref init() functions first, then
+    /// \ref start() or multiple times the \ref augment() function.
+
+    ///@{
+
+    /// \brief Initializes the algorithm.
+    ///
+    /// Initializes the internal data structures and sets the initial
+    /// flow to zero on each arc.
+    void init() {
+      createStructures();
+      for (int i = 0; i != int(_arcs.size()); ++i) {
+        _res[2 * i] = (*_capacity)[_arcs[i]];
+        _res[2 * i + 1] = 0;
+        _flow->set(_arcs[i], 0);
+      }
+      _flow_value = 0;
+    }
+
+    /// \brief Initializes the algorithm using the given flow map.
+    ///
+    /// Initializes the internal data structures and sets the initial
+    /// flow to the given \c flowMap. The \c flowMap should
+    /// contain a feasible flow, i.e. at each node excluding the source
+    /// and the target, the incoming flow should be equal to the
+    /// outgoing flow.
+    template <typename FlowMap>
+    void init(const FlowMap& flowMap) {
+      createStructures();
+      for (int i = 0; i != int(_arcs.size()); ++i) {
+        Value f = flowMap[_arcs[i]];
+        _res[2 * i] = (*_capacity)[_arcs[i]] - f;
+        _res[2 * i + 1] = f;
+        _flow->set(_arcs[i], f);
+      }
+      _flow_value = 0;
+      for (OutArcIt jt(_graph, _source); jt != INVALID; ++jt) {
+        _flow_value += (*_flow)[jt];
+      }
+      for (InArcIt jt(_graph, _source); jt != INVALID; ++jt) {
+        _flow_value -= (*_flow)[jt];
+      }
+    }
+
+    /// \brief Augments the solution by a blocking flow.
+    ///
+    /// Augments the solution by a blocking flow in the layered network
+    /// of the shortest augmenting paths, i.e. after this phase, the
+    /// length of the shortest augmenting path increases. If there is no
+    /// augmenting path, it gives back false.
+    /// \return \c false when the augmenting did not success, i.e. the
+    /// current flow is a feasible and optimal solution.
+    bool augment() {
+      if (!computeLevels()) return false;
+
+      int s = (*_index)[_source], t = (*_index)[_target];
+      for (int i = 0; i != _reached; ++i) {
+        int v = _queue[i];
+        _current[v] = _first[v];
+      }
+
+      while (true) {
+        int v = _tree.findRoot(s);
+        if (v == t) {
+          // Augment along the tree path from the source to the target
+          // and remove the saturated arcs
+          Value d = _tree.cost(_tree.findMin(s));
+          _tree.addCost(s, -d);
+          _flow_value += d;
+          int u = _tree.findMin(s);
+          while (u >= 0 && !_tolerance.positive(_tree.cost(u))) {
+            cutTreeArc(u);
+            u = _tree.findMin(s);
+          }
+          continue;
+        }
+
+        // Link the root to the next node on an admissible arc
+        bool linked = false;
+        for (int &k = _current[v]; k != _first[v + 1]; ++k) {
+          int r = _out[k], w = _head[r];
+          if (_level[w] == _level[v] - 1 && _tolerance.positive(_res[r])) {
+            _tree.link(v, w, _res[r]);
+            _tree_arc[v] = r;
+            _linked.push_back(v);
+            linked = true;
+            break;
+          }
+        }
+        if (linked) continue;
+
+        // Dead end: remove the node and the tree arcs entering it
+        if (v == s) break;
+        _level[v] = -1;
+        for (int k = _first[v]; k != _first[v + 1]; ++k) {
+          int r = _out[k], u = _head[r];
+          if (_tree_arc[u] == (r ^ 1)) cutTreeArc(u);
+        }
+      }
+
+      for (int i = 0; i != int(_linked.size()); ++i) {
+        int v = _linked[i];
+        if (_tree_arc[v] >= 0) cutTreeArc(v);
+      }
+      _linked.clear();
+      return true;
+    }
+
+    /// \brief Executes the algorithm
+    ///
+    /// Executes the algorithm by performing augmenting phases until the
+    /// optimal solution is reached.
+    /// \pre One of the \ref init() functions must be called before
+    /// using this function.
+    void start() {
+      while (augment()) {}
+    }
+
+    /// \brief Runs the algorithm.
+    ///
+    /// Runs Dinic's algorithm.
+    /// \note dinic.run() is just a shortcut of the following code.
+    ///\code
+    /// dinic.init();
+    /// dinic.start();
+    ///\endcode
+    void run() {
+      init();
+      start();
+    }
+
+    /// @}
+
+    /// \name Query Functions
+    /// The result of Dinic's algorithm can be obtained using these
+    /// functions.\n
+    /// Either \ref run() or \ref start() should be called before using them.
+
+    ///@{
+
+    /// \brief Returns the value of the maximum flow.
+    ///
+    /// Returns the value of the maximum flow found by the algorithm.
+    ///
+    /// \pre Either \ref run() or \ref init() must be called before
+    /// using this function.
+    Value flowValue() const {
+      return _flow_value;
+    }
+
+    /// \brief Returns the flow value on the given arc.
+    ///
+    /// Returns the flow value on the given arc.
+    ///
+    /// \pre Either \ref run() or \ref init() must be called before
+    /// using this function.
+    Value flow(const Arc& arc) const {
+      return (*_flow)[arc];
+    }
+
+    /// \brief Returns a const reference to the flow map.
+    ///
+    /// Returns a const reference to the arc map storing the found flow.
+    ///
+    /// \pre Either \ref run() or \ref init() must be called before
+    /// using this function.
+    const FlowMap& flowMap() const {
+      return *_flow;
+    }
+
+    /// \brief Returns \c true when the node is on the source side of the
+    /// minimum cut.
+    ///
+    /// Returns true when the node is on the source side of the found
+    /// minimum cut.
+    ///
+    /// \pre Either \ref run() or \ref start() must be called before
+    /// using this function.
+    bool minCut(const Node& node) const {
+      return _level[(*_index)[node]] < 0;
+    }
+
+    /// \brief Gives back a minimum value cut.
+    ///
+    /// Sets \c cutMap to the characteristic vector of a minimum value
+    /// cut. \c cutMap should be a \ref concepts::WriteMap "writable"
+    /// node map with \c bool (or convertible) value type.
+    ///
+    /// \note This function calls \ref minCut() for each node, so it runs in
+    /// O(n) time.
+    ///
+    /// \pre Either \ref run() or \ref start() must be called before
+    /// using this function.
+    template <typename CutMap>
+    void minCutMap(CutMap& cutMap) const {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        cutMap.set(n, minCut(n));
+      }
+    }
+
+    /// @}
+
+  };
+
+}
+
+#endif
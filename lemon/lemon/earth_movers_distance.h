@@ -0,0 +1,536 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_EARTH_MOVERS_DISTANCE_H
+#define LEMON_EARTH_MOVERS_DISTANCE_H
+
+/// \ingroup min_cost_flow_algs
+///
+/// \file
+/// \brief Earth mover's distance of weighted point sets.
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <lemon/core.h>
+#include <lemon/static_graph.h>
+#include <lemon/network_simplex.h>
+#include <lemon/transportation_simplex.h>
+
+namespace lemon {
+
+  /// \addtogroup min_cost_flow_algs
+  /// @{
+
+  /// \brief Earth mover's distance of weighted point sets.
+  ///
+  /// \ref EarthMoversDistance computes the \e earth \e mover's
+  /// \e distance (EMD) of two sets of weighted points (e.g. histograms),
+  /// i.e. the minimum total cost of moving the weights of the source
+  /// points to the target points, where the cost of moving a unit weight
+  /// is the ground distance of the points (the Euclidean or the
+  /// Manhattan distance). If the total weights differ, then only the
+  /// smaller total weight is moved.
+  ///
+  /// The ground distances are computed from the coordinates on the fly,
+  /// so neither the graph nor the distance matrix is stored. By default,
+  /// the problem is solved by \ref TransportationSimplex on the implicit
+  /// complete bipartite graph, computing the distances of a source point
+  /// to consecutive target points at once in the pricing, using loops
+  /// that the compiler can vectorize (the coordinates are stored
+  /// dimension by dimension).
+  ///
+  /// If a \ref threshold() "threshold" \c t is given, then the ground
+  /// distances are replaced by <tt>min(d, t)</tt>, and the problem is
+  /// solved by \ref NetworkSimplex on a sparse graph, which contains the
+  /// arcs of the point pairs closer than \c t and a transshipment node
+  /// connected to all points \cite pele09fastemd. This is much faster if
+  /// only a small fraction of the pairs is closer than the threshold.
+  ///
+  /// The ground distances are multiplied by the given \ref scale() and
+  /// rounded to the integer \c Cost type, since the algorithms require
+  /// integer costs.
+  ///
+  /// \tparam V The number type used for the weights.
+  /// The default type is \c int.
+  /// \tparam C The integer number type used for the rounded costs.
+  /// The default type is \c long \c long.
+  ///
+  /// \warning The weights must be non-negative integers.
+  template <typename V = int, typename C = long long>
+  class EarthMoversDistance
+  {
+  public:
+
+    /// The type of the weights
+    typedef V Value;
+    /// The type of the rounded costs
+    typedef C Cost;
+
+    /// \brief Constants for selecting the ground distance.
+    enum GroundDistance {
+      /// The Euclidean (L2) distance.
+      EUCLIDEAN,
+      /// The Manhattan (L1) distance.
+      MANHATTAN
+    };
+
+  private:
+
+    typedef std::vector<double> DoubleVector;
+    typedef std::vector<Value> ValueVector;
+
+    // The rounded ground distance of the points of two sets, which are
+    // stored dimension by dimension
+    class Distance {
+    public:
+
+      Distance(int dim, const DoubleVector& rows, int row_num,
+               const DoubleVector& cols, int col_num, bool euclidean,
+               double scale) :
+        _dim(dim), _rows(&rows[0]), _row_num(row_num), _cols(&cols[0]),
+        _col_num(col_num), _euclidean(euclidean), _scale(scale),
+        _sum(col_num) {}
+
+      double distance(int i, int j) const {
+        double sum = 0;
+        for (int d = 0; d != _dim; ++d) {
+          double diff = _rows[d * _row_num + i] - _cols[d * _col_num + j];
+          sum += _euclidean ? diff * diff : std::abs(diff);
+        }
+        return _euclidean ? std::sqrt(sum) : sum;
+      }
+
+      Cost round(double dist) const {
+        return static_cast<Cost>(dist * _scale + 0.5);
+      }
+
+      Cost operator()(int i, int j) const {
+        return round(distance(i, j));
+      }
+
+      // Compute the distances of the row point i to the column points
+      // first..last-1 (the inner loops are vectorizable)
+      template <typename Number>
+      void rowDistances(int i, int first, int last, Number* out,
+                        bool rounded) const {
+        double *sum = &_sum[0];
+        int num = last - first;
+        for (int k = 0; k != num; ++k) sum[k] = 0;
+        for (int d = 0; d != _dim; ++d) {
+          double x = _rows[d * _row_num + i];
+          const double *y = _cols + d * _col_num + first;
+          if (_euclidean) {
+            for (int k = 0; k != num; ++k) {
+              double diff = x - y[k];
+              sum[k] += diff * diff;
+            }
+          } else {
+            for (int k = 0; k != num; ++k) {
+              sum[k] += std::abs(x - y[k]);
+            }
+          }
+        }
+        if (_euclidean) {
+          for (int k = 0; k != num; ++k) sum[k] = std::sqrt(sum[k]);
+        }
+        if (rounded) {
+          for (int k = 0; k != num; ++k) {
+            out[k] = static_cast<Number>(
+              static_cast<Cost>(sum[k] * _scale + 0.5));
+          }
+        } else {
+          for (int k = 0; k != num; ++k) out[k] = sum[k];
+        }
+      }
+
+      void rowCosts(int i, int first, int last, Cost* out) const {
+        rowDistances(i, first, last, out, true);
+      }
+
+    private:
+      int _dim;
+      const double *_rows;
+      int _row_num;
+      const double *_cols;
+      int _col_num;
+      bool _euclidean;
+      double _scale;
+      mutable DoubleVector _sum;
+    };
+
+    // A positive flow between a source and a target point
+    struct Flow {
+      int source;
+      int target;
+      Value value;
+    };
+
+    int _dim;
+    int _source_num;
+    int _target_num;
+    DoubleVector _source_coords;
+    DoubleVector _target_coords;
+    ValueVector _source_weight;
+    ValueVector _target_weight;
+
+    GroundDistance _ground_distance;
+    double _scale;
+    double _threshold;
+    typename TransportationSimplex<V, C>::InitMethod _init_method;
+
+    std::vector<Flow> _flows;
+    Cost _total_cost;
+    Value _total_flow;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param dim The dimension of the points.
+    explicit EarthMoversDistance(int dim) :
+      _dim(dim), _source_num(0), _target_num(0),
+      _ground_distance(EUCLIDEAN), _scale(1.0),
+      _threshold(std::numeric_limits<double>::infinity()),
+      _init_method(TransportationSimplex<V, C>::VOGEL),
+      _total_cost(0), _total_flow(0)
+    {
+      LEMON_ASSERT(std::numeric_limits<Cost>::is_integer,
+        "The cost type of EarthMoversDistance must be integer");
+    }
+
+    /// \name Parameters
+    /// The parameters of the algorithm can be specified using these
+    /// functions.
+
+    /// @{
+
+    /// \brief Set the source points.
+    ///
+    /// This function sets the source points.
+    ///
+    /// \param num The number of the points.
+    /// \param coords The coordinates of the points in row-major order
+    /// (i.e. <tt>coords[i * dim + d]</tt> is the <tt>d</tt>-th
+    /// coordinate of the <tt>i</tt>-th point).
+    /// \param weights A map indexed by the integers <tt>0..num-1</tt>
+    /// (e.g. an array or an \c std::vector) storing the weights.
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename WeightMap>
+    EarthMoversDistance& sourcePoints(int num, const double* coords,
+                                      const WeightMap& weights) {
+      _source_num = num;
+      setPoints(num, coords, weights, _source_coords, _source_weight);
+      return *this;
+    }
+
+    /// \brief Set the target points.
+    ///
+    /// This function sets the target points
+    /// (see \ref sourcePoints()).
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename WeightMap>
+    EarthMoversDistance& targetPoints(int num, const double* coords,
+                                      const WeightMap& weights) {
+      _target_num = num;
+      setPoints(num, coords, weights, _target_coords, _target_weight);
+      return *this;
+    }
+
+    /// \brief Set the ground distance.
+    ///
+    /// This function sets the ground distance.
+    /// The default is \ref EUCLIDEAN.
+    ///
+    /// \return <tt>(*this)</tt>
+    EarthMoversDistance& groundDistance(GroundDistance gd) {
+      _ground_distance = gd;
+      return *this;
+    }
+
+    /// \brief Set the scale factor of the ground distances.
+    ///
+    /// This function sets the factor by which the ground distances are
+    /// multiplied before rounding them to the \c Cost type. Larger
+    /// values provide more precise results.
+    /// The default is 1.
+    ///
+    /// \return <tt>(*this)</tt>
+    EarthMoversDistance& scale(double factor) {
+      _scale = factor;
+      return *this;
+    }
+
+    /// \brief Set the threshold of the ground distances.
+    ///
+    /// This function sets a threshold \c t for the ground distances,
+    /// i.e. <tt>min(d, t)</tt> is used instead of the distance \c d,
+    /// and the problem is solved on a sparse graph.
+    /// The default is infinity (no threshold).
+    ///
+    /// \return <tt>(*this)</tt>
+    EarthMoversDistance& threshold(double t) {
+      _threshold = t;
+      return *this;
+    }
+
+    /// \brief Set the method for constructing the initial basis.
+    ///
+    /// This function sets the method for constructing the initial basis
+    /// of \ref TransportationSimplex (it is not used if a threshold is
+    /// given). The default is \ref TransportationSimplex::VOGEL.
+    ///
+    /// \return <tt>(*this)</tt>
+    EarthMoversDistance&
+    initMethod(typename TransportationSimplex<V, C>::InitMethod method) {
+      _init_method = method;
+      return *this;
+    }
+
+    /// @}
+
+    /// \name Execution Control
+    /// The algorithm can be executed using \ref run().
+
+    /// @{
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    /// For example,
+    /// \code
+    ///   EarthMoversDistance<> emd(2);
+    ///   emd.sourcePoints(n, source_coords, source_weights)
+    ///     .targetPoints(m, target_coords, target_weights)
+    ///     .scale(1000).run();
+    ///   double dist = emd.distance();
+    /// \endcode
+    void run() {
+      _flows.clear();
+      _total_cost = 0;
+      _total_flow = 0;
+      if (_source_num == 0 || _target_num == 0) return;
+      if (_threshold < std::numeric_limits<double>::infinity()) {
+        runSparse();
+      } else {
+        runDense();
+      }
+    }
+
+    /// @}
+
+    /// \name Query Functions
+    /// The results of the algorithm can be obtained using these
+    /// functions.\n
+    /// The \ref run() function must be called before using them.
+
+    /// @{
+
+    /// \brief Return the earth mover's distance.
+    ///
+    /// This function returns the earth mover's distance, i.e. the
+    /// minimum total cost divided by the total moved weight and the
+    /// scale factor (or zero if no weight is moved).
+    double distance() const {
+      return _total_flow == 0 ? 0.0 :
+        double(_total_cost) / (double(_total_flow) * _scale);
+    }
+
+    /// \brief Return the minimum total cost.
+    ///
+    /// This function returns the minimum total cost of moving the
+    /// weights using the rounded (and thresholded) ground distances.
+    Cost totalCost() const {
+      return _total_cost;
+    }
+
+    /// \brief Return the total moved weight.
+    ///
+    /// This function returns the total moved weight, i.e. the minimum
+    /// of the total weights of the source and the target points.
+    Value totalFlow() const {
+      return _total_flow;
+    }
+
+    /// \brief Return the number of the positive flows.
+    ///
+    /// This function returns the number of the positive flows between
+    /// the source and the target points, which is at most the total
+    /// number of the points. They can be obtained using
+    /// \ref flowSource(), \ref flowTarget() and \ref flowValue().
+    int flowNum() const {
+      return int(_flows.size());
+    }
+
+    /// \brief Return the source point of the <tt>k</tt>-th flow.
+    int flowSource(int k) const {
+      return _flows[k].source;
+    }
+
+    /// \brief Return the target point of the <tt>k</tt>-th flow.
+    int flowTarget(int k) const {
+      return _flows[k].target;
+    }
+
+    /// \brief Return the value of the <tt>k</tt>-th flow.
+    Value flowValue(int k) const {
+      return _flows[k].value;
+    }
+
+    /// @}
+
+  private:
+
+    // Store the coordinates dimension by dimension
+    template <typename WeightMap>
+    void setPoints(int num, const double* coords, const WeightMap& weights,
+                   DoubleVector& point_coords, ValueVector& point_weight) {
+      point_coords.resize(std::max(_dim * num, 1));
+      point_weight.resize(num);
+      for (int i = 0; i != num; ++i) {
+        for (int d = 0; d != _dim; ++d) {
+          point_coords[d * num + i] = coords[i * _dim + d];
+        }
+        point_weight[i] = weights[i];
+      }
+    }
+
+    void addFlow(int source, int target, Value value) {
+      Flow f;
+      f.source = source;
+      f.target = target;
+      f.value = value;
+      _flows.push_back(f);
+      _total_flow += value;
+    }
+
+    // Solve the transportation problem on the complete bipartite graph
+    // (the suppliers are the points having larger total weight)
+    void runDense() {
+      Value source_sum = 0, target_sum = 0;
+      for (int i = 0; i != _source_num; ++i) source_sum += _source_weight[i];
+      for (int j = 0; j != _target_num; ++j) target_sum += _target_weight[j];
+      bool swapped = source_sum < target_sum;
+      int row_num = swapped ? _target_num : _source_num;
+      int col_num = swapped ? _source_num : _target_num;
+
+      Distance dist(_dim, swapped ? _target_coords : _source_coords,
+                    row_num, swapped ? _source_coords : _target_coords,
+                    col_num, _ground_distance == EUCLIDEAN, _scale);
+      TransportationSimplex<V, C> ts(row_num, col_num);
+      ts.supplyMap(swapped ? _target_weight : _source_weight)
+        .demandMap(swapped ? _source_weight : _target_weight);
+      ts.run(dist, _init_method);
+
+      _total_cost = ts.totalCost();
+      for (int k = 0; k != ts.flowNum(); ++k) {
+        int i = ts.flowSupplier(k), j = ts.flowConsumer(k);
+        addFlow(swapped ? j : i, swapped ? i : j, ts.flowValue(k));
+      }
+    }
+
+    // Solve the problem with thresholded ground distances on a sparse
+    // graph: the source points are nodes 0..n-1, the target points are
+    // nodes n..n+m-1, and the transshipment node is n+m, which can be
+    // reached from each source point at the cost of the threshold, and
+    // from which each target point can be reached at zero cost
+    void runSparse() {
+      int n = _source_num, m = _target_num, t = n + m;
+      Distance dist(_dim, _source_coords, n, _target_coords, m,
+                    _ground_distance == EUCLIDEAN, _scale);
+      Cost threshold_cost = dist.round(_threshold);
+
+      std::vector<std::pair<int, int> > arcs;
+      std::vector<Cost> costs;
+      DoubleVector row(m);
+      for (int i = 0; i != n; ++i) {
+        dist.rowDistances(i, 0, m, &row[0], false);
+        for (int j = 0; j != m; ++j) {
+          if (row[j] < _threshold) {
+            arcs.push_back(std::make_pair(i, n + j));
+            costs.push_back(dist.round(row[j]));
+          }
+        }
+        arcs.push_back(std::make_pair(i, t));
+        costs.push_back(threshold_cost);
+      }
+      for (int j = 0; j != m; ++j) {
+        arcs.push_back(std::make_pair(t, n + j));
+        costs.push_back(0);
+      }
+
+      StaticDigraph g;
+      g.build(t + 1, arcs.begin(), arcs.end());
+      StaticDigraph::ArcMap<Cost> cost(g);
+      StaticDigraph::NodeMap<Value> supply(g, 0);
+      Value source_sum = 0, target_sum = 0;
+      for (int a = 0; a != int(costs.size()); ++a) {
+        cost[g.arc(a)] = costs[a];
+      }
+      for (int i = 0; i != n; ++i) {
+        supply[g.node(i)] = _source_weight[i];
+        source_sum += _source_weight[i];
+      }
+      for (int j = 0; j != m; ++j) {
+        supply[g.node(n + j)] = -_target_weight[j];
+        target_sum += _target_weight[j];
+      }
+
+      typedef NetworkSimplex<StaticDigraph, V, C> NS;
+      NS ns(g);
+      ns.costMap(cost).supplyMap(supply)
+        .supplyType(source_sum > target_sum ? NS::LEQ : NS::GEQ);
+      ns.run();
+      _total_cost = ns.totalCost();
+
+      // Store the direct flows and pair the flows through the
+      // transshipment node arbitrarily
+      std::vector<std::pair<int, Value> > in, out;
+      for (int a = 0; a != int(arcs.size()); ++a) {
+        Value f = ns.flow(g.arc(a));
+        if (f == 0) continue;
+        if (arcs[a].second == t) {
+          in.push_back(std::make_pair(arcs[a].first, f));
+        } else if (arcs[a].first == t) {
+          out.push_back(std::make_pair(arcs[a].second - n, f));
+        } else {
+          addFlow(arcs[a].first, arcs[a].second - n, f);
+        }
+      }
+      for (int p = 0, q = 0; p != int(in.size()) && q != int(out.size()); ) {
+        Value f = std::min(in[p].second, out[q].second);
+        addFlow(in[p].first, out[q].first, f);
+        if ((in[p].second -= f) == 0) ++p;
+        if ((out[q].second -= f) == 0) ++q;
+      }
+    }
+
+  }; //class EarthMoversDistance
+
+  ///@}
+
+} //namespace lemon
+
+#endif //LEMON_EARTH_MOVERS_DISTANCE_H
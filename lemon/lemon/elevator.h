@@ -976,6 +976,476 @@ namespace lemon {
   };
 
 
+  ///Class for handling "labels" in push-relabel type algorithms.
+
+  ///A class for handling "labels" in push-relabel type algorithms.
+  ///
+  ///\ingroup auxdat
+  ///This class provides the same interface and works in the same way as
+  ///\ref Elevator, but it stores its data in a structure-of-arrays
+  ///layout indexed by the ids of the items: the levels, the positions
+  ///and the active flags of the items are kept in separate compact
+  ///arrays, and the level boundaries are stored as integer positions
+  ///instead of pointers. So the typical queries of the push-relabel
+  ///algorithms (the level and the active state of the neighbors of a
+  ///node) touch only a few bytes per item, which results in better
+  ///cache behaviour on large graphs.
+  ///
+  ///\note The graph must not be changed while the elevator is in use,
+  ///since the arrays are not resized automatically (they are resized
+  ///by \ref initStart(), however).
+  ///
+  ///\sa Elevator, LinkedElevator
+  ///
+  ///\param GR Type of the underlying graph.
+  ///\param Item Type of the items the data is assigned to (\c GR::Node,
+  ///\c GR::Arc or \c GR::Edge).
+  template <class GR, class Item>
+  class CompactElevator
+  {
+  public:
+
+    typedef Item Key;
+    typedef int Value;
+
+  private:
+
+    const GR &_g;
+    int _max_level;
+    int _item_num;
+    std::vector<int> _level;
+    std::vector<int> _where;
+    std::vector<char> _active;
+    std::vector<int> _items;
+    std::vector<int> _first;
+    std::vector<int> _last_active;
+
+    int _highest_active;
+
+    int id(Item i) const { return _g.id(i); }
+    Item item(int id) const { return _g.fromId(id, Item()); }
+
+    void put(int i, int p)
+    {
+      _items[p] = i;
+      _where[i] = p;
+    }
+    void move(int s, int p)
+    {
+      if (s != p) put(_items[s], p);
+    }
+    void swap(int p, int q)
+    {
+      int ip = _items[p], iq = _items[q];
+      _items[p] = iq;
+      _where[iq] = p;
+      _items[q] = ip;
+      _where[ip] = q;
+    }
+
+    void resize()
+    {
+      int size = _g.maxId(Item()) + 1;
+      _level.resize(size, 0);
+      _where.resize(size, 0);
+      _active.resize(size, 0);
+    }
+
+  public:
+
+    ///Constructor with given maximum level.
+
+    ///Constructor with given maximum level.
+    ///
+    ///\param graph The underlying graph.
+    ///\param max_level The maximum allowed level.
+    ///Set the range of the possible labels to <tt>[0..max_level]</tt>.
+    CompactElevator(const GR &graph, int max_level) :
+      _g(graph),
+      _max_level(max_level),
+      _item_num(_max_level),
+      _items(_max_level),
+      _first(_max_level + 2),
+      _last_active(_max_level + 2),
+      _highest_active(-1)
+    {
+      resize();
+    }
+
+    ///Constructor.
+
+    ///Constructor.
+    ///
+    ///\param graph The underlying graph.
+    ///Set the range of the possible labels to <tt>[0..max_level]</tt>,
+    ///where \c max_level is equal to the number of labeled items in the graph.
+    CompactElevator(const GR &graph) :
+      _g(graph),
+      _max_level(countItems<GR, Item>(graph)),
+      _item_num(_max_level),
+      _items(_max_level),
+      _first(_max_level + 2),
+      _last_active(_max_level + 2),
+      _highest_active(-1)
+    {
+      resize();
+    }
+
+    ///Activate item \c i.
+
+    ///Activate item \c i.
+    ///\pre Item \c i shouldn't be active before.
+    void activate(Item i)
+    {
+      const int k = id(i);
+      const int l = _level[k];
+      swap(_where[k], ++_last_active[l]);
+      _active[k] = 1;
+      if (l > _highest_active) _highest_active = l;
+    }
+
+    ///Deactivate item \c i.
+
+    ///Deactivate item \c i.
+    ///\pre Item \c i must be active before.
+    void deactivate(Item i)
+    {
+      const int k = id(i);
+      swap(_where[k], _last_active[_level[k]]--);
+      _active[k] = 0;
+      while (_highest_active >= 0 &&
+             _last_active[_highest_active] < _first[_highest_active])
+        _highest_active--;
+    }
+
+    ///Query whether item \c i is active
+    bool active(Item i) const { return _active[id(i)] != 0; }
+
+    ///Return the level of item \c i.
+    int operator[](Item i) const { return _level[id(i)]; }
+
+    ///Return the number of items on level \c l.
+    int onLevel(int l) const
+    {
+      return _first[l + 1] - _first[l];
+    }
+    ///Return true if level \c l is empty.
+    bool emptyLevel(int l) const
+    {
+      return _first[l + 1] - _first[l] == 0;
+    }
+    ///Return the number of items above level \c l.
+    int aboveLevel(int l) const
+    {
+      return _first[_max_level + 1] - _first[l + 1];
+    }
+    ///Return the number of active items on level \c l.
+    int activesOnLevel(int l) const
+    {
+      return _last_active[l] - _first[l] + 1;
+    }
+    ///Return true if there is no active item on level \c l.
+    bool activeFree(int l) const
+    {
+      return _last_active[l] < _first[l];
+    }
+    ///Return the maximum allowed level.
+    int maxLevel() const
+    {
+      return _max_level;
+    }
+
+    ///\name Highest Active Item
+    ///Functions for working with the highest level
+    ///active item.
+
+    ///@{
+
+    ///Return a highest level active item.
+
+    ///Return a highest level active item or INVALID if there is no active
+    ///item.
+    Item highestActive() const
+    {
+      return _highest_active >= 0 ?
+        item(_items[_last_active[_highest_active]]) : INVALID;
+    }
+
+    ///Return the highest active level.
+
+    ///Return the level of the highest active item or -1 if there is no active
+    ///item.
+    int highestActiveLevel() const
+    {
+      return _highest_active;
+    }
+
+    ///Lift the highest active item by one.
+
+    ///Lift the item returned by highestActive() by one.
+    ///
+    void liftHighestActive()
+    {
+      int it = _items[_last_active[_highest_active]];
+      ++_level[it];
+      swap(_last_active[_highest_active]--, _last_active[_highest_active + 1]);
+      --_first[++_highest_active];
+    }
+
+    ///Lift the highest active item to the given level.
+
+    ///Lift the item returned by highestActive() to level \c new_level.
+    ///
+    ///\warning \c new_level must be strictly higher
+    ///than the current level.
+    ///
+    void liftHighestActive(int new_level)
+    {
+      const int li = _items[_last_active[_highest_active]];
+
+      move(--_first[_highest_active + 1], _last_active[_highest_active]--);
+      for (int l = _highest_active + 1; l < new_level; l++)
+        {
+          move(--_first[l + 1], _first[l]);
+          --_last_active[l];
+        }
+      put(li, _first[new_level]);
+      _level[li] = new_level;
+      _highest_active = new_level;
+    }
+
+    ///Lift the highest active item to the top level.
+
+    ///Lift the item returned by highestActive() to the top level and
+    ///deactivate it.
+    void liftHighestActiveToTop()
+    {
+      const int li = _items[_last_active[_highest_active]];
+
+      move(--_first[_highest_active + 1], _last_active[_highest_active]--);
+      for (int l = _highest_active + 1; l < _max_level; l++)
+        {
+          move(--_first[l + 1], _first[l]);
+          --_last_active[l];
+        }
+      put(li, _first[_max_level]);
+      --_last_active[_max_level];
+      _level[li] = _max_level;
+      _active[li] = 0;
+
+      while (_highest_active >= 0 &&
+             _last_active[_highest_active] < _first[_highest_active])
+        _highest_active--;
+    }
+
+    ///@}
+
+    ///\name Active Item on Certain Level
+    ///Functions for working with the active items.
+
+    ///@{
+
+    ///Return an active item on level \c l.
+
+    ///Return an active item on level \c l or \ref INVALID if there is no such
+    ///an item. (\c l must be from the range [0...\c max_level].
+    Item activeOn(int l) const
+    {
+      return _last_active[l] >= _first[l] ?
+        item(_items[_last_active[l]]) : INVALID;
+    }
+
+    ///Lift the active item returned by \c activeOn(level) by one.
+
+    ///Lift the active item returned by \ref activeOn() "activeOn(level)"
+    ///by one.
+    void liftActiveOn(int level)
+    {
+      int it = _items[_last_active[level]];
+      ++_level[it];
+      swap(_last_active[level]--, --_first[level + 1]);
+      if (level + 1 > _highest_active) ++_highest_active;
+    }
+
+    ///Lift the active item returned by \c activeOn(level) to the given level.
+
+    ///Lift the active item returned by \ref activeOn() "activeOn(level)"
+    ///to the given level.
+    void liftActiveOn(int level, int new_level)
+    {
+      const int ai = _items[_last_active[level]];
+
+      move(--_first[level + 1], _last_active[level]--);
+      for (int l = level + 1; l < new_level; l++)
+        {
+          move(_last_active[l], _first[l]);
+          move(--_first[l + 1], _last_active[l]--);
+        }
+      put(ai, _first[new_level]);
+      _level[ai] = new_level;
+      if (new_level > _highest_active) _highest_active = new_level;
+    }
+
+    ///Lift the active item returned by \c activeOn(level) to the top level.
+
+    ///Lift the active item returned by \ref activeOn() "activeOn(level)"
+    ///to the top level and deactivate it.
+    void liftActiveToTop(int level)
+    {
+      const int ai = _items[_last_active[level]];
+
+      move(--_first[level + 1], _last_active[level]--);
+      for (int l = level + 1; l < _max_level; l++)
+        {
+          move(_last_active[l], _first[l]);
+          move(--_first[l + 1], _last_active[l]--);
+        }
+      put(ai, _first[_max_level]);
+      --_last_active[_max_level];
+      _level[ai] = _max_level;
+      _active[ai] = 0;
+
+      if (_highest_active == level) {
+        while (_highest_active >= 0 &&
+               _last_active[_highest_active] < _first[_highest_active])
+          _highest_active--;
+      }
+    }
+
+    ///@}
+
+    ///Lift an active item to a higher level.
+
+    ///Lift an active item to a higher level.
+    ///\param i The item to be lifted. It must be active.
+    ///\param new_level The new level of \c i. It must be strictly higher
+    ///than the current level.
+    ///
+    void lift(Item i, int new_level)
+    {
+      const int k = id(i);
+      const int lo = _level[k];
+      const int w = _where[k];
+
+      move(_last_active[lo], w);
+      move(--_first[lo + 1], _last_active[lo]--);
+      for (int l = lo + 1; l < new_level; l++)
+        {
+          move(_last_active[l], _first[l]);
+          move(--_first[l + 1], _last_active[l]--);
+        }
+      put(k, _first[new_level]);
+      _level[k] = new_level;
+      if (new_level > _highest_active) _highest_active = new_level;
+    }
+
+    ///Move an inactive item to the top but one level (in a dirty way).
+
+    ///This function moves an inactive item from the top level to the top
+    ///but one level (in a dirty way).
+    ///\warning It makes the underlying datastructure corrupt, so use it
+    ///only if you really know what it is for.
+    ///\pre The item is on the top level.
+    void dirtyTopButOne(Item i) {
+      _level[id(i)] = _max_level - 1;
+    }
+
+    ///Lift all items on and above the given level to the top level.
+
+    ///This function lifts all items on and above level \c l to the top
+    ///level and deactivates them.
+    void liftToTop(int l)
+    {
+      const int f = _first[l];
+      const int tl = _first[_max_level];
+      for (int i = f; i != tl; ++i) {
+        _level[_items[i]] = _max_level;
+        _active[_items[i]] = 0;
+      }
+      for (int i = l; i <= _max_level; i++)
+        {
+          _first[i] = f;
+          _last_active[i] = f - 1;
+        }
+      for (_highest_active = l - 1;
+           _highest_active >= 0 &&
+             _last_active[_highest_active] < _first[_highest_active];
+           _highest_active--) ;
+    }
+
+  private:
+    int _init_lev;
+    int _init_num;
+
+  public:
+
+    ///\name Initialization
+    ///Using these functions you can initialize the levels of the items.
+    ///\n
+    ///The initialization must be started with calling \c initStart().
+    ///Then the items should be listed level by level starting with the
+    ///lowest one (level 0) using \c initAddItem() and \c initNewLevel().
+    ///Finally \c initFinish() must be called.
+    ///The items not listed are put on the highest level.
+    ///@{
+
+    ///Start the initialization process.
+    void initStart()
+    {
+      resize();
+      _init_lev = 0;
+      _init_num = 0;
+      _first[0] = 0;
+      _last_active[0] = -1;
+      int n = 0;
+      for (typename ItemSetTraits<GR,Item>::ItemIt i(_g); i != INVALID; ++i)
+        {
+          const int k = id(i);
+          put(k, n);
+          _level[k] = _max_level;
+          _active[k] = 0;
+          ++n;
+        }
+    }
+
+    ///Add an item to the current level.
+    void initAddItem(Item i)
+    {
+      const int k = id(i);
+      swap(_where[k], _init_num);
+      _level[k] = _init_lev;
+      ++_init_num;
+    }
+
+    ///Start a new level.
+
+    ///Start a new level.
+    ///It shouldn't be used before the items on level 0 are listed.
+    void initNewLevel()
+    {
+      _init_lev++;
+      _first[_init_lev] = _init_num;
+      _last_active[_init_lev] = _init_num - 1;
+    }
+
+    ///Finalize the initialization process.
+    void initFinish()
+    {
+      for (_init_lev++; _init_lev <= _max_level; _init_lev++)
+        {
+          _first[_init_lev] = _init_num;
+          _last_active[_init_lev] = _init_num - 1;
+        }
+      _first[_max_level + 1] = _item_num;
+      _last_active[_max_level + 1] = _item_num - 1;
+      _highest_active = -1;
+    }
+
+    ///@}
+
+  };
+
+
 } //END OF NAMESPACE LEMON
 
 #endif
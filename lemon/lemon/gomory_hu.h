@@ -20,9 +20,15 @@
 #define LEMON_GOMORY_HU_TREE_H
 
 #include <limits>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <utility>
 
 #include <lemon/core.h>
 #include <lemon/preflow.h>
+#include <lemon/bits/thread_pool.h>
 #include <lemon/concept_check.h>
 #include <lemon/concepts/maps.h>
 
@@ -55,6 +61,10 @@ namespace lemon {
   /// in the graph. You can also list (iterate on) the nodes and the
   /// edges of the cuts using \c MinCutNodeIt and \c MinCutEdgeIt.
   ///
+  /// The minimum cuts can be computed in parallel (see \ref threadNum()),
+  /// and \c minCutValues() answers a batch of minimum cut value queries
+  /// in constant time per query.
+  ///
   /// \tparam GR The type of the undirected graph the algorithm runs on.
   /// \tparam CAP The type of the edge map containing the capacities.
   /// The default map type is \ref concepts::Graph::EdgeMap "GR::EdgeMap<int>".
@@ -87,6 +97,17 @@ namespace lemon {
     typename Graph::template NodeMap<Value>* _weight;
     typename Graph::template NodeMap<int>* _order;
 
+    int _thread_num;
+
+    // Data of the constant time queries: the position of each node in
+    // an order of the nodes in which the minimum cut value of two nodes
+    // is the minimum of the values between them, a sparse table for
+    // the range minimum queries on these values and the floor of the
+    // binary logarithm of the possible range lengths
+    mutable typename Graph::template NodeMap<int>* _query_pos;
+    mutable std::vector<std::vector<Value> > _query_table;
+    mutable std::vector<int> _query_log;
+
     void createStructures() {
       if (!_pred) {
         _pred = new typename Graph::template NodeMap<Node>(_graph);
@@ -109,6 +130,9 @@ namespace lemon {
       if (_order) {
         delete _order;
       }
+      if (_query_pos) {
+        delete _query_pos;
+      }
     }
 
   public:
@@ -120,7 +144,7 @@ namespace lemon {
     /// \param capacity The edge capacity map.
     GomoryHu(const Graph& graph, const Capacity& capacity)
       : _graph(graph), _capacity(capacity),
-        _pred(0), _weight(0), _order(0)
+        _pred(0), _weight(0), _order(0), _thread_num(1), _query_pos(0)
     {
       checkConcept<concepts::ReadMap<Edge, Value>, Capacity>();
     }
@@ -133,6 +157,29 @@ namespace lemon {
       destroyStructures();
     }
 
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used for computing the
+    /// minimum cuts. By default, the algorithm is sequential. If the
+    /// given value is not positive, the number of hardware threads will
+    /// be used.
+    ///
+    /// The parallel version follows Gusfield's method
+    /// \cite gusfield90very (like the sequential one), but computes the
+    /// cuts of the next few nodes speculatively at the same time, each
+    /// thread using its own \ref Preflow instance on the shared graph.
+    /// Since the cut of a node depends only on its current predecessor,
+    /// the cuts are applied in the original order and a cut is
+    /// recomputed only if the predecessor of its node has been changed
+    /// by an earlier cut of the same round. Therefore the resulting tree
+    /// is the same as the one of the sequential version.
+    ///
+    /// \return <tt>(*this)</tt>
+    GomoryHu& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
   private:
 
     // Initialize the internal data structures
@@ -146,11 +193,22 @@ namespace lemon {
       }
       (*_pred)[_root] = INVALID;
       (*_weight)[_root] = std::numeric_limits<Value>::max();
+      if (_query_pos) {
+        delete _query_pos;
+        _query_pos = 0;
+      }
+      _query_table.clear();
+      _query_log.clear();
     }
 
 
     // Start the algorithm
     void start() {
+      if (_thread_num != 1) {
+        startParallel();
+        return;
+      }
+
       Preflow<Graph, Capacity> fa(_graph, _capacity, _root, INVALID);
 
       for (NodeIt n(_graph); n != INVALID; ++n) {
@@ -177,6 +235,108 @@ namespace lemon {
         }
       }
 
+      computeOrder();
+    }
+
+    // A minimum cut computed speculatively for a node: the target
+    // (the predecessor of the node at the time of the computation), the
+    // cut value and the nodes on the side of the node
+    struct SpeculativeCut {
+      bool computed;
+      Node target;
+      Value value;
+      std::vector<Node> side;
+
+      SpeculativeCut() : computed(false) {}
+    };
+
+    // Start the parallel version of the algorithm
+    void startParallel() {
+      typedef Preflow<Graph, Capacity> MaxFlow;
+
+      bits::ThreadPool pool(_thread_num);
+      const int thread_num = pool.size();
+      const int batch = 4 * thread_num;
+
+      std::vector<Node> nodes;
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        if (n != _root) nodes.push_back(n);
+      }
+
+      std::vector<MaxFlow*> flows(thread_num);
+      for (int i = 0; i != thread_num; ++i) {
+        flows[i] = new MaxFlow(_graph, _capacity, _root, INVALID);
+      }
+
+      typename Graph::template NodeMap<int> mark(_graph, 0);
+      int stamp = 0;
+      std::deque<SpeculativeCut> window;
+      int pos = 0;
+      while (pos < int(nodes.size())) {
+        const int num = std::min(batch, int(nodes.size()) - pos);
+        window.resize(num);
+
+        // Compute the missing and outdated cuts of the window
+        std::atomic<int> next(0);
+        pool.run([&](int id) {
+          MaxFlow& fa = *flows[id];
+          for (int i = next++; i < num; i = next++) {
+            SpeculativeCut& cut = window[i];
+            Node n = nodes[pos + i];
+            Node pn = (*_pred)[n];
+            if (cut.computed && cut.target == pn) continue;
+            fa.source(n);
+            fa.target(pn);
+            fa.runMinCut();
+            cut.computed = true;
+            cut.target = pn;
+            cut.value = fa.flowValue();
+            cut.side.clear();
+            for (NodeIt nn(_graph); nn != INVALID; ++nn) {
+              if (fa.minCut(nn)) cut.side.push_back(nn);
+            }
+          }
+        });
+
+        // Apply the cuts in order while they are up to date (the first
+        // one always is)
+        int k = 0;
+        for ( ; k != num; ++k) {
+          Node n = nodes[pos + k];
+          Node pn = (*_pred)[n];
+          const SpeculativeCut& cut = window[k];
+          if (cut.target != pn) break;
+
+          ++stamp;
+          (*_weight)[n] = cut.value;
+          for (int i = 0; i != int(cut.side.size()); ++i) {
+            Node nn = cut.side[i];
+            mark[nn] = stamp;
+            if (nn != n && (*_pred)[nn] == pn) {
+              (*_pred)[nn] = n;
+            }
+          }
+          if ((*_pred)[pn] != INVALID && mark[(*_pred)[pn]] == stamp) {
+            (*_pred)[n] = (*_pred)[pn];
+            (*_pred)[pn] = n;
+            (*_weight)[n] = (*_weight)[pn];
+            (*_weight)[pn] = cut.value;
+          }
+        }
+        window.erase(window.begin(), window.begin() + k);
+        pos += k;
+      }
+
+      for (int i = 0; i != thread_num; ++i) {
+        delete flows[i];
+      }
+
+      computeOrder();
+    }
+
+    // Compute the order of the nodes used by the queries (each node
+    // gets a larger index than its predecessor)
+    void computeOrder() {
       (*_order)[_root] = 0;
       int index = 1;
 
@@ -194,6 +354,65 @@ namespace lemon {
       }
     }
 
+    // Build the data of the constant time queries
+    void initQueries() const {
+      std::vector<std::pair<Value, std::pair<Node, Node> > > edges;
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        if ((*_pred)[n] != INVALID) {
+          edges.push_back(std::make_pair((*_weight)[n],
+                                         std::make_pair(n, (*_pred)[n])));
+        }
+      }
+      std::sort(edges.begin(), edges.end());
+
+      // Merge the node lists of the components along the edges in
+      // decreasing order of weights, the value between two consecutive
+      // nodes is the weight of the edge that joined their lists
+      typename Graph::template NodeMap<Node> comp(_graph), tail(_graph),
+        next(_graph, INVALID);
+      typename Graph::template NodeMap<Value> gap(_graph);
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        comp[n] = n;
+        tail[n] = n;
+      }
+      Node head = _root;
+      for (int i = int(edges.size()) - 1; i >= 0; --i) {
+        Node a = edges[i].second.first, b = edges[i].second.second;
+        while (comp[a] != a) a = comp[a] = comp[comp[a]];
+        while (comp[b] != b) b = comp[b] = comp[comp[b]];
+        next[tail[a]] = b;
+        gap[tail[a]] = edges[i].first;
+        tail[a] = tail[b];
+        comp[b] = a;
+        head = a;
+      }
+
+      _query_pos = new typename Graph::template NodeMap<int>(_graph);
+      std::vector<Value> values;
+      int index = 0;
+      for (Node n = head; n != INVALID; n = next[n]) {
+        (*_query_pos)[n] = index++;
+        if (next[n] != INVALID) values.push_back(gap[n]);
+      }
+
+      _query_table.clear();
+      _query_table.push_back(values);
+      for (int k = 1; (1 << k) <= int(values.size()); ++k) {
+        const std::vector<Value>& prev = _query_table[k - 1];
+        std::vector<Value> row(values.size() - (1 << k) + 1);
+        for (int i = 0; i != int(row.size()); ++i) {
+          Value a = prev[i], b = prev[i + (1 << (k - 1))];
+          row[i] = a < b ? a : b;
+        }
+        _query_table.push_back(row);
+      }
+
+      _query_log.assign(values.size() + 1, 0);
+      for (int l = 2; l <= int(values.size()); ++l) {
+        _query_log[l] = _query_log[l / 2] + 1;
+      }
+    }
+
   public:
 
     ///\name Execution Control
@@ -276,6 +495,45 @@ namespace lemon {
       return value;
     }
 
+    /// \brief Return the minimum cut values between the given pairs of
+    /// nodes.
+    ///
+    /// This function computes the minimum cut values between the given
+    /// pairs of nodes (see \ref minCutValue()) in constant time for each
+    /// pair.
+    ///
+    /// The first call builds the data structure of the queries in
+    /// \f$O(n\log n)\f$ time: the edges of the tree are merged in
+    /// decreasing order of their weights, which gives an order of the
+    /// nodes in which the minimum cut value of any two nodes is the
+    /// minimum of the values between them, and a sparse table answers
+    /// these range minimum queries.
+    ///
+    /// \param first, last The range of the queries (\c std::pair objects
+    /// of two nodes).
+    /// \param result The output iterator to which the values are written.
+    /// \return The output iterator after the last written value.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename PairIt, typename OutputIt>
+    OutputIt minCutValues(PairIt first, PairIt last, OutputIt result) const {
+      if (!_query_pos) initQueries();
+      for ( ; first != last; ++first, ++result) {
+        int i = (*_query_pos)[first->first];
+        int j = (*_query_pos)[first->second];
+        if (i == j) {
+          *result = std::numeric_limits<Value>::max();
+          continue;
+        }
+        if (i > j) std::swap(i, j);
+        int k = _query_log[j - i];
+        const std::vector<Value>& row = _query_table[k];
+        Value a = row[i], b = row[j - (1 << k)];
+        *result = a < b ? a : b;
+      }
+      return result;
+    }
+
     /// \brief Return the minimum cut between two nodes
     ///
     /// This function returns the minimum cut between the nodes \c s and \c t
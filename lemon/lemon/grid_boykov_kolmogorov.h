@@ -0,0 +1,652 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_GRID_BOYKOV_KOLMOGOROV_H
+#define LEMON_GRID_BOYKOV_KOLMOGOROV_H
+
+/// \ingroup max_flow
+///
+/// \file
+/// \brief Boykov-Kolmogorov max flow algorithm for grid graphs.
+
+#include <vector>
+#include <deque>
+#include <limits>
+
+#include <lemon/core.h>
+#include <lemon/grid_graph.h>
+
+namespace lemon {
+
+  /// \addtogroup max_flow
+  /// @{
+
+  /// \brief Boykov-Kolmogorov max flow algorithm for grid graphs with
+  /// terminal arcs.
+  ///
+  /// This class implements the augmenting path algorithm of Boykov and
+  /// Kolmogorov \cite boykov04experimental for the max flow problems
+  /// arising in image segmentation: the nodes of a \ref GridGraph are
+  /// connected to their four neighbors by the (directed) arcs of the
+  /// grid, and each node has an arc from the source and an arc to the
+  /// sink. The source and the sink are not nodes of the grid, their
+  /// arcs are given by two node maps.
+  ///
+  /// The algorithm grows a search tree from the source and one from
+  /// the sink, augments along the paths found between the trees and
+  /// repairs the trees after each augmentation, so it does not start
+  /// the search from scratch in each phase. On such graphs the paths
+  /// are short and this method is usually much faster than \ref
+  /// Preflow.
+  ///
+  /// The graph is not stored explicitly, the neighbors of a node are
+  /// computed from its index. The residual capacities are stored in
+  /// four arrays, one for each direction, indexed by the node ids
+  /// (i.e. in row-major order), and the two terminal arcs of a node are
+  /// represented by a single signed residual capacity.
+  ///
+  /// The class also supports solving a sequence of similar problems
+  /// (e.g. the frames of a video): after \ref run(), the capacities can
+  /// be changed with \ref capacity() and \ref terminalCapacities(), and
+  /// the next \ref run() continues from the current flow and search
+  /// trees, repairing only the parts affected by the changes
+  /// \cite kohli05efficiently. Decreasing a capacity below the current
+  /// flow is handled by reparameterization, which shifts the value of
+  /// all cuts by the same amount, so the flow itself is not available,
+  /// only its value and the minimum cut.
+  ///
+  /// \tparam V The number type of the capacities. The default type is
+  /// \c int. Both integer and real types are supported, but in the
+  /// latter case rounding errors may affect the result.
+  template <typename V = int>
+  class GridBoykovKolmogorov {
+  public:
+
+    /// The type of the capacities
+    typedef V Value;
+
+  private:
+
+    TEMPLATE_GRAPH_TYPEDEFS(GridGraph);
+
+    typedef std::vector<Value> ValueVector;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<char> CharVector;
+
+    // Directions of the arcs (the opposite of d is d ^ 1)
+    enum { RIGHT = 0, LEFT = 1, UP = 2, DOWN = 3 };
+
+    // Special values of the parent directions
+    enum { TERMINAL = 4, ORPHAN = 5, FREE = 6 };
+
+    const GridGraph& _graph;
+    int _width;
+    int _node_num;
+    int _offset[4];
+
+    // Capacities of the current problem
+    ValueVector _cap[4];
+    ValueVector _source_cap;
+    ValueVector _sink_cap;
+
+    // Residual capacities of the grid arcs by directions, and the
+    // residual capacity of the source arc (if positive) or the sink arc
+    // (if negative) of each node
+    ValueVector _res[4];
+    ValueVector _tr;
+
+    // Existing neighbors of the nodes (one bit for each direction)
+    CharVector _dirs;
+
+    // The search trees: the direction of the parent (or a special
+    // value), the tree of the node, and the data of the distance
+    // heuristic of the adoption
+    CharVector _parent;
+    CharVector _in_sink;
+    IntVector _ts;
+    IntVector _dist;
+    int _time;
+
+    CharVector _active;
+    std::deque<int> _queue;
+    std::deque<int> _orphans;
+
+    // Nodes whose capacities are changed after the last run
+    CharVector _marked;
+    IntVector _changed;
+    bool _fresh;
+
+    Value _flow_value;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Constructor. All capacities are initialized to zero.
+    /// \param graph The grid graph the algorithm runs on.
+    GridBoykovKolmogorov(const GridGraph& graph)
+      : _graph(graph), _width(graph.width()),
+        _node_num(graph.width() * graph.height()),
+        _flow_value(0)
+    {
+      _offset[RIGHT] = 1;
+      _offset[LEFT] = -1;
+      _offset[UP] = _width;
+      _offset[DOWN] = -_width;
+      for (int d = 0; d != 4; ++d) {
+        _cap[d].assign(_node_num, 0);
+        _res[d].assign(_node_num, 0);
+      }
+      _source_cap.assign(_node_num, 0);
+      _sink_cap.assign(_node_num, 0);
+      _tr.assign(_node_num, 0);
+      _dirs.assign(_node_num, 0);
+      for (int v = 0; v != _node_num; ++v) {
+        int col = v % _width, row = v / _width;
+        char dirs = 0;
+        if (col != _width - 1) dirs |= 1 << RIGHT;
+        if (col != 0) dirs |= 1 << LEFT;
+        if (v + _width < _node_num) dirs |= 1 << UP;
+        if (row != 0) dirs |= 1 << DOWN;
+        _dirs[v] = dirs;
+      }
+      _parent.assign(_node_num, FREE);
+      _in_sink.assign(_node_num, 0);
+      _ts.assign(_node_num, 0);
+      _dist.assign(_node_num, 0);
+      _active.assign(_node_num, 0);
+      _marked.assign(_node_num, 0);
+      _fresh = true;
+    }
+
+    /// \brief Set the capacities of the grid arcs.
+    ///
+    /// This function sets the capacities of all arcs of the grid.
+    /// The next \ref run() starts from scratch.
+    /// \return <tt>(*this)</tt>
+    template <typename CapacityMap>
+    GridBoykovKolmogorov& capacityMap(const CapacityMap& map) {
+      for (int v = 0; v != _node_num; ++v) {
+        Node n = _graph.nodeFromId(v);
+        char dirs = _dirs[v];
+        _cap[RIGHT][v] = dirs & (1 << RIGHT) ? map[_graph.right(n)] : 0;
+        _cap[LEFT][v] = dirs & (1 << LEFT) ? map[_graph.left(n)] : 0;
+        _cap[UP][v] = dirs & (1 << UP) ? map[_graph.up(n)] : 0;
+        _cap[DOWN][v] = dirs & (1 << DOWN) ? map[_graph.down(n)] : 0;
+      }
+      _fresh = true;
+      return *this;
+    }
+
+    /// \brief Set the capacities of the terminal arcs.
+    ///
+    /// This function sets the capacities of the arcs from the source
+    /// and to the sink for all nodes. The next \ref run() starts from
+    /// scratch.
+    /// \return <tt>(*this)</tt>
+    template <typename SourceMap, typename SinkMap>
+    GridBoykovKolmogorov& terminalMaps(const SourceMap& source,
+                                       const SinkMap& sink) {
+      for (int v = 0; v != _node_num; ++v) {
+        Node n = _graph.nodeFromId(v);
+        _source_cap[v] = source[n];
+        _sink_cap[v] = sink[n];
+      }
+      _fresh = true;
+      return *this;
+    }
+
+    /// \brief Change the capacity of a grid arc.
+    ///
+    /// This function changes the capacity of the given arc. The search
+    /// trees and the flow of the previous run are kept, so the next
+    /// \ref run() only repairs them around the changed arcs.
+    void capacity(const Arc& arc, Value cap) {
+      int u = _graph.id(_graph.source(arc));
+      int v = _graph.id(_graph.target(arc));
+      int d = v - u == _width ? UP : (v - u == -_width ? DOWN :
+                                      (v > u ? RIGHT : LEFT));
+      Value delta = cap - _cap[d][u];
+      _cap[d][u] = cap;
+      if (_fresh) return;
+      Value r = _res[d][u] + delta;
+      if (r < 0) {
+        // Decrease the flow on the arc to the new capacity and
+        // reparameterize the terminal arcs of the endpoints
+        _res[d][u] = 0;
+        _res[d ^ 1][v] += r;
+        _tr[u] -= r;
+        _tr[v] += r;
+      } else {
+        _res[d][u] = r;
+      }
+      mark(u);
+      mark(v);
+    }
+
+    /// \brief Change the capacities of the terminal arcs of a node.
+    ///
+    /// This function changes the capacities of the arcs from the source
+    /// and to the sink at the given node. The search trees and the flow
+    /// of the previous run are kept, so the next \ref run() only
+    /// repairs them around the changed nodes.
+    void terminalCapacities(const Node& node, Value source, Value sink) {
+      int v = _graph.id(node);
+      Value delta = (source - _source_cap[v]) - (sink - _sink_cap[v]);
+      _source_cap[v] = source;
+      _sink_cap[v] = sink;
+      if (_fresh) return;
+      _tr[v] += delta;
+      mark(v);
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm. The first call (and the first
+    /// call after \ref capacityMap() or \ref terminalMaps()) starts
+    /// from scratch, the later calls reuse the search trees and the
+    /// flow of the previous run.
+    void run() {
+      if (_fresh) {
+        init();
+      } else {
+        reuseTrees();
+      }
+      adopt();
+      augmentAll();
+      _flow_value = cutValue();
+    }
+
+    /// \brief Return the value of the maximum flow.
+    ///
+    /// This function returns the value of the maximum flow (which is
+    /// the capacity of the minimum cut) with respect to the current
+    /// capacities.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Value flowValue() const {
+      return _flow_value;
+    }
+
+    /// \brief Return \c true if the given node is on the source side
+    /// of the minimum cut.
+    ///
+    /// This function returns \c true if the given node is on the source
+    /// side of the minimum cut found by the algorithm, i.e. it is
+    /// reachable from the source in the residual graph.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    bool minCut(const Node& node) const {
+      return inSource(_graph.id(node));
+    }
+
+    /// \brief Give back a minimum cut.
+    ///
+    /// This function sets \c cutMap to the characteristic vector of the
+    /// source side of the minimum cut (see \ref minCut()).
+    ///
+    /// \param cutMap A \ref concepts::WriteMap "writable" node map with
+    /// \c bool (or convertible) value type.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    template <typename CutMap>
+    void minCutMap(CutMap& cutMap) const {
+      for (int v = 0; v != _node_num; ++v) {
+        cutMap.set(_graph.nodeFromId(v), inSource(v));
+      }
+    }
+
+  private:
+
+    bool inSource(int v) const {
+      return _parent[v] != FREE && !_in_sink[v];
+    }
+
+    void mark(int v) {
+      if (!_marked[v]) {
+        _marked[v] = 1;
+        _changed.push_back(v);
+      }
+    }
+
+    void setActive(int v) {
+      if (!_active[v]) {
+        _active[v] = 1;
+        _queue.push_back(v);
+      }
+    }
+
+    int nextActive() {
+      while (!_queue.empty()) {
+        int v = _queue.front();
+        _queue.pop_front();
+        _active[v] = 0;
+        if (_parent[v] != FREE) return v;
+      }
+      return -1;
+    }
+
+    // Check if the parent of v is u
+    bool isChild(int v, int u) const {
+      return _parent[v] < TERMINAL && v + _offset[int(_parent[v])] == u;
+    }
+
+    // Build the residual graph and the initial trees from the
+    // capacities
+    void init() {
+      for (int d = 0; d != 4; ++d) {
+        const Value *cap = &_cap[d][0];
+        Value *res = &_res[d][0];
+        for (int v = 0; v != _node_num; ++v) res[v] = cap[v];
+      }
+      _queue.clear();
+      _orphans.clear();
+      _time = 0;
+      for (int v = 0; v != _node_num; ++v) {
+        _tr[v] = _source_cap[v] - _sink_cap[v];
+        _active[v] = 0;
+        _marked[v] = 0;
+        _ts[v] = 0;
+        _dist[v] = 1;
+        if (_tr[v] != 0) {
+          _parent[v] = TERMINAL;
+          _in_sink[v] = _tr[v] < 0;
+          setActive(v);
+        } else {
+          _parent[v] = FREE;
+        }
+      }
+      _changed.clear();
+      _fresh = false;
+    }
+
+    // Repair the search trees at the changed nodes: the nodes with
+    // a positive (negative) terminal residual capacity become children
+    // of the source (sink), the others become orphans
+    void reuseTrees() {
+      ++_time;
+      for (int k = 0; k != int(_changed.size()); ++k) {
+        int v = _changed[k];
+        _marked[v] = 0;
+        setActive(v);
+        if (_tr[v] == 0) {
+          if (_parent[v] != FREE && _parent[v] != ORPHAN) {
+            _parent[v] = ORPHAN;
+            _orphans.push_back(v);
+          }
+          continue;
+        }
+        bool sink = _tr[v] < 0;
+        if (_parent[v] == FREE || _parent[v] == ORPHAN ||
+            bool(_in_sink[v]) != sink) {
+          // The node changes its tree, its children become orphans
+          // and the neighbors of the other tree become active
+          char dirs = _dirs[v];
+          for (int d = 0; d != 4; ++d) {
+            if (!(dirs & (1 << d))) continue;
+            int w = v + _offset[d];
+            if (_marked[w]) continue;
+            if (isChild(w, v)) {
+              _parent[w] = ORPHAN;
+              _orphans.push_back(w);
+            }
+            if (_parent[w] != FREE && bool(_in_sink[w]) != sink &&
+                (sink ? _res[d ^ 1][w] : _res[d][v]) > 0) {
+              setActive(w);
+            }
+          }
+          _in_sink[v] = sink;
+        }
+        _parent[v] = TERMINAL;
+        _ts[v] = _time;
+        _dist[v] = 1;
+      }
+      _changed.clear();
+    }
+
+    // The main loop of the algorithm: grow the trees from the active
+    // nodes and augment along the paths found between them
+    void augmentAll() {
+      int cur = -1;
+      while (true) {
+        int v = cur;
+        if (v >= 0 && _parent[v] == FREE) v = -1;
+        if (v < 0) {
+          v = nextActive();
+          if (v < 0) break;
+        }
+
+        // Grow the tree of v
+        int a = -1, ad = 0;
+        char dirs = _dirs[v];
+        if (!_in_sink[v]) {
+          for (int d = 0; d != 4; ++d) {
+            if (!(_res[d][v] > 0)) continue;
+            int w = v + _offset[d];
+            if (_parent[w] == FREE) {
+              _in_sink[w] = 0;
+              _parent[w] = d ^ 1;
+              _ts[w] = _ts[v];
+              _dist[w] = _dist[v] + 1;
+              setActive(w);
+            } else if (_in_sink[w]) {
+              a = v;
+              ad = d;
+              break;
+            } else if (_ts[w] <= _ts[v] && _dist[w] > _dist[v]) {
+              _parent[w] = d ^ 1;
+              _ts[w] = _ts[v];
+              _dist[w] = _dist[v] + 1;
+            }
+          }
+        } else {
+          for (int d = 0; d != 4; ++d) {
+            if (!(dirs & (1 << d))) continue;
+            int w = v + _offset[d];
+            if (!(_res[d ^ 1][w] > 0)) continue;
+            if (_parent[w] == FREE) {
+              _in_sink[w] = 1;
+              _parent[w] = d ^ 1;
+              _ts[w] = _ts[v];
+              _dist[w] = _dist[v] + 1;
+              setActive(w);
+            } else if (!_in_sink[w]) {
+              a = w;
+              ad = d ^ 1;
+              break;
+            } else if (_ts[w] <= _ts[v] && _dist[w] > _dist[v]) {
+              _parent[w] = d ^ 1;
+              _ts[w] = _ts[v];
+              _dist[w] = _dist[v] + 1;
+            }
+          }
+        }
+
+        ++_time;
+        if (a >= 0) {
+          // Keep v as the current node, since it may have more
+          // paths to the other tree
+          cur = v;
+          augment(a, ad);
+          adopt();
+        } else {
+          cur = -1;
+        }
+      }
+    }
+
+    // Augment along the path through the arc from a in direction d
+    // (a is in the source tree, its neighbor is in the sink tree)
+    void augment(int a, int d) {
+      int b = a + _offset[d];
+
+      // Find the bottleneck capacity
+      Value delta = _res[d][a];
+      for (int x = a; ; ) {
+        int p = _parent[x];
+        if (p == TERMINAL) {
+          if (_tr[x] < delta) delta = _tr[x];
+          break;
+        }
+        int y = x + _offset[p];
+        if (_res[p ^ 1][y] < delta) delta = _res[p ^ 1][y];
+        x = y;
+      }
+      for (int x = b; ; ) {
+        int p = _parent[x];
+        if (p == TERMINAL) {
+          if (-_tr[x] < delta) delta = -_tr[x];
+          break;
+        }
+        if (_res[p][x] < delta) delta = _res[p][x];
+        x += _offset[p];
+      }
+
+      // Push the flow and collect the orphans
+      _res[d][a] -= delta;
+      _res[d ^ 1][b] += delta;
+      for (int x = a; ; ) {
+        int p = _parent[x];
+        if (p == TERMINAL) {
+          _tr[x] -= delta;
+          if (!(_tr[x] > 0)) setOrphan(x);
+          break;
+        }
+        int y = x + _offset[p];
+        _res[p ^ 1][y] -= delta;
+        _res[p][x] += delta;
+        if (!(_res[p ^ 1][y] > 0)) setOrphan(x);
+        x = y;
+      }
+      for (int x = b; ; ) {
+        int p = _parent[x];
+        if (p == TERMINAL) {
+          _tr[x] += delta;
+          if (!(_tr[x] < 0)) setOrphan(x);
+          break;
+        }
+        int y = x + _offset[p];
+        _res[p][x] -= delta;
+        _res[p ^ 1][y] += delta;
+        if (!(_res[p][x] > 0)) setOrphan(x);
+        x = y;
+      }
+    }
+
+    void setOrphan(int v) {
+      _parent[v] = ORPHAN;
+      _orphans.push_front(v);
+    }
+
+    // Find a new parent for each orphan or make it free
+    void adopt() {
+      const int INF = std::numeric_limits<int>::max();
+      while (!_orphans.empty()) {
+        int v = _orphans.front();
+        _orphans.pop_front();
+        bool sink = _in_sink[v];
+        char dirs = _dirs[v];
+
+        // Look for the neighbor with the shortest valid path to the
+        // root of the tree
+        int best = -1, best_dist = INF;
+        for (int d = 0; d != 4; ++d) {
+          if (!(dirs & (1 << d))) continue;
+          int w = v + _offset[d];
+          if (_parent[w] == FREE || bool(_in_sink[w]) != sink) continue;
+          if (!((sink ? _res[d][v] : _res[d ^ 1][w]) > 0)) continue;
+          int dist = 0;
+          for (int k = w; ; ) {
+            if (_ts[k] == _time) {
+              dist += _dist[k];
+              break;
+            }
+            int p = _parent[k];
+            ++dist;
+            if (p == TERMINAL) {
+              _ts[k] = _time;
+              _dist[k] = 1;
+              break;
+            }
+            if (p == ORPHAN) {
+              dist = INF;
+              break;
+            }
+            k += _offset[p];
+          }
+          if (dist == INF) continue;
+          if (dist < best_dist) {
+            best = d;
+            best_dist = dist;
+          }
+          for (int k = w; _ts[k] != _time; k += _offset[int(_parent[k])]) {
+            _ts[k] = _time;
+            _dist[k] = dist--;
+          }
+        }
+
+        if (best >= 0) {
+          _parent[v] = best;
+          _ts[v] = _time;
+          _dist[v] = best_dist + 1;
+          continue;
+        }
+
+        // No parent is found: make v free, its children orphans and
+        // the neighbors that can reach it active
+        for (int d = 0; d != 4; ++d) {
+          if (!(dirs & (1 << d))) continue;
+          int w = v + _offset[d];
+          if (_parent[w] == FREE || bool(_in_sink[w]) != sink) continue;
+          if ((sink ? _res[d][v] : _res[d ^ 1][w]) > 0) setActive(w);
+          if (isChild(w, v)) {
+            _parent[w] = ORPHAN;
+            _orphans.push_back(w);
+          }
+        }
+        _parent[v] = FREE;
+      }
+    }
+
+    // Compute the capacity of the cut given by the source tree with
+    // respect to the current capacities
+    Value cutValue() const {
+      Value c = 0;
+      for (int v = 0; v != _node_num; ++v) {
+        if (inSource(v)) {
+          c += _sink_cap[v];
+          char dirs = _dirs[v];
+          for (int d = 0; d != 4; ++d) {
+            if ((dirs & (1 << d)) && !inSource(v + _offset[d])) {
+              c += _cap[d][v];
+            }
+          }
+        } else {
+          c += _source_cap[v];
+        }
+      }
+      return c;
+    }
+
+  }; //class GridBoykovKolmogorov
+
+  /// @}
+
+} //namespace lemon
+
+#endif //LEMON_GRID_BOYKOV_KOLMOGOROV_H
@@ -0,0 +1,306 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_JONKER_VOLGENANT_H
+#define LEMON_JONKER_VOLGENANT_H
+
+/// \ingroup matching
+///
+/// \file
+/// \brief Jonker-Volgenant algorithm for dense assignment problems.
+
+#include <vector>
+#include <limits>
+
+#include <lemon/core.h>
+
+namespace lemon {
+
+  /// \addtogroup matching
+  /// @{
+
+  /// \brief Jonker-Volgenant algorithm for dense assignment problems.
+  ///
+  /// \ref JonkerVolgenant implements the shortest augmenting path
+  /// algorithm of Jonker and Volgenant \cite jonker87shortest for
+  /// finding a minimum cost perfect matching of the rows and columns of
+  /// a square cost matrix (i.e. in a complete bipartite graph). The
+  /// matrix is used directly, no graph is built.
+  ///
+  /// The initial dual solution and partial assignment are obtained by
+  /// column reduction and reduction transfer, then each free row is
+  /// assigned by finding a shortest augmenting path with a dense
+  /// version of Dijkstra's algorithm. The inner loops of these steps
+  /// scan a row (or the minima of the columns) without branches on the
+  /// column lists, so they can be vectorized by the compiler.
+  /// The running time is <tt>O(n<sup>3</sup>)</tt> in the worst case.
+  ///
+  /// \tparam C The number type of the costs. The default type is \c int.
+  /// Both integer and real types are supported.
+  template <typename C = int>
+  class JonkerVolgenant
+  {
+  public:
+
+    /// The type of the costs
+    typedef C Cost;
+
+  private:
+
+    typedef std::vector<int> IntVector;
+    typedef std::vector<Cost> CostVector;
+
+    int _n;
+    const Cost *_cost;
+
+    // The assignment and the dual solution
+    IntVector _row_mate;
+    IntVector _col_mate;
+    CostVector _u;
+    CostVector _v;
+
+    // Data of the shortest path computations
+    CostVector _dist;
+    IntVector _pred;
+    std::vector<char> _scanned;
+    IntVector _scanned_rows;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param n The number of rows and columns of the matrix.
+    /// \param cost The cost matrix in row-major order (i.e. the cost of
+    /// row \c i and column \c j is <tt>cost[i * n + j]</tt>). It is not
+    /// copied, so it must be kept valid while the algorithm is used.
+    JonkerVolgenant(int n, const Cost* cost) : _n(n), _cost(cost) {}
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    void run() {
+      _row_mate.assign(_n, -1);
+      _col_mate.assign(_n, -1);
+      _u.assign(_n, 0);
+      _v.assign(_n, 0);
+      if (_n == 0) return;
+      columnReduction();
+      reductionTransfer();
+      _dist.resize(_n);
+      _pred.resize(_n);
+      _scanned.resize(_n);
+      for (int i = 0; i != _n; ++i) {
+        if (_row_mate[i] == -1) augment(i);
+      }
+    }
+
+    /// \brief Return the column assigned to the given row.
+    int rowMate(int row) const {
+      return _row_mate[row];
+    }
+
+    /// \brief Return the row assigned to the given column.
+    int colMate(int col) const {
+      return _col_mate[col];
+    }
+
+    /// \brief Return the potential of the given row.
+    ///
+    /// This function returns the potential (dual value) of the given
+    /// row. The potentials satisfy <tt>cost(i, j) - rowPotential(i) -
+    /// colPotential(j) >= 0</tt> for all cells with equality for the
+    /// assigned ones.
+    Cost rowPotential(int row) const {
+      return _u[row];
+    }
+
+    /// \brief Return the potential of the given column.
+    ///
+    /// This function returns the potential (dual value) of the given
+    /// column (see \ref rowPotential()).
+    Cost colPotential(int col) const {
+      return _v[col];
+    }
+
+    /// \brief Return the total cost of the assignment.
+    ///
+    /// This function returns the total cost of the assignment.
+    ///
+    /// \note The return type of the function can be specified as a
+    /// template parameter.
+    template <typename Number>
+    Number totalCost() const {
+      Number c = 0;
+      for (int i = 0; i != _n; ++i) {
+        c += static_cast<Number>(_cost[i * static_cast<long long>(_n) +
+                                       _row_mate[i]]);
+      }
+      return c;
+    }
+
+#ifndef DOXYGEN
+    Cost totalCost() const {
+      return totalCost<Cost>();
+    }
+#endif
+
+  private:
+
+    const Cost* row(int i) const {
+      return _cost + i * static_cast<long long>(_n);
+    }
+
+    // Set the potential of each column to its minimum cost, and assign
+    // it to the row of the minimum if that row is still free (the
+    // columns are processed in reverse order, as in the original code)
+    void columnReduction() {
+      const int n = _n;
+      IntVector min_row(n, 0);
+      Cost *v = &_v[0];
+      int *mr = &min_row[0];
+      const Cost *c0 = row(0);
+      for (int j = 0; j != n; ++j) v[j] = c0[j];
+      for (int i = 1; i != n; ++i) {
+        const Cost *c = row(i);
+        for (int j = 0; j != n; ++j) {
+          bool smaller = c[j] < v[j];
+          v[j] = smaller ? c[j] : v[j];
+          mr[j] = smaller ? i : mr[j];
+        }
+      }
+      for (int j = n - 1; j >= 0; --j) {
+        int i = min_row[j];
+        if (_row_mate[i] == -1) {
+          _row_mate[i] = j;
+          _col_mate[j] = i;
+        }
+      }
+    }
+
+    // Transfer the reduction from the assigned column of each assigned
+    // row to the row potential (the reduced cost of the assigned cell
+    // remains zero, the others remain non-negative)
+    void reductionTransfer() {
+      const int n = _n;
+      if (n == 1) return;
+      for (int i = 0; i != n; ++i) {
+        int j1 = _row_mate[i];
+        if (j1 == -1) continue;
+        const Cost *c = row(i);
+        const Cost *v = &_v[0];
+        Cost mu = std::numeric_limits<Cost>::max();
+        for (int j = 0; j != j1; ++j) {
+          Cost r = c[j] - v[j];
+          mu = r < mu ? r : mu;
+        }
+        for (int j = j1 + 1; j != n; ++j) {
+          Cost r = c[j] - v[j];
+          mu = r < mu ? r : mu;
+        }
+        _v[j1] = c[j1] - mu;
+        _u[i] = mu;
+      }
+    }
+
+    // Assign the free row r by finding a shortest augmenting path in
+    // the residual graph with respect to the reduced costs, and update
+    // the potentials
+    void augment(int r) {
+      const Cost INF = std::numeric_limits<Cost>::has_infinity ?
+        std::numeric_limits<Cost>::infinity() :
+        std::numeric_limits<Cost>::max();
+      const int n = _n;
+      Cost *dist = &_dist[0];
+      int *pred = &_pred[0];
+      char *scanned = &_scanned[0];
+      const Cost *v = &_v[0];
+      for (int j = 0; j != n; ++j) {
+        dist[j] = INF;
+        scanned[j] = 0;
+      }
+      _scanned_rows.clear();
+
+      int i = r, sink = -1;
+      Cost min_dist = 0;
+      while (sink == -1) {
+        _scanned_rows.push_back(i);
+
+        // Relax the cells of the row i
+        const Cost *c = row(i);
+        Cost base = min_dist - _u[i];
+        for (int j = 0; j != n; ++j) {
+          Cost d = base + c[j] - v[j];
+          bool better = (scanned[j] == 0) & (d < dist[j]);
+          dist[j] = better ? d : dist[j];
+          pred[j] = better ? i : pred[j];
+        }
+
+        // Find the closest unscanned column (preferring free columns)
+        Cost best_dist = INF;
+        for (int j = 0; j != n; ++j) {
+          Cost d = scanned[j] ? INF : dist[j];
+          best_dist = d < best_dist ? d : best_dist;
+        }
+        int best = -1;
+        for (int j = 0; j != n; ++j) {
+          if (scanned[j] || dist[j] != best_dist) continue;
+          if (best == -1) best = j;
+          if (_col_mate[j] == -1) {
+            best = j;
+            break;
+          }
+        }
+        min_dist = best_dist;
+        scanned[best] = 1;
+        if (_col_mate[best] == -1) {
+          sink = best;
+        } else {
+          i = _col_mate[best];
+        }
+      }
+
+      // Update the potentials
+      _u[r] += min_dist;
+      for (int k = 1; k < int(_scanned_rows.size()); ++k) {
+        int s = _scanned_rows[k];
+        _u[s] += min_dist - _dist[_row_mate[s]];
+      }
+      for (int j = 0; j != n; ++j) {
+        if (scanned[j] && j != sink) _v[j] -= min_dist - dist[j];
+      }
+
+      // Augment along the path
+      for (int j = sink; ; ) {
+        int p = _pred[j];
+        _col_mate[j] = p;
+        int next = _row_mate[p];
+        _row_mate[p] = j;
+        if (p == r) break;
+        j = next;
+      }
+    }
+
+  }; //class JonkerVolgenant
+
+  /// @}
+
+} //namespace lemon
+
+#endif //LEMON_JONKER_VOLGENANT_H
@@ -27,9 +27,11 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <utility>
 
 #include <lemon/core.h>
 #include <lemon/math.h>
+#include <lemon/time_measure.h>
 
 namespace lemon {
 
@@ -97,7 +99,14 @@ namespace lemon {
       /// The objective function of the problem is unbounded, i.e.
       /// there is a directed cycle having negative total cost and
       /// infinite upper bound.
-      UNBOUNDED
+      UNBOUNDED,
+      /// The time limit was reached after finding a feasible flow
+      /// (see \ref timeLimit()). The found flow is feasible, but it is
+      /// not necessarily optimal.
+      FEASIBLE,
+      /// The time limit was reached before finding a feasible flow
+      /// (see \ref timeLimit()).
+      UNDEFINED
     };
 
     /// \brief Constants for selecting the type of the supply constraints.
@@ -234,6 +243,20 @@ namespace lemon {
     int in_arc, join, u_in, v_in, u_out, v_out;
     Value delta;
 
+    // Data related to the time limit and the progress of the algorithm
+    double _time_limit;
+    Timer _timer;
+    int _time_check_interval;
+    int _time_check_count;
+    double _time_check_last;
+    int _art_flow_num;
+    int _pivot_num;
+    double _feasible_time;
+
+    // Indicate if the spanning tree of the last run can be used for
+    // continuing the algorithm (see resume())
+    bool _has_basis;
+
     const Value MAX;
 
   public:
@@ -660,6 +683,7 @@ namespace lemon {
         "The cost type of NetworkSimplex must be signed");
 
       // Reset data structures
+      _time_limit = 0;
       reset();
     }
 
@@ -683,6 +707,7 @@ namespace lemon {
     template <typename LowerMap>
     NetworkSimplex& lowerMap(const LowerMap& map) {
       _has_lower = true;
+      _has_basis = false;
       for (ArcIt a(_graph); a != INVALID; ++a) {
         _lower[_arc_id[a]] = map[a];
       }
@@ -703,6 +728,7 @@ namespace lemon {
     /// \return <tt>(*this)</tt>
     template<typename UpperMap>
     NetworkSimplex& upperMap(const UpperMap& map) {
+      _has_basis = false;
       for (ArcIt a(_graph); a != INVALID; ++a) {
         _upper[_arc_id[a]] = map[a];
       }
@@ -743,6 +769,7 @@ namespace lemon {
     /// \sa supplyType()
     template<typename SupplyMap>
     NetworkSimplex& supplyMap(const SupplyMap& map) {
+      _has_basis = false;
       for (NodeIt n(_graph); n != INVALID; ++n) {
         _supply[_node_id[n]] = map[n];
       }
@@ -767,6 +794,7 @@ namespace lemon {
     ///
     /// \return <tt>(*this)</tt>
     NetworkSimplex& stSupply(const Node& s, const Node& t, Value k) {
+      _has_basis = false;
       for (int i = 0; i != _node_num; ++i) {
         _supply[i] = 0;
       }
@@ -786,6 +814,112 @@ namespace lemon {
     /// \return <tt>(*this)</tt>
     NetworkSimplex& supplyType(SupplyType supply_type) {
       _stype = supply_type;
+      _has_basis = false;
+      return *this;
+    }
+
+    /// \brief Set the time limit.
+    ///
+    /// This function sets a time limit (in seconds) for the algorithm
+    /// (i.e. it can be used as an \e anytime algorithm).
+    /// If the time limit is reached, \ref run() stops and returns
+    /// \c FEASIBLE if a feasible flow has already been found (the
+    /// artificial arcs of the initial spanning tree have left the basis),
+    /// and \c UNDEFINED otherwise.
+    /// In the former case, the query functions can be used to obtain
+    /// the current (feasible but not necessarily optimal) flow, its cost
+    /// and a lower bound for the optimal cost (see \ref dualBound()).
+    ///
+    /// The time limit is checked after each pivot (including the
+    /// heuristic initial pivots), but the clock is read less frequently
+    /// if the pivots are fast, so the limit may be exceeded by about a
+    /// millisecond or by the time of a single pivot.
+    ///
+    /// The time limit is not reset by \ref resetParams() and \ref reset().
+    ///
+    /// \param limit The time limit in seconds. If it is not positive
+    /// (which is the default), then the algorithm runs until it finds an
+    /// optimal solution.
+    ///
+    /// \return <tt>(*this)</tt>
+    NetworkSimplex& timeLimit(double limit) {
+      _time_limit = limit;
+      return *this;
+    }
+
+    /// \brief Add a new arc to the problem.
+    ///
+    /// This function adds an arc to the problem, which has been added
+    /// to the underlying digraph after the construction of the class
+    /// (or the last \ref reset() call), without rebuilding the internal
+    /// data structures. The arc must connect existing nodes, and its
+    /// parameters are given directly instead of using the maps.
+    ///
+    /// The new arc is non-basic at its lower bound in the current
+    /// spanning tree, so \ref resume() can continue the algorithm from
+    /// the current basis, e.g. in column generation methods, where a few
+    /// arcs having negative reduced costs are added in each iteration.
+    /// For example,
+    /// \code
+    ///   NetworkSimplex<ListDigraph> ns(graph);
+    ///   ns.upperMap(upper).costMap(cost).supplyMap(sup).run();
+    ///   while (...) {
+    ///     // Add new arcs having negative reduced costs
+    ///     ListDigraph::Arc a = graph.addArc(u, v);
+    ///     ns.addArc(a, 0, cap, c);
+    ///     ...
+    ///     ns.resume();
+    ///   }
+    /// \endcode
+    ///
+    /// \param a The new arc.
+    /// \param lower The lower bound of the arc. If it is not zero, then
+    /// the current basis cannot be used, so the next call of
+    /// \ref resume() solves the problem from scratch.
+    /// \param upper The upper bound (capacity) of the arc.
+    /// \param cost The cost of the arc.
+    ///
+    /// \return <tt>(*this)</tt>
+    NetworkSimplex& addArc(const Arc& a, Value lower, Value upper,
+                           Cost cost) {
+      int max_arc_num = _arc_num + 2 * _node_num + 1;
+      if (int(_source.size()) < max_arc_num) {
+        _source.resize(max_arc_num);
+        _target.resize(max_arc_num);
+        _cap.resize(max_arc_num);
+        _cost.resize(max_arc_num);
+        _flow.resize(max_arc_num);
+        _state.resize(max_arc_num);
+      }
+
+      // Move the first artificial arcs of the current spanning tree
+      // structure to make room for the new arc
+      int i = _arc_num;
+      if (_has_basis) {
+        if (_all_arc_num != _search_arc_num) {
+          moveArc(_search_arc_num, _all_arc_num);
+        }
+        if (_search_arc_num != _arc_num) {
+          moveArc(_arc_num, _search_arc_num);
+        }
+        ++_search_arc_num;
+        ++_all_arc_num;
+      }
+      ++_arc_num;
+
+      _arc_id[a] = i;
+      _source[i] = _node_id[_graph.source(a)];
+      _target[i] = _node_id[_graph.target(a)];
+      _lower.push_back(lower);
+      _upper.push_back(upper);
+      _cap[i] = upper;
+      _cost[i] = cost;
+      _flow[i] = 0;
+      _state[i] = STATE_LOWER;
+      if (lower != 0) {
+        _has_lower = true;
+        _has_basis = false;
+      }
       return *this;
     }
 
@@ -825,15 +959,107 @@ namespace lemon {
     /// optimal flow and node potentials (primal and dual solutions),
     /// \n \c UNBOUNDED if the objective function of the problem is
     /// unbounded, i.e. there is a directed cycle having negative total
-    /// cost and infinite upper bound.
+    /// cost and infinite upper bound,
+    /// \n \c FEASIBLE or \c UNDEFINED if the time limit was reached
+    /// (see \ref timeLimit()).
     ///
     /// \see ProblemType, PivotRule
     /// \see resetParams(), reset()
     ProblemType run(PivotRule pivot_rule = BLOCK_SEARCH) {
+      _timer.restart();
       if (!init()) return INFEASIBLE;
       return start(pivot_rule);
     }
 
+    /// \brief Run the algorithm starting from the given solution.
+    ///
+    /// This function runs the algorithm starting from the given flow
+    /// and node potentials, which are typically an optimal (or nearly
+    /// optimal) solution found by another algorithm, e.g. \ref CostScaling
+    /// (this is often called \e crossover).
+    /// The free arcs of the given flow (i.e. the arcs having flow value
+    /// strictly between the lower and upper bounds) are used to build a
+    /// strongly feasible spanning tree basis. If the free arcs contain
+    /// cycles, they are eliminated by augmenting the flow along them
+    /// in the non-increasing cost direction. The remaining components
+    /// are connected using artificial arcs according to the given
+    /// potentials, so if the given solution is optimal, the algorithm
+    /// usually terminates after a few pivots, and provides an optimal
+    /// spanning tree solution (see \ref treeArc()).
+    ///
+    /// If the given flow is not feasible or it does not lead to an
+    /// optimal solution, the algorithm is restarted from scratch,
+    /// so the result is the same as that of \ref run(PivotRule).
+    ///
+    /// For example,
+    /// \code
+    ///   CostScaling<ListDigraph> cs(graph);
+    ///   cs.upperMap(upper).costMap(cost).supplyMap(sup).run();
+    ///   ListDigraph::ArcMap<int> flow(graph);
+    ///   ListDigraph::NodeMap<int> pot(graph);
+    ///   cs.flowMap(flow);
+    ///   cs.potentialMap(pot);
+    ///
+    ///   NetworkSimplex<ListDigraph> ns(graph);
+    ///   ns.upperMap(upper).costMap(cost).supplyMap(sup).run(flow, pot);
+    /// \endcode
+    ///
+    /// \param flow The initial flow values. Its \c Value type must be
+    /// convertible to the \c Value type of the algorithm.
+    /// \param pot The initial node potentials. Its \c Value type must be
+    /// convertible to the \c Cost type of the algorithm.
+    /// \param pivot_rule The pivot rule that will be used during the
+    /// algorithm. For more information, see \ref PivotRule.
+    ///
+    /// \return The same as the return value of \ref run(PivotRule).
+    template <typename FlowMap, typename PotentialMap>
+    ProblemType run(const FlowMap &flow, const PotentialMap &pot,
+                    PivotRule pivot_rule = BLOCK_SEARCH) {
+      _timer.restart();
+      if (!initProblem()) return INFEASIBLE;
+      if (initCrossoverTree(flow, pot)) {
+        ProblemType result = start(pivot_rule);
+        if (result != INFEASIBLE && result != UNBOUNDED) return result;
+        if (!initProblem()) return INFEASIBLE;
+      }
+      initArtificialTree();
+      return start(pivot_rule);
+    }
+
+    /// \brief Continue the algorithm from the spanning tree of the
+    /// last run.
+    ///
+    /// This function continues the algorithm from the spanning tree
+    /// solution found by the last \ref run() or \ref resume() call,
+    /// after new arcs have been added using \ref addArc() and/or the
+    /// costs have been modified using \ref costMap().
+    /// Since the current basis remains primal feasible, only the
+    /// potentials are recomputed, and the new arcs are priced in by the
+    /// usual pivots, which is typically much faster than solving the
+    /// problem from scratch.
+    ///
+    /// If there is no usable basis (i.e. the last run did not find a
+    /// feasible solution, or other parameters have been modified since
+    /// then), or the resumed algorithm does not succeed, then the problem
+    /// is solved from scratch, so the result is the same as that of
+    /// \ref run(PivotRule).
+    ///
+    /// \param pivot_rule The pivot rule that will be used during the
+    /// algorithm. For more information, see \ref PivotRule.
+    ///
+    /// \return The same as the return value of \ref run(PivotRule).
+    ///
+    /// \see addArc()
+    ProblemType resume(PivotRule pivot_rule = BLOCK_SEARCH) {
+      if (!_has_basis) return run(pivot_rule);
+      _timer.restart();
+      if (!initProblem()) return INFEASIBLE;
+      initResumedTree();
+      ProblemType result = start(pivot_rule);
+      if (result != INFEASIBLE && result != UNBOUNDED) return result;
+      return run(pivot_rule);
+    }
+
     /// \brief Reset all the parameters that have been given before.
     ///
     /// This function resets all the paramaters that have been given
@@ -881,6 +1107,7 @@ namespace lemon {
       }
       _has_lower = false;
       _stype = GEQ;
+      _has_basis = false;
       return *this;
     }
 
@@ -1001,6 +1228,55 @@ namespace lemon {
     }
 #endif
 
+    /// \brief Return a lower bound for the optimal cost.
+    ///
+    /// This function returns a lower bound for the optimal cost, which
+    /// is the Lagrangian dual bound given by the current node potentials.
+    /// If the algorithm found an optimal solution, it is the same as the
+    /// total cost of the flow, otherwise (i.e. if the time limit was
+    /// reached) it can be compared to \ref totalCost() to see how far the
+    /// current solution is from the optimum.
+    /// If the bound is not finite, then \c -std::numeric_limits<Number>::
+    /// infinity() is returned if available, and \c std::numeric_limits
+    /// <Number>::min() otherwise.
+    /// Its complexity is O(m).
+    ///
+    /// \note The return type of the function can be specified as a
+    /// template parameter (see \ref totalCost()).
+    ///
+    /// \pre \ref run() must be called before using this function, and
+    /// it must have returned \c OPTIMAL or \c FEASIBLE.
+    template <typename Number>
+    Number dualBound() const {
+      const Number NEG_INF = std::numeric_limits<Number>::has_infinity ?
+        -std::numeric_limits<Number>::infinity() :
+        std::numeric_limits<Number>::min();
+      Number b = 0;
+      for (int i = 0; i != _arc_num; ++i) {
+        Number rc = Number(_cost[i]) + Number(_pi[_source[i]]) -
+                    Number(_pi[_target[i]]);
+        if (rc < 0) {
+          if (_upper[i] >= MAX) return NEG_INF;
+          b += rc * Number(_upper[i]);
+        } else if (_has_lower) {
+          b += rc * Number(_lower[i]);
+        }
+      }
+      for (int e = _arc_num; e != _search_arc_num; ++e) {
+        if (_cost[e] + _pi[_source[e]] - _pi[_target[e]] < 0) return NEG_INF;
+      }
+      for (int u = 0; u <= _node_num; ++u) {
+        b -= Number(_pi[u]) * Number(_supply[u]);
+      }
+      return b;
+    }
+
+#ifndef DOXYGEN
+    Cost dualBound() const {
+      return dualBound<Cost>();
+    }
+#endif
+
     /// \brief Return the flow on the given arc.
     ///
     /// This function returns the flow on the given arc.
@@ -1025,6 +1301,42 @@ namespace lemon {
       }
     }
 
+    /// \brief Return the number of pivots.
+    ///
+    /// This function returns the number of pivots performed by the
+    /// last \ref run() (not including the heuristic initial pivots).
+    ///
+    /// \pre \ref run() must be called before using this function.
+    int pivotNum() const {
+      return _pivot_num;
+    }
+
+    /// \brief Return the time when a feasible flow was found.
+    ///
+    /// This function returns the time (in seconds, measured from the
+    /// start of the last \ref run()) when a feasible flow was found,
+    /// i.e. when the artificial arcs of the initial spanning tree left
+    /// the basis. From this point, the flow is feasible and its cost does
+    /// not increase in the further pivots.
+    /// If no feasible flow was found, then \c -1 is returned.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    double feasibleTime() const {
+      return _feasible_time;
+    }
+
+    /// \brief Return \c true if the given arc is in the spanning tree.
+    ///
+    /// This function returns \c true if the given arc belongs to the
+    /// spanning tree of the final basis. The flow value is at the lower
+    /// or upper bound on each arc that is not in the tree, and the reduced
+    /// cost is zero on each tree arc (see \ref potential()).
+    ///
+    /// \pre \ref run() must be called before using this function.
+    bool treeArc(const Arc& a) const {
+      return _state[_arc_id[a]] == STATE_TREE;
+    }
+
     /// \brief Return the potential (dual value) of the given node.
     ///
     /// This function returns the potential (dual value) of the
@@ -1057,6 +1369,15 @@ namespace lemon {
 
     // Initialize internal data structures
     bool init() {
+      if (!initProblem()) return false;
+      initArtificialTree();
+      return true;
+    }
+
+    // Check the supply values and remove non-zero lower bounds
+    bool initProblem() {
+      _pivot_num = 0;
+      _feasible_time = -1;
       if (_node_num == 0) return false;
 
       // Check the sum of supply values
@@ -1089,6 +1410,11 @@ namespace lemon {
         }
       }
 
+      return true;
+    }
+
+    // Initialize the spanning tree structure using artificial arcs
+    void initArtificialTree() {
       // Initialize artifical cost
       Cost ART_COST;
       if (std::numeric_limits<Cost>::is_exact) {
@@ -1232,9 +1558,315 @@ namespace lemon {
         _all_arc_num = f;
       }
 
+      _art_flow_num = 0;
+      for (int e = _search_arc_num; e != _all_arc_num; ++e) {
+        if (_flow[e] != 0) ++_art_flow_num;
+      }
+    }
+
+    // Initialize the spanning tree structure from the given flow and
+    // potentials (crossover). Return false if the flow is not feasible.
+    template <typename FlowMap, typename PotentialMap>
+    bool initCrossoverTree(const FlowMap &flow, const PotentialMap &pot) {
+      // Set the flow values and compute the slacks of the supply
+      // constraints
+      ValueVector excess(_supply.begin(), _supply.end());
+      for (ArcIt a(_graph); a != INVALID; ++a) {
+        int i = _arc_id[a];
+        Value f = flow[a];
+        if (_has_lower) f -= _lower[i];
+        if (f < 0 || (_cap[i] < MAX && f > _cap[i])) return false;
+        _flow[i] = f;
+        excess[_source[i]] -= f;
+        excess[_target[i]] += f;
+      }
+
+      // Set data for the artificial root node and the slack arcs
+      _root = _node_num;
+      _supply[_root] = -_sum_supply;
+      _search_arc_num = _sum_supply == 0 ? _arc_num : _arc_num + _node_num;
+      for (int u = 0, e = _arc_num; u != _node_num; ++u, ++e) {
+        Value s = excess[u];
+        if (_sum_supply == 0) {
+          if (s != 0) return false;
+          continue;
+        }
+        if (_sum_supply < 0) {
+          // GEQ supply constraints
+          if (s > 0) return false;
+          _source[e] = _root;
+          _target[e] = u;
+          _flow[e] = -s;
+        } else {
+          // LEQ supply constraints
+          if (s < 0) return false;
+          _source[e] = u;
+          _target[e] = _root;
+          _flow[e] = s;
+        }
+        _cap[e] = INF;
+        _cost[e] = 0;
+      }
+
+      // Build a forest from the free arcs. If a free arc closes a cycle,
+      // the flow is augmented along the cycle (in the non-increasing cost
+      // direction) until an arc of the cycle reaches its bound, and this
+      // arc is left out of the forest. The trees are also kept in a
+      // union-find structure (the node sets do not change when an arc
+      // of a cycle is replaced), so the cycle test does not walk the
+      // tree paths.
+      IntVector mark_s(_node_num + 1, -1), mark_t(_node_num + 1, -1);
+      IntVector comp(_node_num + 1), comp_size(_node_num + 1, 1);
+      std::vector<std::pair<int, int> > cycle;
+      for (int u = 0; u <= _node_num; ++u) {
+        _parent[u] = -1;
+        _pred[u] = -1;
+        comp[u] = u;
+      }
+      for (int e = 0; e != _search_arc_num; ++e) {
+        if (!freeArc(e)) continue;
+
+        int s = _source[e], t = _target[e];
+        int cs = findComp(comp, s), ct = findComp(comp, t);
+        if (cs != ct) {
+          // The endpoints are in different trees, merge them by
+          // rerooting the smaller one (so a node is on a rerooted path
+          // O(log n) times)
+          if (comp_size[cs] <= comp_size[ct]) {
+            int rs = s;
+            while (_parent[rs] != -1) rs = _parent[rs];
+            reverseTreePath(s, rs, t, e);
+            comp[cs] = ct;
+            comp_size[ct] += comp_size[cs];
+          } else {
+            int rt = t;
+            while (_parent[rt] != -1) rt = _parent[rt];
+            reverseTreePath(t, rt, s, e);
+            comp[ct] = cs;
+            comp_size[cs] += comp_size[ct];
+          }
+          continue;
+        }
+
+        // Find the first common node of the paths from the endpoints
+        // to the root by walking up from both of them in turns (the
+        // steps are proportional to the length of the cycle)
+        int j = s, js = s, jt = t;
+        mark_s[s] = e;
+        mark_t[t] = e;
+        while (mark_t[j] != e) {
+          if (_parent[js] != -1) {
+            js = _parent[js];
+            mark_s[js] = e;
+            if (mark_t[js] == e) {
+              j = js;
+              break;
+            }
+          }
+          if (_parent[jt] != -1) {
+            jt = _parent[jt];
+            mark_t[jt] = e;
+            if (mark_s[jt] == e) {
+              j = jt;
+              break;
+            }
+          }
+        }
+
+        // Collect the tree arcs of the cycle (from t to j and from j
+        // to s) with their directions with respect to the arc e
+        cycle.clear();
+        for (int u = t; u != j; u = _parent[u]) {
+          cycle.push_back(std::make_pair(u, _source[_pred[u]] == u ? 1 : -1));
+        }
+        int t_side = int(cycle.size());
+        for (int u = s; u != j; u = _parent[u]) {
+          cycle.push_back(std::make_pair(u, _target[_pred[u]] == u ? 1 : -1));
+        }
+        Cost cycle_cost = _cost[e];
+        for (int i = 0; i != int(cycle.size()); ++i) {
+          cycle_cost += cycle[i].second * _cost[_pred[cycle[i].first]];
+        }
+
+        // Augment along the cycle
+        int dir = cycle_cost < 0 ? 1 : -1;
+        Value delta = residual(e, dir);
+        int out = -1;
+        for (int i = 0; i != int(cycle.size()); ++i) {
+          Value r = residual(_pred[cycle[i].first], dir * cycle[i].second);
+          if (r < delta) {
+            delta = r;
+            out = i;
+          }
+        }
+        if (delta >= MAX) return false;
+        _flow[e] += dir * delta;
+        for (int i = 0; i != int(cycle.size()); ++i) {
+          _flow[_pred[cycle[i].first]] += dir * cycle[i].second * delta;
+        }
+
+        // Replace the leaving arc with the arc e in the forest
+        if (out >= t_side) {
+          reverseTreePath(s, cycle[out].first, t, e);
+        } else if (out != -1) {
+          reverseTreePath(t, cycle[out].first, s, e);
+        }
+      }
+
+      // Remove the arcs that reached their bounds from the forest, and
+      // connect the trees to the root node using artificial arcs whose
+      // costs are set according to the given potentials
+      for (int u = 0; u <= _node_num; ++u) {
+        if (_parent[u] != -1 && !freeArc(_pred[u])) _parent[u] = -1;
+      }
+      int root_top = _root;
+      while (_parent[root_top] != -1) root_top = _parent[root_top];
+      if (root_top != _root) reverseTreePath(_root, root_top, -1, -1);
+      _all_arc_num = _search_arc_num;
+      _art_flow_num = 0;
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        int u = _node_id[n];
+        if (_parent[u] != -1) continue;
+        int e = _all_arc_num++;
+        _source[e] = u;
+        _target[e] = _root;
+        _cap[e] = INF;
+        _flow[e] = 0;
+        _cost[e] = -static_cast<Cost>(pot[n]);
+        _parent[u] = _root;
+        _pred[u] = e;
+      }
+
+      // Compute the thread order (using a depth-first search) and the
+      // other data of the spanning tree structure
+      IntVector first_child(_node_num + 1, -1), next_sibling(_node_num);
+      for (int u = 0; u != _node_num; ++u) {
+        next_sibling[u] = first_child[_parent[u]];
+        first_child[_parent[u]] = u;
+      }
+      IntVector order, stack;
+      stack.push_back(_root);
+      while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        order.push_back(u);
+        for (int v = first_child[u]; v != -1; v = next_sibling[v]) {
+          stack.push_back(v);
+        }
+      }
+      _pi[_root] = 0;
+      for (int i = 0; i != int(order.size()); ++i) {
+        int u = order[i], v = order[(i + 1) % order.size()];
+        _thread[u] = v;
+        _rev_thread[v] = u;
+        if (u == _root) continue;
+        int e = _pred[u];
+        if (_source[e] == u) {
+          _pred_dir[u] = DIR_UP;
+          _pi[u] = _pi[_parent[u]] - _cost[e];
+        } else {
+          _pred_dir[u] = DIR_DOWN;
+          _pi[u] = _pi[_parent[u]] + _cost[e];
+        }
+      }
+      for (int i = int(order.size()) - 1; i >= 0; --i) {
+        int u = order[i];
+        _succ_num[u] = 1;
+        _last_succ[u] = u;
+        for (int v = first_child[u]; v != -1; v = next_sibling[v]) {
+          _succ_num[u] += _succ_num[v];
+        }
+        // The first child in the list is the last one in the thread order
+        if (first_child[u] != -1) {
+          _last_succ[u] = _last_succ[first_child[u]];
+        }
+      }
+
+      // Set the states of the arcs (an arc with zero capacity is set to
+      // its bound that is not violated by the reduced cost)
+      for (int e = 0; e != _all_arc_num; ++e) {
+        _state[e] = _flow[e] == 0 && (_cap[e] != 0 ||
+          _cost[e] + _pi[_source[e]] - _pi[_target[e]] >= 0) ?
+          STATE_LOWER : STATE_UPPER;
+      }
+      for (int u = 0; u != _node_num; ++u) {
+        _state[_pred[u]] = STATE_TREE;
+      }
+
       return true;
     }
 
+    // Initialize the spanning tree structure from the one of the last
+    // run (the flow is transformed back and the potentials are
+    // recomputed, since the costs may have been modified)
+    void initResumedTree() {
+      if (_has_lower) {
+        for (int i = 0; i != _arc_num; ++i) {
+          _flow[i] -= _lower[i];
+        }
+      }
+      _pi[_root] = 0;
+      for (int u = _thread[_root]; u != _root; u = _thread[u]) {
+        _pi[u] = _pi[_parent[u]] - _pred_dir[u] * _cost[_pred[u]];
+      }
+      _art_flow_num = 0;
+      for (int e = _search_arc_num; e != _all_arc_num; ++e) {
+        if (_flow[e] != 0) ++_art_flow_num;
+      }
+    }
+
+    // Move the data of an artificial arc to another position
+    void moveArc(int from, int to) {
+      _source[to] = _source[from];
+      _target[to] = _target[from];
+      _cap[to] = _cap[from];
+      _cost[to] = _cost[from];
+      _flow[to] = _flow[from];
+      _state[to] = _state[from];
+      if (_state[to] == STATE_TREE) {
+        // Artificial arcs are incident to the root node, which is the
+        // root of the spanning tree, too
+        _pred[_source[to] == _root ? _target[to] : _source[to]] = to;
+      }
+    }
+
+    // Check if the given arc is strictly between its bounds
+    bool freeArc(int e) const {
+      return _flow[e] > 0 && (_cap[e] >= MAX || _flow[e] < _cap[e]);
+    }
+
+    // Return the residual capacity of the given arc in the given
+    // direction (1: increasing the flow, -1: decreasing the flow)
+    Value residual(int e, int dir) const {
+      if (dir < 0) return _flow[e];
+      return _cap[e] >= MAX ? INF : _cap[e] - _flow[e];
+    }
+
+    // Find the representative of the set of node u in a union-find
+    // structure given by the comp vector (with path halving)
+    static int findComp(IntVector &comp, int u) {
+      while (comp[u] != u) {
+        comp[u] = comp[comp[u]];
+        u = comp[u];
+      }
+      return u;
+    }
+
+    // Reverse the tree path from node u to its ancestor v (i.e. make u
+    // the root of its tree) and attach u to node w using arc e
+    void reverseTreePath(int u, int v, int w, int e) {
+      int p = w, pe = e;
+      while (true) {
+        int np = _parent[u], ne = _pred[u];
+        _parent[u] = p;
+        _pred[u] = pe;
+        if (u == v) break;
+        p = u;
+        pe = ne;
+        u = np;
+      }
+    }
+
     // Check if the upper bound is greater than or equal to the lower bound
     // on each arc.
     bool checkBoundMaps() {
@@ -1323,10 +1955,18 @@ namespace lemon {
         Value val = _state[in_arc] * delta;
         _flow[in_arc] += val;
         for (int u = _source[in_arc]; u != join; u = _parent[u]) {
-          _flow[_pred[u]] -= _pred_dir[u] * val;
+          int e = _pred[u];
+          if (e >= _search_arc_num) {
+            updateArtificialFlow(e, -_pred_dir[u] * val);
+          }
+          _flow[e] -= _pred_dir[u] * val;
         }
         for (int u = _target[in_arc]; u != join; u = _parent[u]) {
-          _flow[_pred[u]] += _pred_dir[u] * val;
+          int e = _pred[u];
+          if (e >= _search_arc_num) {
+            updateArtificialFlow(e, _pred_dir[u] * val);
+          }
+          _flow[e] += _pred_dir[u] * val;
         }
       }
       // Update the state of the entering and leaving arcs
@@ -1339,6 +1979,16 @@ namespace lemon {
       }
     }
 
+    // Maintain the number of artificial arcs having non-zero flow
+    // before changing the flow on the given artificial arc
+    void updateArtificialFlow(int e, Value val) {
+      if (_flow[e] == 0) {
+        ++_art_flow_num;
+      } else if (_flow[e] + val == 0) {
+        --_art_flow_num;
+      }
+    }
+
     // Update the tree structure
     void updateTreeStructure() {
       int old_rev_thread = _rev_thread[u_out];
@@ -1476,7 +2126,7 @@ namespace lemon {
     }
 
     // Heuristic initial pivots
-    bool initialPivots() {
+    bool initialPivots(bool &time_out) {
       Value curr, total = 0;
       std::vector<Node> supply_nodes, demand_nodes;
       for (NodeIt u(_graph); u != INVALID; ++u) {
@@ -1565,10 +2215,61 @@ namespace lemon {
           updateTreeStructure();
           updatePotential();
         }
+        if (timeLimitReached()) {
+          time_out = true;
+          break;
+        }
       }
       return true;
     }
 
+    // Start counting the time checks of the current run
+    void initTimeCheck() {
+      _time_check_interval = 1;
+      _time_check_count = 0;
+      _time_check_last = _timer.realTime();
+    }
+
+    // Check if the time limit is reached (called after each pivot).
+    // Reading the clock is not negligible compared to a cheap pivot, so
+    // it is read only at every _time_check_interval-th call, and this
+    // interval follows the measured time of the pivots: it is doubled
+    // if the last interval took less than TIME_CHECK_PERIOD, and it is
+    // halved otherwise (so expensive pivots are checked one by one).
+    bool timeLimitReached() {
+      const double TIME_CHECK_PERIOD = 1e-3;
+      const int MAX_TIME_CHECK_INTERVAL = 1 << 16;
+      if (_time_limit <= 0 || ++_time_check_count < _time_check_interval) {
+        return false;
+      }
+      _time_check_count = 0;
+      double time = _timer.realTime();
+      if (time >= _time_limit) return true;
+      if (time - _time_check_last < TIME_CHECK_PERIOD) {
+        if (_time_check_interval < MAX_TIME_CHECK_INTERVAL) {
+          _time_check_interval *= 2;
+        }
+      } else if (_time_check_interval > 1) {
+        _time_check_interval /= 2;
+      }
+      _time_check_last = time;
+      return false;
+    }
+
+    // Transform the supply map to the original form (i.e. restore the
+    // values modified by the removal of the lower bounds)
+    void restoreSupply() {
+      if (_has_lower) {
+        for (int i = 0; i != _arc_num; ++i) {
+          Value c = _lower[i];
+          if (c != 0) {
+            _supply[_source[i]] += c;
+            _supply[_target[i]] -= c;
+          }
+        }
+      }
+    }
+
     // Execute the algorithm
     ProblemType start(PivotRule pivot_rule) {
       // Select the pivot rule implementation
@@ -1590,38 +2291,65 @@ namespace lemon {
     template <typename PivotRuleImpl>
     ProblemType start() {
       PivotRuleImpl pivot(*this);
+      _has_basis = false;
+      initTimeCheck();
 
       // Perform heuristic initial pivots
-      if (!initialPivots()) return UNBOUNDED;
+      bool time_out = false;
+      if (!initialPivots(time_out)) {
+        restoreSupply();
+        return UNBOUNDED;
+      }
 
       // Execute the Network Simplex algorithm
-      while (pivot.findEnteringArc()) {
+      _pivot_num = 0;
+      _feasible_time = _art_flow_num == 0 ? _timer.realTime() : -1;
+      while (!time_out && pivot.findEnteringArc()) {
         findJoinNode();
         bool change = findLeavingArc();
-        if (delta >= MAX) return UNBOUNDED;
+        if (delta >= MAX) {
+          restoreSupply();
+          return UNBOUNDED;
+        }
         changeFlow(change);
         if (change) {
           updateTreeStructure();
           updatePotential();
         }
+        ++_pivot_num;
+        if (_feasible_time < 0 && _art_flow_num == 0) {
+          _feasible_time = _timer.realTime();
+        }
+        if (timeLimitReached()) {
+          time_out = true;
+          break;
+        }
       }
 
       // Check feasibility
-      for (int e = _search_arc_num; e != _all_arc_num; ++e) {
-        if (_flow[e] != 0) return INFEASIBLE;
+      if (time_out) {
+        if (_art_flow_num != 0) {
+          restoreSupply();
+          return UNDEFINED;
+        }
+      } else {
+        for (int e = _search_arc_num; e != _all_arc_num; ++e) {
+          if (_flow[e] != 0) {
+            restoreSupply();
+            return INFEASIBLE;
+          }
+        }
       }
 
       // Transform the solution and the supply map to the original form
       if (_has_lower) {
         for (int i = 0; i != _arc_num; ++i) {
-          Value c = _lower[i];
-          if (c != 0) {
-            _flow[i] += c;
-            _supply[_source[i]] += c;
-            _supply[_target[i]] -= c;
-          }
+          _flow[i] += _lower[i];
         }
+        restoreSupply();
       }
+      _has_basis = true;
+      if (time_out) return FEASIBLE;
 
       // Shift potentials to meet the requirements of the GEQ/LEQ type
       // optimality conditions
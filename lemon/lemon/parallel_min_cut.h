@@ -0,0 +1,775 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_PARALLEL_MIN_CUT_H
+#define LEMON_PARALLEL_MIN_CUT_H
+
+/// \ingroup min_cut
+///
+/// \file
+/// \brief Parallel algorithms for finding a minimum cut in an undirected
+/// graph.
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <cmath>
+
+#include <lemon/core.h>
+#include <lemon/maps.h>
+#include <lemon/bin_heap.h>
+#include <lemon/bucket_heap.h>
+#include <lemon/random.h>
+#include <lemon/bits/thread_pool.h>
+
+namespace lemon {
+
+  /// \ingroup min_cut
+  ///
+  /// \brief Parallel algorithms for finding a minimum cut in an
+  /// undirected graph.
+  ///
+  /// This class provides two parallel algorithms for finding a minimum
+  /// cut in an undirected graph, i.e. a non-empty and non-complete node
+  /// subset with minimum total capacity of the edges leaving it.
+  /// The algorithm can be selected by the parameter of \ref run().
+  ///
+  /// - \ref NAGAMOCHI_IBARAKI is an exact algorithm based on the sparse
+  ///   certificates of Nagamochi and Ibaraki \cite nagamochi92computing
+  ///   (see also \ref NagamochiIbaraki).
+  ///   It works in rounds. In each round, the threads compute maximum
+  ///   adjacency orderings of disjoint parts of the graph concurrently
+  ///   \cite henzinger19shared, and the edges whose end nodes are proven
+  ///   to be connected at least as strongly as the best cut found so far
+  ///   are contracted. Since the priorities of the orderings are bounded
+  ///   by the value of this cut, bucket heaps are used for integer
+  ///   capacities. If the concurrent orderings contract only a few
+  ///   edges, a single ordering of the whole graph is also computed.
+  /// - \ref KARGER_STEIN is the randomized recursive contraction
+  ///   algorithm of Karger and Stein \cite karger96new. Its independent
+  ///   trials are distributed among the threads, and the small contracted
+  ///   graphs are solved exactly. It finds a minimum cut with high
+  ///   probability if the number of the trials is \f$O(\log^2 n)\f$
+  ///   (see \ref trialNum()), but each trial takes \f$O(n^2\log n)\f$
+  ///   time, so it is suited to dense graphs.
+  ///
+  /// Both algorithms consider every trivial cut (i.e. a single node of
+  /// a contracted graph) which they meet, and the result is always an
+  /// existing cut of the graph.
+  ///
+  /// \tparam GR The type of the undirected graph the algorithm runs on.
+  /// \tparam CAP The type of the capacity map. The default map type is
+  /// \ref concepts::Graph::EdgeMap "GR::EdgeMap<int>".
+  ///
+  /// \warning The capacities must be non-negative, and the value type of
+  /// the capacity map should be able to hold any cut value of the graph,
+  /// otherwise the result can overflow.
+  template <typename GR,
+            typename CAP = typename GR::template EdgeMap<int> >
+  class ParallelMinCut {
+  public:
+
+    /// The type of the undirected graph the algorithm runs on.
+    typedef GR Graph;
+    /// The type of the capacity map.
+    typedef CAP CapacityMap;
+    /// The type of the capacities and the cut values.
+    typedef typename CapacityMap::Value Value;
+
+    /// \brief Constants for selecting the algorithm.
+    ///
+    /// Enum type containing constants for selecting the algorithm for
+    /// the \ref run() function.
+    enum Method {
+      /// Parallel variant of the exact Nagamochi-Ibaraki algorithm.
+      NAGAMOCHI_IBARAKI,
+      /// Parallel trials of the randomized Karger-Stein algorithm.
+      KARGER_STEIN
+    };
+
+  private:
+
+    TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+    // An edge of a contracted graph, whose nodes are numbered from zero
+    struct EdgeData {
+      int u, v;
+      Value cap;
+      EdgeData() {}
+      EdgeData(int u_, int v_, Value cap_) : u(u_), v(v_), cap(cap_) {}
+    };
+
+    // An arc of the adjacency lists of a contracted graph
+    struct ArcData {
+      int target;
+      int edge;
+      Value cap;
+    };
+
+    typedef std::vector<EdgeData> EdgeVector;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<char> CharVector;
+    typedef std::vector<Value> ValueVector;
+
+    // The data of a thread computing a maximum adjacency ordering.
+    // The entries of the touched nodes are reset after each round.
+    struct Workspace {
+      ValueVector prio;
+      RangeMap<int> cross_ref;
+      IntVector touched;
+      IntVector marked;
+    };
+
+    // Integer cut values up to this limit are handled by bucket heaps
+    static const int BUCKET_LIMIT = 1 << 20;
+    // Contracted graphs of at most this many nodes are solved exactly
+    // in the Karger-Stein algorithm
+    static const int EXACT_LIMIT = 32;
+
+    const Graph& _graph;
+    const CapacityMap& _capacity;
+
+    int _thread_num;
+    int _trial_num;
+    int _seed;
+
+    // The graph without loops and parallel edges
+    IntNodeMap _node_id;
+    int _node_num;
+    EdgeVector _edges;
+
+    Value _min_cut;
+    CharVector _cut;
+
+    // The adjacency lists and the thread data of the current round of
+    // the Nagamochi-Ibaraki algorithm
+    IntVector _first;
+    std::vector<ArcData> _arcs;
+    std::vector<Workspace> _work;
+    std::vector<std::atomic<char> > _scanned;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Constructor.
+    /// \param graph The undirected graph the algorithm runs on.
+    /// \param capacity The capacities of the edges.
+    ParallelMinCut(const Graph& graph, const CapacityMap& capacity)
+      : _graph(graph), _capacity(capacity),
+        _thread_num(0), _trial_num(0), _seed(1),
+        _node_id(graph), _node_num(0), _min_cut() {}
+
+    /// \brief Sets the number of threads.
+    ///
+    /// Sets the number of threads used by the algorithm. If it is not
+    /// used before calling \ref run(), or the given value is not
+    /// positive, the number of hardware threads will be used.
+    /// \return <tt>(*this)</tt>
+    ParallelMinCut& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
+    /// \brief Sets the number of the trials of the Karger-Stein
+    /// algorithm.
+    ///
+    /// Sets the number of the independent trials of the
+    /// \ref KARGER_STEIN "Karger-Stein algorithm". If it is not used
+    /// before calling \ref run(), or the given value is not positive,
+    /// \f$\lceil\log_2 n\rceil^2\f$ trials are performed, which find a
+    /// minimum cut with high probability.
+    /// \return <tt>(*this)</tt>
+    ParallelMinCut& trialNum(int num) {
+      _trial_num = num;
+      return *this;
+    }
+
+    /// \brief Sets the seed of the random number generators.
+    ///
+    /// Sets the seed of the random number generators. The trials of the
+    /// \ref KARGER_STEIN "Karger-Stein algorithm" use the seeds
+    /// <tt>seed</tt>, <tt>seed+1</tt>, ..., so the result does not
+    /// depend on the number of threads. The default value is \c 1.
+    /// \return <tt>(*this)</tt>
+    ParallelMinCut& seed(int seed) {
+      _seed = seed;
+      return *this;
+    }
+
+    /// \name Execution Control
+
+    ///@{
+
+    /// \brief Runs the algorithm.
+    ///
+    /// Runs the selected algorithm.
+    /// \param method The algorithm to use, see \ref Method.
+    /// The default is the exact \ref NAGAMOCHI_IBARAKI algorithm.
+    void run(Method method = NAGAMOCHI_IBARAKI) {
+      if (!init()) return;
+      if (method == KARGER_STEIN) {
+        startKargerStein();
+      } else {
+        startNagamochiIbaraki();
+      }
+    }
+
+    ///@}
+
+    /// \name Query Functions
+    /// The results of the algorithm can be obtained using these
+    /// functions.\n
+    /// \ref run() must be called before using them.
+
+    ///@{
+
+    /// \brief Returns the value of the minimum cut.
+    ///
+    /// Returns the value of the minimum cut (or of the best cut found
+    /// by the \ref KARGER_STEIN "Karger-Stein algorithm").
+    Value minCutValue() const {
+      return _min_cut;
+    }
+
+    /// \brief Returns the minimum cut in a node map.
+    ///
+    /// Sets the nodes of one side of the cut to \c true and the other
+    /// nodes to \c false.
+    /// \param cutMap A \ref concepts::WriteMap "writable" node map with
+    /// \c bool (or convertible) value type.
+    /// \return The value of the cut.
+    template <typename CutMap>
+    Value minCutMap(CutMap& cutMap) const {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        cutMap.set(n, _cut[_node_id[n]] != 0);
+      }
+      return _min_cut;
+    }
+
+    ///@}
+
+  private:
+
+    int threadCount() const {
+      return _thread_num > 0 ? _thread_num : bits::hardwareThreadNum();
+    }
+
+    static int find(IntVector& parent, int v) {
+      while (parent[v] != v) {
+        v = parent[v] = parent[parent[v]];
+      }
+      return v;
+    }
+
+    // Merge the parallel edges into out
+    static void mergeEdges(int n, const EdgeVector& edges, EdgeVector& out) {
+      IntVector first(n + 1, 0);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        ++first[std::min(edges[i].u, edges[i].v) + 1];
+      }
+      for (int v = 0; v != n; ++v) {
+        first[v + 1] += first[v];
+      }
+      IntVector order(edges.size()), pos(first.begin(), first.end() - 1);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        order[pos[std::min(edges[i].u, edges[i].v)]++] = i;
+      }
+
+      // last[w] is the position of the edge (u, w) in out
+      IntVector last(n, -1);
+      out.clear();
+      for (int u = 0; u != n; ++u) {
+        int start = out.size();
+        for (int k = first[u]; k != first[u + 1]; ++k) {
+          const EdgeData& e = edges[order[k]];
+          int w = std::max(e.u, e.v);
+          if (last[w] >= start) {
+            out[last[w]].cap += e.cap;
+          } else {
+            last[w] = out.size();
+            out.push_back(EdgeData(u, w, e.cap));
+          }
+        }
+      }
+    }
+
+    // Contract the nodes having the same label (from [0, num))
+    static void contractEdges(const EdgeVector& edges, const IntVector& label,
+                              int num, EdgeVector& out) {
+      EdgeVector remaining;
+      remaining.reserve(edges.size());
+      for (int i = 0; i != int(edges.size()); ++i) {
+        int u = label[edges[i].u], v = label[edges[i].v];
+        if (u != v) remaining.push_back(EdgeData(u, v, edges[i].cap));
+      }
+      mergeEdges(num, remaining, out);
+    }
+
+    // Number the components of the union-find forest, return their number
+    static int labelComponents(IntVector& parent, IntVector& label) {
+      int n = parent.size(), num = 0;
+      label.assign(n, -1);
+      for (int v = 0; v != n; ++v) {
+        int r = find(parent, v);
+        if (label[r] == -1) label[r] = num++;
+        label[v] = label[r];
+      }
+      return num;
+    }
+
+    // Return the node of minimum weighted degree
+    static int minDegree(int n, const EdgeVector& edges, Value& value) {
+      ValueVector degree(n, 0);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        degree[edges[i].u] += edges[i].cap;
+        degree[edges[i].v] += edges[i].cap;
+      }
+      int node = 0;
+      for (int v = 1; v < n; ++v) {
+        if (degree[v] < degree[node]) node = v;
+      }
+      value = degree[node];
+      return node;
+    }
+
+    // Build the simple graph, and check whether it is connected
+    bool init() {
+      int n = 0;
+      for (NodeIt v(_graph); v != INVALID; ++v) {
+        _node_id[v] = n++;
+      }
+      _node_num = n;
+
+      EdgeVector edges;
+      for (EdgeIt e(_graph); e != INVALID; ++e) {
+        int u = _node_id[_graph.u(e)], v = _node_id[_graph.v(e)];
+        if (u != v && _capacity[e] > 0) {
+          edges.push_back(EdgeData(u, v, _capacity[e]));
+        }
+      }
+      mergeEdges(n, edges, _edges);
+
+      _min_cut = std::numeric_limits<Value>::max();
+      _cut.assign(n, 0);
+      if (n == 0) return false;
+      if (n == 1) {
+        _cut[0] = 1;
+        _min_cut = 0;
+        return false;
+      }
+
+      IntVector parent(n), label;
+      for (int v = 0; v != n; ++v) parent[v] = v;
+      for (int i = 0; i != int(_edges.size()); ++i) {
+        int u = find(parent, _edges[i].u), v = find(parent, _edges[i].v);
+        if (u != v) parent[u] = v;
+      }
+      if (labelComponents(parent, label) > 1) {
+        for (int v = 0; v != n; ++v) {
+          _cut[v] = label[v] == label[0];
+        }
+        _min_cut = 0;
+        return false;
+      }
+      return true;
+    }
+
+    // Nagamochi-Ibaraki algorithm
+
+    void startNagamochiIbaraki() {
+      int n = _node_num;
+      EdgeVector edges(_edges), contracted;
+
+      // rep[v] is the node of the contracted graph containing node v
+      IntVector rep(n), parent, label, order;
+      for (int v = 0; v != n; ++v) rep[v] = v;
+
+      bits::ThreadPool pool(std::max(std::min(threadCount(), n), 1));
+      std::vector<Workspace>(pool.size()).swap(_work);
+      for (int i = 0; i != pool.size(); ++i) {
+        _work[i].prio.assign(n, 0);
+        _work[i].cross_ref.resize(n, -1);
+      }
+      std::vector<std::atomic<char> >(n).swap(_scanned);
+      Random rnd(_seed);
+      bool weak = false;
+
+      while (n > 1) {
+        Value value;
+        int node = minDegree(n, edges, value);
+        if (value < _min_cut) {
+          _min_cut = value;
+          for (int v = 0; v != _node_num; ++v) {
+            _cut[v] = rep[v] == node;
+          }
+        }
+
+        buildArcs(n, edges);
+        order.resize(n);
+        for (int v = 0; v != n; ++v) {
+          order[v] = v;
+          std::swap(order[v], order[rnd[v + 1]]);
+        }
+
+        parent.resize(n);
+        for (int v = 0; v != n; ++v) parent[v] = v;
+        // The concurrent orderings contract only a few edges if the cut
+        // value is close to the degrees (e.g. in dense graphs), then a
+        // single ordering is also computed, which contracts at least one
+        // edge, and the next round is not parallel either.
+        bool parallel = pool.size() > 1 && !weak;
+        int num = scanRound(parallel ? &pool : 0, edges, order, parent, n);
+        weak = parallel && n - num <= n / 16;
+        if (weak) {
+          num = scanRound(0, edges, order, parent, num);
+        }
+
+        labelComponents(parent, label);
+        contractEdges(edges, label, num, contracted);
+        edges.swap(contracted);
+        for (int v = 0; v != _node_num; ++v) {
+          rep[v] = label[rep[v]];
+        }
+        n = num;
+      }
+    }
+
+    void buildArcs(int n, const EdgeVector& edges) {
+      _first.assign(n + 1, 0);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        ++_first[edges[i].u + 1];
+        ++_first[edges[i].v + 1];
+      }
+      for (int v = 0; v != n; ++v) {
+        _first[v + 1] += _first[v];
+      }
+      _arcs.resize(2 * edges.size());
+      IntVector pos(_first.begin(), _first.end() - 1);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        ArcData& a = _arcs[pos[edges[i].u]++];
+        a.target = edges[i].v;
+        a.edge = i;
+        a.cap = edges[i].cap;
+        ArcData& b = _arcs[pos[edges[i].v]++];
+        b.target = edges[i].u;
+        b.edge = i;
+        b.cap = edges[i].cap;
+      }
+    }
+
+    // Compute maximum adjacency orderings on the threads of the pool
+    // (or on the calling thread if it is null), and merge the end nodes
+    // of the edges that can be contracted. Return the number of the
+    // sets in the union-find forest, which is num before the merges.
+    int scanRound(bits::ThreadPool* pool, const EdgeVector& edges,
+                  const IntVector& order, IntVector& parent, int num) {
+      int n = order.size();
+      for (int v = 0; v != n; ++v) {
+        _scanned[v].store(0, std::memory_order_relaxed);
+      }
+      std::atomic<int> next(0);
+      auto task = [&](int id) {
+        scan(_work[id], order, next, std::integral_constant<bool,
+             std::numeric_limits<Value>::is_integer>());
+      };
+      if (pool != 0) {
+        pool->run(task);
+      } else {
+        task(0);
+      }
+
+      for (int i = 0; i != int(_work.size()); ++i) {
+        IntVector& marked = _work[i].marked;
+        for (int k = 0; k != int(marked.size()); ++k) {
+          int u = find(parent, edges[marked[k]].u);
+          int v = find(parent, edges[marked[k]].v);
+          if (u != v) {
+            parent[u] = v;
+            --num;
+          }
+        }
+        marked.clear();
+      }
+      return num;
+    }
+
+    void scan(Workspace& work, const IntVector& order,
+              std::atomic<int>& next, std::true_type) {
+      if (_min_cut <= BUCKET_LIMIT) {
+        scan<BucketHeap<RangeMap<int>, false> >(work, order, next);
+      } else {
+        scan(work, order, next, std::false_type());
+      }
+    }
+
+    void scan(Workspace& work, const IntVector& order,
+              std::atomic<int>& next, std::false_type) {
+      scan<BinHeap<Value, RangeMap<int>, std::greater<Value> > >
+        (work, order, next);
+    }
+
+    // Compute a maximum adjacency ordering of the nodes that are not
+    // scanned by the other threads. The priority of a node is the total
+    // capacity of its edges to the scanned nodes (bounded by the value
+    // of the current cut), and an edge whose end node reaches the bound
+    // connects two nodes between which the flow value is at least the
+    // bound. The nodes scanned by the other threads are skipped, i.e.
+    // they are removed from the graph, which does not affect this
+    // property.
+    template <typename Heap>
+    void scan(Workspace& work, const IntVector& order,
+              std::atomic<int>& next) {
+      const int n = order.size();
+      const Value bound = _min_cut;
+      Heap heap(work.cross_ref);
+      int k;
+      while ((k = next.fetch_add(1, std::memory_order_relaxed)) < n) {
+        int s = order[k];
+        if (_scanned[s].load(std::memory_order_relaxed) != 0 ||
+            heap.state(s) != Heap::PRE_HEAP) continue;
+        heap.push(s, 0);
+        work.touched.push_back(s);
+
+        while (!heap.empty()) {
+          int v = heap.top();
+          heap.pop();
+          if (_scanned[v].exchange(1, std::memory_order_relaxed) != 0) {
+            continue;
+          }
+          for (int a = _first[v]; a != _first[v + 1]; ++a) {
+            int t = _arcs[a].target;
+            typename Heap::State state = heap.state(t);
+            if (state == Heap::POST_HEAP) continue;
+            Value& prio = work.prio[t];
+            if (prio < bound) {
+              prio += _arcs[a].cap;
+              if (prio >= bound) {
+                prio = bound;
+                work.marked.push_back(_arcs[a].edge);
+              }
+              if (state == Heap::PRE_HEAP) {
+                heap.push(t, prio);
+                work.touched.push_back(t);
+              } else {
+                heap.decrease(t, prio);
+              }
+            } else {
+              work.marked.push_back(_arcs[a].edge);
+            }
+          }
+        }
+      }
+
+      for (int i = 0; i != int(work.touched.size()); ++i) {
+        work.prio[work.touched[i]] = 0;
+        work.cross_ref[work.touched[i]] = Heap::PRE_HEAP;
+      }
+      work.touched.clear();
+    }
+
+    // Karger-Stein algorithm
+
+    void startKargerStein() {
+      int trials = _trial_num;
+      if (trials <= 0) {
+        int lg = 1;
+        while ((1 << lg) < _node_num) ++lg;
+        trials = lg * lg;
+      }
+
+      bits::ThreadPool pool(std::max(std::min(threadCount(), trials), 1));
+      ValueVector values(pool.size(), std::numeric_limits<Value>::max());
+      IntVector first_trial(pool.size(), trials);
+      std::vector<CharVector> cuts(pool.size());
+      std::atomic<int> next(0);
+      pool.run([&](int id) {
+        Random rnd;
+        CharVector cut;
+        int k;
+        while ((k = next.fetch_add(1, std::memory_order_relaxed)) < trials) {
+          rnd.seed(_seed + k);
+          Value value = contractRecursive(_node_num, _edges, rnd, cut);
+          if (value < values[id] ||
+              (value == values[id] && k < first_trial[id])) {
+            values[id] = value;
+            first_trial[id] = k;
+            cuts[id].swap(cut);
+          }
+        }
+      });
+
+      // The result of the first best trial does not depend on the
+      // number of threads
+      int best = 0;
+      for (int i = 1; i != pool.size(); ++i) {
+        if (values[i] < values[best] || (values[i] == values[best] &&
+                                         first_trial[i] < first_trial[best])) {
+          best = i;
+        }
+      }
+      _min_cut = values[best];
+      _cut.swap(cuts[best]);
+    }
+
+    // Find a small cut of the given connected graph by contracting it
+    // randomly to two smaller graphs and solving them recursively
+    Value contractRecursive(int n, const EdgeVector& edges, Random& rnd,
+                            CharVector& cut) const {
+      cut.assign(n, 0);
+      if (n <= EXACT_LIMIT) return exactMinCut(n, edges, cut);
+
+      Value best;
+      cut[minDegree(n, edges, best)] = 1;
+
+      int num = static_cast<int>(std::ceil(1 + n / std::sqrt(2.0)));
+      IntVector label;
+      EdgeVector contracted;
+      CharVector sub_cut;
+      for (int i = 0; i != 2; ++i) {
+        randomContract(n, edges, num, rnd, label, contracted);
+        Value value = contractRecursive(num, contracted, rnd, sub_cut);
+        if (value < best) {
+          best = value;
+          for (int v = 0; v != n; ++v) {
+            cut[v] = sub_cut[label[v]];
+          }
+        }
+      }
+      return best;
+    }
+
+    // Contract randomly chosen edges (the probability of an edge is
+    // proportional to its capacity) until num nodes remain. The edges
+    // are sampled with replacement and the loops are rejected while
+    // the rejections are not too frequent, then the remaining edges are
+    // contracted in the increasing order of exponentially distributed
+    // random keys. Both methods follow the same distribution.
+    static void randomContract(int n, const EdgeVector& edges, int num,
+                               Random& rnd, IntVector& label,
+                               EdgeVector& contracted) {
+      const int m = edges.size();
+      IntVector parent(n);
+      for (int v = 0; v != n; ++v) parent[v] = v;
+      int rem = n;
+
+      std::vector<double> sum(m);
+      double total = 0;
+      for (int i = 0; i != m; ++i) {
+        total += static_cast<double>(edges[i].cap);
+        sum[i] = total;
+      }
+      for (int rejected = 0; rem > num && rejected <= n - num + 64; ) {
+        int i = std::upper_bound(sum.begin(), sum.end(), rnd() * total) -
+          sum.begin();
+        int u = find(parent, edges[std::min(i, m - 1)].u);
+        int v = find(parent, edges[std::min(i, m - 1)].v);
+        if (u != v) {
+          parent[u] = v;
+          --rem;
+        } else {
+          ++rejected;
+        }
+      }
+
+      if (rem > num) {
+        std::vector<std::pair<double, int> > keys;
+        for (int i = 0; i != m; ++i) {
+          if (find(parent, edges[i].u) == find(parent, edges[i].v)) continue;
+          keys.push_back(std::make_pair(-std::log(1.0 - rnd()) /
+                                        static_cast<double>(edges[i].cap), i));
+        }
+        std::sort(keys.begin(), keys.end());
+        for (int k = 0; k != int(keys.size()) && rem > num; ++k) {
+          const EdgeData& e = edges[keys[k].second];
+          int u = find(parent, e.u), v = find(parent, e.v);
+          if (u != v) {
+            parent[u] = v;
+            --rem;
+          }
+        }
+      }
+      labelComponents(parent, label);
+      contractEdges(edges, label, num, contracted);
+    }
+
+    // Find a minimum cut of a small graph with the algorithm of Stoer
+    // and Wagner, i.e. by contracting the last two nodes of maximum
+    // adjacency orderings using an adjacency matrix
+    static Value exactMinCut(int n, const EdgeVector& edges,
+                             CharVector& cut) {
+      ValueVector w(n * n, 0);
+      for (int i = 0; i != int(edges.size()); ++i) {
+        w[edges[i].u * n + edges[i].v] += edges[i].cap;
+        w[edges[i].v * n + edges[i].u] += edges[i].cap;
+      }
+      // The nodes merged into node v are v, next[v], next[next[v]], ...
+      IntVector nodes(n), next(n, -1), last(n);
+      for (int v = 0; v != n; ++v) nodes[v] = last[v] = v;
+
+      Value best = std::numeric_limits<Value>::max();
+      ValueVector key(n);
+      CharVector added(n);
+      for (int k = n; k > 1; --k) {
+        for (int i = 0; i != k; ++i) {
+          key[nodes[i]] = 0;
+          added[nodes[i]] = 0;
+        }
+        int s = -1, t = -1;
+        for (int i = 0; i != k; ++i) {
+          int u = -1;
+          for (int j = 0; j != k; ++j) {
+            int v = nodes[j];
+            if (!added[v] && (u == -1 || key[v] > key[u])) u = v;
+          }
+          added[u] = 1;
+          s = t;
+          t = u;
+          for (int j = 0; j != k; ++j) {
+            int v = nodes[j];
+            if (!added[v]) key[v] += w[u * n + v];
+          }
+        }
+
+        if (key[t] < best) {
+          best = key[t];
+          cut.assign(n, 0);
+          for (int v = t; v != -1; v = next[v]) cut[v] = 1;
+        }
+
+        for (int j = 0; j != k; ++j) {
+          int v = nodes[j];
+          w[s * n + v] += w[t * n + v];
+          w[v * n + s] = w[s * n + v];
+        }
+        w[s * n + s] = 0;
+        next[last[s]] = t;
+        last[s] = last[t];
+        *std::find(nodes.begin(), nodes.begin() + k, t) = nodes[k - 1];
+      }
+      return best;
+    }
+
+  };
+
+} //namespace lemon
+
+#endif //LEMON_PARALLEL_MIN_CUT_H
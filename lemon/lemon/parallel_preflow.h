@@ -0,0 +1,722 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_PARALLEL_PREFLOW_H
+#define LEMON_PARALLEL_PREFLOW_H
+
+/// \ingroup max_flow
+///
+/// \file
+/// \brief Parallel push-relabel algorithm for finding a maximum flow.
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include <lemon/core.h>
+#include <lemon/tolerance.h>
+#include <lemon/preflow.h>
+#include <lemon/bits/thread_pool.h>
+
+namespace lemon {
+
+  /// \ingroup max_flow
+  ///
+  /// \brief Parallel push-relabel algorithm for finding a maximum flow.
+  ///
+  /// This class implements the synchronous parallel push-relabel
+  /// algorithm of Baumstark, Blelloch and Shun \cite baumstark15efficient
+  /// for finding a \ref max_flow "flow of maximum value" in a digraph.
+  /// It has the same interface as \ref Preflow.
+  ///
+  /// The residual graph is stored in compressed sparse row (CSR) form,
+  /// i.e. the residual arcs of each node are stored contiguously.
+  /// The algorithm works in rounds. In each round, all active nodes push
+  /// their excess concurrently on the admissible arcs with respect to
+  /// the labels of the previous round, then the nodes that still have
+  /// excess are relabeled concurrently, and finally the new labels and
+  /// the received excesses are applied. Since an admissible arc goes
+  /// down by one level, two nodes never push on the two directions of
+  /// the same arc in a round, so the pushes require no locks, only
+  /// atomic additions to the excesses of the target nodes.
+  /// The exact distance labels are periodically recomputed by a
+  /// concurrent breadth-first search from the target
+  /// (see \ref globalRelabelFrequency()).
+  ///
+  /// The algorithm consists of two phases like \ref Preflow. The first
+  /// phase, which computes the maximum flow value and a minimum cut, is
+  /// performed in parallel. The second phase, which converts the maximum
+  /// preflow into a feasible flow, is performed sequentially by
+  /// \ref Preflow, so it does not scale with the number of threads.
+  /// It is usually much faster than the first phase, but if only the
+  /// flow value or a minimum cut is needed, use \ref runMinCut().
+  ///
+  /// \warning This implementation cannot handle infinite or very large
+  /// capacities (e.g. the maximum value of \c CAP::Value).
+  ///
+  /// \tparam GR The type of the digraph the algorithm runs on.
+  /// \tparam CAP The type of the capacity map. The default map
+  /// type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
+  template <typename GR,
+            typename CAP = typename GR::template ArcMap<int> >
+  class ParallelPreflow {
+  public:
+
+    /// The type of the digraph the algorithm runs on.
+    typedef GR Digraph;
+    /// The type of the capacity map.
+    typedef CAP CapacityMap;
+    /// The type of the flow values.
+    typedef typename CapacityMap::Value Value;
+    /// The type of the flow map.
+    typedef typename Digraph::template ArcMap<Value> FlowMap;
+    /// The type of the tolerance.
+    typedef lemon::Tolerance<Value> Tolerance;
+
+  private:
+
+    TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+
+    typedef std::vector<int> IntVector;
+    typedef std::vector<char> CharVector;
+    typedef std::vector<Value> ValueVector;
+    typedef std::vector<std::atomic<Value> > AtomicValueVector;
+    typedef std::vector<std::atomic<char> > AtomicCharVector;
+
+    // The number of items processed by a thread at once
+    static const int CHUNK_SIZE = 64;
+    // Smaller sets of items are processed by the calling thread only
+    static const int PARALLEL_LIMIT = 512;
+
+    const Digraph& _graph;
+    const CapacityMap* _capacity;
+    Node _source, _target;
+
+    FlowMap* _flow;
+    bool _local_flow;
+
+    Tolerance _tolerance;
+    int _thread_num;
+    double _global_relabel_freq;
+    bits::ThreadPool* _pool;
+
+    // The residual graph in CSR form: the residual arcs of node v are
+    // _first[v].._first[v+1]-1, _rev[a] is the reverse of arc a
+    int _node_num;
+    int _arc_num;
+    IntNodeMap _node_id;
+    IntArcMap _arc_id;
+    IntVector _first;
+    IntVector _head;
+    IntVector _rev;
+    AtomicValueVector _res;
+    int _s, _t;
+
+    // The node data: the labels are changed only between the rounds,
+    // the received excess is collected in _added during the rounds
+    IntVector _label;
+    IntVector _new_label;
+    ValueVector _excess;
+    AtomicValueVector _added;
+    AtomicCharVector _discovered;
+    CharVector _is_active;
+    CharVector _cut;
+
+    // The active nodes, the nodes discovered in the current round
+    // (by each thread) and the queues of the breadth-first search
+    IntVector _active;
+    IntVector _next;
+    std::vector<IntVector> _buffers;
+    std::atomic<long long> _work;
+
+  public:
+
+    /// \brief The constructor of the class.
+    ///
+    /// The constructor of the class.
+    /// \param digraph The digraph the algorithm runs on.
+    /// \param capacity The capacity of the arcs.
+    /// \param source The source node.
+    /// \param target The target node.
+    ParallelPreflow(const Digraph& digraph, const CapacityMap& capacity,
+                    Node source, Node target)
+      : _graph(digraph), _capacity(&capacity),
+        _source(source), _target(target),
+        _flow(0), _local_flow(false), _tolerance(),
+        _thread_num(0), _global_relabel_freq(0.5), _pool(0),
+        _node_num(0), _arc_num(0), _node_id(digraph), _arc_id(digraph),
+        _s(-1), _t(-1), _work(0) {}
+
+    /// \brief Destructor.
+    ///
+    /// Destructor.
+    ~ParallelPreflow() {
+      if (_local_flow) delete _flow;
+      delete _pool;
+    }
+
+    /// \brief Sets the capacity map.
+    ///
+    /// Sets the capacity map.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& capacityMap(const CapacityMap& map) {
+      _capacity = &map;
+      return *this;
+    }
+
+    /// \brief Sets the flow map.
+    ///
+    /// Sets the flow map.
+    /// If you don't use this function before calling \ref run() or
+    /// \ref init(), an instance will be allocated automatically.
+    /// The destructor deallocates this automatically allocated map,
+    /// of course.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& flowMap(FlowMap& map) {
+      if (_local_flow) {
+        delete _flow;
+        _local_flow = false;
+      }
+      _flow = &map;
+      return *this;
+    }
+
+    /// \brief Sets the source node.
+    ///
+    /// Sets the source node.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& source(const Node& node) {
+      _source = node;
+      return *this;
+    }
+
+    /// \brief Sets the target node.
+    ///
+    /// Sets the target node.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& target(const Node& node) {
+      _target = node;
+      return *this;
+    }
+
+    /// \brief Sets the tolerance used by the algorithm.
+    ///
+    /// Sets the tolerance object used by the algorithm.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& tolerance(const Tolerance& tolerance) {
+      _tolerance = tolerance;
+      return *this;
+    }
+
+    /// \brief Returns a const reference to the tolerance.
+    ///
+    /// Returns a const reference to the tolerance object used by
+    /// the algorithm.
+    const Tolerance& tolerance() const {
+      return _tolerance;
+    }
+
+    /// \brief Sets the number of threads.
+    ///
+    /// Sets the number of threads used by the algorithm. If it is not
+    /// used before calling \ref run() or \ref init(), or the given value
+    /// is not positive, the number of hardware threads will be used.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& threadNum(int num) {
+      _thread_num = num;
+      return *this;
+    }
+
+    /// \brief Sets the frequency of the global relabeling.
+    ///
+    /// Sets the frequency of the global relabeling, see
+    /// \ref Preflow::globalRelabelFrequency(). The labels are
+    /// recomputed by a concurrent breadth-first search. If the given
+    /// value is not positive, the labels are computed only once in
+    /// \ref init(). The default value is \c 0.5.
+    /// \return <tt>(*this)</tt>
+    ParallelPreflow& globalRelabelFrequency(double freq) {
+      _global_relabel_freq = freq;
+      return *this;
+    }
+
+    /// \name Execution Control
+    /// The simplest way to execute the algorithm is to use \ref run() or
+    /// \ref runMinCut().\n
+    /// If you need more control on the execution, first you have to call
+    /// \ref init(), then \ref startFirstPhase() and if you need it
+    /// \ref startSecondPhase().
+
+    ///@{
+
+    /// \brief Initializes the internal data structures.
+    ///
+    /// Initializes the internal data structures (including the residual
+    /// graph and the threads) and sets the initial flow to zero on
+    /// each arc.
+    void init() {
+      if (!_flow) {
+        _flow = new FlowMap(_graph);
+        _local_flow = true;
+      }
+      buildResidualGraph();
+      const int n = _node_num;
+
+      int num = std::max(std::min(_thread_num > 0 ? _thread_num :
+                                  bits::hardwareThreadNum(), n), 1);
+      if (_pool == 0 || _pool->size() != num) {
+        delete _pool;
+        _pool = new bits::ThreadPool(num);
+      }
+      _buffers.resize(num);
+
+      _label.assign(n, 0);
+      _new_label.assign(n, 0);
+      _excess.assign(n, 0);
+      _is_active.assign(n, 0);
+      _cut.assign(n, 0);
+      AtomicValueVector(n).swap(_added);
+      AtomicCharVector(n).swap(_discovered);
+      parallelFor(n, [&](int, int first, int last) {
+        for (int v = first; v != last; ++v) {
+          _added[v].store(0, std::memory_order_relaxed);
+          _discovered[v].store(0, std::memory_order_relaxed);
+        }
+      });
+
+      // Saturate the arcs leaving the source
+      for (int a = _first[_s]; a != _first[_s + 1]; ++a) {
+        Value r = _res[a].load(std::memory_order_relaxed);
+        if (!_tolerance.positive(r)) continue;
+        int b = _rev[a];
+        _res[a].store(0, std::memory_order_relaxed);
+        _res[b].store(_res[b].load(std::memory_order_relaxed) + r,
+                      std::memory_order_relaxed);
+        _excess[_head[a]] += r;
+        _excess[_s] -= r;
+      }
+
+      globalRelabel();
+      _active.clear();
+      for (int v = 0; v != n; ++v) {
+        if (v != _s && v != _t && _label[v] < n &&
+            _tolerance.positive(_excess[v])) {
+          _active.push_back(v);
+          _is_active[v] = 1;
+        }
+      }
+    }
+
+    /// \brief Starts the first phase of the algorithm.
+    ///
+    /// The algorithm consists of two phases, this method runs the first
+    /// phase in parallel. After the first phase the maximum flow value
+    /// and a minimum value cut can already be computed, although a
+    /// maximum flow is not yet obtained. So after calling this method
+    /// \ref flowValue() returns the value of a maximum flow, \ref minCut()
+    /// returns a minimum cut and \ref flowMap() contains a maximum
+    /// preflow.
+    /// \pre \ref init() must be called before using this function.
+    void startFirstPhase() {
+      const int n = _node_num;
+      const double relabel_limit = _global_relabel_freq > 0 ?
+        (6.0 * n + _arc_num) / _global_relabel_freq : 0;
+
+      while (!_active.empty()) {
+        if (relabel_limit > 0 && _work.load() > relabel_limit) {
+          globalRelabel();
+          int k = 0;
+          for (int i = 0; i != int(_active.size()); ++i) {
+            int v = _active[i];
+            if (_label[v] < n) {
+              _active[k++] = v;
+            } else {
+              _is_active[v] = 0;
+            }
+          }
+          _active.resize(k);
+          if (k == 0) break;
+        }
+        pushRelabelRound();
+      }
+
+      // The nodes from which the target cannot be reached form the
+      // source side of a minimum cut
+      globalRelabel();
+      for (int v = 0; v != n; ++v) {
+        _cut[v] = _label[v] == n;
+      }
+      for (ArcIt e(_graph); e != INVALID; ++e) {
+        int a = _arc_id[e];
+        _flow->set(e, a < 0 ? 0 :
+                   _res[_rev[a]].load(std::memory_order_relaxed));
+      }
+    }
+
+    /// \brief Starts the second phase of the algorithm.
+    ///
+    /// The algorithm consists of two phases, this method runs the
+    /// second phase, which converts the maximum preflow into a maximum
+    /// flow using \ref Preflow. It is not parallelized: Preflow is
+    /// initialized from the preflow (which takes linear time, since no
+    /// node with excess can reach the target), then the excesses are
+    /// returned to the source sequentially. After calling \ref init(),
+    /// \ref startFirstPhase() and then \ref startSecondPhase(),
+    /// \ref flowMap() returns a maximum flow.
+    /// \pre \ref init() and \ref startFirstPhase() must be called before
+    /// using this function.
+    void startSecondPhase() {
+      Preflow<Digraph, CapacityMap> preflow(_graph, *_capacity,
+                                            _source, _target);
+      preflow.tolerance(_tolerance).flowMap(*_flow);
+      preflow.init(*_flow);
+      preflow.startFirstPhase();
+      preflow.startSecondPhase();
+    }
+
+    /// \brief Runs the algorithm.
+    ///
+    /// Runs the algorithm.
+    /// \note pf.run() is just a shortcut of the following code.
+    /// \code
+    ///   pf.init();
+    ///   pf.startFirstPhase();
+    ///   pf.startSecondPhase();
+    /// \endcode
+    void run() {
+      init();
+      startFirstPhase();
+      startSecondPhase();
+    }
+
+    /// \brief Runs the algorithm to compute the minimum cut.
+    ///
+    /// Runs the algorithm to compute the minimum cut.
+    /// \note pf.runMinCut() is just a shortcut of the following code.
+    /// \code
+    ///   pf.init();
+    ///   pf.startFirstPhase();
+    /// \endcode
+    void runMinCut() {
+      init();
+      startFirstPhase();
+    }
+
+    /// @}
+
+    /// \name Query Functions
+    /// The results of the algorithm can be obtained using these
+    /// functions.\n
+    /// \ref startFirstPhase() (or one of the run functions) must be
+    /// called before using them.
+
+    ///@{
+
+    /// \brief Returns the value of the maximum flow.
+    ///
+    /// Returns the value of the maximum flow. This value is already
+    /// computed by the first phase of the algorithm.
+    Value flowValue() const {
+      return _excess[_t];
+    }
+
+    /// \brief Returns the flow value on the given arc.
+    ///
+    /// Returns the flow value on the given arc. After the first phase,
+    /// it is the value of a maximum preflow.
+    Value flow(const Arc& arc) const {
+      return (*_flow)[arc];
+    }
+
+    /// \brief Returns a const reference to the flow map.
+    ///
+    /// Returns a const reference to the arc map storing the found flow.
+    /// After the first phase, it stores a maximum preflow.
+    const FlowMap& flowMap() const {
+      return *_flow;
+    }
+
+    /// \brief Returns \c true when the node is on the source side of the
+    /// minimum cut.
+    ///
+    /// Returns true when the node is on the source side of the found
+    /// minimum cut, i.e. the target cannot be reached from it in the
+    /// residual graph of the maximum preflow.
+    bool minCut(const Node& node) const {
+      return _cut[_node_id[node]] != 0;
+    }
+
+    /// \brief Gives back a minimum value cut.
+    ///
+    /// Sets \c cutMap to the characteristic vector of a minimum value
+    /// cut. \c cutMap should be a \ref concepts::WriteMap "writable"
+    /// node map with \c bool (or convertible) value type.
+    template <typename CutMap>
+    void minCutMap(CutMap& cutMap) const {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        cutMap.set(n, minCut(n));
+      }
+    }
+
+    /// @}
+
+  private:
+
+    static void atomicAdd(std::atomic<Value>& a, Value d, std::true_type) {
+      a.fetch_add(d, std::memory_order_relaxed);
+    }
+
+    static void atomicAdd(std::atomic<Value>& a, Value d, std::false_type) {
+      Value old = a.load(std::memory_order_relaxed);
+      while (!a.compare_exchange_weak(old, old + d,
+                                      std::memory_order_relaxed)) {}
+    }
+
+    static void atomicAdd(std::atomic<Value>& a, Value d) {
+      atomicAdd(a, d, std::integral_constant<bool,
+                std::numeric_limits<Value>::is_integer>());
+    }
+
+    // Mark the node as discovered, return true for the first time
+    bool discover(int v) {
+      return _discovered[v].load(std::memory_order_relaxed) == 0 &&
+        _discovered[v].exchange(1, std::memory_order_relaxed) == 0;
+    }
+
+    // Call task(thread, first, last) for consecutive ranges of [0, size)
+    // on the threads of the pool
+    template <typename Task>
+    void parallelFor(int size, const Task& task) {
+      if (_pool->size() == 1 || size < PARALLEL_LIMIT) {
+        if (size > 0) task(0, 0, size);
+        return;
+      }
+      std::atomic<int> next(0);
+      _pool->run([&](int id) {
+        int k;
+        while ((k = next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed))
+               < size) {
+          task(id, k, std::min(k + CHUNK_SIZE, size));
+        }
+      });
+    }
+
+    // Move the nodes collected by the threads into _next
+    void gatherBuffers() {
+      _next.clear();
+      for (int i = 0; i != int(_buffers.size()); ++i) {
+        _next.insert(_next.end(), _buffers[i].begin(), _buffers[i].end());
+        _buffers[i].clear();
+      }
+    }
+
+    void buildResidualGraph() {
+      int n = 0;
+      for (NodeIt v(_graph); v != INVALID; ++v) {
+        _node_id[v] = n++;
+      }
+      _node_num = n;
+      _s = _node_id[_source];
+      _t = _node_id[_target];
+
+      _first.assign(n + 1, 0);
+      int m = 0;
+      for (ArcIt e(_graph); e != INVALID; ++e) {
+        int u = _node_id[_graph.source(e)], v = _node_id[_graph.target(e)];
+        if (u == v) continue;
+        ++_first[u + 1];
+        ++_first[v + 1];
+        ++m;
+      }
+      _arc_num = m;
+      for (int v = 0; v != n; ++v) {
+        _first[v + 1] += _first[v];
+      }
+
+      IntVector pos(_first.begin(), _first.end() - 1);
+      _head.resize(2 * m);
+      _rev.resize(2 * m);
+      AtomicValueVector(2 * m).swap(_res);
+      for (ArcIt e(_graph); e != INVALID; ++e) {
+        int u = _node_id[_graph.source(e)], v = _node_id[_graph.target(e)];
+        if (u == v) {
+          _arc_id[e] = -1;
+          continue;
+        }
+        int a = pos[u]++, b = pos[v]++;
+        _head[a] = v;
+        _head[b] = u;
+        _rev[a] = b;
+        _rev[b] = a;
+        _res[a].store((*_capacity)[e], std::memory_order_relaxed);
+        _res[b].store(0, std::memory_order_relaxed);
+        _arc_id[e] = a;
+      }
+    }
+
+    // Push the excess of the active node v on its admissible arcs with
+    // respect to the labels of the previous round. An admissible arc goes
+    // down by one level, so the arcs v->w and w->v are never pushed on
+    // concurrently and only v writes their residual capacities.
+    void push(int v, IntVector& discovered) {
+      const int d = _label[v];
+      Value e = _excess[v];
+      for (int a = _first[v]; a != _first[v + 1]; ++a) {
+        if (!_tolerance.positive(e)) break;
+        const int w = _head[a];
+        if (_label[w] + 1 != d) continue;
+        Value r = _res[a].load(std::memory_order_relaxed);
+        if (!_tolerance.positive(r)) continue;
+        Value delta = _tolerance.less(r, e) ? r : e;
+        const int b = _rev[a];
+        e -= delta;
+        _res[a].store(r - delta, std::memory_order_relaxed);
+        _res[b].store(_res[b].load(std::memory_order_relaxed) + delta,
+                      std::memory_order_relaxed);
+        atomicAdd(_added[w], delta);
+        if (discover(w)) discovered.push_back(w);
+      }
+      _excess[v] = e;
+    }
+
+    // Relabel the active node v if it still has excess after the push
+    // step. The residual capacities are not changed in this step, so the
+    // new label is at most one more than the old label of any residual
+    // neighbor (and the labels of the neighbors cannot decrease).
+    // Returns the work spent on relabeling.
+    long long relabel(int v, IntVector& discovered) {
+      const int n = _node_num;
+      _new_label[v] = _label[v];
+      if (!_tolerance.positive(_excess[v])) return 0;
+      int new_label = n;
+      for (int a = _first[v]; a != _first[v + 1]; ++a) {
+        const int dw = _label[_head[a]];
+        if (dw + 1 < new_label &&
+            _tolerance.positive(_res[a].load(std::memory_order_relaxed))) {
+          new_label = dw + 1;
+        }
+      }
+      _new_label[v] = new_label;
+      if (new_label < n && discover(v)) discovered.push_back(v);
+      return _first[v + 1] - _first[v] + 12;
+    }
+
+    // One synchronous round: push from the active nodes, relabel the
+    // ones that still have excess, then apply the new labels and the
+    // received excesses
+    void pushRelabelRound() {
+      const int n = _node_num;
+      parallelFor(int(_active.size()), [&](int id, int first, int last) {
+        for (int k = first; k != last; ++k) {
+          push(_active[k], _buffers[id]);
+        }
+      });
+      parallelFor(int(_active.size()), [&](int id, int first, int last) {
+        long long work = 0;
+        for (int k = first; k != last; ++k) {
+          work += relabel(_active[k], _buffers[id]);
+        }
+        _work.fetch_add(work, std::memory_order_relaxed);
+      });
+      gatherBuffers();
+
+      parallelFor(int(_active.size()), [&](int, int first, int last) {
+        for (int k = first; k != last; ++k) {
+          int v = _active[k];
+          _label[v] = _new_label[v];
+          _is_active[v] = 0;
+        }
+      });
+      parallelFor(int(_next.size()), [&](int, int first, int last) {
+        for (int k = first; k != last; ++k) {
+          int v = _next[k];
+          _excess[v] += _added[v].load(std::memory_order_relaxed);
+          _added[v].store(0, std::memory_order_relaxed);
+          _discovered[v].store(0, std::memory_order_relaxed);
+          _is_active[v] = v != _t && _label[v] < n &&
+            _tolerance.positive(_excess[v]);
+        }
+      });
+
+      _active.clear();
+      for (int k = 0; k != int(_next.size()); ++k) {
+        if (_is_active[_next[k]]) _active.push_back(_next[k]);
+      }
+      LEMON_DEBUG(checkLabels(), "Invalid distance labels");
+    }
+
+    // Check that d(u) <= d(v) + 1 holds for each residual arc (u, v)
+    bool checkLabels() const {
+      for (int u = 0; u != _node_num; ++u) {
+        for (int a = _first[u]; a != _first[u + 1]; ++a) {
+          if (_tolerance.positive(_res[a].load(std::memory_order_relaxed)) &&
+              _label[u] > _label[_head[a]] + 1) return false;
+        }
+      }
+      return true;
+    }
+
+    // Set the labels to the exact distances to the target in the
+    // residual graph by a concurrent breadth-first search (the flags of
+    // _discovered are used as visited flags). The source and the nodes
+    // from which the target cannot be reached get label n.
+    void globalRelabel() {
+      const int n = _node_num;
+      parallelFor(n, [&](int, int first, int last) {
+        for (int v = first; v != last; ++v) _label[v] = n;
+      });
+      _label[_t] = 0;
+      _discovered[_t].store(1, std::memory_order_relaxed);
+      _discovered[_s].store(1, std::memory_order_relaxed);
+
+      IntVector queue(1, _t);
+      for (int level = 1; !queue.empty(); ++level) {
+        parallelFor(int(queue.size()), [&](int id, int first, int last) {
+          IntVector& found = _buffers[id];
+          for (int k = first; k != last; ++k) {
+            int x = queue[k];
+            for (int a = _first[x]; a != _first[x + 1]; ++a) {
+              int u = _head[a];
+              if (_tolerance.positive(
+                    _res[_rev[a]].load(std::memory_order_relaxed)) &&
+                  discover(u)) {
+                _label[u] = level;
+                found.push_back(u);
+              }
+            }
+          }
+        });
+        gatherBuffers();
+        queue.swap(_next);
+      }
+
+      parallelFor(n, [&](int, int first, int last) {
+        for (int v = first; v != last; ++v) {
+          _discovered[v].store(0, std::memory_order_relaxed);
+        }
+      });
+      _work.store(0);
+    }
+
+  }; //class ParallelPreflow
+
+} //namespace lemon
+
+#endif //LEMON_PARALLEL_PREFLOW_H
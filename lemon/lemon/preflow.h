@@ -19,6 +19,9 @@
 #ifndef LEMON_PREFLOW_H
 #define LEMON_PREFLOW_H
 
+#include <algorithm>
+#include <vector>
+
 #include <lemon/tolerance.h>
 #include <lemon/elevator.h>
 
@@ -106,7 +109,9 @@ namespace lemon {
   /// \cite amo93networkflows, \cite goldberg88newapproach.
   /// The preflow algorithms are the fastest known maximum
   /// flow algorithms. The current implementation uses a mixture of the
-  /// \e "highest label" and the \e "bound decrease" heuristics.
+  /// \e "highest label" and the \e "bound decrease" heuristics, and the
+  /// distance labels are periodically recomputed by \e "global
+  /// relabeling" (see \ref globalRelabelFrequency()).
   /// The worst case time complexity of the algorithm is \f$O(n^2\sqrt{m})\f$.
   ///
   /// The algorithm consists of two phases. After the first phase
@@ -174,6 +179,15 @@ namespace lemon {
 
     bool _phase;
 
+    double _global_relabel_freq;
+    long long _relabel_work;
+
+    // The nodes whose excess or outgoing flows can be nonzero since the
+    // last init(), only these are reset by the next init() if the flow
+    // map is local (so it cannot be changed outside)
+    std::vector<Node> _touched;
+    bool _touched_valid;
+
 
     void createStructures() {
       _node_num = countNodes(_graph);
@@ -203,6 +217,133 @@ namespace lemon {
       }
     }
 
+    // Set the levels to the exact distances to the target in the
+    // residual graph (by a reverse BFS), the nodes from which the target
+    // is not reachable are put on the top level
+    void residualLevels() {
+      typename Digraph::template NodeMap<bool> reached(_graph, false);
+
+      _level->initStart();
+      _level->initAddItem(_target);
+
+      std::vector<Node> queue;
+      reached[_source] = true;
+
+      queue.push_back(_target);
+      reached[_target] = true;
+      while (!queue.empty()) {
+        _level->initNewLevel();
+        std::vector<Node> nqueue;
+        for (int i = 0; i < int(queue.size()); ++i) {
+          Node n = queue[i];
+          for (InArcIt e(_graph, n); e != INVALID; ++e) {
+            Node u = _graph.source(e);
+            if (!reached[u] &&
+                _tolerance.positive((*_capacity)[e] - (*_flow)[e])) {
+              reached[u] = true;
+              _level->initAddItem(u);
+              nqueue.push_back(u);
+            }
+          }
+          for (OutArcIt e(_graph, n); e != INVALID; ++e) {
+            Node v = _graph.target(e);
+            if (!reached[v] && _tolerance.positive((*_flow)[e])) {
+              reached[v] = true;
+              _level->initAddItem(v);
+              nqueue.push_back(v);
+            }
+          }
+        }
+        queue.swap(nqueue);
+      }
+      _level->initFinish();
+    }
+
+    // Global relabeling in the first phase: recompute the exact labels
+    // and reactivate the nodes with positive excess below the top level
+    void globalRelabel() {
+      residualLevels();
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        if (n != _target && (*_level)[n] < _level->maxLevel() &&
+            _tolerance.positive((*_excess)[n])) {
+          _level->activate(n);
+        }
+      }
+      _relabel_work = 0;
+    }
+
+    // Compute the exact labels for the current preflow, saturate the
+    // arcs leaving the source and activate the nodes with excess
+    void initLevels() {
+      residualLevels();
+
+      for (OutArcIt e(_graph, _source); e != INVALID; ++e) {
+        Value rem = (*_capacity)[e] - (*_flow)[e];
+        if (_tolerance.positive(rem)) {
+          Node u = _graph.target(e);
+          if ((*_level)[u] == _level->maxLevel()) continue;
+          _flow->set(e, (*_capacity)[e]);
+          (*_excess)[u] += rem;
+        }
+      }
+      for (InArcIt e(_graph, _source); e != INVALID; ++e) {
+        Value rem = (*_flow)[e];
+        if (_tolerance.positive(rem)) {
+          Node v = _graph.source(e);
+          if ((*_level)[v] == _level->maxLevel()) continue;
+          _flow->set(e, 0);
+          (*_excess)[v] += rem;
+        }
+      }
+      for (NodeIt n(_graph); n != INVALID; ++n)
+        if(n!=_source && n!=_target && _tolerance.positive((*_excess)[n]))
+          _level->activate(n);
+    }
+
+    // Decrease the deficit of node v by decreasing the flow along a
+    // path of flow carrying arcs from v to the source or to a node with
+    // positive excess (such a node is always reachable if the flow is
+    // non-negative, since no flow leaves the set of reachable nodes)
+    void cancelDeficit(const Node& v,
+                       typename Digraph::template NodeMap<int>& stamp,
+                       int time) {
+      std::vector<OutArcIt> path;
+      path.push_back(OutArcIt(_graph, v));
+      stamp[v] = time;
+      Node end = INVALID;
+      while (!path.empty()) {
+        OutArcIt& e = path.back();
+        if (e == INVALID) {
+          path.pop_back();
+          if (!path.empty()) ++path.back();
+          continue;
+        }
+        Node w = _graph.target(e);
+        if (stamp[w] != time && _tolerance.positive((*_flow)[e])) {
+          stamp[w] = time;
+          if (w == _source || _tolerance.positive((*_excess)[w])) {
+            end = w;
+            break;
+          }
+          path.push_back(OutArcIt(_graph, w));
+          continue;
+        }
+        ++e;
+      }
+      LEMON_ASSERT(end != INVALID, "The flow map contains negative flows");
+
+      Value delta = -(*_excess)[v];
+      if (end != _source) delta = std::min(delta, (*_excess)[end]);
+      for (int i = 0; i != int(path.size()); ++i) {
+        delta = std::min(delta, (*_flow)[path[i]]);
+      }
+      for (int i = 0; i != int(path.size()); ++i) {
+        _flow->set(path[i], (*_flow)[path[i]] - delta);
+      }
+      (*_excess)[v] += delta;
+      (*_excess)[end] -= delta;
+    }
+
   public:
 
     typedef Preflow Create;
@@ -307,7 +448,9 @@ namespace lemon {
         _node_num(0), _source(source), _target(target),
         _flow(0), _local_flow(false),
         _level(0), _local_level(false),
-        _excess(0), _tolerance(), _phase() {}
+        _excess(0), _tolerance(), _phase(),
+        _global_relabel_freq(0.5), _relabel_work(0),
+        _touched_valid(false) {}
 
     /// \brief Destructor.
     ///
@@ -339,6 +482,7 @@ namespace lemon {
         _local_flow = false;
       }
       _flow = &map;
+      _touched_valid = false;
       return *this;
     }
 
@@ -404,6 +548,27 @@ namespace lemon {
       return _tolerance;
     }
 
+    /// \brief Sets the frequency of the global relabeling.
+    ///
+    /// Sets the frequency of the global relabeling heuristic
+    /// \cite cherkassky97implementing used in the first phase of the
+    /// algorithm. The exact distance labels are recomputed by a reverse
+    /// breadth-first search from the target in the residual graph
+    /// whenever the work spent on relabel operations since the last
+    /// recomputation exceeds <tt>(6n + m) / freq</tt>, which keeps the
+    /// labels from drifting away from the real distances. The nodes from
+    /// which the target is no longer reachable are lifted to the top
+    /// level at the same time.
+    ///
+    /// \param freq The frequency of the global relabeling. If it is not
+    /// positive, then the heuristic is disabled. The default value is
+    /// \c 0.5.
+    /// \return <tt>(*this)</tt>
+    Preflow& globalRelabelFrequency(double freq) {
+      _global_relabel_freq = freq;
+      return *this;
+    }
+
     /// \name Execution Control
     /// The simplest way to execute the preflow algorithm is to use
     /// \ref run() or \ref runMinCut().\n
@@ -417,45 +582,59 @@ namespace lemon {
     ///
     /// Initializes the internal data structures and sets the initial
     /// flow to zero on each arc.
+    ///
+    /// The data structures are reused by the subsequent calls (e.g.
+    /// for other source and target nodes). If the flow map is allocated
+    /// by the algorithm, these calls reset only the nodes and arcs
+    /// touched by the previous run, so only the initial labeling takes
+    /// \f$O(n)\f$ time besides the part of the digraph from which the
+    /// target is reachable.
+    /// \warning In this case the digraph must not be modified between
+    /// the runs.
     void init() {
       createStructures();
 
       _phase = true;
-      for (NodeIt n(_graph); n != INVALID; ++n) {
-        (*_excess)[n] = 0;
-      }
-
-      for (ArcIt e(_graph); e != INVALID; ++e) {
-        _flow->set(e, 0);
+      if (_touched_valid) {
+        for (int i = 0; i < int(_touched.size()); ++i) {
+          (*_excess)[_touched[i]] = 0;
+          for (OutArcIt e(_graph, _touched[i]); e != INVALID; ++e) {
+            _flow->set(e, 0);
+          }
+        }
+      } else {
+        for (NodeIt n(_graph); n != INVALID; ++n) {
+          (*_excess)[n] = 0;
+        }
+        for (ArcIt e(_graph); e != INVALID; ++e) {
+          _flow->set(e, 0);
+        }
       }
 
-      typename Digraph::template NodeMap<bool> reached(_graph, false);
-
+      // The nodes from which the target is reachable are collected in
+      // _touched in BFS order, the others stay on the top level
       _level->initStart();
       _level->initAddItem(_target);
 
-      std::vector<Node> queue;
-      reached[_source] = true;
-
-      queue.push_back(_target);
-      reached[_target] = true;
-      while (!queue.empty()) {
+      _touched.clear();
+      _touched.push_back(_target);
+      for (int first = 0, last = 1; first < last; last = _touched.size()) {
         _level->initNewLevel();
-        std::vector<Node> nqueue;
-        for (int i = 0; i < int(queue.size()); ++i) {
-          Node n = queue[i];
-          for (InArcIt e(_graph, n); e != INVALID; ++e) {
+        for (int i = first; i < last; ++i) {
+          for (InArcIt e(_graph, _touched[i]); e != INVALID; ++e) {
             Node u = _graph.source(e);
-            if (!reached[u] && _tolerance.positive((*_capacity)[e])) {
-              reached[u] = true;
+            if ((*_level)[u] == _level->maxLevel() && u != _source &&
+                _tolerance.positive((*_capacity)[e])) {
               _level->initAddItem(u);
-              nqueue.push_back(u);
+              _touched.push_back(u);
             }
           }
         }
-        queue.swap(nqueue);
+        first = last;
       }
       _level->initFinish();
+      _touched.push_back(_source);
+      _touched_valid = _local_flow;
 
       for (OutArcIt e(_graph, _source); e != INVALID; ++e) {
         if (_tolerance.positive((*_capacity)[e])) {
@@ -482,6 +661,7 @@ namespace lemon {
     template <typename FlowMap>
     bool init(const FlowMap& flowMap) {
       createStructures();
+      _touched_valid = false;
 
       for (ArcIt e(_graph); e != INVALID; ++e) {
         _flow->set(e, flowMap[e]);
@@ -499,66 +679,54 @@ namespace lemon {
         (*_excess)[n] = excess;
       }
 
-      typename Digraph::template NodeMap<bool> reached(_graph, false);
-
-      _level->initStart();
-      _level->initAddItem(_target);
+      initLevels();
+      return true;
+    }
 
-      std::vector<Node> queue;
-      reached[_source] = true;
+    /// \brief Initializes the algorithm from the flow of the previous
+    /// run, repairing it for the current capacities.
+    ///
+    /// Initializes the internal data structures using the current
+    /// content of the flow map (typically the result of a previous run)
+    /// after the capacities, the source or the target have changed.
+    /// On the arcs whose capacity has been decreased below their flow,
+    /// the flow is decreased to the capacity, and the excess created at
+    /// their source nodes is left to the algorithm. The deficits created
+    /// at their target nodes are cancelled by decreasing the flow along
+    /// paths of flow carrying arcs to nodes with positive excess (or to
+    /// the target, which decreases the flow value, or to the source,
+    /// e.g. if the terminals have been swapped). The arcs leaving the
+    /// source are saturated again, which also seeds excess through the
+    /// increased capacities. After that \ref startFirstPhase() only does
+    /// the push-relabel work that is necessary because of the changes.
+    /// \pre The flow map must not contain negative values.
+    void reinit() {
+      createStructures();
+      _touched_valid = false;
 
-      queue.push_back(_target);
-      reached[_target] = true;
-      while (!queue.empty()) {
-        _level->initNewLevel();
-        std::vector<Node> nqueue;
-        for (int i = 0; i < int(queue.size()); ++i) {
-          Node n = queue[i];
-          for (InArcIt e(_graph, n); e != INVALID; ++e) {
-            Node u = _graph.source(e);
-            if (!reached[u] &&
-                _tolerance.positive((*_capacity)[e] - (*_flow)[e])) {
-              reached[u] = true;
-              _level->initAddItem(u);
-              nqueue.push_back(u);
-            }
-          }
-          for (OutArcIt e(_graph, n); e != INVALID; ++e) {
-            Node v = _graph.target(e);
-            if (!reached[v] && _tolerance.positive((*_flow)[e])) {
-              reached[v] = true;
-              _level->initAddItem(v);
-              nqueue.push_back(v);
-            }
-          }
-        }
-        queue.swap(nqueue);
+      for (ArcIt e(_graph); e != INVALID; ++e) {
+        if ((*_flow)[e] > (*_capacity)[e]) _flow->set(e, (*_capacity)[e]);
       }
-      _level->initFinish();
-
-      for (OutArcIt e(_graph, _source); e != INVALID; ++e) {
-        Value rem = (*_capacity)[e] - (*_flow)[e];
-        if (_tolerance.positive(rem)) {
-          Node u = _graph.target(e);
-          if ((*_level)[u] == _level->maxLevel()) continue;
-          _flow->set(e, (*_capacity)[e]);
-          (*_excess)[u] += rem;
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        Value excess = 0;
+        for (InArcIt e(_graph, n); e != INVALID; ++e) {
+          excess += (*_flow)[e];
+        }
+        for (OutArcIt e(_graph, n); e != INVALID; ++e) {
+          excess -= (*_flow)[e];
         }
+        (*_excess)[n] = excess;
       }
-      for (InArcIt e(_graph, _source); e != INVALID; ++e) {
-        Value rem = (*_flow)[e];
-        if (_tolerance.positive(rem)) {
-          Node v = _graph.source(e);
-          if ((*_level)[v] == _level->maxLevel()) continue;
-          _flow->set(e, 0);
-          (*_excess)[v] += rem;
+
+      typename Digraph::template NodeMap<int> stamp(_graph, 0);
+      int time = 0;
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        while (n != _source && _tolerance.negative((*_excess)[n])) {
+          cancelDeficit(n, stamp, ++time);
         }
       }
-      for (NodeIt n(_graph); n != INVALID; ++n)
-        if(n!=_source && n!=_target && _tolerance.positive((*_excess)[n]))
-          _level->activate(n);
 
-      return true;
+      initLevels();
     }
 
     /// \brief Starts the first phase of the preflow algorithm.
@@ -574,6 +742,12 @@ namespace lemon {
     void startFirstPhase() {
       _phase = true;
 
+      // The relabel work allowed between two global relabelings
+      // (each relabel counts as the number of scanned arcs plus 12)
+      const double relabel_limit = _global_relabel_freq > 0 ?
+        (6.0 * _node_num + countArcs(_graph)) / _global_relabel_freq : 0;
+      _relabel_work = 0;
+
       while (true) {
         int num = _node_num;
 
@@ -581,6 +755,9 @@ namespace lemon {
         int level = -1;
 
         while (num > 0) {
+          if (relabel_limit > 0 && _relabel_work > relabel_limit) {
+            globalRelabel();
+          }
           n = _level->highestActive();
           if (n == INVALID) goto first_phase_done;
           level = _level->highestActiveLevel();
@@ -588,8 +765,9 @@ namespace lemon {
 
           Value excess = (*_excess)[n];
           int new_level = _level->maxLevel();
+          int scanned = 0;
 
-          for (OutArcIt e(_graph, n); e != INVALID; ++e) {
+          for (OutArcIt e(_graph, n); e != INVALID; ++e, ++scanned) {
             Value rem = (*_capacity)[e] - (*_flow)[e];
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.target(e);
@@ -612,7 +790,7 @@ namespace lemon {
             }
           }
 
-          for (InArcIt e(_graph, n); e != INVALID; ++e) {
+          for (InArcIt e(_graph, n); e != INVALID; ++e, ++scanned) {
             Value rem = (*_flow)[e];
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.source(e);
@@ -640,6 +818,7 @@ namespace lemon {
           (*_excess)[n] = excess;
 
           if (excess != 0) {
+            _relabel_work += 12 + scanned;
             if (new_level + 1 < _level->maxLevel()) {
               _level->liftHighestActive(new_level + 1);
             } else {
@@ -655,6 +834,10 @@ namespace lemon {
 
         num = _node_num * 20;
         while (num > 0) {
+          if (relabel_limit > 0 && _relabel_work > relabel_limit) {
+            globalRelabel();
+            level = -1;
+          }
           while (level >= 0 && _level->activeFree(level)) {
             --level;
           }
@@ -669,8 +852,9 @@ namespace lemon {
 
           Value excess = (*_excess)[n];
           int new_level = _level->maxLevel();
+          int scanned = 0;
 
-          for (OutArcIt e(_graph, n); e != INVALID; ++e) {
+          for (OutArcIt e(_graph, n); e != INVALID; ++e, ++scanned) {
             Value rem = (*_capacity)[e] - (*_flow)[e];
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.target(e);
@@ -693,7 +877,7 @@ namespace lemon {
             }
           }
 
-          for (InArcIt e(_graph, n); e != INVALID; ++e) {
+          for (InArcIt e(_graph, n); e != INVALID; ++e, ++scanned) {
             Value rem = (*_flow)[e];
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.source(e);
@@ -721,6 +905,7 @@ namespace lemon {
           (*_excess)[n] = excess;
 
           if (excess != 0) {
+            _relabel_work += 12 + scanned;
             if (new_level + 1 < _level->maxLevel()) {
               _level->liftActiveOn(level, new_level + 1);
             } else {
@@ -772,6 +957,7 @@ namespace lemon {
               reached[v] = true;
               _level->initAddItem(v);
               nqueue.push_back(v);
+              _touched.push_back(v);
             }
           }
           for (InArcIt e(_graph, n); e != INVALID; ++e) {
@@ -781,6 +967,7 @@ namespace lemon {
               reached[u] = true;
               _level->initAddItem(u);
               nqueue.push_back(u);
+              _touched.push_back(u);
             }
           }
         }
@@ -885,6 +1072,23 @@ namespace lemon {
       startSecondPhase();
     }
 
+    /// \brief Reruns the preflow algorithm after the capacities have
+    /// changed.
+    ///
+    /// Reruns the preflow algorithm starting from the flow of the
+    /// previous run, see \ref reinit().
+    /// \note pf.rerun() is just a shortcut of the following code.
+    /// \code
+    ///   pf.reinit();
+    ///   pf.startFirstPhase();
+    ///   pf.startSecondPhase();
+    /// \endcode
+    void rerun() {
+      reinit();
+      startFirstPhase();
+      startSecondPhase();
+    }
+
     /// \brief Runs the preflow algorithm to compute the minimum cut.
     ///
     /// Runs the preflow algorithm to compute the minimum cut.
@@ -36,12 +36,15 @@ namespace lemon {
   /// This class implements the \e radix \e heap data structure.
   /// It practically conforms to the \ref concepts::Heap "heap concept",
   /// but it has some limitations due its special implementation.
-  /// The type of the priorities must be \c int and the priority of an
-  /// item cannot be decreased under the priority of the last removed item.
+  /// The type of the priorities must be an integer type and the priority
+  /// of an item cannot be decreased under the priority of the last
+  /// removed item.
   ///
   /// \tparam IM A read-writable item map with \c int values, used
   /// internally to handle the cross references.
-  template <typename IM>
+  /// \tparam PR Type of the priorities of the items. It must be an
+  /// integer type. By default, it is \c int.
+  template <typename IM, typename PR = int>
   class RadixHeap {
 
   public:
@@ -49,7 +52,7 @@ namespace lemon {
     /// Type of the item-int map.
     typedef IM ItemIntMap;
     /// Type of the priorities.
-    typedef int Prio;
+    typedef PR Prio;
     /// Type of the items stored in the heap.
     typedef typename ItemIntMap::Key Item;
 
@@ -84,14 +87,14 @@ namespace lemon {
     struct RadixItem {
       int prev, next, box;
       Item item;
-      int prio;
-      RadixItem(Item _item, int _prio) : item(_item), prio(_prio) {}
+      Prio prio;
+      RadixItem(Item _item, Prio _prio) : item(_item), prio(_prio) {}
     };
 
     struct RadixBox {
       int first;
-      int min, size;
-      RadixBox(int _min, int _size) : first(-1), min(_min), size(_size) {}
+      Prio min, size;
+      RadixBox(Prio _min, Prio _size) : first(-1), min(_min), size(_size) {}
     };
 
     std::vector<RadixItem> _data;
@@ -109,7 +112,7 @@ namespace lemon {
     /// The assigned value must be \c PRE_HEAP (<tt>-1</tt>) for each item.
     /// \param minimum The initial minimum value of the heap.
     /// \param capacity The initial capacity of the heap.
-    RadixHeap(ItemIntMap &map, int minimum = 0, int capacity = 0)
+    RadixHeap(ItemIntMap &map, Prio minimum = 0, Prio capacity = 0)
       : _iim(map)
     {
       _boxes.push_back(RadixBox(minimum, 1));
@@ -138,7 +141,7 @@ namespace lemon {
     /// for each item.
     /// \param minimum The minimum value of the heap.
     /// \param capacity The capacity of the heap.
-    void clear(int minimum = 0, int capacity = 0) {
+    void clear(Prio minimum = 0, Prio capacity = 0) {
       _data.clear(); _boxes.clear();
       _boxes.push_back(RadixBox(minimum, 1));
       _boxes.push_back(RadixBox(minimum + 1, 1));
@@ -185,8 +188,8 @@ namespace lemon {
 
     // Add a new box to the box list
     void extend() {
-      int min = _boxes.back().min + _boxes.back().size;
-      int bs = 2 * _boxes.back().size;
+      Prio min = _boxes.back().min + _boxes.back().size;
+      Prio bs = 2 * _boxes.back().size;
       _boxes.push_back(RadixBox(min, bs));
     }
 
@@ -199,7 +202,7 @@ namespace lemon {
     }
 
     // Find up the proper box for the item with the given priority
-    int findUp(int start, int pr) {
+    int findUp(int start, Prio pr) {
       while (lower(start, pr)) {
         if (++start == int(_boxes.size())) {
           extend();
@@ -217,7 +220,7 @@ namespace lemon {
     }
 
     // Find down the proper box for the item with the given priority
-    int findDown(int start, int pr) {
+    int findDown(int start, Prio pr) {
       while (upper(start, pr)) {
         if (--start < 0) throw PriorityUnderflowError();
       }
@@ -232,8 +235,8 @@ namespace lemon {
     }
 
     // Gives back the minimum priority of the given box
-    int minValue(int box) {
-      int min = _data[_boxes[box].first].prio;
+    Prio minValue(int box) {
+      Prio min = _data[_boxes[box].first].prio;
       for (int k = _boxes[box].first; k != -1; k = _data[k].next) {
         if (_data[k].prio < min) min = _data[k].prio;
       }
@@ -244,7 +247,7 @@ namespace lemon {
     void moveDown() {
       int box = findFirst();
       if (box == 0) return;
-      int min = minValue(box);
+      Prio min = minValue(box);
       for (int i = 0; i <= box; ++i) {
         _boxes[i].min = min;
         min += _boxes[i].size;
@@ -299,7 +302,7 @@ namespace lemon {
     /// This function returns the item having minimum priority.
     /// \pre The heap must be non-empty.
     Item top() const {
-      const_cast<RadixHeap<ItemIntMap>&>(*this).moveDown();
+      const_cast<RadixHeap&>(*this).moveDown();
       return _data[_boxes[0].first].item;
     }
 
@@ -308,7 +311,7 @@ namespace lemon {
     /// This function returns the minimum priority.
     /// \pre The heap must be non-empty.
     Prio prio() const {
-      const_cast<RadixHeap<ItemIntMap>&>(*this).moveDown();
+      const_cast<RadixHeap&>(*this).moveDown();
       return _data[_boxes[0].first].prio;
      }
 
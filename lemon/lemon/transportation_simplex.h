@@ -0,0 +1,845 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_TRANSPORTATION_SIMPLEX_H
+#define LEMON_TRANSPORTATION_SIMPLEX_H
+
+/// \ingroup min_cost_flow_algs
+///
+/// \file
+/// \brief Network Simplex algorithm for dense transportation problems.
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <unordered_map>
+
+#include <lemon/core.h>
+
+namespace lemon {
+
+  /// \addtogroup min_cost_flow_algs
+  /// @{
+
+  /// \brief Network Simplex algorithm for dense transportation problems.
+  ///
+  /// \ref TransportationSimplex implements the primal Network Simplex
+  /// algorithm for the \e transportation \e problem, i.e. the minimum
+  /// cost flow problem on the complete bipartite graph of a set of
+  /// suppliers and a set of consumers with uncapacitated arcs.
+  ///
+  /// The graph is not stored explicitly, the costs of the arcs are
+  /// obtained from a functor on demand (e.g. from a row-major cost
+  /// matrix), and only the current spanning tree basis is stored, which
+  /// consists of <tt>n+m-1</tt> cells for \c n suppliers and \c m
+  /// consumers. Therefore, the memory usage is linear in the number of
+  /// nodes, in contrast to the \ref NetworkSimplex "general version",
+  /// which would require a graph and arc maps having <tt>n*m</tt> items.
+  ///
+  /// The initial basis is constructed using Vogel's approximation method
+  /// or the north-west corner rule (see \ref InitMethod), and the
+  /// entering cells are selected using the Block Search pivot rule (see
+  /// \ref NetworkSimplex::BLOCK_SEARCH).
+  ///
+  /// The total supply must be at least the total demand. If it is
+  /// larger, then the remaining supply is kept at the suppliers (i.e.
+  /// a zero cost dummy consumer is added).
+  ///
+  /// \tparam V The number type used for the supply and demand values.
+  /// The default type is \c int.
+  /// \tparam C The number type used for the costs and potentials.
+  /// The default type is \c V.
+  ///
+  /// \warning Both \c V and \c C must be signed number types, and all
+  /// input data must be integer.
+  /// \warning The supply and demand values must be non-negative.
+  template <typename V = int, typename C = V>
+  class TransportationSimplex
+  {
+  public:
+
+    /// The type of the supply and demand values
+    typedef V Value;
+    /// The type of the costs
+    typedef C Cost;
+
+  public:
+
+    /// \brief Problem type constants for the \c run() function.
+    ///
+    /// Enum type containing the problem type constants that can be
+    /// returned by the \ref run() function of the algorithm.
+    enum ProblemType {
+      /// The problem has no feasible solution (the total supply is
+      /// smaller than the total demand).
+      INFEASIBLE,
+      /// The problem has optimal solution (i.e. it is feasible), and
+      /// the algorithm has found optimal flow and node potentials
+      /// (primal and dual solutions).
+      OPTIMAL
+    };
+
+    /// \brief Constants for selecting the method for constructing the
+    /// initial basis.
+    ///
+    /// Enum type containing constants for selecting the method for
+    /// constructing the initial basis of the \ref run() function.
+    enum InitMethod {
+      /// The \e north-west \e corner rule, which is very fast, but
+      /// it does not take the costs into account.
+      NORTH_WEST_CORNER,
+      /// Vogel's approximation method, which usually provides a
+      /// nearly optimal initial solution (the regret of each supplier
+      /// and consumer, i.e. the difference of its two smallest costs,
+      /// is maintained using a few candidate cells for each of them).
+      VOGEL
+    };
+
+  private:
+
+    typedef std::vector<int> IntVector;
+    typedef std::vector<Value> ValueVector;
+    typedef std::vector<Cost> CostVector;
+
+    // A basic cell of the transportation table
+    struct Cell {
+      int row;
+      int col;
+      Value flow;
+      Cost cost;
+    };
+
+    // A candidate cell of a row or column in Vogel's method
+    typedef std::pair<Cost, int> Candidate;
+
+    // Number of suppliers and consumers (including the dummy consumer)
+    int _row_num;
+    int _col_num;
+    int _all_col_num;
+
+    // Supply and demand values
+    ValueVector _supply;
+    ValueVector _demand;
+
+    // The spanning tree basis: the cells and the tree structure on the
+    // nodes (the rows are nodes 0..n-1, the columns are nodes n..n+m-1)
+    std::vector<Cell> _cells;
+    std::vector<IntVector> _adj;
+    IntVector _parent;
+    IntVector _pred;
+    IntVector _depth;
+    CostVector _pi;
+    IntVector _order;
+
+    // Buffer for the costs of a row segment
+    CostVector _row_cost;
+
+    // The positive flow values of the final solution
+    std::unordered_map<long long, int> _flow_index;
+
+    int _pivot_num;
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// The constructor of the class.
+    ///
+    /// \param supplier_num The number of suppliers.
+    /// \param consumer_num The number of consumers.
+    TransportationSimplex(int supplier_num, int consumer_num) :
+      _row_num(supplier_num), _col_num(consumer_num),
+      _supply(supplier_num, 0), _demand(consumer_num, 0), _pivot_num(0)
+    {
+      // Check the number types
+      LEMON_ASSERT(std::numeric_limits<Value>::is_signed,
+        "The flow type of TransportationSimplex must be signed");
+      LEMON_ASSERT(std::numeric_limits<Cost>::is_signed,
+        "The cost type of TransportationSimplex must be signed");
+    }
+
+    /// \name Parameters
+    /// The parameters of the algorithm can be specified using these
+    /// functions.
+
+    /// @{
+
+    /// \brief Set the supply values of the suppliers.
+    ///
+    /// This function sets the supply values of the suppliers.
+    /// If it is not used before calling \ref run(), the supply values
+    /// will be set to zero.
+    ///
+    /// \param map A map indexed by the integers <tt>0..n-1</tt>
+    /// (e.g. an array or an \c std::vector) storing the supply values.
+    /// Its \c Value type must be convertible to the \c Value type of
+    /// the algorithm.
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename SupplyMap>
+    TransportationSimplex& supplyMap(const SupplyMap& map) {
+      for (int i = 0; i != _row_num; ++i) {
+        _supply[i] = map[i];
+      }
+      return *this;
+    }
+
+    /// \brief Set the demand values of the consumers.
+    ///
+    /// This function sets the demand values of the consumers.
+    /// If it is not used before calling \ref run(), the demand values
+    /// will be set to zero.
+    ///
+    /// \param map A map indexed by the integers <tt>0..m-1</tt>
+    /// (e.g. an array or an \c std::vector) storing the demand values.
+    /// Its \c Value type must be convertible to the \c Value type of
+    /// the algorithm.
+    ///
+    /// \return <tt>(*this)</tt>
+    template <typename DemandMap>
+    TransportationSimplex& demandMap(const DemandMap& map) {
+      for (int j = 0; j != _col_num; ++j) {
+        _demand[j] = map[j];
+      }
+      return *this;
+    }
+
+    /// @}
+
+    /// \name Execution Control
+    /// The algorithm can be executed using \ref run().
+
+    /// @{
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    /// For example, using a row-major cost matrix,
+    /// \code
+    ///   TransportationSimplex<> ts(n, m);
+    ///   ts.supplyMap(supply).demandMap(demand);
+    ///   ts.run([&](int i, int j) { return costs[i * m + j]; });
+    /// \endcode
+    ///
+    /// \param cost A functor that returns the cost of the arc from
+    /// supplier \c i to consumer \c j for <tt>cost(i, j)</tt>. It is
+    /// called several times for each arc, so it should be fast.
+    /// Its return type must be convertible to the \c Cost type of the
+    /// algorithm. If the functor also has a member function
+    /// <tt>rowCosts(i, first, last, out)</tt>, then it is used to
+    /// obtain the costs of the arcs from supplier \c i to the consumers
+    /// <tt>first..last-1</tt> into the \c Cost array \c out at once
+    /// when whole rows are scanned (e.g. for computing the costs using
+    /// SIMD instructions).
+    /// \param init_method The method for constructing the initial
+    /// basis. For more information, see \ref InitMethod.
+    ///
+    /// \return \c INFEASIBLE if no feasible flow exists,
+    /// \n \c OPTIMAL if the algorithm has found optimal flow and node
+    /// potentials (primal and dual solutions).
+    template <typename CostFunc>
+    ProblemType run(const CostFunc& cost, InitMethod init_method = VOGEL) {
+      _pivot_num = 0;
+      _cells.clear();
+      _flow_index.clear();
+      if (!init(cost, init_method)) return INFEASIBLE;
+      start(cost);
+      return OPTIMAL;
+    }
+
+    /// @}
+
+    /// \name Query Functions
+    /// The results of the algorithm can be obtained using these
+    /// functions.\n
+    /// The \ref run() function must be called before using them.
+
+    /// @{
+
+    /// \brief Return the total cost of the found flow.
+    ///
+    /// This function returns the total cost of the found flow.
+    /// Its complexity is O(n+m).
+    ///
+    /// \note The return type of the function can be specified as a
+    /// template parameter. For example,
+    /// \code
+    ///   ts.totalCost<double>();
+    /// \endcode
+    /// It is useful if the total cost cannot be stored in the \c Cost
+    /// type of the algorithm, which is the default return type of the
+    /// function.
+    template <typename Number>
+    Number totalCost() const {
+      Number c = 0;
+      for (int k = 0; k != int(_cells.size()); ++k) {
+        const Cell &cell = _cells[k];
+        if (cell.col != _col_num) {
+          c += Number(cell.flow) * Number(cell.cost);
+        }
+      }
+      return c;
+    }
+
+#ifndef DOXYGEN
+    Cost totalCost() const {
+      return totalCost<Cost>();
+    }
+#endif
+
+    /// \brief Return the flow from the given supplier to the given
+    /// consumer.
+    ///
+    /// This function returns the flow from the given supplier to the
+    /// given consumer. The positive flow values are stored in a hash
+    /// table, so its expected complexity is O(1).
+    Value flow(int i, int j) const {
+      typename std::unordered_map<long long, int>::const_iterator it =
+        _flow_index.find(cellId(i, j));
+      return it == _flow_index.end() ? 0 : _cells[it->second].flow;
+    }
+
+    /// \brief Return the number of the positive flow values.
+    ///
+    /// This function returns the number of the positive flow values,
+    /// which is at most <tt>n+m-1</tt>. They can be obtained using
+    /// \ref flowSupplier(), \ref flowConsumer() and \ref flowValue().
+    int flowNum() const {
+      return int(_flow_index.size());
+    }
+
+    /// \brief Return the supplier of the <tt>k</tt>-th positive flow.
+    int flowSupplier(int k) const {
+      return _cells[k].row;
+    }
+
+    /// \brief Return the consumer of the <tt>k</tt>-th positive flow.
+    int flowConsumer(int k) const {
+      return _cells[k].col;
+    }
+
+    /// \brief Return the <tt>k</tt>-th positive flow value.
+    Value flowValue(int k) const {
+      return _cells[k].flow;
+    }
+
+    /// \brief Return the potential (dual value) of the given supplier.
+    ///
+    /// This function returns the potential (dual value) of the
+    /// given supplier. The potentials satisfy
+    /// <tt>cost(i, j) + supplierPotential(i) - consumerPotential(j)
+    /// >= 0</tt> for all arcs with equality for the arcs having positive
+    /// flow. If the total supply is larger than the total demand, then
+    /// the supplier potentials are non-negative, and they are zero for
+    /// the suppliers having remaining supply.
+    Cost supplierPotential(int i) const {
+      return _pi[i];
+    }
+
+    /// \brief Return the potential (dual value) of the given consumer.
+    ///
+    /// This function returns the potential (dual value) of the given
+    /// consumer (see \ref supplierPotential()).
+    Cost consumerPotential(int j) const {
+      return _pi[_row_num + j];
+    }
+
+    /// \brief Return the number of pivots.
+    ///
+    /// This function returns the number of pivots performed by the
+    /// last \ref run() call (after the construction of the initial
+    /// basis).
+    int pivotNum() const {
+      return _pivot_num;
+    }
+
+    /// @}
+
+  private:
+
+    long long cellId(int i, int j) const {
+      return static_cast<long long>(i) * _all_col_num + j;
+    }
+
+    // Return the cost of the given cell (the cells of the dummy column
+    // have zero cost)
+    template <typename CostFunc>
+    Cost cellCost(const CostFunc& cost, int i, int j) const {
+      return j == _col_num ? Cost(0) : static_cast<Cost>(cost(i, j));
+    }
+
+    // Compute the costs of the cells (i, j) for first <= j < last using
+    // the rowCosts() function of the functor if it exists
+    template <typename CostFunc>
+    void rowCosts(const CostFunc& cost, int i, int first, int last,
+                  Cost* out) const {
+      int real_last = std::min(last, _col_num);
+      if (first < real_last) {
+        realRowCosts(cost, i, first, real_last, out, 0);
+      }
+      for (int j = std::max(first, _col_num); j < last; ++j) {
+        out[j - first] = 0;
+      }
+    }
+
+    template <typename CostFunc>
+    static auto realRowCosts(const CostFunc& cost, int i, int first,
+                             int last, Cost* out, int)
+      -> decltype(cost.rowCosts(i, first, last, out), void()) {
+      cost.rowCosts(i, first, last, out);
+    }
+
+    template <typename CostFunc>
+    static void realRowCosts(const CostFunc& cost, int i, int first,
+                             int last, Cost* out, long) {
+      for (int j = first; j != last; ++j) {
+        out[j - first] = static_cast<Cost>(cost(i, j));
+      }
+    }
+
+    // Check the supply values and construct the initial basis
+    template <typename CostFunc>
+    bool init(const CostFunc& cost, InitMethod init_method) {
+      Value sum_supply = 0, sum_demand = 0;
+      for (int i = 0; i != _row_num; ++i) {
+        if (_supply[i] < 0) return false;
+        sum_supply += _supply[i];
+      }
+      for (int j = 0; j != _col_num; ++j) {
+        if (_demand[j] < 0) return false;
+        sum_demand += _demand[j];
+      }
+      if (sum_supply < sum_demand) return false;
+
+      // Add a dummy consumer for the remaining supply
+      _all_col_num = _col_num + (sum_supply > sum_demand ? 1 : 0);
+      int node_num = _row_num + _all_col_num;
+      _pi.assign(node_num, 0);
+      if (_row_num == 0 || _all_col_num == 0) return true;
+
+      ValueVector supply(_supply), demand(_demand);
+      demand.push_back(sum_supply - sum_demand);
+      _row_cost.resize(_all_col_num);
+      _cells.reserve(node_num - 1);
+      if (init_method == NORTH_WEST_CORNER) {
+        initNorthWestCorner(cost, supply, demand);
+      } else {
+        initVogel(cost, supply, demand);
+      }
+
+      _adj.assign(node_num, IntVector());
+      for (int k = 0; k != int(_cells.size()); ++k) {
+        _adj[_cells[k].row].push_back(k);
+        _adj[_row_num + _cells[k].col].push_back(k);
+      }
+      _parent.resize(node_num);
+      _pred.resize(node_num);
+      _depth.resize(node_num);
+      _order.resize(node_num);
+      return true;
+    }
+
+    // Add a cell to the basis and update the remaining supply and demand
+    template <typename CostFunc>
+    void addCell(const CostFunc& cost, int i, int j,
+                 ValueVector& supply, ValueVector& demand) {
+      Cell cell;
+      cell.row = i;
+      cell.col = j;
+      cell.flow = std::min(supply[i], demand[j]);
+      cell.cost = cellCost(cost, i, j);
+      supply[i] -= cell.flow;
+      demand[j] -= cell.flow;
+      _cells.push_back(cell);
+    }
+
+    // Construct the initial basis using the north-west corner rule
+    template <typename CostFunc>
+    void initNorthWestCorner(const CostFunc& cost, ValueVector& supply,
+                             ValueVector& demand) {
+      int i = 0, j = 0;
+      while (i != _row_num && j != _all_col_num) {
+        addCell(cost, i, j, supply, demand);
+        if (supply[i] == 0 && i + 1 != _row_num) {
+          ++i;
+        } else {
+          ++j;
+        }
+      }
+    }
+
+    // Data of a row or column in Vogel's method: a few of its cheapest
+    // active cells as candidates (sorted by cost), the first candidate
+    // that may be active, and whether all active cells are candidates
+    struct VogelLine {
+      std::vector<Candidate> cand;
+      int head;
+      bool complete;
+    };
+
+    // Fill the candidate list of the line u (a row or a column) from
+    // its active cells
+    template <typename CostFunc>
+    void fillCandidates(const CostFunc& cost, int u,
+                        const std::vector<bool>& active,
+                        std::vector<Candidate>& all, VogelLine& line) {
+      const int MAX_CANDIDATE_NUM = 16;
+      all.clear();
+      if (u < _row_num) {
+        rowCosts(cost, u, 0, _all_col_num, &_row_cost[0]);
+        for (int j = 0; j != _all_col_num; ++j) {
+          if (active[_row_num + j]) {
+            all.push_back(Candidate(_row_cost[j], j));
+          }
+        }
+      } else {
+        for (int i = 0; i != _row_num; ++i) {
+          if (active[i]) {
+            all.push_back(Candidate(cellCost(cost, i, u - _row_num), i));
+          }
+        }
+      }
+      int num = std::min(int(all.size()), MAX_CANDIDATE_NUM);
+      std::partial_sort(all.begin(), all.begin() + num, all.end());
+      line.cand.assign(all.begin(), all.begin() + num);
+      line.head = 0;
+      line.complete = num == int(all.size());
+    }
+
+    // Construct the initial basis using Vogel's approximation method:
+    // the cheapest cell of the row or column having the largest regret
+    // (i.e. the difference of its two smallest costs) is allocated, and
+    // the row or column is removed, until all of them are removed
+    template <typename CostFunc>
+    void initVogel(const CostFunc& cost, ValueVector& supply,
+                   ValueVector& demand) {
+      int node_num = _row_num + _all_col_num;
+      std::vector<bool> active(node_num, true);
+      std::vector<VogelLine> lines(node_num);
+      std::vector<Candidate> all;
+      for (int u = 0; u != node_num; ++u) {
+        fillCandidates(cost, u, active, all, lines[u]);
+      }
+
+      int active_rows = _row_num, active_cols = _all_col_num;
+      while (active_cols > 0) {
+        // Find the line having the largest regret
+        int best = -1;
+        Cost best_regret = 0, best_cost = 0;
+        for (int u = 0; u != node_num; ++u) {
+          if (!active[u]) continue;
+          VogelLine &line = lines[u];
+          int other = u < _row_num ? _row_num : 0;
+          int size = int(line.cand.size());
+          int h = line.head;
+          while (h != size && !active[other + line.cand[h].second]) ++h;
+          int h2 = h == size ? h : h + 1;
+          while (h2 != size && !active[other + line.cand[h2].second]) ++h2;
+          if (h2 == size && !line.complete) {
+            fillCandidates(cost, u, active, all, line);
+            size = int(line.cand.size());
+            h = 0;
+            h2 = size > 1 ? 1 : size;
+          }
+          line.head = h;
+          if (h == size) continue;
+          Cost regret = h2 == size ? line.cand[h].first :
+            line.cand[h2].first - line.cand[h].first;
+          if (best == -1 || regret > best_regret ||
+              (regret == best_regret && line.cand[h].first < best_cost)) {
+            best = u;
+            best_regret = regret;
+            best_cost = line.cand[h].first;
+          }
+        }
+        if (best == -1) break;
+
+        // Allocate the cheapest cell of the line and remove its row
+        // or its column
+        int i, j;
+        const Candidate &c = lines[best].cand[lines[best].head];
+        if (best < _row_num) {
+          i = best;
+          j = c.second;
+        } else {
+          i = c.second;
+          j = best - _row_num;
+        }
+        addCell(cost, i, j, supply, demand);
+        if (supply[i] == 0 && active_rows > 1) {
+          active[i] = false;
+          --active_rows;
+        } else {
+          active[_row_num + j] = false;
+          --active_cols;
+        }
+      }
+    }
+
+    // Compute the tree structure and the potentials in the subtree of
+    // the given node, which is connected to its parent by the given cell
+    // (or it is the root node if the cell is -1), using a breadth-first
+    // search. Return the number of nodes in the subtree.
+    int buildTree(int root, int pred) {
+      _pred[root] = pred;
+      if (pred == -1) {
+        _parent[root] = -1;
+        _depth[root] = 0;
+        _pi[root] = 0;
+      } else {
+        setParent(root, pred);
+      }
+      _order[0] = root;
+      int n = 1;
+      for (int k = 0; k != n; ++k) {
+        int u = _order[k];
+        const IntVector &adj = _adj[u];
+        for (int a = 0; a != int(adj.size()); ++a) {
+          int e = adj[a];
+          if (e == _pred[u]) continue;
+          int v = u < _row_num ? _row_num + _cells[e].col : _cells[e].row;
+          _pred[v] = e;
+          setParent(v, e);
+          _order[n++] = v;
+        }
+      }
+      return n;
+    }
+
+    // Set the parent, the depth and the potential of a node using its
+    // predecessor cell
+    void setParent(int v, int e) {
+      const Cell &cell = _cells[e];
+      if (v < _row_num) {
+        int u = _row_num + cell.col;
+        _parent[v] = u;
+        _pi[v] = _pi[u] - cell.cost;
+      } else {
+        int u = cell.row;
+        _parent[v] = u;
+        _pi[v] = _pi[u] + cell.cost;
+      }
+      _depth[v] = _depth[_parent[v]] + 1;
+    }
+
+    // Check if the basic cell e precedes the basic cell f in row-major
+    // order (or f is -1)
+    bool lessCell(int e, int f) const {
+      return f == -1 || cellId(_cells[e].row, _cells[e].col) <
+        cellId(_cells[f].row, _cells[f].col);
+    }
+
+    // Remove a cell from the adjacency list of a node
+    void removeAdjacent(int u, int e) {
+      IntVector &adj = _adj[u];
+      for (int a = 0; a != int(adj.size()); ++a) {
+        if (adj[a] == e) {
+          adj[a] = adj.back();
+          adj.pop_back();
+          return;
+        }
+      }
+    }
+
+    // Execute the algorithm
+    template <typename CostFunc>
+    void start(const CostFunc& cost) {
+      if (_row_num == 0 || _all_col_num == 0) return;
+
+      const double BLOCK_SIZE_FACTOR = 1.0;
+      const int MIN_BLOCK_SIZE = 10;
+      long long cell_num = static_cast<long long>(_row_num) * _all_col_num;
+      long long block_size = std::max( static_cast<long long>(
+        BLOCK_SIZE_FACTOR * std::sqrt(double(cell_num))),
+        static_cast<long long>(MIN_BLOCK_SIZE) );
+
+      // The initial basis is not strongly feasible, so the leaving cell
+      // rule alone does not prevent cycling through degenerate bases.
+      // After DEGENERATE_LIMIT consecutive degenerate pivots, Bland's
+      // rule is used until a pivot changes the flow: the first cell in
+      // row-major order having negative reduced cost enters, and the
+      // blocking cell having the smallest index leaves.
+      const int DEGENERATE_LIMIT = _row_num + _all_col_num;
+      int degenerate_num = 0;
+
+      std::vector<std::pair<int, int> > row_path, col_path;
+      int next_i = 0, next_j = 0;
+      buildTree(0, -1);
+      while (true) {
+        bool bland = degenerate_num >= DEGENERATE_LIMIT;
+        Cost min = 0;
+        int in_i = -1, in_j = -1;
+        if (bland) {
+          // Find the entering cell using Bland's rule
+          for (int i = 0; i != _row_num && in_i == -1; ++i) {
+            rowCosts(cost, i, 0, _all_col_num, &_row_cost[0]);
+            Cost pi_i = _pi[i];
+            const Cost *pi_j = &_pi[_row_num];
+            for (int j = 0; j != _all_col_num; ++j) {
+              Cost c = _row_cost[j] + pi_i - pi_j[j];
+              if (c < 0) {
+                min = c;
+                in_i = i;
+                in_j = j;
+                break;
+              }
+            }
+          }
+          if (min >= 0) break;
+        } else {
+          // Find the entering cell using the Block Search pivot rule
+          long long cnt = block_size;
+          int i = next_i, j = next_j;
+          for (long long k = 0; k != cell_num; ) {
+            // Scan the segment of the current row within the block
+            int last = static_cast<int>(std::min(
+              static_cast<long long>(_all_col_num),
+              j + std::min(cnt, cell_num - k)));
+            rowCosts(cost, i, j, last, &_row_cost[0]);
+            Cost pi_i = _pi[i];
+            const Cost *pi_j = &_pi[_row_num];
+            for (int jj = j; jj != last; ++jj) {
+              Cost c = _row_cost[jj - j] + pi_i - pi_j[jj];
+              if (c < min) {
+                min = c;
+                in_i = i;
+                in_j = jj;
+              }
+            }
+            k += last - j;
+            cnt -= last - j;
+            j = last;
+            if (j == _all_col_num) {
+              j = 0;
+              if (++i == _row_num) i = 0;
+            }
+            if (cnt == 0) {
+              if (min < 0) break;
+              cnt = block_size;
+            }
+          }
+          if (min >= 0) break;
+          next_i = i;
+          next_j = j;
+        }
+
+        // Find the cycle in the tree, which consists of the path from
+        // the join node to the row (traversed downwards), the entering
+        // cell and the path from the column to the join node (traversed
+        // upwards). The flow of a cell is decreased if it is traversed
+        // from a column to a row.
+        int u = in_i, v = _row_num + in_j;
+        row_path.clear();
+        col_path.clear();
+        while (u != v) {
+          if (_depth[u] >= _depth[v]) {
+            row_path.push_back(std::make_pair(_pred[u],
+                                              u < _row_num ? -1 : 1));
+            u = _parent[u];
+          } else {
+            col_path.push_back(std::make_pair(_pred[v],
+                                              v < _row_num ? 1 : -1));
+            v = _parent[v];
+          }
+        }
+
+        // Find the leaving cell (the last blocking cell in the
+        // orientation of the cycle starting from the join node, or the
+        // one having the smallest index if Bland's rule is used)
+        Value delta = std::numeric_limits<Value>::max();
+        int out = -1;
+        bool out_row_side = false;
+        for (int k = int(row_path.size()) - 1; k >= 0; --k) {
+          int e = row_path[k].first;
+          if (row_path[k].second < 0 && (_cells[e].flow < delta ||
+              (_cells[e].flow == delta && (!bland || lessCell(e, out))))) {
+            delta = _cells[e].flow;
+            out = e;
+            out_row_side = true;
+          }
+        }
+        for (int k = 0; k != int(col_path.size()); ++k) {
+          int e = col_path[k].first;
+          if (col_path[k].second < 0 && (_cells[e].flow < delta ||
+              (_cells[e].flow == delta && (!bland || lessCell(e, out))))) {
+            delta = _cells[e].flow;
+            out = e;
+            out_row_side = false;
+          }
+        }
+        degenerate_num = delta == 0 ? degenerate_num + 1 : 0;
+
+        // Change the flow along the cycle and replace the leaving cell
+        for (int k = 0; k != int(row_path.size()); ++k) {
+          _cells[row_path[k].first].flow += row_path[k].second * delta;
+        }
+        for (int k = 0; k != int(col_path.size()); ++k) {
+          _cells[col_path[k].first].flow += col_path[k].second * delta;
+        }
+        Cell &cell = _cells[out];
+        removeAdjacent(cell.row, out);
+        removeAdjacent(_row_num + cell.col, out);
+        cell.row = in_i;
+        cell.col = in_j;
+        cell.flow = delta;
+        cell.cost = cellCost(cost, in_i, in_j);
+        _adj[in_i].push_back(out);
+        _adj[_row_num + in_j].push_back(out);
+
+        // Update the subtree that is cut off by the leaving cell and
+        // connected again by the entering cell
+        buildTree(out_row_side ? in_i : _row_num + in_j, out);
+        ++_pivot_num;
+      }
+
+      // Store the positive flow values first and build the hash table
+      std::vector<Cell> cells;
+      cells.reserve(_cells.size());
+      for (int k = 0; k != int(_cells.size()); ++k) {
+        if (_cells[k].flow > 0 && _cells[k].col != _col_num) {
+          _flow_index[cellId(_cells[k].row, _cells[k].col)] =
+            int(cells.size());
+          cells.push_back(_cells[k]);
+        }
+      }
+      for (int k = 0; k != int(_cells.size()); ++k) {
+        if (!(_cells[k].flow > 0 && _cells[k].col != _col_num)) {
+          cells.push_back(_cells[k]);
+        }
+      }
+      _cells.swap(cells);
+
+      // Shift the potentials to make the potential of the dummy
+      // consumer zero
+      if (_all_col_num != _col_num) {
+        Cost shift = _pi[_row_num + _col_num];
+        for (int u = 0; u != _row_num + _all_col_num; ++u) {
+          _pi[u] -= shift;
+        }
+      }
+    }
+
+  }; //class TransportationSimplex
+
+  ///@}
+
+} //namespace lemon
+
+#endif //LEMON_TRANSPORTATION_SIMPLEX_H
@@ -0,0 +1,163 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
+#include <lemon/random.h>
+#include <lemon/network_simplex.h>
+#include <lemon/auction_assignment.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+// Generate a random assignment problem in CSR form having a perfect
+// matching (a random permutation is included)
+void randomProblem(int n, int degree, int max_cost, std::vector<int> &first,
+                   std::vector<int> &target, std::vector<int> &cost)
+{
+  std::vector<int> perm(n);
+  for (int i = 0; i != n; ++i) perm[i] = i;
+  for (int i = n - 1; i > 0; --i) std::swap(perm[i], perm[rnd[i + 1]]);
+  first.clear();
+  target.clear();
+  cost.clear();
+  for (int i = 0; i != n; ++i) {
+    first.push_back(int(target.size()));
+    target.push_back(perm[i]);
+    cost.push_back(rnd[max_cost] - max_cost / 4);
+    for (int k = 1; k < degree; ++k) {
+      target.push_back(rnd[n]);
+      cost.push_back(rnd[max_cost] - max_cost / 4);
+    }
+  }
+  first.push_back(int(target.size()));
+}
+
+// Compute the minimum cost of a perfect matching using NetworkSimplex
+long long minCost(int n, const std::vector<int> &first,
+                  const std::vector<int> &target, const std::vector<int> &cost)
+{
+  SmartDigraph g;
+  SmartDigraph::ArcMap<int> c(g);
+  SmartDigraph::NodeMap<int> sup(g);
+  std::vector<SmartDigraph::Node> nodes;
+  for (int i = 0; i != 2 * n; ++i) {
+    nodes.push_back(g.addNode());
+    sup[nodes.back()] = i < n ? 1 : -1;
+  }
+  for (int i = 0; i != n; ++i) {
+    for (int a = first[i]; a != first[i + 1]; ++a) {
+      c[g.addArc(nodes[i], nodes[n + target[a]])] = cost[a];
+    }
+  }
+  NetworkSimplex<SmartDigraph> ns(g);
+  ns.costMap(c).supplyMap(sup);
+  check(ns.run() == ns.OPTIMAL, "Wrong NetworkSimplex result");
+  return ns.totalCost<long long>();
+}
+
+void checkCsr(int n, int degree, int max_cost, int thread_num,
+              const std::string &test_id)
+{
+  std::vector<int> first, target, cost;
+  randomProblem(n, degree, max_cost, first, target, cost);
+  CsrAuctionAssignment<int> alg(n, &first[0], &target[0], &cost[0]);
+  alg.threadNum(thread_num);
+  check(alg.run(), "Wrong result " + test_id);
+
+  std::vector<bool> used(n, false);
+  long long c = 0;
+  for (int i = 0; i != n; ++i) {
+    int a = alg.mateArc(i);
+    check(a >= first[i] && a < first[i + 1], "Wrong arc " + test_id);
+    check(alg.mate(i) == target[a] && alg.owner(target[a]) == i &&
+          !used[target[a]], "Wrong assignment " + test_id);
+    used[target[a]] = true;
+    c += cost[a];
+  }
+  check(c == alg.totalCost<long long>() && c == minCost(n, first, target,
+        cost), "Wrong total cost " + test_id);
+}
+
+template <typename BPGR>
+void checkBpGraph(int n, int degree, int thread_num)
+{
+  std::vector<int> first, target, cost;
+  randomProblem(n, degree, 1000, first, target, cost);
+  BPGR g;
+  typename BPGR::template EdgeMap<int> c(g);
+  std::vector<typename BPGR::RedNode> red;
+  std::vector<typename BPGR::BlueNode> blue;
+  for (int i = 0; i != n; ++i) red.push_back(g.addRedNode());
+  for (int i = 0; i != n; ++i) blue.push_back(g.addBlueNode());
+  for (int i = 0; i != n; ++i) {
+    for (int a = first[i]; a != first[i + 1]; ++a) {
+      c[g.addEdge(red[i], blue[target[a]])] = cost[a];
+    }
+  }
+
+  AuctionAssignment<BPGR> alg(g, c);
+  alg.threadNum(thread_num);
+  check(alg.run(), "Wrong result");
+  long long sum = 0;
+  for (int i = 0; i != n; ++i) {
+    typename BPGR::Edge e = alg.matching(red[i]);
+    check(g.redNode(e) == red[i] && alg.mate(red[i]) == g.blueNode(e) &&
+          alg.mate(g.blueNode(e)) == red[i], "Wrong matching");
+    sum += c[e];
+  }
+  check(sum == alg.totalCost() && sum == minCost(n, first, target, cost),
+        "Wrong total cost");
+}
+
+int main()
+{
+  for (int t = 1; t <= 4; t *= 4) {
+    std::string id = t == 1 ? "seq" : "par";
+    checkCsr(1, 1, 10, t, id + "-1");
+    checkCsr(10, 3, 10, t, id + "-2");
+    checkCsr(100, 5, 1000, t, id + "-3");
+    checkCsr(1000, 4, 100, t, id + "-4");
+    checkCsr(2000, 10, 100000, t, id + "-5");
+    checkCsr(500, 500, 2, t, id + "-6");
+    checkBpGraph<SmartBpGraph>(300, 6, t);
+    checkBpGraph<ListBpGraph>(300, 6, t);
+  }
+
+  // Infeasible problems
+  int first[] = { 0, 2, 3, 4 };
+  int target[] = { 0, 1, 1, 1 };
+  int cost[] = { 1, 2, 3, 4 };
+  CsrAuctionAssignment<int> alg(3, first, target, cost);
+  check(!alg.run(), "Wrong result for an infeasible problem");
+  CsrAuctionAssignment<int> empty(0, first, target, cost);
+  check(empty.run() && empty.totalCost() == 0, "Wrong result for n = 0");
+
+  SmartBpGraph g;
+  g.addRedNode();
+  SmartBpGraph::EdgeMap<int> c(g);
+  AuctionAssignment<SmartBpGraph> bp(g, c);
+  check(!bp.run(), "Wrong result for unequal sides");
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <lemon/random.h>
+#include <lemon/transportation_simplex.h>
+#include <lemon/earth_movers_distance.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+typedef EarthMoversDistance<int, long long> EMD;
+
+// Rounded (and thresholded) ground distance of two points
+long long groundCost(const double *p, const double *q, int dim,
+                     EMD::GroundDistance gd, double scale, double threshold)
+{
+  double sum = 0;
+  for (int d = 0; d != dim; ++d) {
+    double diff = p[d] - q[d];
+    sum += gd == EMD::EUCLIDEAN ? diff * diff : std::abs(diff);
+  }
+  double dist = gd == EMD::EUCLIDEAN ? std::sqrt(sum) : sum;
+  double t = std::min(dist, threshold);
+  return static_cast<long long>(t * scale + 0.5);
+}
+
+// Compute the EMD of random point sets and check the result against
+// TransportationSimplex using an explicit cost functor
+void checkEMD(int n, int m, int dim, int source_sum, int target_sum,
+              EMD::GroundDistance gd, double threshold,
+              const std::string &test_id)
+{
+  const double scale = 100;
+  std::vector<double> source(n * dim), target(m * dim);
+  for (int i = 0; i != n * dim; ++i) source[i] = rnd(10.0);
+  for (int i = 0; i != m * dim; ++i) target[i] = rnd(10.0);
+  std::vector<int> sw(n, 0), tw(m, 0);
+  for (int k = 0; k != source_sum; ++k) ++sw[rnd[n]];
+  for (int k = 0; k != target_sum; ++k) ++tw[rnd[m]];
+
+  EMD emd(dim);
+  emd.sourcePoints(n, &source[0], sw).targetPoints(m, &target[0], tw)
+    .groundDistance(gd).scale(scale);
+  if (threshold > 0) emd.threshold(threshold);
+  emd.run();
+
+  double t = threshold > 0 ? threshold : 1e100;
+  bool swapped = source_sum < target_sum;
+  TransportationSimplex<int, long long> ts(swapped ? m : n, swapped ? n : m);
+  ts.supplyMap(swapped ? tw : sw).demandMap(swapped ? sw : tw);
+  ts.run([&](int i, int j) {
+    const double *p = swapped ? &target[i * dim] : &source[i * dim];
+    const double *q = swapped ? &source[j * dim] : &target[j * dim];
+    return groundCost(p, q, dim, gd, scale, t);
+  });
+  check(emd.totalCost() == ts.totalCost(), "Wrong total cost " + test_id);
+  check(emd.totalFlow() == std::min(source_sum, target_sum),
+        "Wrong total flow " + test_id);
+  check(emd.totalFlow() == 0 ||
+        std::abs(emd.distance() - double(emd.totalCost()) /
+                 (emd.totalFlow() * scale)) < 1e-9,
+        "Wrong distance " + test_id);
+
+  // Check the flows
+  std::vector<int> out(n, 0), in(m, 0);
+  long long cost = 0;
+  for (int k = 0; k != emd.flowNum(); ++k) {
+    int i = emd.flowSource(k), j = emd.flowTarget(k);
+    check(emd.flowValue(k) > 0, "Wrong flow value " + test_id);
+    out[i] += emd.flowValue(k);
+    in[j] += emd.flowValue(k);
+    cost += emd.flowValue(k) *
+      groundCost(&source[i * dim], &target[j * dim], dim, gd, scale, t);
+  }
+  check(emd.flowNum() <= n + m, "Too many flows " + test_id);
+  check(cost == emd.totalCost(), "Wrong flow cost " + test_id);
+  for (int i = 0; i != n; ++i) {
+    check(out[i] == sw[i] || (source_sum > target_sum && out[i] < sw[i]),
+          "Wrong source flow " + test_id);
+  }
+  for (int j = 0; j != m; ++j) {
+    check(in[j] == tw[j] || (target_sum > source_sum && in[j] < tw[j]),
+          "Wrong target flow " + test_id);
+  }
+}
+
+int main()
+{
+  EMD::GroundDistance gds[] = { EMD::EUCLIDEAN, EMD::MANHATTAN };
+  for (int k = 0; k != 2; ++k) {
+    std::string id = k == 0 ? "L2" : "L1";
+    checkEMD(1, 1, 2, 5, 5, gds[k], 0, id + "-1");
+    checkEMD(10, 15, 2, 100, 100, gds[k], 0, id + "-2");
+    checkEMD(20, 12, 3, 150, 100, gds[k], 0, id + "-3");
+    checkEMD(12, 20, 1, 80, 120, gds[k], 0, id + "-4");
+    checkEMD(50, 60, 2, 1000, 1000, gds[k], 0, id + "-5");
+    checkEMD(50, 60, 2, 1000, 1000, gds[k], 1e9, id + "-6");
+    checkEMD(50, 60, 2, 1000, 900, gds[k], 2.5, id + "-7");
+    checkEMD(60, 50, 3, 800, 1000, gds[k], 4.0, id + "-8");
+    checkEMD(40, 40, 2, 500, 500, gds[k], 0.5, id + "-9");
+  }
+
+  // Empty point sets
+  EMD emd(2);
+  std::vector<int> w;
+  emd.sourcePoints(0, 0, w).targetPoints(0, 0, w).run();
+  check(emd.totalCost() == 0 && emd.flowNum() == 0 &&
+        emd.distance() == 0, "Wrong result for empty point sets");
+
+  return 0;
+}
@@ -24,7 +24,9 @@
 #include <lemon/concepts/maps.h>
 #include <lemon/lgf_reader.h>
 #include <lemon/gomory_hu.h>
+#include <lemon/random.h>
 #include <cstdlib>
+#include <vector>
 
 using namespace std;
 using namespace lemon;
@@ -81,6 +83,11 @@ void checkGomoryHuCompile()
   d = const_gh_test.rootDist(n);
   v = const_gh_test.minCutValue(n, n);
   v = const_gh_test.minCutMap(n, n, cut);
+
+  gh_test.threadNum(2).run();
+  std::pair<Node, Node> q[1] = { std::make_pair(n, n) };
+  Value vs[1];
+  const_gh_test.minCutValues(q, q + 1, vs);
 }
 
 GRAPH_TYPEDEFS(Graph);
@@ -103,6 +110,43 @@ int cutValue(const Graph& graph, const BoolNodeMap& cut,
 }
 
 
+// Compare the parallel version and the batched queries with the
+// sequential version on random graphs
+void checkParallel(int n, int m, int threads) {
+  Graph graph;
+  IntEdgeMap capacity(graph);
+  std::vector<Node> nodes;
+  for (int i = 0; i < n; ++i) nodes.push_back(graph.addNode());
+  for (int i = 0; i < m; ++i) {
+    Node u = nodes[rnd[n]], v = nodes[rnd[n]];
+    if (u != v) capacity[graph.addEdge(u, v)] = rnd[10];
+  }
+
+  GomoryHu<Graph> seq(graph, capacity);
+  seq.run();
+  GomoryHu<Graph> par(graph, capacity);
+  par.threadNum(threads).run();
+  for (NodeIt u(graph); u != INVALID; ++u) {
+    check(seq.predNode(u) == par.predNode(u), "Wrong parallel tree");
+    if (seq.predNode(u) != INVALID) {
+      check(seq.predValue(u) == par.predValue(u), "Wrong parallel tree");
+    }
+  }
+
+  std::vector<std::pair<Node, Node> > queries;
+  for (int i = 0; i < 10 * n; ++i) {
+    queries.push_back(std::make_pair(nodes[rnd[n]], nodes[rnd[n]]));
+  }
+  std::vector<int> values(queries.size());
+  check(par.minCutValues(queries.begin(), queries.end(), values.begin()) ==
+        values.end(), "Wrong output iterator");
+  for (int i = 0; i < int(queries.size()); ++i) {
+    check(values[i] == seq.minCutValue(queries[i].first,
+                                       queries[i].second),
+          "Wrong batched min cut value");
+  }
+}
+
 int main() {
   Graph graph;
   IntEdgeMap capacity(graph);
@@ -138,5 +182,13 @@ int main() {
     }
   }
 
+  for (int i = 0; i < 5; ++i) {
+    checkParallel(30, 60, 2);
+    checkParallel(100, 150, 3);
+    checkParallel(200, 1000, 4);
+  }
+  checkParallel(1, 0, 2);
+  checkParallel(50, 30, 0);
+
   return 0;
 }
@@ -0,0 +1,157 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+
+#include <lemon/grid_graph.h>
+#include <lemon/smart_graph.h>
+#include <lemon/random.h>
+#include <lemon/preflow.h>
+#include <lemon/grid_boykov_kolmogorov.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+typedef GridGraph::ArcMap<int> CapMap;
+typedef GridGraph::NodeMap<int> TermMap;
+
+// Solve the problem with Preflow on a digraph with explicit terminals
+int preflowValue(const GridGraph& g, const CapMap& cap,
+                 const TermMap& source, const TermMap& sink) {
+  SmartDigraph d;
+  SmartDigraph::ArcMap<int> dcap(d);
+  GridGraph::NodeMap<SmartDigraph::Node> ref(g);
+  for (GridGraph::NodeIt n(g); n != INVALID; ++n) ref[n] = d.addNode();
+  SmartDigraph::Node s = d.addNode(), t = d.addNode();
+  for (GridGraph::ArcIt a(g); a != INVALID; ++a) {
+    dcap[d.addArc(ref[g.source(a)], ref[g.target(a)])] = cap[a];
+  }
+  for (GridGraph::NodeIt n(g); n != INVALID; ++n) {
+    dcap[d.addArc(s, ref[n])] = source[n];
+    dcap[d.addArc(ref[n], t)] = sink[n];
+  }
+  Preflow<SmartDigraph> pf(d, dcap, s, t);
+  pf.runMinCut();
+  return pf.flowValue();
+}
+
+// Check that the source side of the cut has the given capacity
+void checkCut(const GridGraph& g, const GridBoykovKolmogorov<>& bk,
+              const CapMap& cap, const TermMap& source,
+              const TermMap& sink, int value) {
+  GridGraph::NodeMap<bool> cut(g);
+  bk.minCutMap(cut);
+  int c = 0;
+  for (GridGraph::NodeIt n(g); n != INVALID; ++n) {
+    check(cut[n] == bk.minCut(n), "Wrong cut map");
+    c += cut[n] ? sink[n] : source[n];
+  }
+  for (GridGraph::ArcIt a(g); a != INVALID; ++a) {
+    if (cut[g.source(a)] && !cut[g.target(a)]) c += cap[a];
+  }
+  check(c == value, "Wrong cut value");
+}
+
+void checkSimple() {
+  // A 3x1 grid: s -> a -> b -> c -> t with a bottleneck in the middle
+  GridGraph g(3, 1);
+  CapMap cap(g, 0);
+  TermMap source(g, 0), sink(g, 0);
+  GridGraph::Node a = g(0, 0), b = g(1, 0), c = g(2, 0);
+  cap[g.right(a)] = 5;
+  cap[g.right(b)] = 2;
+  cap[g.left(c)] = 9;
+  source[a] = 4;
+  sink[c] = 7;
+  sink[a] = 1;
+
+  GridBoykovKolmogorov<> bk(g);
+  bk.capacityMap(cap).terminalMaps(source, sink);
+  bk.run();
+  check(bk.flowValue() == 3, "Wrong flow value");
+  check(bk.minCut(a) && bk.minCut(b) && !bk.minCut(c), "Wrong cut");
+
+  // Decrease a capacity below the flow, then increase it
+  bk.capacity(g.right(b), 1);
+  bk.run();
+  check(bk.flowValue() == 2, "Wrong flow value");
+  bk.capacity(g.right(b), 8);
+  bk.terminalCapacities(a, 10, 0);
+  bk.run();
+  check(bk.flowValue() == 5, "Wrong flow value");
+  check(bk.minCut(a) && !bk.minCut(b) && !bk.minCut(c), "Wrong cut");
+}
+
+void checkRandom(int width, int height, int max_cap, int frames,
+                 int changes) {
+  GridGraph g(width, height);
+  CapMap cap(g);
+  TermMap source(g), sink(g);
+  for (GridGraph::ArcIt a(g); a != INVALID; ++a) cap[a] = rnd[max_cap];
+  for (GridGraph::NodeIt n(g); n != INVALID; ++n) {
+    source[n] = rnd(4) == 0 ? rnd[2 * max_cap] : 0;
+    sink[n] = rnd(4) == 0 ? rnd[2 * max_cap] : 0;
+  }
+
+  GridBoykovKolmogorov<> bk(g);
+  bk.capacityMap(cap).terminalMaps(source, sink);
+  bk.run();
+  int value = preflowValue(g, cap, source, sink);
+  check(bk.flowValue() == value, "Wrong flow value");
+  checkCut(g, bk, cap, source, sink, value);
+
+  // Change some capacities and reuse the trees
+  for (int f = 0; f != frames; ++f) {
+    for (int i = 0; i != changes; ++i) {
+      if (rnd.boolean()) {
+        GridGraph::Arc a = g.arcFromId(rnd[g.arcNum()]);
+        cap[a] = rnd[max_cap];
+        bk.capacity(a, cap[a]);
+      } else {
+        GridGraph::Node n = g.nodeFromId(rnd[g.nodeNum()]);
+        source[n] = rnd[2 * max_cap];
+        sink[n] = rnd[2 * max_cap];
+        bk.terminalCapacities(n, source[n], sink[n]);
+      }
+    }
+    bk.run();
+    value = preflowValue(g, cap, source, sink);
+    check(bk.flowValue() == value, "Wrong flow value");
+    checkCut(g, bk, cap, source, sink, value);
+  }
+
+  // Run from scratch again
+  bk.capacityMap(cap).terminalMaps(source, sink);
+  bk.run();
+  check(bk.flowValue() == value, "Wrong flow value");
+}
+
+int main() {
+  checkSimple();
+
+  for (int i = 0; i != 10; ++i) {
+    checkRandom(1, 20, 10, 5, 3);
+    checkRandom(20, 1, 10, 5, 3);
+    checkRandom(7, 5, 10, 10, 4);
+    checkRandom(30, 20, 100, 10, 20);
+  }
+  checkRandom(200, 150, 1000, 5, 500);
+
+  return 0;
+}
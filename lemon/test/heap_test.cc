@@ -243,6 +243,11 @@ int main() {
     typedef RadixHeap<IntNodeMap > NodeHeap;
     checkConcept<Heap<Prio, IntNodeMap >, NodeHeap>();
     dijkstraHeapTest<NodeHeap>(digraph, length, source);
+
+    typedef RadixHeap<ItemIntMap, long long> LongHeap;
+    checkConcept<Heap<long long, ItemIntMap>, LongHeap>();
+    heapSortTest<LongHeap>();
+    heapIncreaseTest<LongHeap>();
   }
 
   // BinomialHeap
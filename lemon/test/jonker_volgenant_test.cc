@@ -0,0 +1,100 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <lemon/full_graph.h>
+#include <lemon/matching.h>
+#include <lemon/random.h>
+#include <lemon/jonker_volgenant.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+// Check the assignment and the dual solution, and compare the total
+// cost to MaxWeightedPerfectMatching on the complete bipartite graph
+// (using negated costs as weights)
+template <typename C>
+void checkJV(int n, const std::vector<C> &cost, const std::string &test_id)
+{
+  JonkerVolgenant<C> jv(n, n == 0 ? 0 : &cost[0]);
+  jv.run();
+
+  std::vector<bool> used(n, false);
+  C sum = 0;
+  for (int i = 0; i != n; ++i) {
+    int j = jv.rowMate(i);
+    check(j >= 0 && j < n && !used[j] && jv.colMate(j) == i,
+          "Wrong assignment " + test_id);
+    used[j] = true;
+    sum += cost[i * n + j];
+    for (int k = 0; k != n; ++k) {
+      C rc = cost[i * n + k] - jv.rowPotential(i) - jv.colPotential(k);
+      check(rc >= -1e-9 && (k != j || std::abs(double(rc)) <= 1e-9),
+            "Wrong potentials " + test_id);
+    }
+  }
+  check(std::abs(double(sum - jv.totalCost())) <= 1e-9,
+        "Wrong total cost " + test_id);
+
+  FullBpGraph g(n, n);
+  FullBpGraph::EdgeMap<C> weight(g);
+  for (FullBpGraph::EdgeIt e(g); e != INVALID; ++e) {
+    weight[e] = -cost[g.index(g.redNode(e)) * n + g.index(g.blueNode(e))];
+  }
+  MaxWeightedPerfectMatching<FullBpGraph, FullBpGraph::EdgeMap<C> >
+    mwpm(g, weight);
+  check(mwpm.run(), "Wrong matching result " + test_id);
+  check(std::abs(double(mwpm.matchingWeight() + jv.totalCost())) <= 1e-6,
+        "Wrong total cost compared to matching " + test_id);
+}
+
+void checkRandom(int n, int max_cost, const std::string &test_id)
+{
+  std::vector<int> cost(n * n);
+  for (int i = 0; i != n * n; ++i) cost[i] = rnd[max_cost];
+  checkJV(n, cost, test_id);
+}
+
+int main()
+{
+  checkRandom(0, 10, "1");
+  checkRandom(1, 10, "2");
+  checkRandom(2, 10, "3");
+  checkRandom(10, 3, "4");
+  checkRandom(30, 1000, "5");
+  checkRandom(60, 100000, "6");
+  checkRandom(50, 1, "7");
+
+  // Identical rows and columns
+  std::vector<int> equal(20 * 20, 7);
+  checkJV(20, equal, "8");
+
+  // Negative and real costs
+  std::vector<int> neg(25 * 25);
+  for (int i = 0; i != 25 * 25; ++i) neg[i] = rnd[100] - 50;
+  checkJV(25, neg, "9");
+  std::vector<double> real(40 * 40);
+  for (int i = 0; i != 40 * 40; ++i) real[i] = rnd(100.0);
+  checkJV(40, real, "10");
+
+  return 0;
+}
@@ -22,10 +22,12 @@
 #include <lemon/smart_graph.h>
 #include <lemon/preflow.h>
 #include <lemon/edmonds_karp.h>
+#include <lemon/dinic.h>
 #include <lemon/concepts/digraph.h>
 #include <lemon/concepts/maps.h>
 #include <lemon/lgf_reader.h>
 #include <lemon/elevator.h>
+#include <lemon/random.h>
 
 using namespace lemon;
 
@@ -136,11 +138,18 @@ void checkPreflowCompile()
   typedef concepts::ReadMap<Digraph::Arc, Value> CapMap;
   typedef Elevator<Digraph, Digraph::Node> Elev;
   typedef LinkedElevator<Digraph, Digraph::Node> LinkedElev;
+  typedef CompactElevator<Digraph, Digraph::Node> CompactElev;
 
   Digraph g;
   Digraph::Node n;
   CapMap cap;
 
+  typedef Preflow<Digraph, CapMap>
+      ::SetStandardElevator<CompactElev>
+      ::Create CompactPreflowType;
+  CompactPreflowType compact_preflow_test(g, cap, n, n);
+  compact_preflow_test.globalRelabelFrequency(0.5).runMinCut();
+
   typedef Preflow<Digraph, CapMap>
       ::SetElevator<Elev>
       ::SetStandardElevator<LinkedElev>
@@ -242,6 +251,204 @@ void initFlowTest()
   check(!pre.minCut(t), "Wrong min cut (Node t).");
 }
 
+// Checks the global relabeling of Preflow on random graphs
+template <typename MF>
+void checkGlobalRelabel() {
+  typedef SmartDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  typedef Digraph::ArcMap<int> CapMap;
+
+  for (int k = 0; k < 10; ++k) {
+    Digraph g;
+    CapMap cap(g);
+    std::vector<Node> nodes;
+    for (int i = 0; i < 200; ++i) nodes.push_back(g.addNode());
+    for (int i = 0; i < 1000; ++i) {
+      Node u = nodes[rnd[200]], v = nodes[rnd[200]];
+      if (u != v) cap[g.addArc(u, v)] = 1 + rnd[100];
+    }
+    Node s = nodes[0], t = nodes[199];
+
+    MF ref(g, cap, s, t);
+    ref.globalRelabelFrequency(0).run();
+
+    // Relabel very often to exercise the heuristic
+    MF max_flow(g, cap, s, t);
+    max_flow.globalRelabelFrequency(100).run();
+    check(max_flow.flowValue() == ref.flowValue(),
+          "Wrong max flow value with global relabeling.");
+    check(checkFlow(g, max_flow.flowMap(), cap, s, t),
+          "The flow is not feasible.");
+
+    BoolNodeMap min_cut(g);
+    max_flow.minCutMap(min_cut);
+    check(cutValue(g, min_cut, cap) == max_flow.flowValue(),
+          "The max flow value is not equal to the min cut value.");
+  }
+}
+
+// Checks the warm start of Preflow after capacity changes
+void checkReinit() {
+  typedef SmartDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  typedef Digraph::ArcMap<int> CapMap;
+
+  for (int k = 0; k < 20; ++k) {
+    Digraph g;
+    CapMap cap(g);
+    std::vector<Node> nodes;
+    for (int i = 0; i < 100; ++i) nodes.push_back(g.addNode());
+    for (int i = 0; i < 600; ++i) {
+      Node u = nodes[rnd[100]], v = nodes[rnd[100]];
+      cap[g.addArc(u, v)] = rnd[50];
+    }
+    Node s = nodes[0], t = nodes[99];
+
+    Preflow<Digraph> max_flow(g, cap, s, t);
+    if (k % 2 == 0) {
+      max_flow.run();
+    } else {
+      max_flow.runMinCut();
+    }
+
+    for (int r = 0; r < 6; ++r) {
+      // Decrease and increase some capacities (and sometimes move
+      // or swap the terminals)
+      for (ArcIt a(g); a != INVALID; ++a) {
+        if (rnd[4] == 0) cap[a] = rnd[50];
+      }
+      if (r == 3) {
+        t = nodes[50];
+        max_flow.target(t);
+      }
+      if (r == 5) {
+        std::swap(s, t);
+        max_flow.source(s).target(t);
+      }
+      max_flow.rerun();
+
+      Preflow<Digraph> ref(g, cap, s, t);
+      ref.runMinCut();
+      check(max_flow.flowValue() == ref.flowValue(),
+            "Wrong max flow value after reinit().");
+      check(checkFlow(g, max_flow.flowMap(), cap, s, t),
+            "The flow is not feasible after reinit().");
+
+      BoolNodeMap min_cut(g);
+      max_flow.minCutMap(min_cut);
+      check(cutValue(g, min_cut, cap) == max_flow.flowValue(),
+            "The max flow value is not equal to the min cut value.");
+    }
+  }
+}
+
+// Check the reuse of a Preflow instance for other terminals (only the
+// touched part of the local flow map is reset by init())
+void checkTerminalQueries() {
+  typedef SmartDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  typedef Digraph::ArcMap<int> CapMap;
+
+  Digraph g;
+  CapMap cap(g);
+  std::vector<Node> nodes;
+  for (int i = 0; i < 200; ++i) nodes.push_back(g.addNode());
+  for (int i = 0; i < 600; ++i) {
+    Node u = nodes[rnd[200]], v = nodes[rnd[200]];
+    cap[g.addArc(u, v)] = rnd[50];
+  }
+
+  Preflow<Digraph> max_flow(g, cap, nodes[0], nodes[1]);
+  for (int k = 0; k < 100; ++k) {
+    Node s = nodes[rnd[200]], t = nodes[rnd[200]];
+    if (s == t) continue;
+    max_flow.source(s).target(t);
+    if (k % 3 == 0) {
+      max_flow.run();
+      check(checkFlow(g, max_flow.flowMap(), cap, s, t),
+            "The flow is not feasible after a reused init().");
+    } else {
+      max_flow.runMinCut();
+    }
+
+    Preflow<Digraph> ref(g, cap, s, t);
+    ref.runMinCut();
+    check(max_flow.flowValue() == ref.flowValue(),
+          "Wrong max flow value after a reused init().");
+
+    BoolNodeMap min_cut(g);
+    max_flow.minCutMap(min_cut);
+    check(min_cut[s] && !min_cut[t], "Wrong min cut.");
+    check(cutValue(g, min_cut, cap) == max_flow.flowValue(),
+          "The max flow value is not equal to the min cut value.");
+  }
+}
+
+// Compare Dinic with Preflow on random digraphs (with loops and parallel
+// arcs) and on long paths, where the dynamic trees are essential
+void checkDinic() {
+  typedef SmartDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  typedef Digraph::ArcMap<int> CapMap;
+
+  for (int k = 0; k < 200; ++k) {
+    Digraph g;
+    CapMap cap(g);
+    std::vector<Node> nodes;
+    int n = 2 + rnd[k < 150 ? 10 : 100], m = rnd[5 * n];
+    for (int i = 0; i < n; ++i) nodes.push_back(g.addNode());
+    if (k % 2 == 0) {
+      // Long paths with shortcuts
+      for (int i = 0; i + 1 < n; ++i) {
+        cap[g.addArc(nodes[i], nodes[i + 1])] = 1 + rnd[100];
+      }
+      m /= 5;
+    }
+    for (int i = 0; i < m; ++i) {
+      cap[g.addArc(nodes[rnd[n]], nodes[rnd[n]])] = rnd[100];
+    }
+    Node s = nodes[0], t = nodes[n - 1];
+
+    Dinic<Digraph> max_flow(g, cap, s, t);
+    max_flow.run();
+    check(checkFlow(g, max_flow.flowMap(), cap, s, t),
+          "The flow is not feasible.");
+
+    Preflow<Digraph> ref(g, cap, s, t);
+    ref.runMinCut();
+    check(max_flow.flowValue() == ref.flowValue(), "Wrong max flow value.");
+
+    BoolNodeMap min_cut(g);
+    max_flow.minCutMap(min_cut);
+    check(min_cut[s] && !min_cut[t], "Wrong min cut.");
+    check(cutValue(g, min_cut, cap) == max_flow.flowValue(),
+          "The max flow value is not equal to the min cut value.");
+  }
+
+  // Many unit paths that share a long chain
+  Digraph g;
+  CapMap cap(g);
+  int k = 2000, n = 5000;
+  std::vector<Node> chain;
+  for (int i = 0; i < n; ++i) chain.push_back(g.addNode());
+  for (int i = 0; i + 1 < n; ++i) {
+    cap[g.addArc(chain[i], chain[i + 1])] = k;
+  }
+  Node s = g.addNode(), t = g.addNode();
+  for (int i = 0; i < k; ++i) {
+    Node u = g.addNode(), v = g.addNode();
+    cap[g.addArc(s, u)] = 1;
+    cap[g.addArc(u, chain[0])] = 1;
+    cap[g.addArc(chain[n - 1], v)] = 1;
+    cap[g.addArc(v, t)] = 1;
+  }
+  Dinic<Digraph> max_flow(g, cap, s, t);
+  max_flow.run();
+  check(max_flow.flowValue() == k, "Wrong max flow value.");
+  check(checkFlow(g, max_flow.flowMap(), cap, s, t),
+        "The flow is not feasible.");
+}
+
 template <typename MF, typename SF>
 void checkMaxFlowAlg() {
   typedef SmartDigraph Digraph;
@@ -376,6 +583,12 @@ int main() {
   checkConcept< MaxFlowClassConcept<GR, CM2>,
                 EdmondsKarp<GR, CM2> >();
 
+  // Check the interface of Dinic
+  checkConcept< MaxFlowClassConcept<GR, CM1>,
+                Dinic<GR, CM1> >();
+  checkConcept< MaxFlowClassConcept<GR, CM2>,
+                Dinic<GR, CM2> >();
+
   // Check Preflow
   typedef Preflow<SmartDigraph, SmartDigraph::ArcMap<int> > PType1;
   typedef Preflow<SmartDigraph, SmartDigraph::ArcMap<float> > PType2;
@@ -383,12 +596,30 @@ int main() {
   checkMaxFlowAlg<PType2, PreflowStartFunctions<PType2> >();
   initFlowTest();
 
+  // Check Preflow with CompactElevator and global relabeling
+  typedef Preflow<SmartDigraph, SmartDigraph::ArcMap<int> >
+    ::SetStandardElevator<CompactElevator<SmartDigraph,
+                                          SmartDigraph::Node> >
+    ::Create PType3;
+  checkMaxFlowAlg<PType3, PreflowStartFunctions<PType3> >();
+  checkGlobalRelabel<PType1>();
+  checkGlobalRelabel<PType3>();
+  checkReinit();
+  checkTerminalQueries();
+
   // Check EdmondsKarp
   typedef EdmondsKarp<SmartDigraph, SmartDigraph::ArcMap<int> > EKType1;
   typedef EdmondsKarp<SmartDigraph, SmartDigraph::ArcMap<float> > EKType2;
   checkMaxFlowAlg<EKType1, GeneralStartFunctions<EKType1> >();
   checkMaxFlowAlg<EKType2, GeneralStartFunctions<EKType2> >();
 
+  // Check Dinic
+  typedef Dinic<SmartDigraph, SmartDigraph::ArcMap<int> > DType1;
+  typedef Dinic<SmartDigraph, SmartDigraph::ArcMap<float> > DType2;
+  checkMaxFlowAlg<DType1, GeneralStartFunctions<DType1> >();
+  checkMaxFlowAlg<DType2, GeneralStartFunctions<DType2> >();
+  checkDinic();
+
   initFlowTest();
 
   return 0;
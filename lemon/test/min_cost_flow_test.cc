@@ -22,11 +22,16 @@
 
 #include <lemon/list_graph.h>
 #include <lemon/lgf_reader.h>
+#include <lemon/random.h>
 
 #include <lemon/network_simplex.h>
 #include <lemon/capacity_scaling.h>
 #include <lemon/cost_scaling.h>
 #include <lemon/cycle_canceling.h>
+#include <lemon/cost_rounding.h>
+#include <lemon/bin_heap.h>
+#include <lemon/radix_heap.h>
+#include <lemon/bucket_heap.h>
 
 #include <lemon/concepts/digraph.h>
 #include <lemon/concepts/heap.h>
@@ -421,6 +426,334 @@ void runMcfLeqTests( Param param,
            mcf1.INFEASIBLE, false,  0, test_str + "-21", LEQ);
 }
 
+// Run NetworkSimplex starting from the solution of another algorithm
+// (crossover) and check the results and the spanning tree basis
+template < typename MCF, typename GR, typename LM, typename UM,
+           typename CM, typename SM >
+void checkCrossover( const MCF& mcf,
+                     const GR& gr, const LM& lower, const UM& upper,
+                     const CM& cost, const SM& supply,
+                     typename CM::Value total,
+                     const std::string &test_id = "",
+                     SupplyType type = EQ )
+{
+  typename GR::template ArcMap<int> flow(gr);
+  typename GR::template NodeMap<int> pot(gr);
+  mcf.flowMap(flow);
+  mcf.potentialMap(pot);
+
+  NetworkSimplex<GR> ns(gr);
+  ns.lowerMap(lower).upperMap(upper).costMap(cost).supplyMap(supply);
+  if (type != EQ) ns.supplyType(type == GEQ ? ns.GEQ : ns.LEQ);
+  checkMcf(ns, ns.run(flow, pot), gr, lower, upper, cost, supply,
+           ns.OPTIMAL, true, total, test_id, type);
+
+  int tree_arcs = 0;
+  for (typename GR::ArcIt a(gr); a != INVALID; ++a) {
+    int f = ns.flow(a);
+    if (f > lower[a] && f < upper[a]) {
+      check(ns.treeArc(a), "Free arc is not in the tree " + test_id);
+    }
+    if (ns.treeArc(a)) {
+      ++tree_arcs;
+      check(cost[a] + ns.potential(gr.source(a)) -
+            ns.potential(gr.target(a)) == 0,
+            "Wrong potentials on a tree arc " + test_id);
+    }
+  }
+  check(tree_arcs < countNodes(gr), "Too many tree arcs " + test_id);
+
+  // Starting from a non-optimal or infeasible flow
+  ConstMap<typename GR::Arc, int> zero(0);
+  checkMcf(ns, ns.run(zero, pot), gr, lower, upper, cost, supply,
+           ns.OPTIMAL, true, total, test_id + "-zero", type);
+}
+
+
+// Add arcs to a solved NetworkSimplex instance in a few batches and
+// continue the algorithm from the current basis (column generation)
+void checkAddArcs( SupplyType type, bool lower_bounds,
+                   const std::string &test_id )
+{
+  typedef ListDigraph GR;
+  const int n = 100;
+  GR gr;
+  GR::ArcMap<int> lower(gr), upper(gr), cost(gr);
+  GR::NodeMap<int> supply(gr);
+  std::vector<GR::Node> nodes;
+  for (int i = 0; i != n; ++i) {
+    nodes.push_back(gr.addNode());
+    supply[nodes[i]] = rnd[21] - 10;
+  }
+  supply[nodes[0]] += type == LEQ ? 50 : type == GEQ ? -50 : 0;
+  int sum = 0;
+  for (int i = 0; i != n; ++i) sum += supply[nodes[i]];
+  supply[nodes[n - 1]] -= type == EQ ? sum : 0;
+  for (int i = 0; i != n; ++i) {
+    GR::Arc a = gr.addArc(nodes[i], nodes[(i + 1) % n]);
+    lower[a] = 0;
+    upper[a] = 1000;
+    cost[a] = 100;
+  }
+
+  NetworkSimplex<GR> ns(gr);
+  if (type != EQ) ns.supplyType(type == GEQ ? ns.GEQ : ns.LEQ);
+  ns.upperMap(upper).costMap(cost).supplyMap(supply);
+  if (lower_bounds) ns.lowerMap(lower);
+  check(ns.run() == ns.OPTIMAL, "Wrong result " + test_id);
+  for (int k = 0; k != 5; ++k) {
+    for (int i = 0; i != 100; ++i) {
+      GR::Arc a = gr.addArc(nodes[rnd[n]], nodes[rnd[n]]);
+      lower[a] = 0;
+      upper[a] = rnd[20];
+      cost[a] = rnd[100] - (k == 4 ? 10 : 0);
+      ns.addArc(a, lower[a], upper[a], cost[a]);
+    }
+    if (k == 2) {
+      // Modified costs
+      for (GR::ArcIt a(gr); a != INVALID; ++a) {
+        if (rnd[4] == 0) cost[a] = rnd[100];
+      }
+      ns.costMap(cost);
+    }
+    if (k == 3 && lower_bounds) {
+      // An arc having a non-zero lower bound
+      GR::Arc a = gr.addArc(nodes[0], nodes[n / 2]);
+      lower[a] = upper[a] = 1;
+      cost[a] = 1;
+      ns.addArc(a, lower[a], upper[a], cost[a]);
+    }
+
+    NetworkSimplex<GR> ns2(gr);
+    if (type != EQ) ns2.supplyType(type == GEQ ? ns2.GEQ : ns2.LEQ);
+    ns2.lowerMap(lower).upperMap(upper).costMap(cost).supplyMap(supply);
+    check(ns2.run() == ns2.OPTIMAL, "Wrong result " + test_id);
+    checkMcf(ns, ns.resume(), gr, lower, upper, cost, supply,
+             ns.OPTIMAL, true, ns2.totalCost(), test_id, type);
+  }
+}
+
+// Evaluate a convex piecewise-linear cost function
+long long convexCostValue( const std::vector<int> &bp,
+                           const std::vector<int> &slope, int x )
+{
+  long long c = 0;
+  for (int p = 0; p != int(slope.size()); ++p) {
+    long long lo = p == 0 ? std::numeric_limits<int>::min() : bp[p - 1];
+    long long hi = p == int(bp.size()) ?
+      std::numeric_limits<int>::max() : bp[p];
+    long long x0 = std::min(std::max(0LL, lo), hi);
+    long long x1 = std::min(std::max(static_cast<long long>(x), lo), hi);
+    c += slope[p] * (x1 - x0);
+  }
+  return c;
+}
+
+// Check convex piecewise-linear arc costs against the equivalent network
+// containing a parallel arc for each piece (solved by NetworkSimplex)
+template < typename MCF, typename Param >
+void checkConvexCosts( Param param, const std::string &test_id,
+                       bool geq = false )
+{
+  const int n = 100;
+  const int INF = std::numeric_limits<int>::max();
+  Digraph cgr, egr;
+  Digraph::ArcMap<int> clow(cgr), cup(cgr), ccost(cgr), cflow(cgr);
+  Digraph::NodeMap<int> csup(cgr);
+  Digraph::ArcMap<int> eup(egr), ecost(egr);
+  Digraph::NodeMap<int> esup(egr);
+  std::vector<Node> cn, en;
+  for (int i = 0; i != n; ++i) {
+    cn.push_back(cgr.addNode());
+    en.push_back(egr.addNode());
+  }
+  int sum = 0;
+  for (int i = 0; i != n; ++i) {
+    csup[cn[i]] = esup[en[i]] = rnd[21] - 10;
+    sum += csup[cn[i]];
+  }
+  if (geq) sum += 50;
+  csup[cn[0]] -= sum;
+  esup[en[0]] -= sum;
+
+  // Cycle of linear cost arcs
+  for (int i = 0; i != n; ++i) {
+    Arc a = cgr.addArc(cn[i], cn[(i + 1) % n]);
+    clow[a] = 0;
+    cup[a] = INF;
+    ccost[a] = 100;
+    Arc e = egr.addArc(en[i], en[(i + 1) % n]);
+    eup[e] = INF;
+    ecost[e] = 100;
+  }
+
+  // Random convex cost arcs and the parallel arcs of their pieces
+  std::vector<Arc> arcs;
+  std::vector<std::vector<int> > bps, slopes;
+  long long lower_cost = 0;
+  for (int i = 0; i != 5 * n; ++i) {
+    int u = rnd[n], v = rnd[n];
+    Arc a = cgr.addArc(cn[u], cn[v]);
+    int l = rnd[4] == 0 ? rnd[11] - 5 : 0;
+    clow[a] = l;
+    cup[a] = rnd[5] == 0 ? INF : l + rnd[40];
+    ccost[a] = 0;
+    std::vector<int> bp, sl;
+    for (int p = rnd[4]; p != 0; --p) bp.push_back(rnd[60] - 10);
+    std::sort(bp.begin(), bp.end());
+    bp.erase(std::unique(bp.begin(), bp.end()), bp.end());
+    for (int p = 0; p <= int(bp.size()); ++p) sl.push_back(rnd[80] - 30);
+    std::sort(sl.begin(), sl.end());
+    if (cup[a] == INF && sl.back() < 0) sl.back() = 0;
+    arcs.push_back(a);
+    bps.push_back(bp);
+    slopes.push_back(sl);
+
+    esup[en[u]] -= l;
+    esup[en[v]] += l;
+    lower_cost += convexCostValue(bp, sl, l);
+    for (int p = 0; p != int(sl.size()); ++p) {
+      bool last = p == int(bp.size());
+      int lo = p == 0 ? l : std::max(bp[p - 1], l);
+      int hi = last ? cup[a] : std::min(bp[p], cup[a]);
+      if (hi <= lo) continue;
+      Arc e = egr.addArc(en[u], en[v]);
+      eup[e] = hi == INF ? INF : hi - lo;
+      ecost[e] = sl[p];
+    }
+  }
+
+  MCF mcf(cgr);
+  mcf.lowerMap(clow).upperMap(cup).costMap(ccost).supplyMap(csup);
+  for (int i = 0; i != int(arcs.size()); ++i) {
+    mcf.convexCost(arcs[i], bps[i].begin(), bps[i].end(),
+                   slopes[i].begin());
+  }
+  check(mcf.run(param) == mcf.OPTIMAL, "Wrong result " + test_id);
+  mcf.flowMap(cflow);
+  check(checkFlow(cgr, clow, cup, csup, cflow, geq ? GEQ : EQ),
+        "The flow is not feasible " + test_id);
+  long long cost = 0;
+  for (ArcIt a(cgr); a != INVALID; ++a) {
+    cost += static_cast<long long>(ccost[a]) * cflow[a];
+  }
+  for (int i = 0; i != int(arcs.size()); ++i) {
+    cost += convexCostValue(bps[i], slopes[i], cflow[arcs[i]]);
+  }
+  check(mcf.template totalCost<long long>() == cost,
+        "Wrong total cost " + test_id);
+
+  NetworkSimplex<Digraph, int, long long> ns(egr);
+  ns.upperMap(eup).costMap(ecost).supplyMap(esup);
+  check(ns.run() == ns.OPTIMAL, "Wrong result " + test_id);
+  check(ns.totalCost() + lower_cost == cost,
+        "Wrong total cost " + test_id);
+
+  // Unbounded cost function
+  Arc a = cgr.addArc(cn[0], cn[1]);
+  cup[a] = INF;
+  int bp[] = { 5 }, sl[] = { -3, -1 };
+  mcf.reset().upperMap(cup).supplyMap(csup).convexCost(a, bp, bp + 1, sl);
+  check(mcf.run(param) == mcf.UNBOUNDED, "Wrong result " + test_id);
+}
+
+// Check the cost curve of s-t flows against NetworkSimplex
+template < typename MCF, typename GR, typename LM, typename UM,
+           typename CM >
+void checkCostCurve( MCF& mcf, const GR& gr, const LM& lower,
+                     const UM& upper, const CM& cost,
+                     typename GR::Node s, typename GR::Node t,
+                     int max_flow, const std::string &test_id )
+{
+  NetworkSimplex<GR> ns(gr);
+  ns.lowerMap(lower).upperMap(upper).costMap(cost);
+  typename MCF::ProblemType res =
+    max_flow < 0 ? mcf.runCostCurve(s, t) : mcf.runCostCurve(s, t, max_flow);
+  ns.stSupply(s, t, 0);
+  if (ns.run() == ns.INFEASIBLE) {
+    check(res == mcf.INFEASIBLE, "Wrong result " + test_id);
+    return;
+  }
+  check(res == mcf.OPTIMAL, "Wrong result " + test_id);
+
+  int num = mcf.curvePointNum();
+  check(num >= 1 && mcf.curveFlow(0) == 0, "Wrong cost curve " + test_id);
+  for (int i = 0; i != num; ++i) {
+    int f = mcf.curveFlow(i);
+    ns.stSupply(s, t, f);
+    check(ns.run() == ns.OPTIMAL && ns.totalCost() == mcf.curveCost(i),
+          "Wrong cost curve " + test_id);
+    if (i == 0) continue;
+    int pf = mcf.curveFlow(i - 1), pc = mcf.curveCost(i - 1);
+    check(f > pf, "Wrong cost curve " + test_id);
+    if (i > 1) {
+      check((mcf.curveCost(i) - pc) * (pf - mcf.curveFlow(i - 2)) >
+            (pc - mcf.curveCost(i - 2)) * (f - pf),
+            "The cost curve is not strictly convex " + test_id);
+    }
+    int m = (pf + f) / 2;
+    if ((mcf.curveCost(i) - pc) * (m - pf) % (f - pf) == 0) {
+      ns.stSupply(s, t, m);
+      check(ns.run() == ns.OPTIMAL && ns.totalCost() ==
+            pc + (mcf.curveCost(i) - pc) * (m - pf) / (f - pf),
+            "Wrong cost curve " + test_id);
+    }
+  }
+  int last = mcf.curveFlow(num - 1);
+  check(last == max_flow || (ns.stSupply(s, t, last + 1),
+                             ns.run() == ns.INFEASIBLE),
+        "Wrong maximum flow value " + test_id);
+
+  // The solution at the last breakpoint
+  typename GR::template ArcMap<int> flow(gr);
+  typename GR::template NodeMap<int> sup(gr, 0);
+  sup[s] = last;
+  sup[t] = -last;
+  mcf.flowMap(flow);
+  check(checkFlow(gr, lower, upper, sup, flow) &&
+        mcf.totalCost() == mcf.curveCost(num - 1),
+        "Wrong flow " + test_id);
+}
+
+// Run the same instance of CostScaling several times with new costs and
+// supplies (the maximum costs are not multiples of alpha, thus epsilon
+// must be rounded up between the phases)
+template < typename Param >
+void checkCostScalingRerun( Param param, const std::string &test_id )
+{
+  typedef CostScaling<Digraph> MCF;
+  Digraph rgr;
+  Node rn[4];
+  for (int i = 0; i != 4; ++i) rn[i] = rgr.addNode();
+  const int src[] = { 0, 0, 1, 1, 2 }, trg[] = { 1, 2, 2, 3, 3 };
+  const int cap[] = { 3, 2, 2, 1, 4 };
+  Arc ra[5];
+  Digraph::ArcMap<int> rcap(rgr), rcost(rgr);
+  for (int i = 0; i != 5; ++i) {
+    ra[i] = rgr.addArc(rn[src[i]], rn[trg[i]]);
+    rcap[ra[i]] = cap[i];
+  }
+  ConstMap<Arc, int> rlow(0);
+  Digraph::NodeMap<int> rsup(rgr, 0);
+
+  MCF mcf(rgr);
+  mcf.upperMap(rcap);
+  NetworkSimplex<Digraph> ns(rgr);
+  ns.upperMap(rcap);
+  for (int s = 0; s != 8; ++s) {
+    for (int i = 0; i != 5; ++i) {
+      rcost[ra[i]] = 1 + (s * 7 + i * 3) % 5;
+    }
+    rsup[rn[0]] = 1 + s % 4;
+    rsup[rn[3]] = -rsup[rn[0]];
+    mcf.costMap(rcost).supplyMap(rsup);
+    ns.costMap(rcost).supplyMap(rsup).run();
+    checkMcf(mcf, mcf.run(param), rgr, rlow, rcap, rcost, rsup,
+             mcf.OPTIMAL, true, ns.totalCost(),
+             test_id + "-" + std::string(1, '0' + s));
+  }
+}
+
 
 int main()
 {
@@ -526,6 +859,33 @@ int main()
     typedef CapacityScaling<Digraph> MCF;
     runMcfGeqTests<MCF>(0, "SSP");
     runMcfGeqTests<MCF>(2, "CAS");
+    typedef MCF::SetHeap<RadixHeap<RangeMap<int> > >::Create RadixMCF;
+    runMcfGeqTests<RadixMCF>(2, "CAS-RADIX");
+    typedef MCF::SetHeap<BucketHeap<RangeMap<int> > >::Create BucketMCF;
+    runMcfGeqTests<BucketMCF>(2, "CAS-BUCKET");
+
+    // Cost curve of s-t flows
+    MCF cs1(gr), cs2(neg1_gr);
+    cs1.upperMap(u).costMap(c);
+    checkCostCurve(cs1, gr, l1, u, c, v, w, -1, "CURVE-1");
+    checkCostCurve(cs1, gr, l1, u, c, v, w, 13, "CURVE-2");
+    cs1.lowerMap(l3);
+    checkCostCurve(cs1, gr, l3, u, c, v, w, -1, "CURVE-3");
+    cs2.lowerMap(neg1_l1).upperMap(neg1_u2).costMap(neg1_c);
+    checkCostCurve(cs2, neg1_gr, neg1_l1, neg1_u2, neg1_c,
+                   neg1_gr.nodeFromId(0), neg1_gr.nodeFromId(3), -1,
+                   "CURVE-4");
+    cs1.resetParams().costMap(c);
+    check(cs1.runCostCurve(v, w) == cs1.UNBOUNDED &&
+          cs1.curvePointNum() >= 1, "Wrong result CURVE-5");
+    check(cs1.runCostCurve(v, w, 100) == cs1.OPTIMAL &&
+          cs1.curveFlow(cs1.curvePointNum() - 1) == 100,
+          "Wrong result CURVE-6");
+
+    // Convex piecewise-linear costs
+    checkConvexCosts<MCF>(0, "SSP-CONVEX");
+    checkConvexCosts<MCF>(2, "CAS-CONVEX");
+    checkConvexCosts<MCF>(2, "CAS-CONVEX-GEQ", true);
   }
 
   // Test CostScaling
@@ -534,8 +894,229 @@ int main()
     runMcfGeqTests<MCF>(MCF::PUSH, "COS-PR");
     runMcfGeqTests<MCF>(MCF::AUGMENT, "COS-AR");
     runMcfGeqTests<MCF>(MCF::PARTIAL_AUGMENT, "COS-PAR");
+    runMcfGeqTests<MCF>(MCF::WAVE, "COS-WAVE");
+    runMcfGeqTests<MCF>(MCF::PARALLEL_PUSH, "COS-PPR");
+
+    // Convex piecewise-linear costs
+    checkConvexCosts<MCF>(MCF::PUSH, "COS-PR-CONVEX");
+    checkConvexCosts<MCF>(MCF::AUGMENT, "COS-AR-CONVEX");
+    checkConvexCosts<MCF>(MCF::PARTIAL_AUGMENT, "COS-PAR-CONVEX");
+    checkConvexCosts<MCF>(MCF::WAVE, "COS-WAVE-CONVEX");
+    checkConvexCosts<MCF>(MCF::PARALLEL_PUSH, "COS-PPR-CONVEX");
+    checkConvexCosts<MCF>(MCF::PUSH, "COS-PR-CONVEX-GEQ", true);
+
+    // Repeated runs with new costs
+    checkCostScalingRerun(MCF::PUSH, "COS-PR-RERUN");
+    checkCostScalingRerun(MCF::AUGMENT, "COS-AR-RERUN");
+    checkCostScalingRerun(MCF::PARTIAL_AUGMENT, "COS-PAR-RERUN");
+    checkCostScalingRerun(MCF::WAVE, "COS-WAVE-RERUN");
+    checkCostScalingRerun(MCF::PARALLEL_PUSH, "COS-PPR-RERUN");
   }
 
+  // Test the parallel method of CostScaling, the crossover and the time
+  // limit of NetworkSimplex on a larger random network
+  {
+    const int n = 3000;
+    Digraph rgr;
+    Digraph::ArcMap<int> rcost(rgr), rcap(rgr);
+    Digraph::NodeMap<int> rsup(rgr);
+    ConstMap<Arc, int> rlow(0);
+    std::vector<Node> nodes;
+    for (int i = 0; i != n; ++i) {
+      nodes.push_back(rgr.addNode());
+    }
+    int sum = 0;
+    for (int i = 0; i != n; ++i) {
+      rsup[nodes[i]] = rnd[41] - 20;
+      sum += rsup[nodes[i]];
+      if (i + 1 != n) {
+        Arc a = rgr.addArc(nodes[i], nodes[i + 1]);
+        rcost[a] = 1000;
+        rcap[a] = 20 * n;
+        a = rgr.addArc(nodes[i + 1], nodes[i]);
+        rcost[a] = 1000;
+        rcap[a] = 20 * n;
+      }
+    }
+    rsup[nodes[n - 1]] -= sum;
+    for (int i = 0; i != 10 * n; ++i) {
+      Arc a = rgr.addArc(nodes[rnd[n]], nodes[rnd[n]]);
+      rcost[a] = rnd[100];
+      rcap[a] = rnd[50];
+    }
+
+    NetworkSimplex<Digraph> ns(rgr);
+    ns.upperMap(rcap).costMap(rcost).supplyMap(rsup);
+    check(ns.run() == ns.OPTIMAL, "Wrong result");
+    check(ns.dualBound() == ns.totalCost(), "Wrong dual bound");
+    check(ns.feasibleTime() >= 0 && ns.pivotNum() > 0,
+          "Wrong progress data");
+    for (int t = 1; t <= 4; t *= 2) {
+      CostScaling<Digraph> cs(rgr);
+      cs.upperMap(rcap).costMap(rcost).supplyMap(rsup).threadNum(t);
+      checkMcf(cs, cs.run(cs.PARALLEL_PUSH), rgr, rlow, rcap, rcost, rsup,
+               cs.OPTIMAL, true, ns.totalCost(), "COS-PPR-RND");
+    }
+
+    // Test the time limit (anytime mode) of NetworkSimplex
+    Digraph::ArcMap<int> rflow(rgr);
+    Digraph::NodeMap<int> rpot(rgr, 0);
+    NetworkSimplex<Digraph> ns2(rgr);
+    ns2.upperMap(rcap).supplyMap(rsup).run();
+    ns2.flowMap(rflow);
+    ns2.costMap(rcost).timeLimit(1e-9);
+    NetworkSimplex<Digraph>::ProblemType res = ns2.run(rflow, rpot);
+    check(res == ns2.FEASIBLE || res == ns2.OPTIMAL, "Wrong result");
+    check(ns2.feasibleTime() >= 0, "Wrong progress data");
+    ns2.flowMap(rflow);
+    check(checkFlow(rgr, rlow, rcap, rsup, rflow),
+          "The flow is not feasible");
+    check(ns2.dualBound<long long>() <= ns.totalCost() &&
+          ns.totalCost() <= ns2.totalCost(), "Wrong bounds");
+    res = ns2.run();
+    check(res == ns2.UNDEFINED || res == ns2.FEASIBLE ||
+          res == ns2.OPTIMAL, "Wrong result");
+    check(ns2.pivotNum() <= 1, "The time limit is not checked");
+    ns2.timeLimit(0);
+    checkMcf(ns2, ns2.run(), rgr, rlow, rcap, rcost, rsup,
+             ns2.OPTIMAL, true, ns.totalCost(), "NS-TIME");
+
+    CostScaling<Digraph> cs(rgr);
+    cs.upperMap(rcap).costMap(rcost).supplyMap(rsup).run();
+    checkCrossover(cs, rgr, rlow, rcap, rcost, rsup, ns.totalCost(),
+                   "CROSS-RND");
+
+    // Test the early termination of CostScaling
+    const CostScaling<Digraph>::Method methods[] = {
+      cs.PUSH, cs.AUGMENT, cs.PARTIAL_AUGMENT, cs.WAVE, cs.PARALLEL_PUSH
+    };
+    Digraph::ArcMap<int> rlow2(rgr);
+    for (ArcIt a(rgr); a != INVALID; ++a) rlow2[a] = rcap[a] / 10;
+    for (int i = 0; i != 5; ++i) {
+      CostScaling<Digraph> cs2(rgr);
+      cs2.upperMap(rcap).costMap(rcost).supplyMap(rsup)
+         .optimalityGap(0, 0.01);
+      CostScaling<Digraph>::ProblemType res = cs2.run(methods[i]);
+      check(res == cs2.FEASIBLE || res == cs2.OPTIMAL, "Wrong result");
+      cs2.flowMap(rflow);
+      check(checkFlow(rgr, rlow, rcap, rsup, rflow),
+            "The flow is not feasible");
+      check(cs2.dualBound() <= ns.totalCost() &&
+            ns.totalCost() <= cs2.totalCost() &&
+            cs2.totalCost() <= ns.totalCost() * 1.01, "Wrong bounds");
+      check(res == cs2.FEASIBLE || cs2.dualBound() == cs2.totalCost(),
+            "Wrong dual bound");
+
+      cs2.lowerMap(rlow2).optimalityGap(1e12);
+      check(cs2.run(methods[i]) == cs2.FEASIBLE, "Wrong result");
+      cs2.flowMap(rflow);
+      check(checkFlow(rgr, rlow2, rcap, rsup, rflow),
+            "The flow is not feasible");
+      cs2.optimalityGap(0);
+      long long opt = cs2.run(methods[i]) == cs2.OPTIMAL ?
+        cs2.totalCost() : 0;
+      cs2.optimalityGap(opt / 100);
+      check(cs2.run(methods[i]) != cs2.INFEASIBLE &&
+            cs2.dualBound() <= opt && opt <= cs2.totalCost() &&
+            cs2.totalCost() - cs2.dualBound() <= opt / 100,
+            "Wrong bounds");
+    }
+
+    // Test the early termination with large costs and capacities, for
+    // which the terms of the duality gap do not fit into LargeCost
+    {
+      typedef CostScaling<Digraph, int, long long> LargeCS;
+      typedef NetworkSimplex<Digraph, int, long long> LargeNS;
+      Digraph lgr;
+      Node u = lgr.addNode(), v = lgr.addNode();
+      Arc a1 = lgr.addArc(u, v), a2 = lgr.addArc(v, u);
+      Digraph::ArcMap<int> lcost(lgr), lcap(lgr);
+      lcost[a1] = -1000000000;
+      lcost[a2] = 0;
+      lcap[a1] = lcap[a2] = 1000000000;
+      LargeNS lns(lgr);
+      lns.upperMap(lcap).costMap(lcost);
+      check(lns.run() == lns.OPTIMAL, "Wrong result");
+      const LargeCS::Method lmethods[] = {
+        LargeCS::PUSH, LargeCS::AUGMENT, LargeCS::PARTIAL_AUGMENT,
+        LargeCS::WAVE, LargeCS::PARALLEL_PUSH
+      };
+      for (int i = 0; i != 5; ++i) {
+        LargeCS lcs(lgr);
+        lcs.upperMap(lcap).costMap(lcost).optimalityGap(1.0);
+        LargeCS::ProblemType res = lcs.run(lmethods[i]);
+        check(res == lcs.FEASIBLE || res == lcs.OPTIMAL, "Wrong result");
+        check(lcs.dualBound() <= lns.totalCost() &&
+              lns.totalCost() <= lcs.totalCost() &&
+              lcs.totalCost() - lcs.dualBound() <= 1, "Wrong bounds");
+      }
+    }
+
+    // Test CostRounding with integer and real-valued costs
+    typedef CostScaling<Digraph, int, long long> IntCS;
+    typedef NetworkSimplex<Digraph, int, long long> IntNS;
+    CostRounding<Digraph, IntCS> cr1(rgr);
+    cr1.upperMap(rcap).costMap(rcost).supplyMap(rsup);
+    checkMcf(cr1, cr1.run(), rgr, rlow, rcap, rcost, rsup,
+             cr1.algorithm().OPTIMAL, true, ns.totalCost(), "CR-INT");
+    check(cr1.scale() == 1 && cr1.roundingError() == 0,
+          "Wrong cost rounding");
+
+    Digraph::ArcMap<double> dcost(rgr);
+    for (ArcIt a(rgr); a != INVALID; ++a) {
+      dcost[a] = rcost[a] / 7.0 + rnd() * 1e-3;
+    }
+    CapacityScaling<Digraph, int, double> cas(rgr);
+    cas.upperMap(rcap).costMap(dcost).supplyMap(rsup).run();
+    CostRounding<Digraph, IntNS> cr2(rgr);
+    cr2.upperMap(rcap).costMap(dcost).supplyMap(rsup).tolerance(1e-7);
+    check(cr2.run() == cr2.algorithm().OPTIMAL, "Wrong result");
+    check(cr2.scale() > 1 && cr2.roundingError() <= 1e-7,
+          "Wrong cost rounding");
+    cr2.flowMap(rflow);
+    check(checkFlow(rgr, rlow, rcap, rsup, rflow),
+          "The flow is not feasible");
+    check(std::abs(cr2.totalCost() - cas.totalCost()) <=
+          1e-6 * cas.totalCost(), "Wrong total cost");
+    CostRounding<Digraph, IntCS> cr3(rgr);
+    cr3.upperMap(rcap).costMap(dcost).supplyMap(rsup).tolerance(1e-3);
+    check(cr3.run(IntCS::PUSH) == IntCS::OPTIMAL, "Wrong result");
+    check(cr3.roundingError() <= 1e-3 && cr3.scale() < cr2.scale(),
+          "Wrong cost rounding");
+    check(std::abs(cr3.totalCost() - cas.totalCost()) <=
+          1e-3 * cas.totalCost(), "Wrong total cost");
+  }
+
+  // Test the crossover from CostScaling to NetworkSimplex
+  {
+    typedef CostScaling<Digraph> COS;
+    COS cs1(gr), cs2(neg1_gr);
+    cs1.upperMap(u).costMap(c).supplyMap(s1).run();
+    checkCrossover(cs1, gr, l1, u, c, s1, 5240, "CROSS-1");
+    cs1.lowerMap(l2).supplyMap(s2).run();
+    checkCrossover(cs1, gr, l2, u, c, s2, 8010, "CROSS-4");
+    cs1.lowerMap(l3).supplyMap(s4).run();
+    checkCrossover(cs1, gr, l3, u, c, s4, 6360, "CROSS-9");
+    cs1.lowerMap(l2).supplyMap(s5).run();
+    checkCrossover(cs1, gr, l2, u, c, s5, 4540, "CROSS-11", GEQ);
+    cs2.lowerMap(neg1_l1).upperMap(neg1_u2).costMap(neg1_c)
+      .supplyMap(neg1_s).run();
+    checkCrossover(cs2, neg1_gr, neg1_l1, neg1_u2, neg1_c, neg1_s,
+                   -40000, "CROSS-14");
+
+    // CostScaling does not support the LEQ form
+    NetworkSimplex<Digraph> ns(gr);
+    ns.supplyType(ns.LEQ).lowerMap(l2).upperMap(u).costMap(c)
+      .supplyMap(s6).run();
+    checkCrossover(ns, gr, l2, u, c, s6, 5930, "CROSS-20", LEQ);
+  }
+
+  // Test the incremental arc insertion of NetworkSimplex
+  checkAddArcs(EQ, false, "ADD-1");
+  checkAddArcs(EQ, true, "ADD-2");
+  checkAddArcs(GEQ, true, "ADD-3");
+  checkAddArcs(LEQ, false, "ADD-4");
+
   // Test CycleCanceling
   {
     typedef CycleCanceling<Digraph> MCF;
@@ -0,0 +1,198 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <sstream>
+#include <vector>
+
+#include <lemon/smart_graph.h>
+#include <lemon/concepts/graph.h>
+#include <lemon/concepts/maps.h>
+#include <lemon/lgf_reader.h>
+#include <lemon/random.h>
+#include <lemon/hao_orlin.h>
+#include <lemon/nagamochi_ibaraki.h>
+#include <lemon/parallel_min_cut.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+using namespace std;
+
+const std::string lgf =
+  "@nodes\n"
+  "label\n"
+  "0\n"
+  "1\n"
+  "2\n"
+  "3\n"
+  "4\n"
+  "5\n"
+  "@edges\n"
+  "     cap1 cap2 cap3\n"
+  "0 1  1    1    1   \n"
+  "0 2  2    2    4   \n"
+  "1 2  4    4    4   \n"
+  "3 4  1    1    1   \n"
+  "3 5  2    2    4   \n"
+  "4 5  4    4    4   \n"
+  "2 3  1    6    6   \n";
+
+void checkParallelMinCutCompile()
+{
+  typedef int Value;
+  typedef concepts::Graph Graph;
+
+  typedef Graph::Edge Edge;
+  typedef concepts::ReadMap<Edge, Value> CapMap;
+  typedef concepts::WriteMap<Graph::Node, bool> CutMap;
+
+  Graph g;
+  CapMap cap;
+  CutMap cut;
+  Value v;
+  ::lemon::ignore_unused_variable_warning(v);
+
+  typedef ParallelMinCut<Graph, CapMap> MinCut;
+  MinCut mc_test(g, cap);
+  const MinCut& const_mc_test = mc_test;
+
+  mc_test.threadNum(2).trialNum(10).seed(42);
+  mc_test.run();
+  mc_test.run(MinCut::NAGAMOCHI_IBARAKI);
+  mc_test.run(MinCut::KARGER_STEIN);
+
+  v = const_mc_test.minCutValue();
+  v = const_mc_test.minCutMap(cut);
+}
+
+template <typename Graph, typename CapMap, typename CutMap>
+typename CapMap::Value
+  cutValue(const Graph& graph, const CapMap& cap, const CutMap& cut)
+{
+  typename CapMap::Value sum = 0;
+  for (typename Graph::EdgeIt e(graph); e != INVALID; ++e) {
+    if (cut[graph.u(e)] != cut[graph.v(e)]) {
+      sum += cap[e];
+    }
+  }
+  return sum;
+}
+
+template <typename Graph, typename CutMap>
+bool properCut(const Graph& graph, const CutMap& cut)
+{
+  int num = 0;
+  for (typename Graph::NodeIt n(graph); n != INVALID; ++n) {
+    if (cut[n]) ++num;
+  }
+  return num > 0 && num < countNodes(graph);
+}
+
+// Check both algorithms on a graph whose minimum cut value is known
+template <typename CapMap>
+void checkMinCut(const SmartGraph& graph, const CapMap& cap,
+                 typename CapMap::Value value, int threads, int trials)
+{
+  typedef ParallelMinCut<SmartGraph, CapMap> MinCut;
+  SmartGraph::NodeMap<bool> cut(graph);
+
+  MinCut mc(graph, cap);
+  mc.threadNum(threads).trialNum(trials);
+
+  mc.run();
+  mc.minCutMap(cut);
+  check(mc.minCutValue() == value, "Wrong cut value");
+  check(mc.minCutValue() == cutValue(graph, cap, cut), "Wrong cut value");
+  check(properCut(graph, cut), "Wrong cut");
+
+  mc.run(MinCut::KARGER_STEIN);
+  mc.minCutMap(cut);
+  check(mc.minCutValue() == value, "Wrong cut value");
+  check(mc.minCutValue() == cutValue(graph, cap, cut), "Wrong cut value");
+  check(properCut(graph, cut), "Wrong cut");
+}
+
+// Compare the results with NagamochiIbaraki and HaoOrlin on a random
+// graph with loops and parallel edges
+void checkRandom(int n, int m, int max_cap, int threads)
+{
+  SmartGraph graph;
+  SmartGraph::EdgeMap<int> cap(graph);
+  vector<SmartGraph::Node> nodes;
+  for (int i = 0; i != n; ++i) nodes.push_back(graph.addNode());
+  for (int i = 0; i != m; ++i) {
+    cap[graph.addEdge(nodes[rnd[n]], nodes[rnd[n]])] = rnd[max_cap];
+  }
+
+  NagamochiIbaraki<SmartGraph> ni(graph, cap);
+  ni.run();
+
+  SmartGraph::ArcMap<int> arc_cap(graph);
+  for (SmartGraph::ArcIt a(graph); a != INVALID; ++a) {
+    arc_cap[a] = cap[a];
+  }
+  HaoOrlin<SmartGraph, SmartGraph::ArcMap<int> > ho(graph, arc_cap);
+  ho.run();
+  check(ni.minCutValue() == ho.minCutValue(), "Wrong reference value");
+
+  checkMinCut(graph, cap, ni.minCutValue(), threads, 40);
+}
+
+int main() {
+  SmartGraph graph;
+  SmartGraph::EdgeMap<int> cap1(graph), cap2(graph), cap3(graph);
+
+  istringstream input(lgf);
+  graphReader(graph, input)
+    .edgeMap("cap1", cap1)
+    .edgeMap("cap2", cap2)
+    .edgeMap("cap3", cap3)
+    .run();
+
+  for (int threads = 1; threads <= 4; threads *= 2) {
+    checkMinCut(graph, cap1, 1, threads, 10);
+    checkMinCut(graph, cap2, 3, threads, 10);
+    checkMinCut(graph, cap3, 5, threads, 10);
+  }
+
+  {
+    SmartGraph::EdgeMap<double> cap(graph);
+    for (SmartGraph::EdgeIt e(graph); e != INVALID; ++e) {
+      cap[e] = cap3[e] / 2.0;
+    }
+    checkMinCut(graph, cap, 2.5, 2, 10);
+  }
+
+  // Small graphs, disconnected graphs and dense graphs
+  for (int i = 0; i != 50; ++i) {
+    checkRandom(2 + rnd[10], rnd[40], 10, 1 + i % 4);
+  }
+  for (int i = 0; i != 10; ++i) {
+    checkRandom(30 + rnd[50], 200 + rnd[400], 100, 1 + i % 4);
+  }
+  for (int i = 0; i != 5; ++i) {
+    checkRandom(40, 1500, 1000, 1 + i % 4);
+  }
+
+  // Large capacities are not handled by bucket heaps
+  for (int i = 0; i != 5; ++i) {
+    checkRandom(100, 1000, 2000000, 1 + i % 4);
+  }
+
+  return 0;
+}
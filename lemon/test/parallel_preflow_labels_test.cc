@@ -0,0 +1,62 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+// Check the distance labels after each round of ParallelPreflow. The
+// check takes O(m) time per round, so it is done on a single small
+// instance here, separately from parallel_preflow_test.cc.
+#undef NDEBUG
+#define LEMON_ENABLE_DEBUG
+
+#include <lemon/smart_graph.h>
+#include <lemon/random.h>
+#include <lemon/preflow.h>
+#include <lemon/parallel_preflow.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+int main() {
+  // The source and the target are connected to random halves of the
+  // nodes, so that the rounds are processed in parallel
+  const int n = 2000, m = 8000, max_cap = 20;
+  SmartDigraph g;
+  SmartDigraph::ArcMap<int> cap(g);
+  for (int i = 0; i != n; ++i) g.addNode();
+  for (int i = 0; i != m; ++i) {
+    cap[g.addArc(g.nodeFromId(rnd[n]), g.nodeFromId(rnd[n]))] =
+      rnd[max_cap];
+  }
+  SmartDigraph::Node s = g.addNode(), t = g.addNode();
+  for (int i = 0; i != n; ++i) {
+    if (rnd.boolean()) {
+      cap[g.addArc(s, g.nodeFromId(i))] = rnd[2 * max_cap];
+    } else {
+      cap[g.addArc(g.nodeFromId(i), t)] = rnd[2 * max_cap];
+    }
+  }
+
+  Preflow<SmartDigraph, SmartDigraph::ArcMap<int> > ref(g, cap, s, t);
+  ref.runMinCut();
+  ParallelPreflow<SmartDigraph, SmartDigraph::ArcMap<int> > pf(g, cap, s, t);
+  pf.threadNum(4).globalRelabelFrequency(0.5);
+  pf.runMinCut();
+  check(pf.flowValue() == ref.flowValue(), "Wrong flow value");
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
+#include <lemon/random.h>
+#include <lemon/preflow.h>
+#include <lemon/parallel_preflow.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+template <typename GR, typename CAP>
+typename CAP::Value cutValue(const GR& g,
+                             const typename GR::template NodeMap<bool>& cut,
+                             const CAP& cap) {
+  typename CAP::Value c = 0;
+  for (typename GR::ArcIt e(g); e != INVALID; ++e) {
+    if (cut[g.source(e)] && !cut[g.target(e)]) c += cap[e];
+  }
+  return c;
+}
+
+template <typename GR, typename T>
+bool checkFlow(const GR& g, const typename GR::template ArcMap<T>& flow,
+               const typename GR::template ArcMap<T>& cap,
+               typename GR::Node s, typename GR::Node t, T value) {
+  for (typename GR::ArcIt e(g); e != INVALID; ++e) {
+    if (flow[e] < 0 || flow[e] > cap[e]) return false;
+  }
+  for (typename GR::NodeIt n(g); n != INVALID; ++n) {
+    T sum = 0;
+    for (typename GR::OutArcIt e(g, n); e != INVALID; ++e) sum += flow[e];
+    for (typename GR::InArcIt e(g, n); e != INVALID; ++e) sum -= flow[e];
+    T expected = n == s ? value : (n == t ? -value : 0);
+    if (sum != expected) return false;
+  }
+  return true;
+}
+
+// Build a random digraph with parallel arcs, loops and (possibly)
+// unreachable parts
+template <typename GR, typename T>
+void randomGraph(GR& g, typename GR::template ArcMap<T>& cap,
+                 int n, int m, int max_cap) {
+  std::vector<typename GR::Node> nodes;
+  for (int i = 0; i != n; ++i) nodes.push_back(g.addNode());
+  for (int i = 0; i != m; ++i) {
+    typename GR::Arc e = g.addArc(nodes[rnd[n]], nodes[rnd[n]]);
+    cap[e] = T(rnd[max_cap]);
+  }
+}
+
+template <typename GR, typename T>
+void checkRandom(int n, int m, int max_cap, int threads, double freq) {
+  GR g;
+  typename GR::template ArcMap<T> cap(g);
+  randomGraph<GR, T>(g, cap, n, m, max_cap);
+  typename GR::Node s = g.nodeFromId(0), t = g.nodeFromId(n - 1);
+
+  Preflow<GR, typename GR::template ArcMap<T> > ref(g, cap, s, t);
+  ref.runMinCut();
+
+  ParallelPreflow<GR, typename GR::template ArcMap<T> > pf(g, cap, s, t);
+  pf.threadNum(threads).globalRelabelFrequency(freq);
+  pf.runMinCut();
+  check(pf.flowValue() == ref.flowValue(), "Wrong flow value");
+
+  typename GR::template NodeMap<bool> cut(g);
+  pf.minCutMap(cut);
+  check(cut[s] && !cut[t], "Wrong cut");
+  check(cutValue(g, cut, cap) == pf.flowValue(), "Wrong cut value");
+
+  pf.startSecondPhase();
+  check(pf.flowValue() == ref.flowValue(), "Wrong flow value");
+  check(checkFlow(g, pf.flowMap(), cap, s, t, pf.flowValue()),
+        "The flow is not feasible");
+
+  // Run again with changed capacities and terminals
+  for (typename GR::ArcIt e(g); e != INVALID; ++e) cap[e] = 2 * cap[e];
+  typename GR::Node t2 = g.nodeFromId(n / 2);
+  ref.target(t2).run();
+  pf.target(t2).run();
+  check(pf.flowValue() == ref.flowValue(), "Wrong flow value");
+  check(checkFlow(g, pf.flowMap(), cap, s, t2, pf.flowValue()),
+        "The flow is not feasible");
+}
+
+// Many active nodes and many threads: the source and the target are
+// connected to random halves of the nodes, so that the rounds are large
+// enough to be processed in parallel. The distance labels are checked
+// after each round in parallel_preflow_labels_test.cc.
+void checkStress(int n, int m, int max_cap, int threads, double freq) {
+  SmartDigraph g;
+  SmartDigraph::ArcMap<int> cap(g);
+  randomGraph<SmartDigraph, int>(g, cap, n, m, max_cap);
+  SmartDigraph::Node s = g.addNode(), t = g.addNode();
+  for (int i = 0; i != n; ++i) {
+    if (rnd.boolean()) {
+      cap[g.addArc(s, g.nodeFromId(i))] = rnd[2 * max_cap];
+    } else {
+      cap[g.addArc(g.nodeFromId(i), t)] = rnd[2 * max_cap];
+    }
+  }
+
+  Preflow<SmartDigraph, SmartDigraph::ArcMap<int> > ref(g, cap, s, t);
+  ref.runMinCut();
+  ParallelPreflow<SmartDigraph, SmartDigraph::ArcMap<int> > pf(g, cap, s, t);
+  pf.threadNum(threads).globalRelabelFrequency(freq);
+  pf.run();
+  check(pf.flowValue() == ref.flowValue(), "Wrong flow value");
+  check(checkFlow(g, pf.flowMap(), cap, s, t, pf.flowValue()),
+        "The flow is not feasible");
+}
+
+void checkSimple() {
+  ListDigraph g;
+  ListDigraph::ArcMap<int> cap(g);
+  ListDigraph::Node s = g.addNode(), a = g.addNode(), b = g.addNode(),
+    t = g.addNode(), u = g.addNode();
+  cap[g.addArc(s, a)] = 10;
+  cap[g.addArc(s, b)] = 5;
+  cap[g.addArc(a, b)] = 15;
+  cap[g.addArc(a, t)] = 4;
+  cap[g.addArc(b, t)] = 8;
+  cap[g.addArc(u, t)] = 7;
+  cap[g.addArc(a, a)] = 3;
+
+  // Erase a node to make the ids non-contiguous
+  ListDigraph::Node x = g.addNode();
+  cap[g.addArc(s, x)] = 1;
+  g.erase(x);
+
+  ParallelPreflow<ListDigraph> pf(g, cap, s, t);
+  pf.run();
+  check(pf.flowValue() == 12, "Wrong flow value");
+  check(pf.minCut(s) && pf.minCut(a) && pf.minCut(b) && !pf.minCut(t) &&
+        !pf.minCut(u), "Wrong cut");
+  check(checkFlow(g, pf.flowMap(), cap, s, t, 12),
+        "The flow is not feasible");
+}
+
+int main() {
+  checkSimple();
+
+  for (int i = 0; i != 5; ++i) {
+    checkRandom<SmartDigraph, int>(100, 400, 100, 2, 0.5);
+    checkRandom<SmartDigraph, int>(1000, 3000, 10, 3, 100);
+    checkRandom<ListDigraph, long long>(300, 2000, 1000, 4, 0);
+    checkRandom<ListDigraph, long long>(3000, 20000, 1000, 4, 0.5);
+  }
+  checkRandom<SmartDigraph, int>(20000, 100000, 1000, 4, 0.5);
+  checkRandom<SmartDigraph, int>(5000, 40000, 1000, 1, 0.5);
+
+  checkStress(4000, 16000, 20, 16, 0);
+  checkStress(4000, 16000, 20, 8, 0.5);
+
+  return 0;
+}
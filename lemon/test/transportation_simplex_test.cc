@@ -0,0 +1,140 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <lemon/smart_graph.h>
+#include <lemon/random.h>
+#include <lemon/network_simplex.h>
+#include <lemon/transportation_simplex.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+typedef TransportationSimplex<int, long long> TS;
+
+// Solve a random transportation problem and check the solution against
+// NetworkSimplex on the explicit complete bipartite graph
+void checkTransportation(int n, int m, int max_cost, int max_supply,
+                         int excess, TS::InitMethod init_method,
+                         const std::string &test_id)
+{
+  std::vector<int> supply(n), demand(m), cost(n * m);
+  for (int i = 0; i != n * m; ++i) {
+    cost[i] = rnd[max_cost];
+  }
+  int sum = 0;
+  for (int j = 0; j != m; ++j) {
+    demand[j] = rnd[max_supply + 1];
+    sum += demand[j];
+  }
+  sum += excess;
+  for (int i = 0; i != n; ++i) {
+    supply[i] = i + 1 == n ? sum : rnd[sum / n + 1];
+    sum -= supply[i];
+  }
+
+  TS ts(n, m);
+  ts.supplyMap(supply).demandMap(demand);
+  check(ts.run([&](int i, int j) { return cost[i * m + j]; },
+               init_method) == ts.OPTIMAL, "Wrong result " + test_id);
+
+  // Check the flow and the potentials
+  std::vector<int> out(n, 0), in(m, 0);
+  check(ts.flowNum() <= n + m - 1, "Too many flow values " + test_id);
+  for (int k = 0; k != ts.flowNum(); ++k) {
+    int i = ts.flowSupplier(k), j = ts.flowConsumer(k);
+    check(ts.flowValue(k) > 0 && ts.flow(i, j) == ts.flowValue(k),
+          "Wrong flow value " + test_id);
+    check(cost[i * m + j] + ts.supplierPotential(i) -
+          ts.consumerPotential(j) == 0, "Wrong potentials " + test_id);
+    out[i] += ts.flowValue(k);
+    in[j] += ts.flowValue(k);
+  }
+  for (int i = 0; i != n; ++i) {
+    check(out[i] == supply[i] || (excess > 0 && out[i] < supply[i]),
+          "Wrong supply " + test_id);
+    check(excess == 0 || (ts.supplierPotential(i) >= 0 &&
+          (out[i] == supply[i] || ts.supplierPotential(i) == 0)),
+          "Wrong potentials " + test_id);
+    for (int j = 0; j != m; ++j) {
+      check(cost[i * m + j] + ts.supplierPotential(i) -
+            ts.consumerPotential(j) >= 0, "Wrong potentials " + test_id);
+    }
+  }
+  for (int j = 0; j != m; ++j) {
+    check(in[j] == demand[j], "Wrong demand " + test_id);
+  }
+
+  // Compare the total cost to that of NetworkSimplex
+  SmartDigraph gr;
+  SmartDigraph::ArcMap<int> arc_cost(gr);
+  SmartDigraph::NodeMap<int> sup(gr);
+  std::vector<SmartDigraph::Node> nodes;
+  for (int i = 0; i != n + m; ++i) {
+    nodes.push_back(gr.addNode());
+    sup[nodes[i]] = i < n ? supply[i] : -demand[i - n];
+  }
+  for (int i = 0; i != n; ++i) {
+    for (int j = 0; j != m; ++j) {
+      arc_cost[gr.addArc(nodes[i], nodes[n + j])] = cost[i * m + j];
+    }
+  }
+  NetworkSimplex<SmartDigraph, int, long long> ns(gr);
+  ns.costMap(arc_cost).supplyMap(sup).supplyType(ns.LEQ);
+  check(ns.run() == ns.OPTIMAL, "Wrong result " + test_id);
+  check(ts.totalCost() == ns.totalCost() &&
+        ts.totalCost<double>() == ns.totalCost(),
+        "The flow is not optimal " + test_id);
+}
+
+int main()
+{
+  const TS::InitMethod methods[] = { TS::NORTH_WEST_CORNER, TS::VOGEL };
+  for (int k = 0; k != 2; ++k) {
+    std::string id = k == 0 ? "NWC" : "VOGEL";
+    checkTransportation(1, 1, 10, 10, 0, methods[k], id + "-1");
+    checkTransportation(1, 20, 10, 10, 5, methods[k], id + "-2");
+    checkTransportation(20, 1, 10, 10, 0, methods[k], id + "-3");
+    for (int i = 0; i != 10; ++i) {
+      checkTransportation(30, 40, 100, 20, 0, methods[k], id + "-4");
+      checkTransportation(40, 30, 1000, 100, 50, methods[k], id + "-5");
+      checkTransportation(25, 25, 3, 2, 0, methods[k], id + "-6");
+      // Highly degenerate (assignment-like) problems
+      checkTransportation(60, 60, 5, 1, 0, methods[k], id + "-8");
+    }
+    checkTransportation(150, 200, 10000, 1000, 100, methods[k], id + "-7");
+  }
+
+  // Infeasible and trivial problems
+  std::vector<int> supply(3, 1), demand(2, 2);
+  TS ts1(3, 2);
+  ts1.supplyMap(supply).demandMap(demand);
+  check(ts1.run([](int, int) { return 1; }) == ts1.INFEASIBLE,
+        "Wrong result");
+  demand[0] = 1;
+  check(ts1.demandMap(demand).run([](int i, int j) { return i + j; }) ==
+        ts1.OPTIMAL && ts1.totalCost() == 5, "Wrong result");
+  TS ts2(0, 0);
+  check(ts2.run([](int, int) { return 1; }) == ts2.OPTIMAL &&
+        ts2.totalCost() == 0 && ts2.flowNum() == 0, "Wrong result");
+
+  return 0;
+}
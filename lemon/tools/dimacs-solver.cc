@@ -31,8 +31,11 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <limits>
 
 #include <lemon/smart_graph.h>
+#include <lemon/adaptors.h>
+#include <lemon/maps.h>
 #include <lemon/dimacs.h>
 #include <lemon/lgf_writer.h>
 #include <lemon/time_measure.h>
@@ -42,8 +45,14 @@
 
 #include <lemon/dijkstra.h>
 #include <lemon/preflow.h>
+#include <lemon/dinic.h>
+#include <lemon/edmonds_karp.h>
 #include <lemon/matching.h>
 #include <lemon/network_simplex.h>
+#include <lemon/cost_scaling.h>
+#include <lemon/capacity_scaling.h>
+#include <lemon/radix_heap.h>
+#include <lemon/bucket_heap.h>
 
 using namespace lemon;
 typedef SmartDigraph Digraph;
@@ -70,6 +79,19 @@ void solve_sp(ArgParser &ap, std::istream &is, std::ostream &,
   if(report) std::cerr << "Run Dijkstra: " << t << '\n';
 }
 
+template<class MF>
+void solve_mf(bool report, const char *name, const Digraph &g,
+              const Digraph::ArcMap<typename MF::Value> &cap, Node s, Node t)
+{
+  Timer ti;
+  MF mf(g,cap,s,t);
+  if(report) std::cerr << "Setup " << name << " class: " << ti << '\n';
+  ti.restart();
+  mf.run();
+  if(report) std::cerr << "Run " << name << ": " << ti << '\n';
+  if(report) std::cerr << "\nMax flow value: " << mf.flowValue() << '\n';
+}
+
 template<class Value>
 void solve_max(ArgParser &ap, std::istream &is, std::ostream &,
                Value infty, DimacsDescriptor &desc)
@@ -82,13 +104,138 @@ void solve_max(ArgParser &ap, std::istream &is, std::ostream &,
   ti.restart();
   readDimacsMax(is, g, cap, s, t, infty, desc);
   if(report) std::cerr << "Read the file: " << ti << '\n';
+
+  std::string alg = ap["maxflow"];
+  if (alg == "preflow") {
+    solve_mf<Preflow<Digraph, Digraph::ArcMap<Value> > >
+      (report, "Preflow", g, cap, s, t);
+  }
+  else if (alg == "dinic") {
+    solve_mf<Dinic<Digraph, Digraph::ArcMap<Value> > >
+      (report, "Dinic", g, cap, s, t);
+  }
+  else if (alg == "ek") {
+    solve_mf<EdmondsKarp<Digraph, Digraph::ArcMap<Value> > >
+      (report, "EdmondsKarp", g, cap, s, t);
+  }
+  else {
+    std::cerr << "Unknown max flow algorithm: " << alg << '\n';
+    exit(1);
+  }
+}
+
+template<class MCF, class LargeValue, class SupplyMap>
+void solve_cas(bool report, const typename MCF::Digraph &g,
+               const Digraph::ArcMap<typename MCF::Value> &lower,
+               const Digraph::ArcMap<typename MCF::Value> &cap,
+               const Digraph::ArcMap<typename MCF::Value> &cost,
+               const SupplyMap &sup)
+{
+  Timer ti;
+  MCF cas(g);
+  cas.lowerMap(lower).upperMap(cap).costMap(cost).supplyMap(sup);
+  if (report) std::cerr << "Setup CapacityScaling class: " << ti << '\n';
   ti.restart();
-  Preflow<Digraph, Digraph::ArcMap<Value> > pre(g,cap,s,t);
-  if(report) std::cerr << "Setup Preflow class: " << ti << '\n';
-  ti.restart();
-  pre.run();
-  if(report) std::cerr << "Run Preflow: " << ti << '\n';
-  if(report) std::cerr << "\nMax flow value: " << pre.flowValue() << '\n';
+  typename MCF::ProblemType res = cas.run();
+  if (report) {
+    std::cerr << "Run CapacityScaling: " << ti << "\n\n";
+    std::cerr << "Feasible flow: " << (res == MCF::OPTIMAL ? "found" :
+                                       "not found") << '\n';
+    if (res) std::cerr << "Min flow cost: "
+                       << cas.template totalCost<LargeValue>() << '\n';
+  }
+}
+
+// Solve a min cost flow problem having GEQ supply constraints with
+// CostScaling or CapacityScaling
+template<class LargeValue, class GR, class Value, class SupplyMap>
+void solve_geq(ArgParser &ap, bool report, const GR &g,
+               const Digraph::ArcMap<Value> &lower,
+               const Digraph::ArcMap<Value> &cap,
+               const Digraph::ArcMap<Value> &cost, const SupplyMap &sup)
+{
+  std::string alg = ap["mcf"];
+  if (alg == "cas") {
+    solve_cas<CapacityScaling<GR, Value>, LargeValue>
+      (report, g, lower, cap, cost, sup);
+  }
+  else if (alg == "cas-radix" && std::numeric_limits<Value>::is_integer) {
+    solve_cas<typename CapacityScaling<GR, Value>::template
+      SetHeap<RadixHeap<RangeMap<int>, Value> >::Create, LargeValue>
+      (report, g, lower, cap, cost, sup);
+  }
+  else if (alg == "cas-bucket" && std::numeric_limits<Value>::is_integer) {
+    // BucketHeap has int priorities and allocates a bucket for each
+    // distance value, so it is used only if the Dijkstra distances
+    // (at most 3(n-1) times the largest cost) are small
+    long double bound = 0;
+    for (typename GR::ArcIt a(g); a != INVALID; ++a) {
+      long double c = static_cast<long double>(cost[a]);
+      if (c < 0) c = -c;
+      if (c > bound) bound = c;
+    }
+    bound *= 3.0L * countNodes(g);
+    if (bound > (1 << 20)) {
+      std::cerr << "The costs are too large for cas-bucket\n";
+      exit(1);
+    }
+    solve_cas<typename CapacityScaling<GR, Value>::template
+      SetHeap<BucketHeap<RangeMap<int> > >::Create, LargeValue>
+      (report, g, lower, cap, cost, sup);
+  }
+  else {
+    typedef CostScaling<GR, Value> MCF;
+    typename MCF::Method method;
+    if (alg == "cos-push") method = MCF::PUSH;
+    else if (alg == "cos-augment") method = MCF::AUGMENT;
+    else if (alg == "cos-partial") method = MCF::PARTIAL_AUGMENT;
+    else if (alg == "cos-wave") method = MCF::WAVE;
+    else if (alg == "cos-parallel") method = MCF::PARALLEL_PUSH;
+    else {
+      std::cerr << "Unknown min cost flow algorithm: " << alg << '\n';
+      exit(1);
+    }
+    Timer ti;
+    MCF cos(g);
+    cos.lowerMap(lower).upperMap(cap).costMap(cost).supplyMap(sup);
+    cos.threadNum(ap["threads"]);
+    cos.optimalityGap(0, ap["gap"]);
+    if (report) std::cerr << "Setup CostScaling class: " << ti << '\n';
+    ti.restart();
+    typename MCF::ProblemType res = cos.run(method);
+    if (report) {
+      std::cerr << "Run CostScaling (" << alg << "): " << ti << "\n\n";
+      std::cerr << "Feasible flow: " << (res == MCF::OPTIMAL ||
+                                         res == MCF::FEASIBLE ? "found" :
+                                         "not found") << '\n';
+      if (res == MCF::FEASIBLE) {
+        std::cerr << "Optimality gap reached\n";
+        std::cerr << "Flow cost: "
+                  << cos.template totalCost<LargeValue>() << '\n';
+        std::cerr << "Lower bound: "
+                  << cos.template dualBound<LargeValue>() << '\n';
+      }
+      if (res == MCF::OPTIMAL) std::cerr << "Min flow cost: "
+                         << cos.template totalCost<LargeValue>() << '\n';
+    }
+    if (res == MCF::OPTIMAL && ap.given("crossover")) {
+      ti.restart();
+      typename GR::template ArcMap<Value> flow(g);
+      typename GR::template NodeMap<Value> pot(g);
+      cos.flowMap(flow);
+      cos.potentialMap(pot);
+      NetworkSimplex<GR, Value> ns(g);
+      ns.lowerMap(lower).upperMap(cap).costMap(cost).supplyMap(sup);
+      if (report) std::cerr << "\nSetup NetworkSimplex class: " << ti << '\n';
+      ti.restart();
+      ns.run(flow, pot);
+      if (report) {
+        std::cerr << "Run NetworkSimplex (crossover): " << ti << "\n\n";
+        std::cerr << "Min flow cost: "
+                  << ns.template totalCost<LargeValue>() << '\n';
+      }
+    }
+  }
 }
 
 template<class Value, class LargeValue>
@@ -111,26 +258,50 @@ void solve_min(ArgParser &ap, std::istream &is, std::ostream &,
   if (report) {
     std::cerr << "Sum of supply values: " << sum_sup << "\n";
     if (sum_sup <= 0)
-      std::cerr << "GEQ supply contraints are used for NetworkSimplex\n\n";
+      std::cerr << "GEQ supply contraints are used\n\n";
     else
-      std::cerr << "LEQ supply contraints are used for NetworkSimplex\n\n";
+      std::cerr << "LEQ supply contraints are used\n\n";
   }
   if (report) std::cerr << "Read the file: " << ti << '\n';
 
-  typedef NetworkSimplex<Digraph, Value> MCF;
-  ti.restart();
-  MCF ns(g);
-  ns.lowerMap(lower).upperMap(cap).costMap(cost).supplyMap(sup);
-  if (sum_sup > 0) ns.supplyType(ns.LEQ);
-  if (report) std::cerr << "Setup NetworkSimplex class: " << ti << '\n';
-  ti.restart();
-  typename MCF::ProblemType res = ns.run();
-  if (report) {
-    std::cerr << "Run NetworkSimplex: " << ti << "\n\n";
-    std::cerr << "Feasible flow: " << (res == MCF::OPTIMAL ? "found" :
-                                       "not found") << '\n';
-    if (res) std::cerr << "Min flow cost: "
-                       << ns.template totalCost<LargeValue>() << '\n';
+  std::string alg = ap["mcf"];
+  if (alg == "ns") {
+    typedef NetworkSimplex<Digraph, Value> MCF;
+    ti.restart();
+    MCF ns(g);
+    ns.lowerMap(lower).upperMap(cap).costMap(cost).supplyMap(sup);
+    if (sum_sup > 0) ns.supplyType(ns.LEQ);
+    ns.timeLimit(ap["timelimit"]);
+    if (report) std::cerr << "Setup NetworkSimplex class: " << ti << '\n';
+    ti.restart();
+    typename MCF::ProblemType res = ns.run();
+    if (report) {
+      std::cerr << "Run NetworkSimplex: " << ti << "\n\n";
+      std::cerr << "Feasible flow: " << (res == MCF::OPTIMAL ||
+                                         res == MCF::FEASIBLE ? "found" :
+                                         "not found") << '\n';
+      if (res == MCF::FEASIBLE) {
+        std::cerr << "Time limit reached, feasible flow found after "
+                  << ns.feasibleTime() << "s\n";
+        std::cerr << "Flow cost: "
+                  << ns.template totalCost<LargeValue>() << '\n';
+        std::cerr << "Lower bound: "
+                  << ns.template dualBound<LargeValue>() << '\n';
+      }
+      if (res == MCF::OPTIMAL) std::cerr << "Min flow cost: "
+                         << ns.template totalCost<LargeValue>() << '\n';
+    }
+  }
+  else if (sum_sup > 0) {
+    // CostScaling and CapacityScaling support GEQ supply constraints
+    // only, the LEQ form is solved by reversing the arcs and negating
+    // the supply values
+    ReverseDigraph<const Digraph> rg(g);
+    NegMap<Digraph::NodeMap<Value> > neg_sup(sup);
+    solve_geq<LargeValue>(ap, report, rg, lower, cap, cost, neg_sup);
+  }
+  else {
+    solve_geq<LargeValue>(ap, report, g, lower, cap, cost, sup);
   }
 }
 
@@ -210,6 +381,20 @@ int main(int argc, const char *argv[]) {
     .optionGroup("datatype","ldouble")
     .onlyOneGroup("datatype")
     .stringOption("infcap","Value used for 'very high' capacities","0")
+    .stringOption("maxflow","Max flow algorithm: preflow, dinic or ek",
+                  "preflow")
+    .stringOption("mcf","Min cost flow algorithm: ns, cas, cas-radix,\n"
+                  "     cas-bucket (only for n * max cost < 2^20 / 3),\n"
+                  "     cos-push, cos-augment, cos-partial,\n"
+                  "     cos-wave or cos-parallel","ns")
+    .doubleOption("timelimit","Time limit for NetworkSimplex in seconds\n"
+                  "     (0: no limit)",0)
+    .doubleOption("gap","Allowed relative optimality gap for CostScaling\n"
+                  "     (0: exact solution)",0)
+    .boolOption("crossover","Run NetworkSimplex starting from the solution\n"
+                "     of CostScaling to obtain a spanning tree solution")
+    .intOption("threads","Number of threads used by parallel algorithms\n"
+               "     (0: the number of hardware threads)",0)
     .run();
 
   std::ifstream input;
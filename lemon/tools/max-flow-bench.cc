@@ -0,0 +1,159 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+///\ingroup tools
+///\file
+///\brief Max flow benchmark on long path networks.
+///
+/// This program generates networks in which the augmenting paths are
+/// long, and compares the running times of Preflow, Dinic and
+/// EdmondsKarp on them. The \c -paths family is the one Dinic is meant
+/// for (many long augmenting paths in each phase), on the other two
+/// Preflow is faster.
+///
+/// See
+/// \code
+///   max-flow-bench --help
+/// \endcode
+/// for more info on usage.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <lemon/smart_graph.h>
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+
+#include <lemon/preflow.h>
+#include <lemon/dinic.h>
+#include <lemon/edmonds_karp.h>
+
+using namespace lemon;
+typedef SmartDigraph Digraph;
+DIGRAPH_TYPEDEFS(Digraph);
+typedef long long Value;
+typedef Digraph::ArcMap<Value> CapMap;
+
+// k unit paths from the source to the target sharing a chain of
+// length len (each phase of Dinic has k paths through the chain)
+void sharedChain(Digraph &g, CapMap &cap, Node s, Node t, int k, int len) {
+  std::vector<Node> c;
+  for (int i = 0; i <= len; ++i) c.push_back(g.addNode());
+  for (int i = 0; i < len; ++i) cap[g.addArc(c[i], c[i + 1])] = k;
+  for (int i = 0; i < k; ++i) {
+    Node a = g.addNode(), b = g.addNode();
+    cap[g.addArc(s, a)] = 1;
+    cap[g.addArc(a, c[0])] = 1;
+    cap[g.addArc(c[len], b)] = 1;
+    cap[g.addArc(b, t)] = 1;
+  }
+}
+
+// k parallel paths of length len with unit cross links between the
+// neighboring paths at every 7th node (the source and target arcs of
+// the paths are unbalanced, so the flow has to cross over)
+void crossedPaths(Digraph &g, CapMap &cap, Node s, Node t, int k, int len) {
+  std::vector<std::vector<Node> > p(k);
+  for (int j = 0; j < k; ++j) {
+    for (int i = 0; i < len; ++i) p[j].push_back(g.addNode());
+    cap[g.addArc(s, p[j][0])] = 1 + j;
+    cap[g.addArc(p[j][len - 1], t)] = k - j;
+    for (int i = 0; i + 1 < len; ++i) {
+      cap[g.addArc(p[j][i], p[j][i + 1])] = k;
+    }
+  }
+  for (int j = 0; j + 1 < k; ++j) {
+    for (int i = 0; i < len; i += 7) {
+      cap[g.addArc(p[j][i], p[j + 1][i])] = 1;
+      cap[g.addArc(p[j + 1][i], p[j][i])] = 1;
+    }
+  }
+}
+
+// A chain of length len with a unit arc from each node to the target
+// (each phase of Dinic has a single augmenting path)
+void chainExits(Digraph &g, CapMap &cap, Node s, Node t, int len) {
+  std::vector<Node> c;
+  for (int i = 0; i < len; ++i) c.push_back(g.addNode());
+  cap[g.addArc(s, c[0])] = len;
+  for (int i = 0; i + 1 < len; ++i) {
+    cap[g.addArc(c[i], c[i + 1])] = len - i - 1;
+    cap[g.addArc(c[i], t)] = 1;
+  }
+  cap[g.addArc(c[len - 1], t)] = 1;
+}
+
+template <typename MF>
+Value bench(const std::string &name, const Digraph &g, const CapMap &cap,
+            Node s, Node t) {
+  Timer ti;
+  MF mf(g, cap, s, t);
+  mf.run();
+  std::cout << name << ": " << ti << '\n';
+  std::cout << "  flow value: " << mf.flowValue() << '\n';
+  return mf.flowValue();
+}
+
+int main(int argc, const char *argv[]) {
+  ArgParser ap(argc, argv);
+  ap.boolOption("chain", "k unit paths sharing a chain of length len")
+    .optionGroup("family", "chain")
+    .boolOption("paths", "k parallel paths of length len with cross links")
+    .optionGroup("family", "paths")
+    .boolOption("exits", "A chain of length len with unit exits")
+    .optionGroup("family", "exits")
+    .onlyOneGroup("family")
+    .mandatoryGroup("family")
+    .intOption("k", "Number of paths", 1000)
+    .intOption("len", "Length of the paths", 1000)
+    .boolOption("ek", "Also run EdmondsKarp (slow on most of these)")
+    .run();
+
+  int k = ap["k"], len = ap["len"];
+  if (k < 1 || len < 2) {
+    std::cerr << ap.commandName() << ": k must be positive and len must be"
+              << " at least 2\n";
+    return 1;
+  }
+
+  Digraph g;
+  CapMap cap(g);
+  Node s = g.addNode(), t = g.addNode();
+  if (ap.given("chain")) {
+    sharedChain(g, cap, s, t, k, len);
+  } else if (ap.given("paths")) {
+    crossedPaths(g, cap, s, t, k, len);
+  } else {
+    chainExits(g, cap, s, t, len);
+  }
+  std::cout << "Nodes: " << countNodes(g) << ", arcs: " << countArcs(g)
+            << '\n';
+
+  Value value = bench<Preflow<Digraph, CapMap> >("Preflow", g, cap, s, t);
+  bool ok = bench<Dinic<Digraph, CapMap> >("Dinic", g, cap, s, t) == value;
+  if (ap.given("ek")) {
+    ok = bench<EdmondsKarp<Digraph, CapMap> >("EdmondsKarp", g, cap, s, t)
+      == value && ok;
+  }
+  if (!ok) {
+    std::cerr << "The flow values differ\n";
+    return 1;
+  }
+  return 0;
+}
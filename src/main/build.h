@@ -0,0 +1,20 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "lemon/static_graph.h"
+
+// Build a static digraph from bulk arrays of arc sources and targets. The
+// arcs must be sorted by their sources (like for SG_build), arc i of the
+// graph is the arc given by sources[i] and targets[i].
+inline void buildStaticDigraph(lemon::StaticDigraph &graph, int nodeNum,
+                               int arcNum, const int *sources,
+                               const int *targets) {
+  std::vector<std::pair<int, int>> arcs;
+  arcs.reserve(arcNum);
+  for (int i = 0; i < arcNum; i++) {
+    arcs.push_back(std::make_pair(sources[i], targets[i]));
+  }
+  graph.build(nodeNum, arcs.begin(), arcs.end());
+}
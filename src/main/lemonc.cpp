@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include <utility>
 
 #include "lemon/concepts/digraph.h"
@@ -7,10 +9,23 @@
 #include "lemon/smart_graph.h"
 #include "lemon/static_graph.h"
 
+#include "lemon/auction_assignment.h"
+#include "lemon/bits/thread_pool.h"
 #include "lemon/capacity_scaling.h"
+#include "lemon/circulation.h"
+#include "lemon/cost_rounding.h"
 #include "lemon/cost_scaling.h"
+#include "lemon/earth_movers_distance.h"
+#include "lemon/jonker_volgenant.h"
 #include "lemon/network_simplex.h"
+#include "lemon/radix_heap.h"
+#include "lemon/transportation_simplex.h"
 
+#include "build.h"
+#include "max_flow_batch.h"
+#include "max_flow_problem.h"
+#include "scenario_batch.h"
+#include "solution_cache.h"
 #include "types.h"
 
 template <typename T> inline void *copyToHeap(T &obj) {
@@ -21,6 +36,93 @@ template <typename T> inline void *copyToHeap(T &obj) {
 
 template <typename T> inline T &deref(void *ptr) { return *((T *)ptr); }
 
+template <typename ALG> struct ProblemTypeCode {
+  static int get(typename ALG::ProblemType type) {
+    switch (type) {
+    case ALG::ProblemType::INFEASIBLE:
+      return 0;
+    case ALG::ProblemType::OPTIMAL:
+      return 1;
+    case ALG::ProblemType::UNBOUNDED:
+      return 2;
+    }
+    return 0;
+  }
+};
+
+// NetworkSimplex can also stop at its time limit: 3 means that a feasible
+// flow was found, 4 means that no feasible flow was found
+template <typename G, typename V, typename C>
+struct ProblemTypeCode<lemon::NetworkSimplex<G, V, C>> {
+  typedef lemon::NetworkSimplex<G, V, C> NS;
+  static int get(typename NS::ProblemType type) {
+    switch (type) {
+    case NS::ProblemType::FEASIBLE:
+      return 3;
+    case NS::ProblemType::UNDEFINED:
+      return 4;
+    default:
+      return type == NS::ProblemType::OPTIMAL
+                 ? 1
+                 : (type == NS::ProblemType::UNBOUNDED ? 2 : 0);
+    }
+  }
+};
+
+// CostScaling can also stop at the given optimality gap: 3 means that a
+// feasible flow within the gap was found
+template <typename G, typename V, typename C>
+struct ProblemTypeCode<lemon::CostScaling<G, V, C>> {
+  typedef lemon::CostScaling<G, V, C> CS;
+  static int get(typename CS::ProblemType type) {
+    switch (type) {
+    case CS::ProblemType::FEASIBLE:
+      return 3;
+    default:
+      return type == CS::ProblemType::OPTIMAL
+                 ? 1
+                 : (type == CS::ProblemType::UNBOUNDED ? 2 : 0);
+    }
+  }
+};
+
+// TransportationSimplex has no UNBOUNDED type (the arcs have nonnegative
+// flow and the problem is bounded, since it has finitely many bases)
+template <typename V, typename C>
+struct ProblemTypeCode<lemon::TransportationSimplex<V, C>> {
+  typedef lemon::TransportationSimplex<V, C> TS;
+  static int get(typename TS::ProblemType type) {
+    return type == TS::ProblemType::OPTIMAL ? 1 : 0;
+  }
+};
+
+template <typename G, typename MCF, typename C>
+struct ProblemTypeCode<lemon::CostRounding<G, MCF, C>>
+    : ProblemTypeCode<MCF> {};
+
+template <typename ALG> inline int problemType(typename ALG::ProblemType type) {
+  return ProblemTypeCode<ALG>::get(type);
+}
+
+// Check convex cost functions given by bulk arrays (like for
+// setConvexCosts): each function must have at least one piece, increasing
+// breakpoints and non-decreasing slopes
+template <typename V, typename C>
+bool validConvexCosts(int arcNum, const int *pieceNums, const V *breakpoints,
+                      const C *slopes) {
+  for (int i = 0; i < arcNum; i++) {
+    int k = pieceNums[i];
+    if (k < 1) return false;
+    for (int p = 1; p < k; p++) {
+      if (p > 1 && breakpoints[p - 2] >= breakpoints[p - 1]) return false;
+      if (slopes[p - 1] > slopes[p]) return false;
+    }
+    breakpoints += k - 1;
+    slopes += k;
+  }
+  return true;
+}
+
 #define CLASS(C, name)                                                         \
   void *name##_construct() { return new C(); }                                 \
   void name##_destruct(void *ptr) { delete (C *)ptr; }
@@ -71,18 +173,135 @@ template <typename T> inline T &deref(void *ptr) { return *((T *)ptr); }
     deref<ALG<G, V, C>>(algoPtr).supplyMap(deref<G::NodeMap<V>>(mapPtr));      \
   }                                                                            \
   int name##_run(void *algoPtr) {                                              \
-    auto type = deref<ALG<G, V, C>>(algoPtr).run();                            \
-    switch (type) {                                                            \
-    case ALG<G, V, C>::ProblemType::INFEASIBLE:                                \
-      return 0;                                                                \
-    case ALG<G, V, C>::ProblemType::OPTIMAL:                                   \
-      return 1;                                                                \
-    case ALG<G, V, C>::ProblemType::UNBOUNDED:                                 \
-      return 2;                                                                \
-    }                                                                          \
+    return problemType<ALG<G, V, C>>(deref<ALG<G, V, C>>(algoPtr).run());      \
   }                                                                            \
   V name##_flow(void *algoPtr, void *arcPtr) {                                 \
     return deref<ALG<G, V, C>>(algoPtr).flow(deref<G::Arc>(arcPtr));           \
+  }                                                                            \
+  double name##_totalCost(void *algoPtr) {                                     \
+    return deref<ALG<G, V, C>>(algoPtr).totalCost<double>();                   \
+  }
+
+// The method is given by its index in CostScaling::Method, runMethod
+// returns 4 (undefined, the algorithm is not run) for an invalid index
+#define COST_SCALING(G, V, C, name)                                            \
+  void name##_setThreadNum(void *algoPtr, int threadNum) {                     \
+    deref<CostScaling<G, V, C>>(algoPtr).threadNum(threadNum);                 \
+  }                                                                            \
+  int name##_runMethod(void *algoPtr, int method) {                            \
+    typedef CostScaling<G, V, C> CS;                                           \
+    if (method < CS::PUSH || method > CS::PARALLEL_PUSH) return 4;             \
+    auto &algo = deref<CS>(algoPtr);                                           \
+    return problemType<CS>(algo.run(static_cast<typename CS::Method>(method)));\
+  }                                                                            \
+  void name##_setOptimalityGap(void *algoPtr, double absGap, double relGap) {  \
+    deref<CostScaling<G, V, C>>(algoPtr).optimalityGap(absGap, relGap);        \
+  }                                                                            \
+  double name##_dualBound(void *algoPtr) {                                     \
+    auto &algo = deref<CostScaling<G, V, C>>(algoPtr);                         \
+    return algo.dualBound<double>();                                           \
+  }
+
+#define NETWORK_SIMPLEX(G, V, C, name)                                         \
+  int name##_runCrossover(void *algoPtr, void *graphPtr, void *csPtr) {        \
+    typedef NetworkSimplex<G, V, C> NS;                                        \
+    G::ArcMap<V> flow(deref<G>(graphPtr));                                     \
+    G::NodeMap<C> pot(deref<G>(graphPtr));                                     \
+    deref<CostScaling<G, V, C>>(csPtr).flowMap(flow);                          \
+    deref<CostScaling<G, V, C>>(csPtr).potentialMap(pot);                      \
+    return problemType<NS>(deref<NS>(algoPtr).run(flow, pot));                 \
+  }                                                                            \
+  int name##_treeArc(void *algoPtr, void *arcPtr) {                            \
+    return deref<NetworkSimplex<G, V, C>>(algoPtr).treeArc(                    \
+        deref<G::Arc>(arcPtr));                                                \
+  }                                                                            \
+  C name##_potential(void *algoPtr, void *nodePtr) {                           \
+    return deref<NetworkSimplex<G, V, C>>(algoPtr).potential(                  \
+        deref<G::Node>(nodePtr));                                              \
+  }                                                                            \
+  void name##_setTimeLimit(void *algoPtr, double limit) {                      \
+    deref<NetworkSimplex<G, V, C>>(algoPtr).timeLimit(limit);                  \
+  }                                                                            \
+  double name##_feasibleTime(void *algoPtr) {                                  \
+    return deref<NetworkSimplex<G, V, C>>(algoPtr).feasibleTime();             \
+  }                                                                            \
+  int name##_pivotNum(void *algoPtr) {                                         \
+    return deref<NetworkSimplex<G, V, C>>(algoPtr).pivotNum();                 \
+  }                                                                            \
+  double name##_dualBound(void *algoPtr) {                                     \
+    auto &algo = deref<NetworkSimplex<G, V, C>>(algoPtr);                      \
+    return algo.dualBound<double>();                                           \
+  }                                                                            \
+  void name##_addArcs(void *algoPtr, void *graphPtr, int arcNum,               \
+                      void **sources, void **targets, V *lower, V *upper,      \
+                      C *cost, void **arcs) {                                  \
+    auto &algo = deref<NetworkSimplex<G, V, C>>(algoPtr);                      \
+    G &graph = deref<G>(graphPtr);                                             \
+    for (int i = 0; i < arcNum; i++) {                                         \
+      G::Arc arc = graph.addArc(deref<G::Node>(sources[i]),                    \
+                                deref<G::Node>(targets[i]));                   \
+      algo.addArc(arc, lower ? lower[i] : 0, upper ? upper[i] : algo.INF,      \
+                  cost[i]);                                                    \
+      if (arcs) {                                                              \
+        arcs[i] = copyToHeap(arc);                                             \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+  int name##_resume(void *algoPtr) {                                           \
+    typedef NetworkSimplex<G, V, C> NS;                                        \
+    return problemType<NS>(deref<NS>(algoPtr).resume());                       \
+  }
+
+#define COST_ROUNDING(G, ALG, V, C, name)                                      \
+  void name##_setTolerance(void *algoPtr, double tolerance) {                  \
+    deref<ALG<G, V, C>>(algoPtr).tolerance(tolerance);                         \
+  }                                                                            \
+  double name##_scale(void *algoPtr) {                                         \
+    return deref<ALG<G, V, C>>(algoPtr).scale();                               \
+  }                                                                            \
+  double name##_roundingError(void *algoPtr) {                                 \
+    return deref<ALG<G, V, C>>(algoPtr).roundingError();                       \
+  }
+
+// Convex piecewise-linear cost functions given by bulk arrays: pieceNums[i]
+// slopes and pieceNums[i] - 1 breakpoints for the i-th arc. Returns 0
+// without setting any function if one of them is invalid (see
+// validConvexCosts), 1 otherwise.
+#define CONVEX_COST(ALG, G, V, C, name)                                        \
+  int name##_setConvexCosts(void *algoPtr, int arcNum, void **arcs,           \
+                            int *pieceNums, V *breakpoints, C *slopes) {       \
+    auto &algo = deref<ALG<G, V, C>>(algoPtr);                                 \
+    if (!validConvexCosts(arcNum, pieceNums, breakpoints, slopes)) {           \
+      return 0;                                                                \
+    }                                                                          \
+    for (int i = 0; i < arcNum; i++) {                                         \
+      int k = pieceNums[i];                                                    \
+      algo.convexCost(deref<G::Arc>(arcs[i]), breakpoints,                     \
+                      breakpoints + (k - 1), slopes);                          \
+      breakpoints += k - 1;                                                    \
+      slopes += k;                                                             \
+    }                                                                          \
+    return 1;                                                                  \
+  }
+
+#define COST_CURVE(G, V, C, name)                                              \
+  int name##_runCostCurve(void *algoPtr, void *sPtr, void *tPtr,               \
+                          V maxFlow) {                                         \
+    typedef CapacityScaling<G, V, C> CAS;                                      \
+    auto &algo = deref<CAS>(algoPtr);                                          \
+    G::Node s = deref<G::Node>(sPtr), t = deref<G::Node>(tPtr);                \
+    return problemType<CAS>(maxFlow < 0 ? algo.runCostCurve(s, t)              \
+                                        : algo.runCostCurve(s, t, maxFlow));   \
+  }                                                                            \
+  int name##_curvePointNum(void *algoPtr) {                                    \
+    return deref<CapacityScaling<G, V, C>>(algoPtr).curvePointNum();           \
+  }                                                                            \
+  void name##_getCostCurve(void *algoPtr, V *flows, C *costs) {                \
+    auto &algo = deref<CapacityScaling<G, V, C>>(algoPtr);                     \
+    for (int i = 0; i < algo.curvePointNum(); i++) {                           \
+      flows[i] = algo.curveFlow(i);                                            \
+      costs[i] = algo.curveCost(i);                                            \
+    }                                                                          \
   }
 
 #define GRAPH(C, name)                                                         \
@@ -104,12 +323,33 @@ template <typename T> inline T &deref(void *ptr) { return *((T *)ptr); }
                 name##_NetworkSimplex_LONG_LONG)                               \
   MIN_COST_FLOW(NetworkSimplex, C, LONG, DOUBLE,                               \
                 name##_NetworkSimplex_LONG_DOUBLE)                             \
+  NETWORK_SIMPLEX(C, LONG, LONG, name##_NetworkSimplex_LONG_LONG)              \
+  NETWORK_SIMPLEX(C, LONG, DOUBLE, name##_NetworkSimplex_LONG_DOUBLE)          \
   MIN_COST_FLOW(CostScaling, C, LONG, LONG, name##_CostScaling_LONG_LONG)      \
   MIN_COST_FLOW(CostScaling, C, LONG, DOUBLE, name##_CostScaling_LONG_DOUBLE)  \
+  COST_SCALING(C, LONG, LONG, name##_CostScaling_LONG_LONG)                    \
+  CONVEX_COST(CostScaling, C, LONG, LONG, name##_CostScaling_LONG_LONG)        \
+  COST_SCALING(C, LONG, DOUBLE, name##_CostScaling_LONG_DOUBLE)                \
   MIN_COST_FLOW(CapacityScaling, C, LONG, LONG,                                \
                 name##_CapacityScaling_LONG_LONG)                              \
   MIN_COST_FLOW(CapacityScaling, C, LONG, DOUBLE,                              \
-                name##_CapacityScaling_LONG_DOUBLE)
+                name##_CapacityScaling_LONG_DOUBLE)                            \
+  CONVEX_COST(CapacityScaling, C, LONG, LONG,                                  \
+              name##_CapacityScaling_LONG_LONG)                                \
+  CONVEX_COST(CapacityScaling, C, LONG, DOUBLE,                                \
+              name##_CapacityScaling_LONG_DOUBLE)                              \
+  COST_CURVE(C, LONG, LONG, name##_CapacityScaling_LONG_LONG)                  \
+  COST_CURVE(C, LONG, DOUBLE, name##_CapacityScaling_LONG_DOUBLE)              \
+  MIN_COST_FLOW(CapacityScalingRadixHeap, C, LONG, LONG,                       \
+                name##_CapacityScalingRadixHeap_LONG_LONG)                     \
+  MIN_COST_FLOW(CostScalingRounded, C, LONG, DOUBLE,                           \
+                name##_CostScalingRounded_LONG_DOUBLE)                         \
+  COST_ROUNDING(C, CostScalingRounded, LONG, DOUBLE,                           \
+                name##_CostScalingRounded_LONG_DOUBLE)                         \
+  MIN_COST_FLOW(NetworkSimplexRounded, C, LONG, DOUBLE,                        \
+                name##_NetworkSimplexRounded_LONG_DOUBLE)                      \
+  COST_ROUNDING(C, NetworkSimplexRounded, LONG, DOUBLE,                        \
+                name##_NetworkSimplexRounded_LONG_DOUBLE)
 
 #define SG StaticDigraph
 #define PV std::vector<std::pair<int, int>>
@@ -156,22 +396,463 @@ template <typename T> inline T &deref(void *ptr) { return *((T *)ptr); }
     deref<ALG<SG, V, C>>(algoPtr).supplyMap(deref<SG::NodeMap<V>>(mapPtr));    \
   }                                                                            \
   int name##_run(void *algoPtr) {                                              \
-    auto type = deref<ALG<SG, V, C>>(algoPtr).run();                           \
-    switch (type) {                                                            \
-    case ALG<SG, V, C>::ProblemType::INFEASIBLE:                               \
-      return 0;                                                                \
-    case ALG<SG, V, C>::ProblemType::OPTIMAL:                                  \
-      return 1;                                                                \
-    case ALG<SG, V, C>::ProblemType::UNBOUNDED:                                \
-      return 2;                                                                \
-    }                                                                          \
+    return problemType<ALG<SG, V, C>>(deref<ALG<SG, V, C>>(algoPtr).run());    \
   }                                                                            \
   V name##_flow(void *algoPtr, int arcIdx) {                                   \
     return deref<ALG<SG, V, C>>(algoPtr).flow(SG::arc(arcIdx));                \
+  }                                                                            \
+  double name##_totalCost(void *algoPtr) {                                     \
+    return deref<ALG<SG, V, C>>(algoPtr).totalCost<double>();                  \
+  }
+
+// Convex cost functions of arcs given by indices (see CONVEX_COST)
+#define SG_CONVEX_COST(ALG, V, C, name)                                        \
+  int name##_setConvexCosts(void *algoPtr, int arcNum, int *arcIdxs,          \
+                            int *pieceNums, V *breakpoints, C *slopes) {       \
+    auto &algo = deref<ALG<SG, V, C>>(algoPtr);                                \
+    if (!validConvexCosts(arcNum, pieceNums, breakpoints, slopes)) {           \
+      return 0;                                                                \
+    }                                                                          \
+    for (int i = 0; i < arcNum; i++) {                                         \
+      int k = pieceNums[i];                                                    \
+      algo.convexCost(SG::arc(arcIdxs[i]), breakpoints,                        \
+                      breakpoints + (k - 1), slopes);                          \
+      breakpoints += k - 1;                                                    \
+      slopes += k;                                                             \
+    }                                                                          \
+    return 1;                                                                  \
+  }
+
+#define SG_CACHED_SOLVE(ALG, V, C, name)                                       \
+  int name##_solveCached(void *cachePtr, int nodeNum, int arcNum,              \
+                         int *sources, int *targets, V *lower, V *upper,       \
+                         C *cost, V *supply, V *flows, C *potentials) {        \
+    return solveCached<ALG<SG, V, C>>(cachePtr, #name, nodeNum, arcNum,        \
+                                      sources, targets, lower, upper, cost,    \
+                                      supply, flows, potentials);              \
+  }
+
+#define SG_CHECKED_SOLVE(ALG, V, C, name)                                      \
+  int name##_solveChecked(int nodeNum, int arcNum, int *sources,               \
+                          int *targets, V *lower, V *upper, C *cost,           \
+                          V *supply, V *flows, C *potentials, int *barrier) {  \
+    return solveChecked<ALG<SG, V, C>>(nodeNum, arcNum, sources, targets,      \
+                                       lower, upper, cost, supply, flows,      \
+                                       potentials, barrier);                   \
+  }
+
+// Scenarios of a ScenarioBatch (see solveScenarios). Warm start is only
+// used between consecutive scenarios with the same supply values. Returns
+// 0 without solving anything if warm start is requested for an algorithm
+// other than NetworkSimplex, 1 otherwise.
+#define SG_SCENARIO_BATCH(ALG, V, C, name)                                     \
+  int name##_solveScenarios(void *batchPtr, int scenarioNum, C *costs,         \
+                            V *supplies, int threadNum, int warmStart,         \
+                            int *results, V *flows, C *potentials) {           \
+    return solveScenarios<ALG<SG, V, C>>(                                      \
+               deref<ScenarioBatch<V>>(batchPtr), scenarioNum, costs,          \
+               supplies, threadNum, warmStart != 0, results, flows,            \
+               potentials)                                                     \
+               ? 1                                                             \
+               : 0;                                                            \
+  }
+
+// Max flow problem on a StaticDigraph given by bulk arrays, which can be
+// solved again after bulk capacity updates (warm started from the previous
+// flow). The flows and the source side of the minimum cut (1 for the nodes
+// on the source side) are copied into the given arrays unless they are
+// null. Returns the value of the maximum flow.
+#define SG_MAX_FLOW(V, name)                                                   \
+  void *name##_construct(int nodeNum, int arcNum, int *sources, int *targets,  \
+                         V *capacities, int source, int target) {              \
+    return new MaxFlowProblem<V>(nodeNum, arcNum, sources, targets,            \
+                                 capacities, source, target);                  \
+  }                                                                            \
+  void name##_destruct(void *ptr) { delete (MaxFlowProblem<V> *)ptr; }         \
+  void name##_setCapacities(void *ptr, int num, int *arcIdxs,                  \
+                            V *capacities) {                                   \
+    deref<MaxFlowProblem<V>>(ptr).setCapacities(num, arcIdxs, capacities);    \
+  }                                                                            \
+  void name##_setTerminals(void *ptr, int source, int target) {                \
+    deref<MaxFlowProblem<V>>(ptr).setTerminals(source, target);                \
+  }                                                                            \
+  V name##_solve(void *ptr, V *flows, int *cut) {                              \
+    auto &problem = deref<MaxFlowProblem<V>>(ptr);                             \
+    V value = problem.solve();                                                 \
+    if (flows != nullptr) {                                                    \
+      for (int i = 0; i < problem.graph().arcNum(); i++) {                     \
+        flows[i] = problem.flow(i);                                            \
+      }                                                                        \
+    }                                                                          \
+    if (cut != nullptr) {                                                      \
+      for (int i = 0; i < problem.graph().nodeNum(); i++) {                    \
+        cut[i] = problem.minCut(i) ? 1 : 0;                                    \
+      }                                                                        \
+    }                                                                          \
+    return value;                                                              \
+  }
+
+// Batch of max flow queries (source-target pairs) on a StaticDigraph given
+// by bulk arrays, which are answered in parallel by reusable per-thread
+// workspaces (see MaxFlowBatch). The flow values are copied into values,
+// and the source sides of the minimum cuts into cuts as bitsets of
+// (nodeNum + 31) / 32 ints per query unless it is null.
+#define SG_MAX_FLOW_BATCH(V, name)                                             \
+  void *name##_construct(int nodeNum, int arcNum, int *sources, int *targets,  \
+                         V *capacities) {                                      \
+    return new MaxFlowBatch<V>(nodeNum, arcNum, sources, targets,              \
+                               capacities);                                    \
+  }                                                                            \
+  void name##_destruct(void *ptr) { delete (MaxFlowBatch<V> *)ptr; }           \
+  void name##_solve(void *ptr, int queryNum, int *sources, int *targets,       \
+                    int threadNum, V *values, int *cuts) {                     \
+    deref<MaxFlowBatch<V>>(ptr).solve(queryNum, sources, targets, threadNum,   \
+                                      values, cuts);                           \
+  }
+
+// Minimum cost perfect matching of the rows and columns of a dense n x n
+// cost matrix given in row-major order. The column of each row is copied
+// into rowMates, and the row and column potentials into rowPotentials and
+// colPotentials unless they are null. Returns the total cost.
+#define JONKER_VOLGENANT(C, name)                                              \
+  C name##_solve(int n, C *costs, int *rowMates, C *rowPotentials,             \
+                 C *colPotentials) {                                           \
+    JonkerVolgenant<C> jv(n, costs);                                           \
+    jv.run();                                                                  \
+    for (int i = 0; i < n; i++) {                                              \
+      rowMates[i] = jv.rowMate(i);                                             \
+      if (rowPotentials != nullptr) rowPotentials[i] = jv.rowPotential(i);     \
+      if (colPotentials != nullptr) colPotentials[i] = jv.colPotential(i);     \
+    }                                                                          \
+    return jv.totalCost();                                                     \
   }
 
 using namespace lemon;
 
+// CapacityScaling variant using a monotone integer heap in the Dijkstra
+// searches (only meaningful for integer costs). RadixHeap takes the cost
+// type as its priority type, so the full LONG cost range is supported.
+// BucketHeap is not exported: its priorities are int and it allocates a
+// bucket for each distance value, which fails for large costs.
+template <typename G, typename V, typename C>
+using CapacityScalingRadixHeap = typename CapacityScaling<G, V, C>::template
+    SetHeap<RadixHeap<RangeMap<int>, C>>::Create;
+
+// Variants for real-valued costs, which scale and round the costs to
+// integers within a tolerance and run the integer algorithms (the native
+// double cost versions are intended for integral costs only)
+template <typename G, typename V, typename C>
+using CostScalingRounded = CostRounding<G, CostScaling<G, V, LONG>, C>;
+
+template <typename G, typename V, typename C>
+using NetworkSimplexRounded = CostRounding<G, NetworkSimplex<G, V, LONG>, C>;
+
+// Run a min cost flow algorithm on a StaticDigraph built from bulk arrays
+// (see buildStaticDigraph) and store its result. The lower and upper
+// bounds can be null (zero and infinite bounds).
+template <typename ALG, typename V, typename C>
+void solveGraph(const SG &graph, V *lower, V *upper, C *cost, V *supply,
+                SolutionCache::Result &result) {
+  int nodeNum = graph.nodeNum(), arcNum = graph.arcNum();
+  SG::ArcMap<V> lowerMap(graph), upperMap(graph);
+  SG::ArcMap<C> costMap(graph);
+  SG::NodeMap<V> supplyMap(graph);
+  for (int i = 0; i < arcNum; i++) {
+    if (lower != nullptr) lowerMap[SG::arc(i)] = lower[i];
+    if (upper != nullptr) upperMap[SG::arc(i)] = upper[i];
+    costMap[SG::arc(i)] = cost[i];
+  }
+  for (int i = 0; i < nodeNum; i++) {
+    supplyMap[SG::node(i)] = supply[i];
+  }
+
+  ALG algo(graph);
+  algo.costMap(costMap).supplyMap(supplyMap);
+  if (lower != nullptr) algo.lowerMap(lowerMap);
+  if (upper != nullptr) algo.upperMap(upperMap);
+  result.problemType = problemType<ALG>(algo.run());
+  result.flows.resize(sizeof(V) * arcNum);
+  result.potentials.resize(sizeof(C) * nodeNum);
+  V *f = (V *)result.flows.data();
+  C *pi = (C *)result.potentials.data();
+  for (int i = 0; i < arcNum; i++) {
+    f[i] = algo.flow(SG::arc(i));
+  }
+  for (int i = 0; i < nodeNum; i++) {
+    pi[i] = algo.potential(SG::node(i));
+  }
+}
+
+// Copy the flows and the potentials of a result into the given arrays
+// unless they are null, and return its problem type
+template <typename V, typename C>
+int copyResult(const SolutionCache::Result &result, V *flows,
+               C *potentials) {
+  if (flows != nullptr) {
+    std::memcpy(flows, result.flows.data(), result.flows.size());
+  }
+  if (potentials != nullptr) {
+    std::memcpy(potentials, result.potentials.data(),
+                result.potentials.size());
+  }
+  return result.problemType;
+}
+
+// Run a min cost flow algorithm on a StaticDigraph given by bulk arrays
+// (see solveGraph). If a cache is given, then the result of an identical
+// problem is returned from the cache without running the algorithm.
+template <typename ALG, typename V, typename C>
+int solveCached(void *cachePtr, const char *solver, int nodeNum, int arcNum,
+                int *sources, int *targets, V *lower, V *upper, C *cost,
+                V *supply, V *flows, C *potentials) {
+  ProblemKey key(solver);
+  key.add(nodeNum);
+  key.add(arcNum);
+  key.add(sources, arcNum);
+  key.add(targets, arcNum);
+  key.add(lower, arcNum);
+  key.add(upper, arcNum);
+  key.add(cost, arcNum);
+  key.add(supply, nodeNum);
+
+  SolutionCache *cache = (SolutionCache *)cachePtr;
+  SolutionCache::Result result;
+  if (cache == nullptr || !cache->find(key.bytes(), result)) {
+    SG graph;
+    buildStaticDigraph(graph, nodeNum, arcNum, sources, targets);
+    solveGraph<ALG>(graph, lower, upper, cost, supply, result);
+    if (cache != nullptr) cache->insert(key.bytes(), result);
+  }
+  return copyResult(result, flows, potentials);
+}
+
+// The O(n + m) part of checkFeasibility(): the total supply must not be
+// positive and the lower bounds must not exceed the upper bounds
+template <typename V>
+bool checkBounds(int nodeNum, int arcNum, V *lower, V *upper, V *supply,
+                 int *barrier) {
+  if (barrier != nullptr) std::fill(barrier, barrier + nodeNum, 0);
+
+  // The whole node set is a barrier if the total supply is positive
+  V sum = 0;
+  for (int i = 0; i < nodeNum; i++) {
+    sum += supply[i];
+  }
+  if (sum > 0) {
+    if (barrier != nullptr) std::fill(barrier, barrier + nodeNum, 1);
+    return false;
+  }
+  // A null lower bound array means zero lower bounds
+  if (upper != nullptr) {
+    for (int i = 0; i < arcNum; i++) {
+      if ((lower != nullptr ? lower[i] : 0) > upper[i]) return false;
+    }
+  }
+  return true;
+}
+
+// The Circulation part of checkFeasibility() on an already built graph
+template <typename V>
+bool findCirculation(const SG &graph, V *lower, V *upper, V *supply,
+                     int *barrier) {
+  int nodeNum = graph.nodeNum(), arcNum = graph.arcNum();
+  SG::ArcMap<V> lowerMap(graph, 0);
+  SG::ArcMap<V> upperMap(graph, std::numeric_limits<V>::max());
+  SG::NodeMap<V> supplyMap(graph);
+  for (int i = 0; i < arcNum; i++) {
+    if (lower != nullptr) lowerMap[SG::arc(i)] = lower[i];
+    if (upper != nullptr) upperMap[SG::arc(i)] = upper[i];
+  }
+  for (int i = 0; i < nodeNum; i++) {
+    supplyMap[SG::node(i)] = supply[i];
+  }
+
+  Circulation<SG, SG::ArcMap<V>, SG::ArcMap<V>, SG::NodeMap<V>> circ(
+      graph, lowerMap, upperMap, supplyMap);
+  if (circ.run()) return true;
+  if (barrier != nullptr) {
+    for (int i = 0; i < nodeNum; i++) {
+      barrier[i] = circ.barrier(SG::node(i)) ? 1 : 0;
+    }
+  }
+  return false;
+}
+
+// Check whether a min cost flow problem given by bulk arrays (like for
+// solveCached) has a feasible solution, without solving it. The supply
+// balance and the arc bounds are checked in O(n + m) time, then a feasible
+// circulation is searched with Circulation, which is much cheaper than a
+// full solve. Returns 1 if the problem is feasible and 0 otherwise. If the
+// barrier array is not null, it is set to the characteristic vector of a
+// violated cut: a node set B for which the total supply of B exceeds the
+// capacity of the arcs leaving B minus the lower bounds of the arcs
+// entering B. (It is empty if the problem is infeasible only because an
+// arc has a lower bound greater than its upper bound.)
+template <typename V>
+int checkFeasibility(int nodeNum, int arcNum, int *sources, int *targets,
+                     V *lower, V *upper, V *supply, int *barrier) {
+  if (!checkBounds(nodeNum, arcNum, lower, upper, supply, barrier)) {
+    return 0;
+  }
+  SG graph;
+  buildStaticDigraph(graph, nodeNum, arcNum, sources, targets);
+  return findCirculation(graph, lower, upper, supply, barrier) ? 1 : 0;
+}
+
+// Run checkFeasibility() and then solve the problem if it is feasible
+// (returns INFEASIBLE otherwise). The graph is built only once, for both
+// Circulation and the min cost flow algorithm.
+template <typename ALG, typename V, typename C>
+int solveChecked(int nodeNum, int arcNum, int *sources, int *targets,
+                 V *lower, V *upper, C *cost, V *supply, V *flows,
+                 C *potentials, int *barrier) {
+  if (!checkBounds(nodeNum, arcNum, lower, upper, supply, barrier)) {
+    return 0;
+  }
+  SG graph;
+  buildStaticDigraph(graph, nodeNum, arcNum, sources, targets);
+  if (!findCirculation(graph, lower, upper, supply, barrier)) return 0;
+  SolutionCache::Result result;
+  solveGraph<ALG>(graph, lower, upper, cost, supply, result);
+  return copyResult(result, flows, potentials);
+}
+
+// Run an algorithm starting from the solution of a similar problem. Only
+// NetworkSimplex supports it (crossover from the flow and the potentials,
+// the flow must be feasible for the current supplies), CostScaling and
+// CapacityScaling cannot start from given potentials.
+template <typename ALG> struct WarmStart {
+  static const bool supported = false;
+  template <typename FM, typename PM>
+  static typename ALG::ProblemType run(ALG &algo, const FM &, const PM &) {
+    return algo.run();
+  }
+};
+
+template <typename G, typename V, typename C>
+struct WarmStart<NetworkSimplex<G, V, C>> {
+  static const bool supported = true;
+  template <typename FM, typename PM>
+  static typename NetworkSimplex<G, V, C>::ProblemType
+  run(NetworkSimplex<G, V, C> &algo, const FM &flow, const PM &pot) {
+    return algo.run(flow, pot);
+  }
+};
+
+// Solve the scenarios of a batch in parallel. The costs and the supply
+// values of the scenarios are given as consecutive blocks of the bulk
+// arrays, and so are the flows and the potentials (unless they are null).
+// Each thread solves a contiguous range of scenarios using a single
+// algorithm instance, so consecutive scenarios should be similar: if
+// warm start is enabled, a scenario is started from the solution of the
+// previous one in the same range, provided that they have the same supply
+// values (only the costs differ). The previous flow is not feasible for
+// other supply values, so these scenarios are solved from scratch.
+// Returns false without solving anything if warm start is enabled but not
+// supported by the algorithm (see WarmStart).
+template <typename ALG, typename V, typename C>
+bool solveScenarios(const ScenarioBatch<V> &batch, int scenarioNum,
+                    const C *costs, const V *supplies, int threadNum,
+                    bool warm, int *results, V *flows, C *potentials) {
+  if (warm && !WarmStart<ALG>::supported) return false;
+  const SG &graph = batch.graph();
+  int nodeNum = batch.nodeNum(), arcNum = batch.arcNum();
+  if (threadNum <= 0) threadNum = bits::hardwareThreadNum();
+  bits::ThreadPool pool(std::max(std::min(threadNum, scenarioNum), 1));
+  pool.run([&](int id) {
+    int first = (long long)scenarioNum * id / pool.size();
+    int last = (long long)scenarioNum * (id + 1) / pool.size();
+    if (first == last) return;
+
+    SG::ArcMap<V> flowMap(graph);
+    SG::ArcMap<C> costMap(graph);
+    SG::NodeMap<V> supplyMap(graph);
+    SG::NodeMap<C> potMap(graph);
+    ALG algo(graph);
+    if (batch.hasLower()) algo.lowerMap(batch.lowerMap());
+    if (batch.hasUpper()) algo.upperMap(batch.upperMap());
+
+    // Supply values of the last scenario solved to optimality (null if
+    // there is none)
+    const V *solvedSupply = nullptr;
+    for (int s = first; s < last; s++) {
+      const C *cost = costs + (long long)s * arcNum;
+      const V *supply = supplies + (long long)s * nodeNum;
+      for (int i = 0; i < arcNum; i++) {
+        costMap[SG::arc(i)] = cost[i];
+      }
+      for (int i = 0; i < nodeNum; i++) {
+        supplyMap[SG::node(i)] = supply[i];
+      }
+      algo.costMap(costMap).supplyMap(supplyMap);
+      bool restart = warm && solvedSupply != nullptr &&
+                     std::equal(supply, supply + nodeNum, solvedSupply);
+      typename ALG::ProblemType type =
+          restart ? WarmStart<ALG>::run(algo, flowMap, potMap) : algo.run();
+      results[s] = problemType<ALG>(type);
+      if (type == ALG::OPTIMAL) {
+        solvedSupply = supply;
+        if (warm) {
+          algo.flowMap(flowMap);
+          algo.potentialMap(potMap);
+        }
+      } else {
+        solvedSupply = nullptr;
+      }
+
+      if (flows != nullptr) {
+        V *flow = flows + (long long)s * arcNum;
+        for (int i = 0; i < arcNum; i++) {
+          flow[i] = algo.flow(SG::arc(i));
+        }
+      }
+      if (potentials != nullptr) {
+        C *pot = potentials + (long long)s * nodeNum;
+        for (int i = 0; i < nodeNum; i++) {
+          pot[i] = algo.potential(SG::node(i));
+        }
+      }
+    }
+  });
+  return true;
+}
+
+// Solve a dense transportation problem with the given cost functor. The
+// positive flows are copied into the rows, cols and flows arrays (of size
+// at least supplierNum + consumerNum - 1) and their number into flowNum,
+// the potentials of the suppliers and then the consumers are copied into
+// the potentials array unless it is null.
+template <typename V, typename C, typename CF>
+int solveTransportation(int supplierNum, int consumerNum, const V *supply,
+                        const V *demand, const CF &cost, int initMethod,
+                        int *flowNum, int *rows, int *cols, V *flows,
+                        C *potentials) {
+  typedef TransportationSimplex<V, C> TS;
+  TS algo(supplierNum, consumerNum);
+  algo.supplyMap(supply).demandMap(demand);
+  typename TS::ProblemType type =
+      algo.run(cost, initMethod == 0 ? TS::NORTH_WEST_CORNER : TS::VOGEL);
+  int result = problemType<TS>(type);
+  *flowNum = 0;
+  if (type != TS::OPTIMAL) return result;
+
+  *flowNum = algo.flowNum();
+  for (int k = 0; k < algo.flowNum(); k++) {
+    rows[k] = algo.flowSupplier(k);
+    cols[k] = algo.flowConsumer(k);
+    flows[k] = algo.flowValue(k);
+  }
+  if (potentials != nullptr) {
+    for (int i = 0; i < supplierNum; i++) {
+      potentials[i] = algo.supplierPotential(i);
+    }
+    for (int j = 0; j < consumerNum; j++) {
+      potentials[supplierNum + j] = algo.consumerPotential(j);
+    }
+  }
+  return result;
+}
+
 extern "C" {
 
 void deleteObject(void *ptr) { free(ptr); }
@@ -209,10 +890,149 @@ void SG_build(void *graphPtr, int nodeCount, void *arcsPtr) {
   deref<SG>(graphPtr).build(nodeCount, arcs.begin(), arcs.end());
 }
 
+// Feasibility pre-check of a min cost flow problem (see checkFeasibility)
+int SG_Circulation_LONG_checkFeasibility(int nodeNum, int arcNum,
+                                         int *sources, int *targets,
+                                         LONG *lower, LONG *upper,
+                                         LONG *supply, int *barrier) {
+  return checkFeasibility(nodeNum, arcNum, sources, targets, lower, upper,
+                          supply, barrier);
+}
+
+void *ScenarioBatch_construct(int nodeNum, int arcNum, int *sources,
+                              int *targets, LONG *lower, LONG *upper) {
+  return new ScenarioBatch<LONG>(nodeNum, arcNum, sources, targets, lower,
+                                 upper);
+}
+
+void ScenarioBatch_destruct(void *ptr) { delete (ScenarioBatch<LONG> *)ptr; }
+
+// A negative limit is treated as 0, i.e. no result is stored
+void *SolutionCache_construct(LONG maxBytes) {
+  return new SolutionCache(maxBytes > 0 ? (size_t)maxBytes : 0);
+}
+
+void SolutionCache_destruct(void *ptr) { delete (SolutionCache *)ptr; }
+
+void SolutionCache_clear(void *ptr) { deref<SolutionCache>(ptr).clear(); }
+
+LONG SolutionCache_hits(void *ptr) { return deref<SolutionCache>(ptr).hits(); }
+
+LONG SolutionCache_misses(void *ptr) {
+  return deref<SolutionCache>(ptr).misses();
+}
+
+int SolutionCache_size(void *ptr) { return deref<SolutionCache>(ptr).size(); }
+
+LONG SolutionCache_bytes(void *ptr) {
+  return deref<SolutionCache>(ptr).bytes();
+}
+
 SG_NODE_MAP(LONG, SG_NodeMap_LONG);
 SG_ARC_MAP(LONG, SG_ArcMap_LONG);
 SG_ARC_MAP(DOUBLE, SG_ArcMap_DOUBLE);
 
 SG_MIN_COST_FLOW(CostScaling, LONG, DOUBLE, SG_CostScaling_LONG_DOUBLE)
 SG_MIN_COST_FLOW(CostScaling, LONG, LONG, SG_CostScaling_LONG_LONG)
+COST_SCALING(SG, LONG, DOUBLE, SG_CostScaling_LONG_DOUBLE)
+COST_SCALING(SG, LONG, LONG, SG_CostScaling_LONG_LONG)
+SG_CONVEX_COST(CostScaling, LONG, LONG, SG_CostScaling_LONG_LONG)
+SG_MIN_COST_FLOW(CostScalingRounded, LONG, DOUBLE,
+                 SG_CostScalingRounded_LONG_DOUBLE)
+COST_ROUNDING(SG, CostScalingRounded, LONG, DOUBLE,
+              SG_CostScalingRounded_LONG_DOUBLE)
+SG_CACHED_SOLVE(NetworkSimplex, LONG, LONG, SG_NetworkSimplex_LONG_LONG)
+SG_CACHED_SOLVE(CostScaling, LONG, LONG, SG_CostScaling_LONG_LONG)
+SG_CACHED_SOLVE(CapacityScaling, LONG, LONG, SG_CapacityScaling_LONG_LONG)
+SG_CHECKED_SOLVE(NetworkSimplex, LONG, LONG, SG_NetworkSimplex_LONG_LONG)
+SG_CHECKED_SOLVE(CostScaling, LONG, LONG, SG_CostScaling_LONG_LONG)
+SG_CHECKED_SOLVE(CapacityScaling, LONG, LONG, SG_CapacityScaling_LONG_LONG)
+SG_SCENARIO_BATCH(NetworkSimplex, LONG, LONG, SG_NetworkSimplex_LONG_LONG)
+SG_SCENARIO_BATCH(CostScaling, LONG, LONG, SG_CostScaling_LONG_LONG)
+SG_SCENARIO_BATCH(CapacityScaling, LONG, LONG, SG_CapacityScaling_LONG_LONG)
+
+SG_MAX_FLOW(LONG, SG_Preflow_LONG)
+SG_MAX_FLOW_BATCH(LONG, SG_PreflowBatch_LONG)
+
+// Dense transportation problem given by a row-major cost matrix
+// (initMethod: 0 north-west corner rule, 1 Vogel's approximation method)
+int TransportationSimplex_LONG_LONG_solve(int supplierNum, int consumerNum,
+                                          LONG *supply, LONG *demand,
+                                          LONG *costs, int initMethod,
+                                          int *flowNum, int *rows, int *cols,
+                                          LONG *flows, LONG *potentials) {
+  auto cost = [=](int i, int j) {
+    return costs[(long long)i * consumerNum + j];
+  };
+  return solveTransportation<LONG, LONG>(supplierNum, consumerNum, supply,
+                                         demand, cost, initMethod, flowNum,
+                                         rows, cols, flows, potentials);
+}
+
+// Dense transportation problem with costs given by a callback, which is
+// called several times for each supplier-consumer pair
+int TransportationSimplex_LONG_LONG_solveCallback(
+    int supplierNum, int consumerNum, LONG *supply, LONG *demand,
+    LONG (*costFunc)(int, int, void *), void *data, int initMethod,
+    int *flowNum, int *rows, int *cols, LONG *flows, LONG *potentials) {
+  auto cost = [=](int i, int j) { return costFunc(i, j, data); };
+  return solveTransportation<LONG, LONG>(supplierNum, consumerNum, supply,
+                                         demand, cost, initMethod, flowNum,
+                                         rows, cols, flows, potentials);
+}
+
+// Minimum cost perfect matching of n persons and n objects given in CSR
+// form (the arcs of person i are first[i]..first[i+1]-1) using the parallel
+// auction algorithm (threadNum: non-positive for all hardware threads).
+// Returns 1 and copies the arc of each person into mateArcs if a perfect
+// matching exists, returns 0 otherwise.
+int AuctionAssignment_LONG_solve(int n, int *first, int *targets,
+                                 LONG *costs, int threadNum, int *mateArcs,
+                                 LONG *totalCost) {
+  CsrAuctionAssignment<LONG> alg(n, first, targets, costs);
+  alg.threadNum(threadNum);
+  if (!alg.run()) return 0;
+  for (int i = 0; i < n; i++) {
+    mateArcs[i] = alg.mateArc(i);
+  }
+  if (totalCost != nullptr) *totalCost = alg.totalCost();
+  return 1;
+}
+
+JONKER_VOLGENANT(LONG, JonkerVolgenant_LONG)
+JONKER_VOLGENANT(DOUBLE, JonkerVolgenant_DOUBLE)
+
+// Earth mover's distance of two weighted point sets given by row-major
+// coordinate arrays (groundDistance: 0 Euclidean, 1 Manhattan). The ground
+// distances are multiplied by the scale and rounded to integers, and they
+// are thresholded if the threshold is positive. The positive flows are
+// copied into the sources, targets and flows arrays (of size at least
+// sourceNum + targetNum) unless they are null, and the rounded total cost
+// into totalCost unless it is null.
+DOUBLE EMD_LONG_LONG_solve(int dim, int sourceNum, DOUBLE *sourceCoords,
+                           LONG *sourceWeights, int targetNum,
+                           DOUBLE *targetCoords, LONG *targetWeights,
+                           int groundDistance, DOUBLE scale,
+                           DOUBLE threshold, int *flowNum, int *sources,
+                           int *targets, LONG *flows, LONG *totalCost) {
+  typedef EarthMoversDistance<LONG, LONG> EMD;
+  EMD emd(dim);
+  emd.sourcePoints(sourceNum, sourceCoords, sourceWeights)
+      .targetPoints(targetNum, targetCoords, targetWeights)
+      .groundDistance(groundDistance == 0 ? EMD::EUCLIDEAN : EMD::MANHATTAN)
+      .scale(scale);
+  if (threshold > 0) emd.threshold(threshold);
+  emd.run();
+
+  if (flowNum != nullptr) *flowNum = emd.flowNum();
+  if (flows != nullptr) {
+    for (int k = 0; k < emd.flowNum(); k++) {
+      sources[k] = emd.flowSource(k);
+      targets[k] = emd.flowTarget(k);
+      flows[k] = emd.flowValue(k);
+    }
+  }
+  if (totalCost != nullptr) *totalCost = emd.totalCost();
+  return emd.distance();
+}
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "lemon/bits/thread_pool.h"
+#include "lemon/preflow.h"
+#include "lemon/static_graph.h"
+
+#include "build.h"
+
+// Many max flow queries (source-target pairs) on a static digraph with
+// fixed capacities. The graph and the capacities are shared by the
+// threads, each thread answers its queries with its own Preflow instance.
+// These workspaces are kept between the queries and the solve() calls, so
+// their maps are allocated only once and a query resets only the entries
+// touched by the previous one (see Preflow::init()).
+template <typename V> class MaxFlowBatch {
+public:
+  typedef lemon::StaticDigraph Graph;
+  typedef Graph::ArcMap<V> ValueMap;
+  typedef lemon::Preflow<Graph, ValueMap> Algorithm;
+
+  // The arcs must be sorted by their sources (see buildStaticDigraph)
+  MaxFlowBatch(int nodeNum, int arcNum, const int *sources,
+               const int *targets, const V *capacities) {
+    buildStaticDigraph(_graph, nodeNum, arcNum, sources, targets);
+    _capacity.reset(new ValueMap(_graph));
+    for (int i = 0; i < arcNum; i++) {
+      (*_capacity)[Graph::arc(i)] = capacities[i];
+    }
+  }
+
+  const Graph &graph() const { return _graph; }
+
+  // Number of ints used by the cut of a query
+  int cutWords() const { return (_graph.nodeNum() + 31) / 32; }
+
+  // Compute the maximum flow values of the given queries in parallel (the
+  // source and the target of a query must differ). If cuts is not null,
+  // the source side of the minimum cut of each query is stored as a bitset
+  // of cutWords() ints: bit i % 32 of word i / 32 is set for the nodes i
+  // on the source side.
+  void solve(int queryNum, const int *sources, const int *targets,
+             int threadNum, V *values, int *cuts) {
+    if (threadNum <= 0) threadNum = lemon::bits::hardwareThreadNum();
+    lemon::bits::ThreadPool pool(std::max(std::min(threadNum, queryNum), 1));
+    while ((int)_algos.size() < pool.size()) {
+      _algos.emplace_back(new Algorithm(_graph, *_capacity, lemon::INVALID,
+                                        lemon::INVALID));
+    }
+    int nodeNum = _graph.nodeNum(), words = cutWords();
+    std::atomic<int> next(0);
+    pool.run([&](int id) {
+      Algorithm &algo = *_algos[id];
+      for (int q = next++; q < queryNum; q = next++) {
+        algo.source(Graph::node(sources[q]))
+            .target(Graph::node(targets[q]));
+        algo.init();
+        algo.startFirstPhase();
+        values[q] = algo.flowValue();
+        if (cuts != nullptr) {
+          int *cut = cuts + (long long)q * words;
+          std::fill(cut, cut + words, 0);
+          for (int i = 0; i < nodeNum; i++) {
+            if (algo.minCut(Graph::node(i))) {
+              cut[i >> 5] |= (int)(1u << (i & 31));
+            }
+          }
+        }
+      }
+    });
+  }
+
+private:
+  Graph _graph;
+  std::unique_ptr<ValueMap> _capacity;
+  std::vector<std::unique_ptr<Algorithm>> _algos;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+
+#include "lemon/preflow.h"
+#include "lemon/static_graph.h"
+
+#include "build.h"
+
+// A max flow problem on a static digraph whose capacities (and terminals)
+// may change between the solutions. Only the first solution starts from
+// scratch, the later ones repair the flow of the previous solution for
+// the changed capacities and continue the push-relabel algorithm from it
+// (see Preflow::reinit()).
+template <typename V> class MaxFlowProblem {
+public:
+  typedef lemon::StaticDigraph Graph;
+  typedef Graph::ArcMap<V> ValueMap;
+  typedef lemon::Preflow<Graph, ValueMap> Algorithm;
+
+  // The arcs must be sorted by their sources (see buildStaticDigraph)
+  MaxFlowProblem(int nodeNum, int arcNum, const int *sources,
+                 const int *targets, const V *capacities, int source,
+                 int target)
+      : _solved(false) {
+    buildStaticDigraph(_graph, nodeNum, arcNum, sources, targets);
+    _capacity.reset(new ValueMap(_graph));
+    _flow.reset(new ValueMap(_graph));
+    for (int i = 0; i < arcNum; i++) {
+      (*_capacity)[Graph::arc(i)] = capacities[i];
+    }
+    _algo.reset(new Algorithm(_graph, *_capacity, Graph::node(source),
+                              Graph::node(target)));
+    _algo->flowMap(*_flow);
+  }
+
+  const Graph &graph() const { return _graph; }
+
+  // Change the capacities of the given arcs, or of all arcs if arcIdxs is
+  // null
+  void setCapacities(int num, const int *arcIdxs, const V *capacities) {
+    for (int i = 0; i < num; i++) {
+      int arc = arcIdxs != nullptr ? arcIdxs[i] : i;
+      (*_capacity)[Graph::arc(arc)] = capacities[i];
+    }
+  }
+
+  void setTerminals(int source, int target) {
+    _algo->source(Graph::node(source)).target(Graph::node(target));
+  }
+
+  // Compute a maximum flow and return its value
+  V solve() {
+    if (_solved) {
+      _algo->rerun();
+    } else {
+      _algo->run();
+      _solved = true;
+    }
+    return _algo->flowValue();
+  }
+
+  V flow(int arcIdx) const { return (*_flow)[Graph::arc(arcIdx)]; }
+
+  bool minCut(int nodeIdx) const {
+    return _algo->minCut(Graph::node(nodeIdx));
+  }
+
+private:
+  Graph _graph;
+  std::unique_ptr<ValueMap> _capacity;
+  std::unique_ptr<ValueMap> _flow;
+  std::unique_ptr<Algorithm> _algo;
+  bool _solved;
+};
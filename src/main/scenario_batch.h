@@ -0,0 +1,47 @@
+#pragma once
+
+#include "lemon/static_graph.h"
+
+#include "build.h"
+
+// Topology and arc bounds shared by a batch of min cost flow scenarios,
+// which differ only in their costs and supply values. The graph and the
+// bound maps are built once and only read by the solvers, so they are not
+// copied for each scenario or thread. Note that the solver internals are
+// not shared: each thread's solver builds its own topology arrays once
+// (in its constructor) and copies the bounds, costs and supplies into its
+// own arrays on every run.
+template <typename V> class ScenarioBatch {
+public:
+  typedef lemon::StaticDigraph Graph;
+  typedef Graph::ArcMap<V> BoundMap;
+
+  // The arcs must be sorted by their sources (see buildStaticDigraph), the
+  // lower and upper bounds can be null (zero and infinite bounds)
+  ScenarioBatch(int nodeNum, int arcNum, const int *sources,
+                const int *targets, const V *lower, const V *upper)
+      : _hasLower(lower != nullptr), _hasUpper(upper != nullptr),
+        _lower(_graph), _upper(_graph) {
+    buildStaticDigraph(_graph, nodeNum, arcNum, sources, targets);
+    for (int i = 0; i < arcNum; i++) {
+      if (_hasLower) _lower[Graph::arc(i)] = lower[i];
+      if (_hasUpper) _upper[Graph::arc(i)] = upper[i];
+    }
+  }
+
+  const Graph &graph() const { return _graph; }
+  int nodeNum() const { return _graph.nodeNum(); }
+  int arcNum() const { return _graph.arcNum(); }
+
+  bool hasLower() const { return _hasLower; }
+  bool hasUpper() const { return _hasUpper; }
+  const BoundMap &lowerMap() const { return _lower; }
+  const BoundMap &upperMap() const { return _upper; }
+
+private:
+  Graph _graph;
+  bool _hasLower;
+  bool _hasUpper;
+  BoundMap _lower;
+  BoundMap _upper;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 64-bit xxHash (XXH64) of a byte array
+inline uint64_t xxHash64(const char *data, size_t len, uint64_t seed = 0) {
+  const uint64_t P1 = 11400714785074694791ULL;
+  const uint64_t P2 = 14029467366897019727ULL;
+  const uint64_t P3 = 1609587929392839161ULL;
+  const uint64_t P4 = 9650029242287828579ULL;
+  const uint64_t P5 = 2870177450012600261ULL;
+  auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+  auto read64 = [](const char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+  };
+  auto round = [&](uint64_t acc, uint64_t input) {
+    return rotl(acc + input * P2, 31) * P1;
+  };
+
+  const char *p = data, *end = data + len;
+  uint64_t h;
+  if (len >= 32) {
+    uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = round(v1, read64(p));
+      v2 = round(v2, read64(p + 8));
+      v3 = round(v3, read64(p + 16));
+      v4 = round(v4, read64(p + 24));
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    for (uint64_t v : {v1, v2, v3, v4}) {
+      h = (h ^ round(0, v)) * P1 + P4;
+    }
+  } else {
+    h = seed + P5;
+  }
+  h += len;
+  for (; p + 8 <= end; p += 8) {
+    h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+  }
+  if (p + 4 <= end) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    h = rotl(h ^ (v * P1), 23) * P2 + P3;
+    p += 4;
+  }
+  for (; p < end; p++) {
+    h = rotl(h ^ (static_cast<unsigned char>(*p) * P5), 11) * P1;
+  }
+  h ^= h >> 33;
+  h *= P2;
+  h ^= h >> 29;
+  h *= P3;
+  h ^= h >> 32;
+  return h;
+}
+
+// Serialized form of a min cost flow problem (the solver name, the graph,
+// the maps and the parameters), which is used as the key of the cache
+class ProblemKey {
+public:
+  explicit ProblemKey(const char *solver) {
+    addBytes(solver, std::strlen(solver) + 1);
+  }
+
+  template <typename T> void add(T value) { addBytes(&value, sizeof value); }
+
+  // Add an array (a null pointer is distinguished from any array)
+  template <typename T> void add(const T *data, int size) {
+    add(data != nullptr);
+    if (data != nullptr) addBytes(data, sizeof(T) * size);
+  }
+
+  const std::string &bytes() const { return _bytes; }
+
+private:
+  void addBytes(const void *data, size_t len) {
+    _bytes.append((const char *)data, len);
+  }
+
+  std::string _bytes;
+};
+
+// LRU cache of min cost flow results with a memory limit. The hash of the
+// key is only used for indexing, the keys are compared byte by byte, so a
+// hash collision cannot return a wrong result. All functions are thread
+// safe, the solvers are run outside of the lock.
+class SolutionCache {
+public:
+  struct Result {
+    int problemType;
+    std::vector<char> flows;
+    std::vector<char> potentials;
+  };
+
+  explicit SolutionCache(size_t maxBytes)
+      : _maxBytes(maxBytes), _bytes(0), _hits(0), _misses(0) {}
+
+  // Find a result and mark it as the most recently used one
+  bool find(const std::string &key, Result &result) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = lookup(key, xxHash64(key.data(), key.size()));
+    if (it == _entries.end()) {
+      _misses++;
+      return false;
+    }
+    _entries.splice(_entries.begin(), _entries, it);
+    result = it->result;
+    _hits++;
+    return true;
+  }
+
+  // Insert a result and evict the least recently used ones if the memory
+  // limit is exceeded (results larger than the limit are not stored)
+  void insert(const std::string &key, const Result &result) {
+    size_t bytes = sizeof(Entry) + key.size() + result.flows.size() +
+                   result.potentials.size();
+    if (bytes > _maxBytes) return;
+    uint64_t hash = xxHash64(key.data(), key.size());
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = lookup(key, hash);
+    if (it != _entries.end()) erase(it);
+    while (_bytes + bytes > _maxBytes) erase(std::prev(_entries.end()));
+    _entries.push_front(Entry{key, hash, result, bytes});
+    _index.emplace(hash, _entries.begin());
+    _bytes += bytes;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+  }
+
+  long long hits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+  }
+  long long misses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+  }
+  int size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_entries.size();
+  }
+  size_t bytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+  }
+
+private:
+  struct Entry {
+    std::string key;
+    uint64_t hash;
+    Result result;
+    size_t bytes;
+  };
+  typedef std::list<Entry> EntryList;
+
+  EntryList::iterator lookup(const std::string &key, uint64_t hash) {
+    auto range = _index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second->key == key) return it->second;
+    }
+    return _entries.end();
+  }
+
+  void erase(EntryList::iterator entry) {
+    auto range = _index.equal_range(entry->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == entry) {
+        _index.erase(it);
+        break;
+      }
+    }
+    _bytes -= entry->bytes;
+    _entries.erase(entry);
+  }
+
+  size_t _maxBytes;
+  size_t _bytes;
+  long long _hits;
+  long long _misses;
+  EntryList _entries; // the most recently used one first
+  std::unordered_multimap<uint64_t, EntryList::iterator> _index;
+  mutable std::mutex _mutex;
+};
@@ -159,7 +159,32 @@ void SG_CostScaling_LONG_DOUBLE_setUpperMap(void *algoPtr, void *mapPtr);
 void SG_CostScaling_LONG_DOUBLE_setSupplyMap(void *algoPtr, void *mapPtr);
 int SG_CostScaling_LONG_DOUBLE_run(void *algoPtr);
 LONG SG_CostScaling_LONG_DOUBLE_flow(void *algoPtr, int arcIdx);
+void SG_CostScaling_LONG_DOUBLE_setThreadNum(void *algoPtr, int threadNum);
+int SG_CostScaling_LONG_DOUBLE_runMethod(void *algoPtr, int method);
+void *SG_CostScalingRounded_LONG_DOUBLE_construct(void *graphPtr);
+void SG_CostScalingRounded_LONG_DOUBLE_destruct(void *ptr);
+void SG_CostScalingRounded_LONG_DOUBLE_setCostMap(void *algoPtr, void *mapPtr);
+void SG_CostScalingRounded_LONG_DOUBLE_setUpperMap(void *algoPtr, void *mapPtr);
+void SG_CostScalingRounded_LONG_DOUBLE_setSupplyMap(void *algoPtr,
+                                                    void *mapPtr);
+int SG_CostScalingRounded_LONG_DOUBLE_run(void *algoPtr);
+LONG SG_CostScalingRounded_LONG_DOUBLE_flow(void *algoPtr, int arcIdx);
+void SG_CostScalingRounded_LONG_DOUBLE_setTolerance(void *algoPtr,
+                                                    double tolerance);
+double SG_CostScalingRounded_LONG_DOUBLE_totalCost(void *algoPtr);
+double SG_CostScalingRounded_LONG_DOUBLE_scale(void *algoPtr);
+double SG_CostScalingRounded_LONG_DOUBLE_roundingError(void *algoPtr);
 }
+
+// The indices of the methods of CostScaling (see lemon::CostScaling::Method)
+enum CostScalingMethod {
+  PUSH,
+  AUGMENT,
+  PARTIAL_AUGMENT,
+  WAVE,
+  PARALLEL_PUSH
+};
+
 void SG_CostScaling_test() {
   PROFILE_BLOCK("SG_CostScaling");
   void *graphPtr = SG_construct();
@@ -234,23 +259,1024 @@ void SG_CostScaling_test() {
   assert(flow3 == 2);
   assert(flow4 == 3);
 
+  // WAVE and PARALLEL_PUSH methods
+  SG_CostScaling_LONG_DOUBLE_setThreadNum(algo, 2);
+  for (int method : {WAVE, PARALLEL_PUSH}) {
+    result = SG_CostScaling_LONG_DOUBLE_runMethod(algo, method);
+    assert(result == 1);
+    assert(SG_CostScaling_LONG_DOUBLE_flow(algo, 0) == 1);
+    assert(SG_CostScaling_LONG_DOUBLE_flow(algo, 1) == 0);
+    assert(SG_CostScaling_LONG_DOUBLE_flow(algo, 2) == 2);
+    assert(SG_CostScaling_LONG_DOUBLE_flow(algo, 3) == 3);
+  }
+  assert(SG_CostScaling_LONG_DOUBLE_runMethod(algo, PUSH - 1) == 4);
+  assert(SG_CostScaling_LONG_DOUBLE_runMethod(algo, PARALLEL_PUSH + 1) == 4);
+
   SG_CostScaling_LONG_DOUBLE_destruct(algo);
 
+  // Costs rounded to integers
+  algo = SG_CostScalingRounded_LONG_DOUBLE_construct(graphPtr);
+  SG_CostScalingRounded_LONG_DOUBLE_setCostMap(algo, costMap);
+  SG_CostScalingRounded_LONG_DOUBLE_setSupplyMap(algo, supplyMap);
+  SG_CostScalingRounded_LONG_DOUBLE_setUpperMap(algo, upperMap);
+  SG_CostScalingRounded_LONG_DOUBLE_setTolerance(algo, 1e-6);
+  result = SG_CostScalingRounded_LONG_DOUBLE_run(algo);
+  assert(result == 1);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_flow(algo, 0) == 1);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_flow(algo, 1) == 0);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_flow(algo, 2) == 2);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_flow(algo, 3) == 3);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_totalCost(algo) == 270.5);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_scale(algo) == 2);
+  assert(SG_CostScalingRounded_LONG_DOUBLE_roundingError(algo) == 0);
+  SG_CostScalingRounded_LONG_DOUBLE_destruct(algo);
+
   SG_NodeMap_LONG_destruct(supplyMap);
   SG_ArcMap_LONG_destruct(upperMap);
   SG_ArcMap_DOUBLE_destruct(costMap);
   SG_destruct(graphPtr);
 }
 
+extern "C" {
+void *SolutionCache_construct(LONG maxBytes);
+void SolutionCache_destruct(void *ptr);
+void SolutionCache_clear(void *ptr);
+LONG SolutionCache_hits(void *ptr);
+LONG SolutionCache_misses(void *ptr);
+int SolutionCache_size(void *ptr);
+LONG SolutionCache_bytes(void *ptr);
+int SG_NetworkSimplex_LONG_LONG_solveCached(void *cachePtr, int nodeNum,
+                                            int arcNum, int *sources,
+                                            int *targets, LONG *lower,
+                                            LONG *upper, LONG *cost,
+                                            LONG *supply, LONG *flows,
+                                            LONG *potentials);
+int SG_CostScaling_LONG_LONG_solveCached(void *cachePtr, int nodeNum,
+                                         int arcNum, int *sources,
+                                         int *targets, LONG *lower,
+                                         LONG *upper, LONG *cost,
+                                         LONG *supply, LONG *flows,
+                                         LONG *potentials);
+}
+
+void SG_Cache_test() {
+  PROFILE_BLOCK("SG_Cache");
+  int sources[] = {0, 0, 1, 1, 2};
+  int targets[] = {1, 2, 2, 3, 3};
+  LONG upper[] = {3, 2, 2, 1, 4};
+  LONG cost[] = {1, 5, 1, 1, 1};
+  LONG supply[] = {4, 0, 0, -4};
+  LONG expected[] = {3, 1, 2, 1, 3};
+  LONG flows[5], potentials[4];
+
+  void *cache = SolutionCache_construct(1 << 20);
+  for (int i = 0; i < 2; i++) {
+    int result = SG_NetworkSimplex_LONG_LONG_solveCached(
+        cache, 4, 5, sources, targets, nullptr, upper, cost, supply, flows,
+        potentials);
+    assert(result == 1);
+    for (int j = 0; j < 5; j++) {
+      assert(flows[j] == expected[j]);
+      if (flows[j] > 0 && flows[j] < upper[j]) {
+        assert(cost[j] + potentials[sources[j]] - potentials[targets[j]] == 0);
+      }
+    }
+  }
+  assert(SolutionCache_hits(cache) == 1 && SolutionCache_misses(cache) == 1);
+  assert(SolutionCache_size(cache) == 1 && SolutionCache_bytes(cache) > 0);
+
+  // Different solver, then a modified problem
+  SG_CostScaling_LONG_LONG_solveCached(cache, 4, 5, sources, targets, nullptr,
+                                       upper, cost, supply, flows, nullptr);
+  assert(SolutionCache_misses(cache) == 2 && SolutionCache_size(cache) == 2);
+  cost[1] = 1;
+  SG_NetworkSimplex_LONG_LONG_solveCached(cache, 4, 5, sources, targets,
+                                          nullptr, upper, cost, supply, flows,
+                                          nullptr);
+  assert(SolutionCache_misses(cache) == 3 && SolutionCache_size(cache) == 3);
+  assert(flows[1] == 2);
+  cost[1] = 5;
+  SG_NetworkSimplex_LONG_LONG_solveCached(cache, 4, 5, sources, targets,
+                                          nullptr, upper, cost, supply, flows,
+                                          nullptr);
+  assert(SolutionCache_hits(cache) == 2 && flows[1] == 1);
+
+  // Memory limit (only the most recently used result fits)
+  LONG bytes = SolutionCache_bytes(cache) / 3;
+  SolutionCache_destruct(cache);
+  cache = SolutionCache_construct(bytes + bytes / 2);
+  for (int i = 0; i < 3; i++) {
+    supply[0] = supply[3] = 0;
+    supply[i] = 1;
+    supply[3] = -1;
+    SG_NetworkSimplex_LONG_LONG_solveCached(cache, 4, 5, sources, targets,
+                                            nullptr, upper, cost, supply,
+                                            flows, nullptr);
+    assert(SolutionCache_size(cache) == 1);
+  }
+  SG_NetworkSimplex_LONG_LONG_solveCached(cache, 4, 5, sources, targets,
+                                          nullptr, upper, cost, supply, flows,
+                                          nullptr);
+  assert(SolutionCache_hits(cache) == 1 && SolutionCache_misses(cache) == 3);
+  SolutionCache_clear(cache);
+  assert(SolutionCache_size(cache) == 0 && SolutionCache_bytes(cache) == 0);
+  SolutionCache_destruct(cache);
+
+  // A negative limit disables the cache
+  cache = SolutionCache_construct(-1);
+  for (int i = 0; i < 2; i++) {
+    SG_NetworkSimplex_LONG_LONG_solveCached(cache, 4, 5, sources, targets,
+                                            nullptr, upper, cost, supply,
+                                            flows, nullptr);
+  }
+  assert(SolutionCache_hits(cache) == 0 && SolutionCache_misses(cache) == 2);
+  assert(SolutionCache_size(cache) == 0 && SolutionCache_bytes(cache) == 0);
+  SolutionCache_destruct(cache);
+}
+
+extern "C" {
+void *ScenarioBatch_construct(int nodeNum, int arcNum, int *sources,
+                              int *targets, LONG *lower, LONG *upper);
+void ScenarioBatch_destruct(void *ptr);
+int SG_NetworkSimplex_LONG_LONG_solveScenarios(
+    void *batchPtr, int scenarioNum, LONG *costs, LONG *supplies,
+    int threadNum, int warmStart, int *results, LONG *flows,
+    LONG *potentials);
+int SG_CostScaling_LONG_LONG_solveScenarios(
+    void *batchPtr, int scenarioNum, LONG *costs, LONG *supplies,
+    int threadNum, int warmStart, int *results, LONG *flows,
+    LONG *potentials);
+}
+
+void SG_ScenarioBatch_test() {
+  PROFILE_BLOCK("SG_ScenarioBatch");
+  const int num = 8;
+  int sources[] = {0, 0, 1, 1, 2};
+  int targets[] = {1, 2, 2, 3, 3};
+  LONG upper[] = {3, 2, 2, 1, 4};
+  LONG costs[num * 5], supplies[num * 4];
+  for (int s = 0; s < num; s++) {
+    for (int i = 0; i < 5; i++) {
+      costs[s * 5 + i] = 1 + (s * 7 + i * 3) % 5;
+    }
+    // Pairs of consecutive scenarios with the same supplies (warm start)
+    LONG k = s == num - 1 ? 9 : 1 + s / 2 % 4;
+    LONG supply[] = {k, 0, 0, -k};
+    std::copy(supply, supply + 4, supplies + s * 4);
+  }
+
+  void *batch = ScenarioBatch_construct(4, 5, sources, targets, nullptr, upper);
+  for (int t = 0; t < 2; t++) {
+    int results[num];
+    LONG flows[num * 5], potentials[num * 4];
+    int ok;
+    if (t == 0) {
+      ok = SG_NetworkSimplex_LONG_LONG_solveScenarios(
+          batch, num, costs, supplies, 3, 1, results, flows, potentials);
+    } else {
+      // No warm start for CostScaling
+      ok = SG_CostScaling_LONG_LONG_solveScenarios(
+          batch, num, costs, supplies, 3, 1, results, flows, potentials);
+      assert(ok == 0);
+      ok = SG_CostScaling_LONG_LONG_solveScenarios(
+          batch, num, costs, supplies, 3, 0, results, flows, potentials);
+    }
+    assert(ok == 1);
+    for (int s = 0; s < num; s++) {
+      LONG expected[5];
+      int result = SG_NetworkSimplex_LONG_LONG_solveCached(
+          nullptr, 4, 5, sources, targets, nullptr, upper, costs + s * 5,
+          supplies + s * 4, expected, nullptr);
+      assert(results[s] == result);
+      if (result != 1) continue;
+      LONG cost = 0, expectedCost = 0;
+      for (int i = 0; i < 5; i++) {
+        cost += flows[s * 5 + i] * costs[s * 5 + i];
+        expectedCost += expected[i] * costs[s * 5 + i];
+        LONG pi1 = potentials[s * 4 + sources[i]];
+        LONG pi2 = potentials[s * 4 + targets[i]];
+        LONG reducedCost = costs[s * 5 + i] + pi1 - pi2;
+        assert(reducedCost >= 0 || flows[s * 5 + i] == upper[i]);
+        assert(reducedCost <= 0 || flows[s * 5 + i] == 0);
+      }
+      assert(cost == expectedCost);
+    }
+    assert(results[num - 1] == 0);
+  }
+
+  // Without output arrays
+  int results[num];
+  SG_NetworkSimplex_LONG_LONG_solveScenarios(batch, num, costs, supplies, 2, 0,
+                                             results, nullptr, nullptr);
+  assert(results[0] == 1 && results[num - 1] == 0);
+  ScenarioBatch_destruct(batch);
+}
+
+extern "C" {
+int TransportationSimplex_LONG_LONG_solve(int supplierNum, int consumerNum,
+                                          LONG *supply, LONG *demand,
+                                          LONG *costs, int initMethod,
+                                          int *flowNum, int *rows, int *cols,
+                                          LONG *flows, LONG *potentials);
+int TransportationSimplex_LONG_LONG_solveCallback(
+    int supplierNum, int consumerNum, LONG *supply, LONG *demand,
+    LONG (*costFunc)(int, int, void *), void *data, int initMethod,
+    int *flowNum, int *rows, int *cols, LONG *flows, LONG *potentials);
+}
+
+LONG transportationCost(int i, int j, void *data) {
+  return ((LONG *)data)[i * 4 + j];
+}
+
+void TransportationSimplex_test() {
+  PROFILE_BLOCK("TransportationSimplex");
+  LONG supply[] = {5, 7, 4};
+  LONG demand[] = {3, 6, 2, 5};
+  LONG costs[] = {4, 2, 7, 3, 1, 5, 2, 6, 8, 3, 4, 1};
+
+  // The same problem as an explicit graph (suppliers 0..2, consumers 3..6)
+  int sources[12], targets[12];
+  LONG nodeSupply[] = {5, 7, 4, -3, -6, -2, -5};
+  for (int i = 0; i < 12; i++) {
+    sources[i] = i / 4;
+    targets[i] = 3 + i % 4;
+  }
+  LONG expected[12];
+  assert(SG_NetworkSimplex_LONG_LONG_solveCached(
+             nullptr, 7, 12, sources, targets, nullptr, nullptr, costs,
+             nodeSupply, expected, nullptr) == 1);
+  LONG expectedCost = 0;
+  for (int i = 0; i < 12; i++) {
+    expectedCost += expected[i] * costs[i];
+  }
+
+  for (int t = 0; t < 4; t++) {
+    int flowNum, rows[6], cols[6];
+    LONG flows[6], potentials[7];
+    int result =
+        t < 2 ? TransportationSimplex_LONG_LONG_solve(
+                    3, 4, supply, demand, costs, t, &flowNum, rows, cols,
+                    flows, potentials)
+              : TransportationSimplex_LONG_LONG_solveCallback(
+                    3, 4, supply, demand, transportationCost, costs, t - 2,
+                    &flowNum, rows, cols, flows, potentials);
+    assert(result == 1 && flowNum <= 6);
+    LONG cost = 0;
+    for (int k = 0; k < flowNum; k++) {
+      LONG c = costs[rows[k] * 4 + cols[k]];
+      cost += flows[k] * c;
+      assert(c + potentials[rows[k]] - potentials[3 + cols[k]] == 0);
+    }
+    assert(cost == expectedCost);
+    for (int i = 0; i < 12; i++) {
+      assert(costs[i] + potentials[i / 4] - potentials[3 + i % 4] >= 0);
+    }
+  }
+
+  int flowNum, rows[6], cols[6];
+  LONG flows[6];
+  LONG largeDemand[] = {3, 6, 2, 6};
+  assert(TransportationSimplex_LONG_LONG_solve(3, 4, supply, largeDemand,
+                                               costs, 1, &flowNum, rows, cols,
+                                               flows, nullptr) == 0);
+  assert(flowNum == 0);
+}
+
+extern "C" {
+DOUBLE EMD_LONG_LONG_solve(int dim, int sourceNum, DOUBLE *sourceCoords,
+                           LONG *sourceWeights, int targetNum,
+                           DOUBLE *targetCoords, LONG *targetWeights,
+                           int groundDistance, DOUBLE scale,
+                           DOUBLE threshold, int *flowNum, int *sources,
+                           int *targets, LONG *flows, LONG *totalCost);
+}
+
+void EMD_test() {
+  PROFILE_BLOCK("EMD");
+  // Two 1-dimensional histograms on a grid
+  DOUBLE coords[] = {0, 1, 2, 3, 4};
+  LONG sourceWeights[] = {4, 0, 0, 0, 0};
+  LONG targetWeights[] = {0, 0, 1, 0, 3};
+  int flowNum, sources[10], targets[10];
+  LONG flows[10], totalCost;
+  for (int gd = 0; gd < 2; gd++) {
+    DOUBLE dist = EMD_LONG_LONG_solve(
+        1, 5, coords, sourceWeights, 5, coords, targetWeights, gd, 10, 0,
+        &flowNum, sources, targets, flows, &totalCost);
+    assert(totalCost == 140 && std::abs(dist - 3.5) < 1e-9);
+    assert(flowNum == 2);
+    for (int k = 0; k < flowNum; k++) {
+      assert(sources[k] == 0);
+      assert(flows[k] == (targets[k] == 2 ? 1 : 3));
+    }
+  }
+
+  // Thresholded ground distance
+  DOUBLE dist = EMD_LONG_LONG_solve(1, 5, coords, sourceWeights, 5, coords,
+                                    targetWeights, 1, 10, 3, &flowNum,
+                                    sources, targets, flows, &totalCost);
+  assert(totalCost == 110 && std::abs(dist - 2.75) < 1e-9);
+
+  // Unequal total weights, only the weights are moved (2 dimensions)
+  DOUBLE points[] = {0, 0, 3, 4};
+  LONG w1[] = {2, 1}, w2[] = {1};
+  dist = EMD_LONG_LONG_solve(2, 2, points, w1, 1, points + 2, w2, 0, 1, 0,
+                             nullptr, nullptr, nullptr, nullptr, &totalCost);
+  assert(totalCost == 0 && dist == 0);
+  dist = EMD_LONG_LONG_solve(2, 1, points, w2, 2, points, w1, 0, 1, 0,
+                             nullptr, nullptr, nullptr, nullptr, &totalCost);
+  assert(totalCost == 0);
+  LONG w3[] = {0, 2};
+  dist = EMD_LONG_LONG_solve(2, 2, points, w3, 1, points, w2, 0, 1, 0,
+                             nullptr, nullptr, nullptr, nullptr, &totalCost);
+  assert(totalCost == 5 && dist == 5);
+}
+
+extern "C" {
+int AuctionAssignment_LONG_solve(int n, int *first, int *targets,
+                                 LONG *costs, int threadNum, int *mateArcs,
+                                 LONG *totalCost);
+}
+
+void AuctionAssignment_test() {
+  PROFILE_BLOCK("AuctionAssignment");
+  // 3 persons and 3 objects, the optimal assignment is 0-1, 1-0, 2-2
+  int first[] = {0, 2, 4, 6};
+  int targets[] = {0, 1, 0, 2, 1, 2};
+  LONG costs[] = {4, 1, 2, 5, 3, 3};
+  int mateArcs[3];
+  LONG totalCost;
+  for (int threads = 1; threads <= 2; threads++) {
+    assert(AuctionAssignment_LONG_solve(3, first, targets, costs, threads,
+                                        mateArcs, &totalCost) == 1);
+    assert(totalCost == 6);
+    assert(mateArcs[0] == 1 && mateArcs[1] == 2 && mateArcs[2] == 5);
+  }
+
+  // No perfect matching: persons 1 and 2 can only get object 2
+  int first2[] = {0, 2, 3, 4};
+  int targets2[] = {0, 2, 2, 2};
+  assert(AuctionAssignment_LONG_solve(3, first2, targets2, costs, 1,
+                                      mateArcs, nullptr) == 0);
+}
+
+extern "C" {
+LONG JonkerVolgenant_LONG_solve(int n, LONG *costs, int *rowMates,
+                                LONG *rowPotentials, LONG *colPotentials);
+DOUBLE JonkerVolgenant_DOUBLE_solve(int n, DOUBLE *costs, int *rowMates,
+                                    DOUBLE *rowPotentials,
+                                    DOUBLE *colPotentials);
+}
+
+void JonkerVolgenant_test() {
+  PROFILE_BLOCK("JonkerVolgenant");
+  // The optimal assignment is 0-1, 1-0, 2-2 with total cost 5
+  LONG costs[] = {4, 1, 3, 2, 0, 5, 3, 2, 2};
+  int rowMates[3];
+  LONG u[3], v[3];
+  assert(JonkerVolgenant_LONG_solve(3, costs, rowMates, u, v) == 5);
+  assert(rowMates[0] == 1 && rowMates[1] == 0 && rowMates[2] == 2);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      LONG reducedCost = costs[i * 3 + j] - u[i] - v[j];
+      assert(reducedCost >= 0 && (rowMates[i] != j || reducedCost == 0));
+    }
+  }
+
+  DOUBLE realCosts[] = {0.5, 1.5, 2.0, 0.25};
+  DOUBLE cost =
+      JonkerVolgenant_DOUBLE_solve(2, realCosts, rowMates, nullptr, nullptr);
+  assert(std::abs(cost - 0.75) < 1e-12);
+  assert(rowMates[0] == 0 && rowMates[1] == 1);
+}
+
+extern "C" {
+int SG_Circulation_LONG_checkFeasibility(int nodeNum, int arcNum,
+                                         int *sources, int *targets,
+                                         LONG *lower, LONG *upper,
+                                         LONG *supply, int *barrier);
+int SG_NetworkSimplex_LONG_LONG_solveChecked(int nodeNum, int arcNum,
+                                             int *sources, int *targets,
+                                             LONG *lower, LONG *upper,
+                                             LONG *cost, LONG *supply,
+                                             LONG *flows, LONG *potentials,
+                                             int *barrier);
+}
+
+void SG_Feasibility_test() {
+  PROFILE_BLOCK("SG_Feasibility");
+  int sources[] = {0, 0, 1, 1, 2};
+  int targets[] = {1, 2, 2, 3, 3};
+  LONG upper[] = {3, 2, 2, 1, 4};
+  LONG cost[] = {1, 5, 1, 1, 1};
+  LONG supply[] = {4, 0, 0, -4};
+  LONG expected[] = {3, 1, 2, 1, 3};
+  LONG flows[5];
+  int barrier[4];
+
+  assert(SG_Circulation_LONG_checkFeasibility(4, 5, sources, targets, nullptr,
+                                              upper, supply, barrier) == 1);
+  assert(SG_NetworkSimplex_LONG_LONG_solveChecked(
+             4, 5, sources, targets, nullptr, upper, cost, supply, flows,
+             nullptr, barrier) == 1);
+  for (int i = 0; i < 5; i++) {
+    assert(flows[i] == expected[i]);
+  }
+  for (int i = 0; i < 4; i++) {
+    assert(barrier[i] == 0);
+  }
+
+  // The total supply is positive, the whole node set is a barrier
+  LONG unbalanced[] = {4, 0, 0, -3};
+  assert(SG_Circulation_LONG_checkFeasibility(4, 5, sources, targets, nullptr,
+                                              upper, unbalanced, barrier) == 0);
+  for (int i = 0; i < 4; i++) {
+    assert(barrier[i] == 1);
+  }
+
+  // Only 5 units can leave node 0: the barrier is a violated cut
+  LONG tooMuch[] = {6, 0, 0, -6};
+  assert(SG_NetworkSimplex_LONG_LONG_solveChecked(
+             4, 5, sources, targets, nullptr, upper, cost, tooMuch, flows,
+             nullptr, barrier) == 0);
+  assert(barrier[0] == 1 && barrier[3] == 0);
+  LONG excess = 0;
+  for (int i = 0; i < 4; i++) {
+    if (barrier[i]) excess += tooMuch[i];
+  }
+  for (int i = 0; i < 5; i++) {
+    if (barrier[sources[i]] && !barrier[targets[i]]) excess -= upper[i];
+  }
+  assert(excess > 0);
+
+  // The lower bound of an arc exceeds its upper bound
+  LONG lower[] = {0, 0, 3, 0, 0};
+  assert(SG_Circulation_LONG_checkFeasibility(4, 5, sources, targets, lower,
+                                              upper, supply, nullptr) == 0);
+
+  // A negative upper bound with zero (null) lower bounds
+  LONG negative[] = {3, 2, -1, 1, 4};
+  assert(SG_Circulation_LONG_checkFeasibility(4, 5, sources, targets, nullptr,
+                                              negative, supply, nullptr) == 0);
+}
+
+extern "C" {
+void *SG_Preflow_LONG_construct(int nodeNum, int arcNum, int *sources,
+                                int *targets, LONG *capacities, int source,
+                                int target);
+void SG_Preflow_LONG_destruct(void *ptr);
+void SG_Preflow_LONG_setCapacities(void *ptr, int num, int *arcIdxs,
+                                   LONG *capacities);
+void SG_Preflow_LONG_setTerminals(void *ptr, int source, int target);
+LONG SG_Preflow_LONG_solve(void *ptr, LONG *flows, int *cut);
+}
+
+void checkMaxFlow(int *sources, int *targets, LONG *capacities, LONG *flows,
+                  int *cut, int source, int target, LONG value) {
+  LONG excess[4] = {0, 0, 0, 0}, cutValue = 0;
+  for (int i = 0; i < 5; i++) {
+    assert(flows[i] >= 0 && flows[i] <= capacities[i]);
+    excess[sources[i]] -= flows[i];
+    excess[targets[i]] += flows[i];
+    if (cut[sources[i]] && !cut[targets[i]]) cutValue += capacities[i];
+  }
+  for (int i = 0; i < 4; i++) {
+    if (i != source && i != target) assert(excess[i] == 0);
+  }
+  assert(excess[target] == value);
+  assert(cut[source] == 1 && cut[target] == 0);
+  assert(cutValue == value);
+}
+
+void SG_Preflow_test() {
+  PROFILE_BLOCK("SG_Preflow");
+  int sources[] = {0, 0, 1, 1, 2};
+  int targets[] = {1, 2, 2, 3, 3};
+  LONG capacities[] = {3, 2, 2, 1, 4};
+  LONG flows[5];
+  int cut[4];
+
+  void *problem = SG_Preflow_LONG_construct(4, 5, sources, targets,
+                                            capacities, 0, 3);
+  assert(SG_Preflow_LONG_solve(problem, flows, cut) == 5);
+  checkMaxFlow(sources, targets, capacities, flows, cut, 0, 3, 5);
+
+  // Decrease capacities below the current flow
+  int arcIdxs[] = {0, 4};
+  LONG decreased[] = {1, 1};
+  SG_Preflow_LONG_setCapacities(problem, 2, arcIdxs, decreased);
+  LONG capacities2[] = {1, 2, 2, 1, 1};
+  assert(SG_Preflow_LONG_solve(problem, flows, cut) == 2);
+  checkMaxFlow(sources, targets, capacities2, flows, cut, 0, 3, 2);
+
+  // Increase all capacities
+  LONG capacities3[] = {6, 4, 4, 2, 8};
+  SG_Preflow_LONG_setCapacities(problem, 5, nullptr, capacities3);
+  assert(SG_Preflow_LONG_solve(problem, flows, cut) == 10);
+  checkMaxFlow(sources, targets, capacities3, flows, cut, 0, 3, 10);
+
+  // Change the target
+  SG_Preflow_LONG_setTerminals(problem, 0, 2);
+  assert(SG_Preflow_LONG_solve(problem, flows, cut) == 8);
+  checkMaxFlow(sources, targets, capacities3, flows, cut, 0, 2, 8);
+  SG_Preflow_LONG_destruct(problem);
+}
+
+extern "C" {
+void *SG_PreflowBatch_LONG_construct(int nodeNum, int arcNum, int *sources,
+                                     int *targets, LONG *capacities);
+void SG_PreflowBatch_LONG_destruct(void *ptr);
+void SG_PreflowBatch_LONG_solve(void *ptr, int queryNum, int *sources,
+                                int *targets, int threadNum, LONG *values,
+                                int *cuts);
+}
+
+void SG_PreflowBatch_test() {
+  PROFILE_BLOCK("SG_PreflowBatch");
+  const int n = 30, words = (n + 31) / 32;
+  std::vector<int> sources, targets;
+  std::vector<LONG> capacities;
+  unsigned seed = 12345;
+  auto next = [&](int bound) {
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 16) % bound);
+  };
+  for (int u = 0; u < n; u++) {
+    for (int k = 0; k < 4; k++) {
+      int v = next(n);
+      if (v == u) continue;
+      sources.push_back(u);
+      targets.push_back(v);
+      capacities.push_back(1 + next(20));
+    }
+  }
+  int arcNum = sources.size();
+
+  std::vector<int> querySources, queryTargets;
+  for (int s = 0; s < n; s++) {
+    for (int t = 0; t < n; t++) {
+      if (s == t) continue;
+      querySources.push_back(s);
+      queryTargets.push_back(t);
+    }
+  }
+  int queryNum = querySources.size();
+
+  std::vector<LONG> expected(queryNum);
+  void *problem = SG_Preflow_LONG_construct(n, arcNum, sources.data(),
+                                            targets.data(), capacities.data(),
+                                            0, 1);
+  for (int q = 0; q < queryNum; q++) {
+    SG_Preflow_LONG_setTerminals(problem, querySources[q], queryTargets[q]);
+    expected[q] = SG_Preflow_LONG_solve(problem, nullptr, nullptr);
+  }
+  SG_Preflow_LONG_destruct(problem);
+
+  void *batch = SG_PreflowBatch_LONG_construct(
+      n, arcNum, sources.data(), targets.data(), capacities.data());
+  std::vector<LONG> values(queryNum);
+  std::vector<int> cuts((long long)queryNum * words);
+  for (int threadNum : {1, 3, 1}) {
+    SG_PreflowBatch_LONG_solve(batch, queryNum, querySources.data(),
+                               queryTargets.data(), threadNum, values.data(),
+                               cuts.data());
+    for (int q = 0; q < queryNum; q++) {
+      assert(values[q] == expected[q]);
+      const int *cut = cuts.data() + (long long)q * words;
+      auto side = [&](int i) { return (cut[i / 32] >> (i % 32)) & 1; };
+      assert(side(querySources[q]) == 1 && side(queryTargets[q]) == 0);
+      LONG cutValue = 0;
+      for (int i = 0; i < arcNum; i++) {
+        if (side(sources[i]) && !side(targets[i])) cutValue += capacities[i];
+      }
+      assert(cutValue == values[q]);
+    }
+  }
+
+  // Values only
+  std::vector<LONG> values2(queryNum);
+  SG_PreflowBatch_LONG_solve(batch, queryNum, querySources.data(),
+                             queryTargets.data(), 0, values2.data(), nullptr);
+  assert(values2 == expected);
+  SG_PreflowBatch_LONG_destruct(batch);
+}
+
+#define CAS_HEAP_TEST(G, MCF, scale, name)                                     \
+  extern "C" {                                                                 \
+  void *G##_##MCF##_LONG_LONG_construct(void *graphPtr);                       \
+  void G##_##MCF##_LONG_LONG_destruct(void *ptr);                              \
+  void G##_##MCF##_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);          \
+  void G##_##MCF##_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr);         \
+  void G##_##MCF##_LONG_LONG_setSupplyMap(void *algoPtr, void *mapPtr);        \
+  int G##_##MCF##_LONG_LONG_run(void *algoPtr);                                \
+  LONG G##_##MCF##_LONG_LONG_flow(void *algoPtr, void *arcPtr);                \
+  }                                                                            \
+  void name##_test() {                                                         \
+    PROFILE_BLOCK(#name);                                                      \
+    void *graphPtr = G##_construct();                                          \
+    std::vector<void *> nodes;                                                 \
+    std::vector<void *> arcs;                                                  \
+    for (int i = 0; i < 4; i++) {                                              \
+      nodes.push_back(G##_addNode(graphPtr));                                  \
+    }                                                                          \
+    arcs.push_back(G##_addArc(graphPtr, nodes[0], nodes[1]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[0], nodes[2]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[1], nodes[3]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[2], nodes[3]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[1], nodes[2]));                  \
+                                                                               \
+    void *supplyMap = G##_NodeMap_LONG_construct(graphPtr);                    \
+    G##_NodeMap_LONG_set(supplyMap, nodes[0], 4);                              \
+    G##_NodeMap_LONG_set(supplyMap, nodes[3], -4);                             \
+    void *upperMap = G##_ArcMap_LONG_construct(graphPtr);                      \
+    void *costMap = G##_ArcMap_LONG_construct(graphPtr);                       \
+    LONG upper[] = {3, 2, 1, 4, 2};                                            \
+    LONG cost[] = {1, 5, 1, 1, 1};                                             \
+    for (int i = 0; i < 5; i++) {                                              \
+      G##_ArcMap_LONG_set(upperMap, arcs[i], upper[i]);                        \
+      G##_ArcMap_LONG_set(costMap, arcs[i], cost[i] * (LONG)(scale));          \
+    }                                                                          \
+                                                                               \
+    void *algo = G##_##MCF##_LONG_LONG_construct(graphPtr);                    \
+    G##_##MCF##_LONG_LONG_setCostMap(algo, costMap);                           \
+    G##_##MCF##_LONG_LONG_setSupplyMap(algo, supplyMap);                       \
+    G##_##MCF##_LONG_LONG_setUpperMap(algo, upperMap);                         \
+    assert(G##_##MCF##_LONG_LONG_run(algo) == 1);                              \
+                                                                               \
+    LONG expected[] = {3, 1, 1, 3, 2};                                         \
+    for (int i = 0; i < 5; i++) {                                              \
+      assert(G##_##MCF##_LONG_LONG_flow(algo, arcs[i]) == expected[i]);        \
+    }                                                                          \
+                                                                               \
+    G##_##MCF##_LONG_LONG_destruct(algo);                                      \
+    G##_NodeMap_LONG_destruct(supplyMap);                                      \
+    G##_ArcMap_LONG_destruct(upperMap);                                        \
+    G##_ArcMap_LONG_destruct(costMap);                                         \
+    for (void *node : nodes) {                                                 \
+      deleteObject(node);                                                      \
+    }                                                                          \
+    for (void *arc : arcs) {                                                   \
+      deleteObject(arc);                                                       \
+    }                                                                          \
+    G##_destruct(graphPtr);                                                    \
+  }
+
+#define CROSSOVER_TEST(G, name)                                                \
+  extern "C" {                                                                 \
+  void *G##_CostScaling_LONG_LONG_construct(void *graphPtr);                   \
+  void G##_CostScaling_LONG_LONG_destruct(void *ptr);                          \
+  void G##_CostScaling_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);      \
+  void G##_CostScaling_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr);     \
+  void G##_CostScaling_LONG_LONG_setSupplyMap(void *algoPtr, void *mapPtr);    \
+  int G##_CostScaling_LONG_LONG_run(void *algoPtr);                            \
+  void *G##_NetworkSimplex_LONG_LONG_construct(void *graphPtr);                \
+  void G##_NetworkSimplex_LONG_LONG_destruct(void *ptr);                       \
+  void G##_NetworkSimplex_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);   \
+  void G##_NetworkSimplex_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr);  \
+  void G##_NetworkSimplex_LONG_LONG_setSupplyMap(void *algoPtr, void *mapPtr); \
+  int G##_NetworkSimplex_LONG_LONG_runCrossover(void *algoPtr, void *graphPtr, \
+                                                void *csPtr);                  \
+  LONG G##_NetworkSimplex_LONG_LONG_flow(void *algoPtr, void *arcPtr);         \
+  int G##_NetworkSimplex_LONG_LONG_treeArc(void *algoPtr, void *arcPtr);       \
+  LONG G##_NetworkSimplex_LONG_LONG_potential(void *algoPtr, void *nodePtr);   \
+  int G##_NetworkSimplex_LONG_LONG_run(void *algoPtr);                         \
+  void G##_NetworkSimplex_LONG_LONG_setTimeLimit(void *algoPtr, double limit); \
+  double G##_NetworkSimplex_LONG_LONG_feasibleTime(void *algoPtr);             \
+  double G##_NetworkSimplex_LONG_LONG_totalCost(void *algoPtr);                \
+  double G##_NetworkSimplex_LONG_LONG_dualBound(void *algoPtr);                \
+  void G##_CostScaling_LONG_LONG_setOptimalityGap(void *algoPtr, double absGap,\
+                                                  double relGap);              \
+  double G##_CostScaling_LONG_LONG_totalCost(void *algoPtr);                   \
+  double G##_CostScaling_LONG_LONG_dualBound(void *algoPtr);                   \
+  }                                                                            \
+  void name##_test() {                                                         \
+    PROFILE_BLOCK(#name);                                                      \
+    void *graphPtr = G##_construct();                                          \
+    std::vector<void *> nodes;                                                 \
+    std::vector<void *> arcs;                                                  \
+    for (int i = 0; i < 4; i++) {                                              \
+      nodes.push_back(G##_addNode(graphPtr));                                  \
+    }                                                                          \
+    int ends[][2] = {{0, 1}, {0, 2}, {1, 3}, {2, 3}, {1, 2}};                  \
+    for (int i = 0; i < 5; i++) {                                              \
+      arcs.push_back(                                                          \
+          G##_addArc(graphPtr, nodes[ends[i][0]], nodes[ends[i][1]]));         \
+    }                                                                          \
+                                                                               \
+    void *supplyMap = G##_NodeMap_LONG_construct(graphPtr);                    \
+    G##_NodeMap_LONG_set(supplyMap, nodes[0], 4);                              \
+    G##_NodeMap_LONG_set(supplyMap, nodes[3], -4);                             \
+    void *upperMap = G##_ArcMap_LONG_construct(graphPtr);                      \
+    void *costMap = G##_ArcMap_LONG_construct(graphPtr);                       \
+    LONG upper[] = {3, 2, 1, 4, 2};                                            \
+    LONG cost[] = {1, 5, 1, 1, 1};                                             \
+    for (int i = 0; i < 5; i++) {                                              \
+      G##_ArcMap_LONG_set(upperMap, arcs[i], upper[i]);                        \
+      G##_ArcMap_LONG_set(costMap, arcs[i], cost[i]);                          \
+    }                                                                          \
+                                                                               \
+    void *cs = G##_CostScaling_LONG_LONG_construct(graphPtr);                  \
+    G##_CostScaling_LONG_LONG_setCostMap(cs, costMap);                         \
+    G##_CostScaling_LONG_LONG_setSupplyMap(cs, supplyMap);                     \
+    G##_CostScaling_LONG_LONG_setUpperMap(cs, upperMap);                       \
+    assert(G##_CostScaling_LONG_LONG_run(cs) == 1);                            \
+                                                                               \
+    void *ns = G##_NetworkSimplex_LONG_LONG_construct(graphPtr);               \
+    G##_NetworkSimplex_LONG_LONG_setCostMap(ns, costMap);                      \
+    G##_NetworkSimplex_LONG_LONG_setSupplyMap(ns, supplyMap);                  \
+    G##_NetworkSimplex_LONG_LONG_setUpperMap(ns, upperMap);                    \
+    assert(G##_NetworkSimplex_LONG_LONG_runCrossover(ns, graphPtr, cs) == 1);  \
+                                                                               \
+    LONG expected[] = {3, 1, 1, 3, 2};                                         \
+    for (int i = 0; i < 5; i++) {                                              \
+      LONG flow = G##_NetworkSimplex_LONG_LONG_flow(ns, arcs[i]);              \
+      assert(flow == expected[i]);                                             \
+      if (G##_NetworkSimplex_LONG_LONG_treeArc(ns, arcs[i])) {                 \
+        LONG pi1 =                                                             \
+            G##_NetworkSimplex_LONG_LONG_potential(ns, nodes[ends[i][0]]);     \
+        LONG pi2 =                                                             \
+            G##_NetworkSimplex_LONG_LONG_potential(ns, nodes[ends[i][1]]);     \
+        assert(cost[i] + pi1 - pi2 == 0);                                      \
+      } else {                                                                 \
+        assert(flow == 0 || flow == upper[i]);                                 \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    assert(G##_NetworkSimplex_LONG_LONG_totalCost(ns) == 14);                  \
+    assert(G##_NetworkSimplex_LONG_LONG_dualBound(ns) == 14);                  \
+                                                                               \
+    G##_NetworkSimplex_LONG_LONG_setTimeLimit(ns, 10.0);                       \
+    assert(G##_NetworkSimplex_LONG_LONG_run(ns) == 1);                         \
+    assert(G##_NetworkSimplex_LONG_LONG_feasibleTime(ns) >= 0);                \
+    assert(G##_NetworkSimplex_LONG_LONG_totalCost(ns) == 14);                  \
+                                                                               \
+    G##_CostScaling_LONG_LONG_setOptimalityGap(cs, 100, 0);                    \
+    int res = G##_CostScaling_LONG_LONG_run(cs);                               \
+    assert(res == 1 || res == 3);                                              \
+    assert(G##_CostScaling_LONG_LONG_dualBound(cs) <= 14);                     \
+    assert(G##_CostScaling_LONG_LONG_totalCost(cs) >= 14);                     \
+    G##_CostScaling_LONG_LONG_setOptimalityGap(cs, 0, 0);                      \
+    assert(G##_CostScaling_LONG_LONG_run(cs) == 1);                            \
+    assert(G##_CostScaling_LONG_LONG_dualBound(cs) == 14);                     \
+                                                                               \
+    G##_NetworkSimplex_LONG_LONG_destruct(ns);                                 \
+    G##_CostScaling_LONG_LONG_destruct(cs);                                    \
+    G##_NodeMap_LONG_destruct(supplyMap);                                      \
+    G##_ArcMap_LONG_destruct(upperMap);                                        \
+    G##_ArcMap_LONG_destruct(costMap);                                         \
+    for (void *node : nodes) {                                                 \
+      deleteObject(node);                                                      \
+    }                                                                          \
+    for (void *arc : arcs) {                                                   \
+      deleteObject(arc);                                                       \
+    }                                                                          \
+    G##_destruct(graphPtr);                                                    \
+  }
+
+#define ADD_ARCS_TEST(G, name)                                                 \
+  extern "C" {                                                                 \
+  void *G##_NetworkSimplex_LONG_LONG_construct(void *graphPtr);                \
+  void G##_NetworkSimplex_LONG_LONG_destruct(void *ptr);                       \
+  void G##_NetworkSimplex_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);   \
+  void G##_NetworkSimplex_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr);  \
+  void G##_NetworkSimplex_LONG_LONG_setSupplyMap(void *algoPtr, void *mapPtr); \
+  int G##_NetworkSimplex_LONG_LONG_run(void *algoPtr);                         \
+  LONG G##_NetworkSimplex_LONG_LONG_flow(void *algoPtr, void *arcPtr);         \
+  double G##_NetworkSimplex_LONG_LONG_totalCost(void *algoPtr);                \
+  void G##_NetworkSimplex_LONG_LONG_addArcs(void *algoPtr, void *graphPtr,     \
+                                            int arcNum, void **sources,        \
+                                            void **targets, LONG *lower,       \
+                                            LONG *upper, LONG *cost,           \
+                                            void **arcs);                      \
+  int G##_NetworkSimplex_LONG_LONG_resume(void *algoPtr);                      \
+  }                                                                            \
+  void name##_test() {                                                         \
+    PROFILE_BLOCK(#name);                                                      \
+    void *graphPtr = G##_construct();                                          \
+    std::vector<void *> nodes;                                                 \
+    std::vector<void *> arcs;                                                  \
+    for (int i = 0; i < 4; i++) {                                              \
+      nodes.push_back(G##_addNode(graphPtr));                                  \
+    }                                                                          \
+    arcs.push_back(G##_addArc(graphPtr, nodes[0], nodes[1]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[1], nodes[3]));                  \
+                                                                               \
+    void *supplyMap = G##_NodeMap_LONG_construct(graphPtr);                    \
+    G##_NodeMap_LONG_set(supplyMap, nodes[0], 4);                              \
+    G##_NodeMap_LONG_set(supplyMap, nodes[3], -4);                             \
+    void *upperMap = G##_ArcMap_LONG_construct(graphPtr);                      \
+    void *costMap = G##_ArcMap_LONG_construct(graphPtr);                       \
+    for (int i = 0; i < 2; i++) {                                              \
+      G##_ArcMap_LONG_set(upperMap, arcs[i], 4);                               \
+      G##_ArcMap_LONG_set(costMap, arcs[i], 5);                                \
+    }                                                                          \
+                                                                               \
+    void *ns = G##_NetworkSimplex_LONG_LONG_construct(graphPtr);               \
+    G##_NetworkSimplex_LONG_LONG_setCostMap(ns, costMap);                      \
+    G##_NetworkSimplex_LONG_LONG_setSupplyMap(ns, supplyMap);                  \
+    G##_NetworkSimplex_LONG_LONG_setUpperMap(ns, upperMap);                    \
+    assert(G##_NetworkSimplex_LONG_LONG_run(ns) == 1);                         \
+    assert(G##_NetworkSimplex_LONG_LONG_totalCost(ns) == 40);                  \
+                                                                               \
+    void *sources[] = {nodes[0], nodes[2]};                                    \
+    void *targets[] = {nodes[2], nodes[3]};                                    \
+    LONG upper[] = {3, 3};                                                     \
+    LONG cost[] = {1, 1};                                                      \
+    void *newArcs[2];                                                          \
+    G##_NetworkSimplex_LONG_LONG_addArcs(ns, graphPtr, 2, sources, targets,    \
+                                         nullptr, upper, cost, newArcs);       \
+    arcs.insert(arcs.end(), newArcs, newArcs + 2);                             \
+    assert(G##_NetworkSimplex_LONG_LONG_resume(ns) == 1);                      \
+    assert(G##_NetworkSimplex_LONG_LONG_totalCost(ns) == 16);                  \
+    LONG expected[] = {1, 1, 3, 3};                                            \
+    for (int i = 0; i < 4; i++) {                                              \
+      assert(G##_NetworkSimplex_LONG_LONG_flow(ns, arcs[i]) == expected[i]);   \
+    }                                                                          \
+                                                                               \
+    G##_NetworkSimplex_LONG_LONG_destruct(ns);                                 \
+    G##_NodeMap_LONG_destruct(supplyMap);                                      \
+    G##_ArcMap_LONG_destruct(upperMap);                                        \
+    G##_ArcMap_LONG_destruct(costMap);                                         \
+    for (void *node : nodes) {                                                 \
+      deleteObject(node);                                                      \
+    }                                                                          \
+    for (void *arc : arcs) {                                                   \
+      deleteObject(arc);                                                       \
+    }                                                                          \
+    G##_destruct(graphPtr);                                                    \
+  }
+
+#define CONVEX_TEST(G, MCF, name)                                              \
+  extern "C" {                                                                 \
+  void *G##_##MCF##_LONG_LONG_construct(void *graphPtr);                       \
+  void G##_##MCF##_LONG_LONG_destruct(void *ptr);                              \
+  void G##_##MCF##_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);          \
+  void G##_##MCF##_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr);         \
+  void G##_##MCF##_LONG_LONG_setSupplyMap(void *algoPtr, void *mapPtr);        \
+  int G##_##MCF##_LONG_LONG_setConvexCosts(void *algoPtr, int arcNum,          \
+                                           void **arcs, int *pieceNums,        \
+                                           LONG *breakpoints, LONG *slopes);   \
+  int G##_##MCF##_LONG_LONG_run(void *algoPtr);                                \
+  LONG G##_##MCF##_LONG_LONG_flow(void *algoPtr, void *arcPtr);                \
+  double G##_##MCF##_LONG_LONG_totalCost(void *algoPtr);                       \
+  }                                                                            \
+  void name##_test() {                                                         \
+    PROFILE_BLOCK(#name);                                                      \
+    void *graphPtr = G##_construct();                                          \
+    std::vector<void *> nodes;                                                 \
+    std::vector<void *> arcs;                                                  \
+    for (int i = 0; i < 4; i++) {                                              \
+      nodes.push_back(G##_addNode(graphPtr));                                  \
+    }                                                                          \
+    arcs.push_back(G##_addArc(graphPtr, nodes[0], nodes[1]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[0], nodes[2]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[1], nodes[3]));                  \
+    arcs.push_back(G##_addArc(graphPtr, nodes[2], nodes[3]));                  \
+                                                                               \
+    void *supplyMap = G##_NodeMap_LONG_construct(graphPtr);                    \
+    G##_NodeMap_LONG_set(supplyMap, nodes[0], 6);                              \
+    G##_NodeMap_LONG_set(supplyMap, nodes[3], -6);                             \
+    void *upperMap = G##_ArcMap_LONG_construct(graphPtr);                      \
+    void *costMap = G##_ArcMap_LONG_construct(graphPtr);                       \
+    for (int i = 0; i < 4; i++) {                                              \
+      G##_ArcMap_LONG_set(upperMap, arcs[i], 10);                              \
+      G##_ArcMap_LONG_set(costMap, arcs[i], 0);                                \
+    }                                                                          \
+                                                                               \
+    void *algo = G##_##MCF##_LONG_LONG_construct(graphPtr);                    \
+    G##_##MCF##_LONG_LONG_setCostMap(algo, costMap);                           \
+    G##_##MCF##_LONG_LONG_setSupplyMap(algo, supplyMap);                       \
+    G##_##MCF##_LONG_LONG_setUpperMap(algo, upperMap);                         \
+    int pieceNums[] = {3, 2};                                                  \
+    LONG breakpoints[] = {2, 3, 2};                                            \
+    LONG slopes[] = {1, 2, 4, 3, 5};                                           \
+    int badPieceNums[] = {0, 2};                                               \
+    LONG badBreakpoints[] = {3, 2, 2};                                         \
+    LONG badSlopes[] = {1, 2, 4, 5, 3};                                        \
+    assert(G##_##MCF##_LONG_LONG_setConvexCosts(                               \
+               algo, 2, arcs.data(), badPieceNums, breakpoints, slopes) == 0); \
+    assert(G##_##MCF##_LONG_LONG_setConvexCosts(                               \
+               algo, 2, arcs.data(), pieceNums, badBreakpoints, slopes) == 0); \
+    assert(G##_##MCF##_LONG_LONG_setConvexCosts(                               \
+               algo, 2, arcs.data(), pieceNums, breakpoints, badSlopes) == 0); \
+    assert(G##_##MCF##_LONG_LONG_setConvexCosts(algo, 2, arcs.data(),          \
+                                                pieceNums, breakpoints,        \
+                                                slopes) == 1);                 \
+    assert(G##_##MCF##_LONG_LONG_run(algo) == 1);                              \
+                                                                               \
+    LONG expected[] = {4, 2, 4, 2};                                            \
+    for (int i = 0; i < 4; i++) {                                              \
+      assert(G##_##MCF##_LONG_LONG_flow(algo, arcs[i]) == expected[i]);        \
+    }                                                                          \
+    assert(G##_##MCF##_LONG_LONG_totalCost(algo) == 14);                       \
+                                                                               \
+    G##_##MCF##_LONG_LONG_destruct(algo);                                      \
+    G##_NodeMap_LONG_destruct(supplyMap);                                      \
+    G##_ArcMap_LONG_destruct(upperMap);                                        \
+    G##_ArcMap_LONG_destruct(costMap);                                         \
+    for (void *node : nodes) {                                                 \
+      deleteObject(node);                                                      \
+    }                                                                          \
+    for (void *arc : arcs) {                                                   \
+      deleteObject(arc);                                                       \
+    }                                                                          \
+    G##_destruct(graphPtr);                                                    \
+  }
+
+#define CURVE_TEST(G, name)                                                    \
+  extern "C" {                                                                 \
+  void *G##_CapacityScaling_LONG_LONG_construct(void *graphPtr);               \
+  void G##_CapacityScaling_LONG_LONG_destruct(void *ptr);                      \
+  void G##_CapacityScaling_LONG_LONG_setCostMap(void *algoPtr, void *mapPtr);  \
+  void G##_CapacityScaling_LONG_LONG_setUpperMap(void *algoPtr, void *mapPtr); \
+  int G##_CapacityScaling_LONG_LONG_runCostCurve(void *algoPtr, void *sPtr,    \
+                                                 void *tPtr, LONG maxFlow);    \
+  int G##_CapacityScaling_LONG_LONG_curvePointNum(void *algoPtr);              \
+  void G##_CapacityScaling_LONG_LONG_getCostCurve(void *algoPtr, LONG *flows,  \
+                                                  LONG *costs);                \
+  }                                                                            \
+  void name##_test() {                                                         \
+    PROFILE_BLOCK(#name);                                                      \
+    void *graphPtr = G##_construct();                                          \
+    std::vector<void *> nodes;                                                 \
+    std::vector<void *> arcs;                                                  \
+    for (int i = 0; i < 4; i++) {                                              \
+      nodes.push_back(G##_addNode(graphPtr));                                  \
+    }                                                                          \
+    int ends[][2] = {{0, 1}, {0, 2}, {1, 3}, {2, 3}, {1, 2}};                  \
+    for (int i = 0; i < 5; i++) {                                              \
+      arcs.push_back(                                                          \
+          G##_addArc(graphPtr, nodes[ends[i][0]], nodes[ends[i][1]]));         \
+    }                                                                          \
+                                                                               \
+    void *upperMap = G##_ArcMap_LONG_construct(graphPtr);                      \
+    void *costMap = G##_ArcMap_LONG_construct(graphPtr);                       \
+    LONG upper[] = {3, 2, 1, 4, 2};                                            \
+    LONG cost[] = {1, 5, 1, 1, 1};                                             \
+    for (int i = 0; i < 5; i++) {                                              \
+      G##_ArcMap_LONG_set(upperMap, arcs[i], upper[i]);                        \
+      G##_ArcMap_LONG_set(costMap, arcs[i], cost[i]);                          \
+    }                                                                          \
+                                                                               \
+    void *algo = G##_CapacityScaling_LONG_LONG_construct(graphPtr);            \
+    G##_CapacityScaling_LONG_LONG_setCostMap(algo, costMap);                   \
+    G##_CapacityScaling_LONG_LONG_setUpperMap(algo, upperMap);                 \
+    assert(G##_CapacityScaling_LONG_LONG_runCostCurve(algo, nodes[0],          \
+                                                      nodes[3], -1) == 1);     \
+    assert(G##_CapacityScaling_LONG_LONG_curvePointNum(algo) == 4);            \
+    LONG flows[4], costs[4];                                                   \
+    G##_CapacityScaling_LONG_LONG_getCostCurve(algo, flows, costs);            \
+    LONG expectedFlows[] = {0, 1, 3, 5};                                       \
+    LONG expectedCosts[] = {0, 2, 8, 20};                                      \
+    for (int i = 0; i < 4; i++) {                                              \
+      assert(flows[i] == expectedFlows[i]);                                    \
+      assert(costs[i] == expectedCosts[i]);                                    \
+    }                                                                          \
+                                                                               \
+    assert(G##_CapacityScaling_LONG_LONG_runCostCurve(algo, nodes[0],          \
+                                                      nodes[3], 4) == 1);      \
+    assert(G##_CapacityScaling_LONG_LONG_curvePointNum(algo) == 4);            \
+    G##_CapacityScaling_LONG_LONG_getCostCurve(algo, flows, costs);            \
+    assert(flows[3] == 4 && costs[3] == 14);                                   \
+                                                                               \
+    G##_CapacityScaling_LONG_LONG_destruct(algo);                              \
+    G##_ArcMap_LONG_destruct(upperMap);                                        \
+    G##_ArcMap_LONG_destruct(costMap);                                         \
+    for (void *node : nodes) {                                                 \
+      deleteObject(node);                                                      \
+    }                                                                          \
+    for (void *arc : arcs) {                                                   \
+      deleteObject(arc);                                                       \
+    }                                                                          \
+    G##_destruct(graphPtr);                                                    \
+  }
+
 TEST(SmartDigraph, NetworkSimplex, SmartDigraph_NetworkSimplex);
 TEST(ListDigraph, NetworkSimplex, ListDigraph_NetworkSimplex);
 
 TEST(SmartDigraph, CostScaling, SmartDigraph_CostScaling);
 TEST(ListDigraph, CostScaling, ListDigraph_CostScaling);
 
+TEST(SmartDigraph, CostScalingRounded, SmartDigraph_CostScalingRounded);
+TEST(ListDigraph, NetworkSimplexRounded, ListDigraph_NetworkSimplexRounded);
+
 TEST(SmartDigraph, CapacityScaling, SmartDigraph_CapacityScaling);
 TEST(ListDigraph, CapacityScaling, ListDigraph_CapacityScaling);
 
+CAS_HEAP_TEST(SmartDigraph, CapacityScalingRadixHeap, 1,
+              SmartDigraph_CapacityScalingRadixHeap);
+// Costs above 2^31 (they must not be truncated to int priorities)
+CAS_HEAP_TEST(ListDigraph, CapacityScalingRadixHeap, 3000000000LL,
+              ListDigraph_CapacityScalingRadixHeap);
+
+CROSSOVER_TEST(SmartDigraph, SmartDigraph_Crossover);
+ADD_ARCS_TEST(ListDigraph, ListDigraph_AddArcs);
+
+CONVEX_TEST(SmartDigraph, CapacityScaling, SmartDigraph_ConvexCapacityScaling);
+CONVEX_TEST(ListDigraph, CostScaling, ListDigraph_ConvexCostScaling);
+
+CURVE_TEST(ListDigraph, ListDigraph_CostCurve);
+
 int main() {
   std::cout << "Starting tests...\n";
 
@@ -258,9 +1284,27 @@ int main() {
   ListDigraph_NetworkSimplex_test();
   SmartDigraph_CostScaling_test();
   ListDigraph_CostScaling_test();
+  SmartDigraph_CostScalingRounded_test();
+  ListDigraph_NetworkSimplexRounded_test();
   SmartDigraph_CapacityScaling_test();
   ListDigraph_CapacityScaling_test();
+  SmartDigraph_CapacityScalingRadixHeap_test();
+  ListDigraph_CapacityScalingRadixHeap_test();
+  SmartDigraph_Crossover_test();
+  ListDigraph_AddArcs_test();
+  SmartDigraph_ConvexCapacityScaling_test();
+  ListDigraph_ConvexCostScaling_test();
+  ListDigraph_CostCurve_test();
   SG_CostScaling_test();
+  SG_Cache_test();
+  SG_ScenarioBatch_test();
+  TransportationSimplex_test();
+  EMD_test();
+  AuctionAssignment_test();
+  JonkerVolgenant_test();
+  SG_Feasibility_test();
+  SG_Preflow_test();
+  SG_PreflowBatch_test();
 
   std::cout << "Tests passed succesfully!\n";
 